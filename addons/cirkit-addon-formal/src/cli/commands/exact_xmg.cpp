@@ -67,6 +67,7 @@ exact_xmg_command::exact_xmg_command( const environment::ptr& env )
     ( "print_solutions",                                     "print solutions" )
     ( "enc_int",                                             "encode numbers as integers (not bit-vectors)" )
     ( "timeout",           value( &timeout ),                "timeout (in seconds)" )
+    ( "engine",            value_with_default( &engine ),    "SAT engine (only for truth tables):\nz3: SMT encoding\nbmcg: incremental SAT encoding" )
     ( "timeout_heuristic",                                   "continue with next level on timeout" )
     ( "very_verbose",                                        "be very verbose" )
     ;
@@ -85,6 +86,7 @@ bool exact_xmg_command::execute()
   settings->set( "breaking",            breaking );
   settings->set( "enc_with_bitvectors", !is_set( "enc_int" ) );
   settings->set( "very_verbose",        is_set( "very_verbose" ) );
+  settings->set( "engine",              engine );
   if ( is_set( "timeout" ) )
   {
     settings->set( "timeout", boost::optional<unsigned>( timeout ) );
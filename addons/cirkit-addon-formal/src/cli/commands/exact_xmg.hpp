@@ -57,6 +57,7 @@ private:
   unsigned              start = 1u;
   unsigned              timeout;
   std::string           breaking = "CIsalty";
+  std::string           engine = "z3";
 };
 
 }
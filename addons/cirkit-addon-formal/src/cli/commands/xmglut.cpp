@@ -66,10 +66,12 @@ xmglut_command::xmglut_command( const environment::ptr& env )
     ( "lut_size,k", value_with_default( &lut_size ), "LUT size" )
     ( "map_cmd",    value_with_default( &map_cmd ),  "ABC map command in &space, use %d as placeholder for the LUT size" )
     ( "timeout,t",  value( &timeout ),               "timeout in seconds (afterwards, heuristics are tried)" )
+    ( "threads",    value_with_default( &threads ),  "number of threads for exact synthesis of missing library entries (0: all cores)" )
     ( "xmg,x",                                       "create cover from XMG instead of AIG" )
     ( "noxor",                                       "don't use XOR, only works with LUT sizes up to 4" )
     ( "blif_name",  value( &blif_name ),             "read cover from BLIF instead of AIG" )
     ( "dump_luts",  value( &dump_luts ),             "if not empty, all LUTs will be written to file without performing mapping" )
+    ( "parallel_cuts",                               "enumerate cuts in parallel when mapping an XMG" )
     ( "progress,p",                                  "show progress" )
     ;
   add_new_option();
@@ -95,6 +97,8 @@ bool xmglut_command::execute()
   settings->set( "lut_size", lut_size );
   settings->set( "noxor", is_set( "noxor" ) );
   settings->set( "progress", is_set( "progress" ) );
+  settings->set( "parallel_cuts", is_set( "parallel_cuts" ) );
+  settings->set( "num_threads", threads );
   if ( is_set( "dump_luts" ) )
   {
     settings->set( "npn", false );
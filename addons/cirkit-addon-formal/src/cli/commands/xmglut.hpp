@@ -56,6 +56,7 @@ public:
 private:
   unsigned lut_size    = 6u;
   unsigned timeout;
+  unsigned threads     = 0u;
   std::string map_cmd  = "&if -a -K %d";
   std::string blif_name;
   std::string dump_luts;
@@ -31,6 +31,7 @@
 
 #include <alice/rules.hpp>
 #include <cli/stores.hpp>
+#include <core/utils/program_options.hpp>
 #include <formal/xmg/xmg_mine.hpp>
 #include <formal/xmg/xmg_minlib.hpp>
 
@@ -43,11 +44,15 @@ xmgmine_command::xmgmine_command( const environment::ptr& env )
   : cirkit_command( env, "Mine optimum XMGs" )
 {
   opts.add_options()
-    ( "lut_file",  value( &lut_file ), "filename with truth table in binary form in each line" )
-    ( "opt_file",  value( &opt_file ), "filename with optimum XMG database" )
-    ( "timeout,t", value( &timeout ),  "timeout in seconds (afterwards, heuristics are tried)" )
-    ( "add,a",                         "add current XMG to database" )
-    ( "verify",                        "verifies entries in optimum XMG database" )
+    ( "lut_file",  value( &lut_file ),             "filename with truth table in binary form in each line" )
+    ( "opt_file",  value( &opt_file ),             "filename with optimum XMG database" )
+    ( "timeout,t", value( &timeout ),              "timeout in seconds (afterwards, heuristics are tried)" )
+    ( "threads",   value_with_default( &threads ), "number of threads for exact synthesis (0: all cores)" )
+    ( "engine",    value_with_default( &engine ),  "exact synthesis engine:\nz3: SMT encoding\nbmcg: incremental SAT encoding" )
+    ( "portfolio", value_with_default( &portfolio ), "number of SAT encodings that race per function (only for bmcg, at most 3)" )
+    ( "add,a",                                     "add current XMG to database" )
+    ( "convert",   value( &convert ),              "write database to this file (binary if extension is .bin) and compact it" )
+    ( "verify",                                    "verifies entries in optimum XMG database" )
     ;
   be_verbose();
 }
@@ -55,8 +60,9 @@ xmgmine_command::xmgmine_command( const environment::ptr& env )
 command::rules_t xmgmine_command::validity_rules() const
 {
   return {
-    {[this]() { return is_set( "verify" ) || is_set( "add" ) || is_set( "lut_file" ); }, "lut_file or verify needs to be set" },
-    {[this]() { return is_set( "verify" ) || is_set( "add" ) || boost::filesystem::exists( lut_file ); }, "lut_file does not exist" },
+    {[this]() { return is_set( "verify" ) || is_set( "add" ) || is_set( "convert" ) || is_set( "lut_file" ); }, "lut_file, verify, add, or convert needs to be set" },
+    {[this]() { return is_set( "verify" ) || is_set( "add" ) || is_set( "convert" ) || boost::filesystem::exists( lut_file ); }, "lut_file does not exist" },
+    {[this]() { return engine == "z3" || engine == "bmcg"; }, "unknown engine" },
     {[this]() { return !is_set( "add" ) || env->store<xmg_graph>().current_index() != -1; }, "no XMG in store" },
     {[this]() { return !is_set( "add" ) || env->store<xmg_graph>().current().outputs().size() == 1u; }, "XMG can only have one output" },
     file_exists_if_set( *this, opt_file, "opt_file" )
@@ -71,10 +77,15 @@ bool xmgmine_command::execute()
     opt_file.clear();
     if ( const auto* path = std::getenv( "CIRKIT_HOME" ) )
     {
-      const auto filename = boost::str( boost::format( "%s/xmgmin.txt" ) % path );
-      if ( boost::filesystem::exists( filename ) )
+      /* prefer the binary library */
+      for ( const auto& ext : {"bin", "txt"} )
       {
-        opt_file = filename;
+        const auto filename = boost::str( boost::format( "%s/xmgmin.%s" ) % path % ext );
+        if ( boost::filesystem::exists( filename ) )
+        {
+          opt_file = filename;
+          break;
+        }
       }
     }
   }
@@ -108,9 +119,18 @@ bool xmgmine_command::execute()
     minlib.add_to_library( xmgs.current() );
     minlib.write_library_file( opt_file, 5u );
   }
+  else if ( is_set( "convert" ) )
+  {
+    xmg_minlib_manager minlib( make_settings() );
+    minlib.load_library_file( opt_file );
+    minlib.write_library_file( convert, 5u );
+  }
   else
   {
     const auto settings = make_settings();
+    settings->set( "num_threads", threads );
+    settings->set( "engine",      engine );
+    settings->set( "portfolio",   portfolio );
     if ( is_set( "timeout" ) )
     {
       settings->set( "timeout", boost::optional<unsigned>( timeout ) );
@@ -56,6 +56,10 @@ private:
   std::string lut_file;
   std::string opt_file;
   unsigned    timeout;
+  unsigned    threads = 0u;
+  std::string engine = "z3";
+  unsigned    portfolio = 1u;
+  std::string convert;
 };
 
 }
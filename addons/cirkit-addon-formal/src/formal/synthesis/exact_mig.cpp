@@ -41,6 +41,8 @@
 #include <classical/mig/mig_from_string.hpp>
 #include <classical/mig/mig_utils.hpp>
 #include <classical/utils/spec_representation.hpp>
+#include <classical/xmg/xmg_exact_sat.hpp>
+#include <classical/xmg/xmg_mig.hpp>
 
 #ifdef ADDON_FORMAL
 #include <formal/utils/z3_utils.hpp>
@@ -1443,6 +1445,19 @@ boost::optional<mig_graph> exact_mig_with_sat( const tt& spec,
                                                const properties::ptr& settings,
                                                const properties::ptr& statistics )
 {
+  if ( get( settings, "engine", std::string( "z3" ) ) == "bmcg" )
+  {
+    auto bmcg_settings = std::make_shared<properties>( settings ? *settings : properties() );
+    bmcg_settings->set( "with_xor", false );
+
+    const auto xmg = xmg_exact_sat( spec, bmcg_settings, statistics );
+    if ( !(bool)xmg )
+    {
+      return boost::none;
+    }
+    return xmg_create_mig_topological( *xmg );
+  }
+
   /* timing */
   properties_timer t( statistics );
 
@@ -1493,6 +1508,11 @@ boost::optional<xmg_graph> exact_xmg_with_sat( const tt& spec,
                                                const properties::ptr& settings,
                                                const properties::ptr& statistics )
 {
+  if ( get( settings, "engine", std::string( "z3" ) ) == "bmcg" )
+  {
+    return xmg_exact_sat( spec, settings, statistics );
+  }
+
   /* timing */
   properties_timer t( statistics );
 
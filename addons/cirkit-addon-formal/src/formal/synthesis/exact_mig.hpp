@@ -60,6 +60,7 @@ namespace cirkit
    | min_depth           | Smallest MIG with smallest depth              | false                  |
    | all_solutions       | Enumerate all solutions                       | false                  |
    | enc_with_bitvectors | Encode numbers as bit-vectors and not as ints | false                  |
+   | engine              | z3 or bmcg (see xmg_exact_sat, only for tt)   | std::string( "z3" )    |
    | verbose             | Be verbose                                    | false                  |
    |---------------------+-----------------------------------------------+------------------------|
  */
@@ -28,7 +28,7 @@
 
 #include <fstream>
 #include <map>
-#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
@@ -39,7 +39,6 @@
 #include <core/utils/timer.hpp>
 #include <classical/functions/npn_canonization.hpp>
 #include <classical/utils/truth_table_utils.hpp>
-#include <classical/xmg/xmg_rewrite.hpp>
 #include <formal/synthesis/exact_mig.hpp>
 #include <formal/xmg/xmg_minlib.hpp>
 
@@ -64,9 +63,10 @@ public:
       minlib( settings )
   {
     /* settings */
-    dump_luts = get( settings, "dump_luts", std::string() );
-    npn       = get( settings, "npn",       true );
-    noxor     = get( settings, "noxor",     false );
+    dump_luts   = get( settings, "dump_luts",   std::string() );
+    npn         = get( settings, "npn",         true );
+    noxor       = get( settings, "noxor",       false );
+    num_threads = get( settings, "num_threads", 0u );
   }
 
   xmg_graph run()
@@ -94,30 +94,30 @@ public:
 
     compute_optimal_xmgs();
 
-    if ( !noxor )
-    {
-      write_library_to_file();
-    }
-
     initialize_xmg();
     map();
 
     return xmg;
   }
 
+  /* number of library entries computed with exact synthesis */
+  unsigned synthesized() const { return num_synthesized; }
+
 private:
   void compute_optimal_xmgs()
   {
     const auto tts = get( boost::vertex_lut, lut );
     const auto types = get( boost::vertex_lut_type, lut );
 
-    auto ex_settings = std::make_shared<properties>();
-    ex_settings->set( "verbose", verbose );
-
+    /* synthesize all missing library entries at once, such that each
+       NPN class is only solved once and solving is done in parallel */
+    std::vector<tt> specs;
+    std::unordered_set<std::string> visited;
     for ( const auto& v : boost::make_iterator_range( vertices( lut ) ) )
     {
       if ( types[v] != lut_type_t::internal ) { continue; }
       if ( boost::out_degree( v, lut ) == 1u ) { continue; }
+      if ( !visited.insert( tts[v] ).second ) { continue; }
 
       tt t( convert_hex2bin( tts[v] ) );
 
@@ -133,33 +133,9 @@ private:
         assert( false );
       }
 
-      // tt_extend( t, 4u ); /* at least 4 variables */
-
-      if ( optimal_xmgs.find( tts[v] ) != optimal_xmgs.end() )
-      {
-        if ( verbose )
-        {
-          //std::cout << "[i] used cached entry" << std::endl;
-        }
-        continue;
-      }
-
-      if ( verbose )
-      {
-        //std::cout << "[i] compute XMG for " << tt_to_hex( t ) << std::endl;
-      }
-
-      xmg_graph xmg;
-      if ( npn )
-      {
-        xmg = minlib.find_xmg( t );
-      }
-      else
-      {
-        xmg = minlib.find_xmg_no_npn( t );
-      }
-      optimal_xmgs.insert( std::make_pair( tts[v], xmg ) );
+      specs.push_back( t );
     }
+    num_synthesized = minlib.prepare( specs, npn, num_threads );
   }
 
   void initialize_xmg()
@@ -227,32 +203,8 @@ private:
             assert( false );
           }
 
-          const auto it = optimal_xmgs.find( tts[v] );
-          assert ( it != optimal_xmgs.end() );
-
-          const auto opt_xmg = it->second;
-          if ( opt_xmg.inputs().size() != boost::out_degree( v, lut ) )
-          {
-            boost::dynamic_bitset<> phase;
-            std::vector<unsigned> perm;
-            tt orig( convert_hex2bin( tts[v] ) );
-            auto npn = npn_canonization_lucky( orig, phase, perm );
-
-            std::cout << "[e] problem when mapping LUT " << v << " with TT " << tts[v] << " to XMG" << std::endl;
-            std::cout << "[e] LUT has " << boost::out_degree( v, lut ) << " inputs" << std::endl;
-            std::cout << "[e] XMG has " << opt_xmg.inputs().size() << " inputs" << std::endl;
-            std::cout << "[e] TT: " << orig << ", NPN: " << npn << std::endl;
-            assert( false );
-          }
-          const auto outputs = xmg_rewrite_top_down_inplace( xmg, opt_xmg, rewrite_default_maj, rewrite_default_xor, pi_mapping );
-
-          if ( outputs.size() != 1u )
-          {
-            std::cout << "[e] expected: 1, got: " << outputs.size() << std::endl;
-            assert( false );
-          }
-
-          node_to_function[v] = outputs.front();
+          /* library entries are instantiated directly in the target XMG */
+          node_to_function[v] = minlib.rewrite_inplace( tt( convert_hex2bin( tts[v] ) ), xmg, pi_mapping, npn );
         } break;
 
       case lut_type_t::po:
@@ -266,23 +218,22 @@ private:
     }
   }
 
+  /* the binary library is preferred; if only the text library exists, it is
+     converted once; new entries are appended to the binary library */
   void read_library_from_file()
   {
     if ( const auto* path = std::getenv( "CIRKIT_HOME" ) )
     {
-      const auto filename = boost::str( boost::format( "%s/xmgmin.txt" ) % path );
-      if ( boost::filesystem::exists( filename ) )
+      const auto bin_filename = boost::str( boost::format( "%s/xmgmin.bin" ) % path );
+      const auto txt_filename = boost::str( boost::format( "%s/xmgmin.txt" ) % path );
+
+      if ( !boost::filesystem::exists( bin_filename ) && boost::filesystem::exists( txt_filename ) )
       {
-        minlib.load_library_file( filename );
+        minlib.load_library_file( txt_filename );
+        minlib.write_library_file( bin_filename );
       }
-    }
-  }
 
-  void write_library_to_file()
-  {
-    if ( const auto* path = std::getenv( "CIRKIT_HOME" ) )
-    {
-      minlib.write_library_file( boost::str( boost::format( "%s/xmgmin.txt" ) % path ) );
+      minlib.load_library_file( bin_filename, true );
     }
   }
 
@@ -336,8 +287,9 @@ private:
   std::string dump_luts; /* if not empty, no mapping is performed but only luts are dumped */
   bool npn = true;
   bool noxor = false;
+  unsigned num_threads = 0u;
+  unsigned num_synthesized = 0u;
 
-  std::unordered_map<std::string, xmg_graph> optimal_xmgs;
   std::vector<xmg_function> node_to_function;
   xmg_graph xmg;
   xmg_minlib_manager minlib;
@@ -356,7 +308,11 @@ xmg_graph xmg_from_lut_mapping( const lut_graph_t& lut,
 
   /* compute optimal XMGs for each LUT */
   xmg_from_lut_mapping_manager mgr( lut, settings );
-  return mgr.run();
+  const auto xmg = mgr.run();
+
+  set( statistics, "num_synthesized", mgr.synthesized() );
+
+  return xmg;
 }
 
 }
@@ -28,11 +28,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/optional.hpp>
 
 #include <core/utils/string_utils.hpp>
+#include <core/utils/timer.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <formal/xmg/xmg_minlib.hpp>
 
@@ -60,17 +62,25 @@ void xmg_mine( const std::string& lut_file, const std::string& opt_file, const p
 
   minlib.load_library_file( opt_file, true );
 
+  /* settings */
+  const auto num_threads = get( settings, "num_threads", 0u );
+
+  /* timer */
+  properties_timer t( statistics );
+
   std::ifstream in( lut_file.c_str(), std::ifstream::in );
   std::string line;
+  std::vector<tt> specs;
 
   while ( getline( in, line ) )
   {
     boost::trim( line );
 
-    tt t( line );
-
-    minlib.find_xmg_no_npn( t );
+    specs.push_back( tt( line ) );
   }
+
+  /* missing entries are computed concurrently and appended to opt_file */
+  set( statistics, "num_synthesized", minlib.prepare( specs, false, num_threads ) );
 }
 
 }
@@ -26,17 +26,27 @@
 
 #include "xmg_minlib.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
+#include <map>
 #include <sstream>
+#include <tuple>
+#include <unordered_set>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/pending/integer_log2.hpp>
 
 #include <core/utils/conversion_utils.hpp>
 #include <core/utils/string_utils.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/functions/aig_from_truth_table.hpp>
 #include <classical/functions/npn_canonization.hpp>
 #include <classical/utils/expression_parser.hpp>
@@ -54,10 +64,295 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+/* Binary library format, all numbers are 32-bit unsigned integers in host
+ * byte order unless noted otherwise:
+ *
+ *   header    magic, version, number of sorted entries n, byte offset of the
+ *             first appended record
+ *   index     n times: truth table (64 bit), number of variables, byte offset
+ *             of the record; sorted by number of variables and truth table
+ *   records   truth table (64 bit), number of variables, number of gates g,
+ *             output literal, 4 * g words for the gates (see xmg_minlib_entry)
+ *
+ * Records behind the offset in the header have been appended after the file
+ * was written and are not indexed; they are decoded when the library is
+ * loaded.  Only functions with up to 6 variables are stored.
+ */
+constexpr uint32_t    xmg_minlib_magic            = 0x4c474d58; /* XMGL */
+constexpr uint32_t    xmg_minlib_version          = 1u;
+constexpr std::size_t xmg_minlib_header_size      = 4u * sizeof( uint32_t );
+constexpr std::size_t xmg_minlib_index_entry_size = sizeof( uint64_t ) + 2u * sizeof( uint32_t );
+constexpr std::size_t xmg_minlib_record_size      = sizeof( uint64_t ) + 3u * sizeof( uint32_t );
+
+static_assert( sizeof( unsigned ) == sizeof( uint32_t ), "gates of library entries are read as 32-bit words" );
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+/* hex strings of truth tables have 2^(n-2) digits */
+unsigned xmg_minlib_num_vars( const std::string& hex )
+{
+  return boost::integer_log2( hex.size() ) + 2u;
+}
+
+/* packed key of a truth table, returns false if it does not fit into 64 bits */
+bool xmg_minlib_key( const std::string& hex, uint64_t& bits, unsigned& num_vars )
+{
+  if ( hex.empty() || hex.size() > 16u || ( hex.size() & ( hex.size() - 1u ) ) != 0u )
+  {
+    return false;
+  }
+
+  num_vars = xmg_minlib_num_vars( hex );
+  bits = std::stoull( hex, nullptr, 16 );
+  return true;
+}
+
+std::string xmg_minlib_hex( uint64_t bits, unsigned num_vars )
+{
+  std::ostringstream os;
+  os << std::hex << std::setfill( '0' ) << std::setw( 1u << ( num_vars - 2u ) ) << bits;
+  return os.str();
+}
+
+class xmg_minlib_entry_builder
+{
+public:
+  explicit xmg_minlib_entry_builder( unsigned num_vars )
+  {
+    entry.num_vars = num_vars;
+  }
+
+  /* returns literal */
+  unsigned add( const expression_t::ptr& expr )
+  {
+    switch ( expr->type )
+    {
+    case expression_t::_const:
+      return expr->value == 1u ? 1u : 0u;
+
+    case expression_t::_var:
+      if ( expr->value >= entry.num_vars )
+      {
+        throw "Error: variable index in library entry exceeds number of variables";
+      }
+      return 2u * ( expr->value + 1u );
+
+    case expression_t::_inv:
+      return add( expr->children.front() ) ^ 1u;
+
+    case expression_t::_and:
+    case expression_t::_or:
+      {
+        auto it = expr->children.begin();
+        const auto a = add( *it++ );
+        const auto b = add( *it );
+        return add_gate( 0u, expr->type == expression_t::_and ? 0u : 1u, a, b );
+      }
+
+    case expression_t::_maj:
+      {
+        auto it = expr->children.begin();
+        const auto a = add( *it++ );
+        const auto b = add( *it++ );
+        const auto c = add( *it );
+        return add_gate( 0u, a, b, c );
+      }
+
+    case expression_t::_xor:
+      {
+        auto it = expr->children.begin();
+        const auto a = add( *it++ );
+        const auto b = add( *it );
+        return add_gate( 1u, a, b, 0u );
+      }
+    }
+
+    assert( false );
+    return 0u;
+  }
+
+private:
+  unsigned add_gate( unsigned type, unsigned a, unsigned b, unsigned c )
+  {
+    const std::array<unsigned, 4u> key{{type, a, b, c}};
+
+    const auto it = strash.find( key );
+    if ( it != strash.end() )
+    {
+      return it->second;
+    }
+
+    const auto literal = 2u * ( 1u + entry.num_vars + entry.num_gates() );
+    entry.gates.insert( entry.gates.end(), key.begin(), key.end() );
+    strash.insert( {key, literal} );
+    return literal;
+  }
+
+public:
+  xmg_minlib_entry entry;
+
+private:
+  std::map<std::array<unsigned, 4u>, unsigned> strash;
+};
+
+xmg_minlib_entry xmg_minlib_entry_from_expression( const expression_t::ptr& expr, unsigned num_vars )
+{
+  xmg_minlib_entry_builder builder( num_vars );
+  builder.entry.output = builder.add( expr );
+  return builder.entry;
+}
+
+expression_t::ptr xmg_minlib_entry_to_expression( const xmg_minlib_entry& entry, unsigned literal )
+{
+  auto expr = std::make_shared<expression_t>();
+  const auto node = literal >> 1u;
+
+  if ( node == 0u )
+  {
+    expr->type = expression_t::_const;
+    expr->value = literal & 1u;
+  }
+  else if ( literal & 1u )
+  {
+    expr->type = expression_t::_inv;
+    expr->children.push_back( xmg_minlib_entry_to_expression( entry, literal ^ 1u ) );
+  }
+  else if ( node <= entry.num_vars )
+  {
+    expr->type = expression_t::_var;
+    expr->value = node - 1u;
+  }
+  else
+  {
+    const auto* gate = &entry.gates[4u * ( node - 1u - entry.num_vars )];
+
+    expr->type = gate[0] == 0u ? expression_t::_maj : expression_t::_xor;
+    for ( auto i = 1u; i <= ( gate[0] == 0u ? 3u : 2u ); ++i )
+    {
+      expr->children.push_back( xmg_minlib_entry_to_expression( entry, gate[i] ) );
+    }
+  }
+
+  return expr;
+}
+
+expression_t::ptr xmg_minlib_entry_to_expression( const xmg_minlib_entry& entry )
+{
+  return xmg_minlib_entry_to_expression( entry, entry.output );
+}
+
+/* inputs that are not in pis are created on demand, as in xmg_from_expression */
+xmg_function xmg_minlib_instantiate( const xmg_minlib_entry& entry, xmg_graph& dest, std::vector<xmg_function> pis )
+{
+  std::vector<xmg_function> gates;
+  gates.reserve( entry.num_gates() );
+
+  const auto function = [&]( unsigned literal ) {
+    const auto node = literal >> 1u;
+    const auto complemented = ( literal & 1u ) == 1u;
+
+    if ( node == 0u )
+    {
+      return dest.get_constant( complemented );
+    }
+    else if ( node <= entry.num_vars )
+    {
+      for ( auto i = pis.size(); i < node; ++i )
+      {
+        pis.push_back( dest.create_pi( boost::str( boost::format( "x%d" ) % i ) ) );
+      }
+      return pis[node - 1u] ^ complemented;
+    }
+    else
+    {
+      return gates[node - 1u - entry.num_vars] ^ complemented;
+    }
+  };
+
+  for ( auto i = 0u; i < entry.gates.size(); i += 4u )
+  {
+    if ( entry.gates[i] == 0u )
+    {
+      gates.push_back( dest.create_maj( function( entry.gates[i + 1u] ), function( entry.gates[i + 2u] ), function( entry.gates[i + 3u] ) ) );
+    }
+    else
+    {
+      gates.push_back( dest.create_xor( function( entry.gates[i + 1u] ), function( entry.gates[i + 2u] ) ) );
+    }
+  }
+
+  return function( entry.output );
+}
+
+/* throws if some literal does not point to a preceding node */
+void xmg_minlib_validate_entry( const xmg_minlib_entry& entry )
+{
+  const auto num_nodes = 1u + entry.num_vars + entry.num_gates();
+
+  for ( auto i = 0u; i < entry.gates.size(); i += 4u )
+  {
+    const auto node = 1u + entry.num_vars + i / 4u;
+    if ( entry.gates[i] > 1u ||
+         ( entry.gates[i + 1u] >> 1u ) >= node || ( entry.gates[i + 2u] >> 1u ) >= node || ( entry.gates[i + 3u] >> 1u ) >= node )
+    {
+      throw "Error: invalid gate in binary XMG library";
+    }
+  }
+
+  if ( ( entry.output >> 1u ) >= num_nodes )
+  {
+    throw "Error: invalid output in binary XMG library";
+  }
+}
+
+xmg_minlib_entry xmg_minlib_read_record( mapped_reader& reader, uint64_t& bits )
+{
+  xmg_minlib_entry entry;
+
+  bits = reader.read<uint64_t>();
+  entry.num_vars = reader.read<uint32_t>();
+  const auto num_gates = reader.read<uint32_t>();
+  entry.output = reader.read<uint32_t>();
+
+  if ( entry.num_vars < 2u || entry.num_vars > 6u || num_gates > reader.remaining() / ( 4u * sizeof( uint32_t ) ) )
+  {
+    throw "Error: invalid record in binary XMG library";
+  }
+
+  if ( num_gates > 0u )
+  {
+    entry.gates.resize( 4u * num_gates );
+    reader.read( entry.gates.data(), entry.gates.size() );
+  }
+  xmg_minlib_validate_entry( entry );
+
+  return entry;
+}
+
+void xmg_minlib_write_record( std::ostream& os, uint64_t bits, const xmg_minlib_entry& entry )
+{
+  /* assemble the record first, such that it is appended with a single write */
+  std::string buffer( xmg_minlib_record_size + entry.gates.size() * sizeof( uint32_t ), '\0' );
+  const uint32_t words[] = {static_cast<uint32_t>( entry.num_vars ), static_cast<uint32_t>( entry.num_gates() ), static_cast<uint32_t>( entry.output )};
+
+  std::memcpy( &buffer[0], &bits, sizeof( bits ) );
+  std::memcpy( &buffer[sizeof( bits )], words, sizeof( words ) );
+  if ( !entry.gates.empty() )
+  {
+    std::memcpy( &buffer[xmg_minlib_record_size], entry.gates.data(), entry.gates.size() * sizeof( uint32_t ) );
+  }
+
+  os.write( buffer.data(), buffer.size() );
+}
+
+void xmg_minlib_write_header( std::ostream& os, uint32_t num_sorted, uint32_t tail_offset )
+{
+  const uint32_t header[] = {xmg_minlib_magic, xmg_minlib_version, num_sorted, tail_offset};
+  os.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+}
+
 void xmg_minlib_manager::load_library( std::istream& in )
 {
   std::string line;
@@ -83,9 +378,126 @@ void xmg_minlib_manager::load_library( std::istream& in )
   }
 }
 
+void xmg_minlib_manager::load_binary_library( const std::string& filename )
+{
+  binary.reset( new mapped_file( filename ) );
+
+  mapped_reader reader( binary->begin(), binary->end() );
+  if ( reader.read<uint32_t>() != xmg_minlib_magic )
+  {
+    throw "Error: not a binary XMG library";
+  }
+  if ( reader.read<uint32_t>() != xmg_minlib_version )
+  {
+    throw "Error: unsupported version of binary XMG library";
+  }
+  binary_num_sorted = reader.read<uint32_t>();
+  const auto tail_offset = reader.read<uint32_t>();
+
+  if ( binary_num_sorted > reader.remaining() / xmg_minlib_index_entry_size || tail_offset > binary->size() )
+  {
+    throw "Error: corrupt binary XMG library";
+  }
+  binary_index = reader.skip( binary_num_sorted * xmg_minlib_index_entry_size );
+
+  /* records appended since the file was written; a record that is still
+     being appended by another process is ignored */
+  mapped_reader tail( binary->begin() + tail_offset, binary->end() );
+  auto count = 0u;
+  while ( tail.remaining() >= xmg_minlib_record_size )
+  {
+    uint64_t bits;
+    try
+    {
+      const auto entry = xmg_minlib_read_record( tail, bits );
+      library[xmg_minlib_hex( bits, entry.num_vars )].push_back( entry );
+      ++count;
+    }
+    catch ( const char* e )
+    {
+      std::cout << "[w] " << e << ", ignore remaining appended entries" << std::endl;
+      break;
+    }
+  }
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] mapped %d entries and loaded %d appended entries from %s" ) % binary_num_sorted % count % filename << std::endl;
+  }
+}
+
+/* decodes all entries of the sorted part of a binary library */
+void xmg_minlib_manager::load_all_entries()
+{
+  for ( auto i = 0u; i < binary_num_sorted; ++i )
+  {
+    uint64_t bits;
+    uint32_t num_vars;
+    std::memcpy( &bits, binary_index + i * xmg_minlib_index_entry_size, sizeof( bits ) );
+    std::memcpy( &num_vars, binary_index + i * xmg_minlib_index_entry_size + sizeof( bits ), sizeof( num_vars ) );
+
+    if ( num_vars >= 2u && num_vars <= 6u )
+    {
+      find_entry( xmg_minlib_hex( bits, num_vars ) );
+    }
+  }
+}
+
+void xmg_minlib_manager::write_binary_library_file( const std::string& filename, unsigned minsize )
+{
+  load_all_entries();
+
+  /* only the first implementation of each function is stored */
+  std::vector<std::tuple<uint32_t, uint64_t, const xmg_minlib_entry*>> entries;
+  for ( const auto& p : library )
+  {
+    uint64_t bits;
+    unsigned num_vars;
+    if ( p.second.empty() || !xmg_minlib_key( p.first, bits, num_vars ) ) { continue; }
+    if ( minsize >= 2 && p.first.size() < ( 1u << ( minsize - 2 ) ) ) { continue; }
+
+    entries.emplace_back( num_vars, bits, &p.second.front() );
+  }
+  std::sort( entries.begin(), entries.end() );
+
+  /* written to a temporary file first, since filename may be mapped */
+  const auto tmp_filename = filename + ".tmp";
+  std::ofstream os( tmp_filename.c_str(), std::ofstream::out | std::ofstream::binary );
+
+  auto offset = xmg_minlib_header_size + entries.size() * xmg_minlib_index_entry_size;
+  for ( const auto& e : entries )
+  {
+    offset += xmg_minlib_record_size + std::get<2>( e )->gates.size() * sizeof( uint32_t );
+  }
+  xmg_minlib_write_header( os, entries.size(), offset );
+
+  offset = xmg_minlib_header_size + entries.size() * xmg_minlib_index_entry_size;
+  for ( const auto& e : entries )
+  {
+    const auto bits = std::get<1>( e );
+    const uint32_t words[] = {std::get<0>( e ), static_cast<uint32_t>( offset )};
+    os.write( reinterpret_cast<const char*>( &bits ), sizeof( bits ) );
+    os.write( reinterpret_cast<const char*>( words ), sizeof( words ) );
+
+    offset += xmg_minlib_record_size + std::get<2>( e )->gates.size() * sizeof( uint32_t );
+  }
+
+  for ( const auto& e : entries )
+  {
+    xmg_minlib_write_record( os, std::get<1>( e ), *std::get<2>( e ) );
+  }
+
+  os.close();
+
+  if ( !os || std::rename( tmp_filename.c_str(), filename.c_str() ) != 0 )
+  {
+    throw "Error: could not write binary XMG library";
+  }
+}
+
 void xmg_minlib_manager::add_to_library( const std::string& hex, const std::string& expr )
 {
-  library[hex].push_back( expr );
+  library[hex].push_back( xmg_minlib_entry_from_expression( parse_expression( expr ), xmg_minlib_num_vars( hex ) ) );
 }
 
 std::string xmg_minlib_manager::format_library_entry( const std::string& hex, const std::string& expr )
@@ -93,7 +505,9 @@ std::string xmg_minlib_manager::format_library_entry( const std::string& hex, co
   return boost::str( boost::format( "0x%s %s" ) % hex % expr );
 }
 
-std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
+/* looks up decoded entries first and then the sorted part of a binary
+   library, whose entries are decoded on first use */
+const xmg_minlib_entry* xmg_minlib_manager::find_entry( const std::string& hex )
 {
   const auto it = library.find( hex );
 
@@ -101,17 +515,82 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
   if ( it != library.end() && !it->second.empty() )
   {
     /* TODO implement different strategies if there are more than one implementation */
-    return it->second.front();
+    return &it->second.front();
+  }
+
+  uint64_t bits;
+  unsigned num_vars;
+  if ( binary_num_sorted == 0u || !xmg_minlib_key( hex, bits, num_vars ) )
+  {
+    return nullptr;
+  }
+
+  const auto key_at = [this]( unsigned i ) {
+    uint64_t bits;
+    uint32_t num_vars;
+    std::memcpy( &bits, binary_index + i * xmg_minlib_index_entry_size, sizeof( bits ) );
+    std::memcpy( &num_vars, binary_index + i * xmg_minlib_index_entry_size + sizeof( bits ), sizeof( num_vars ) );
+    return std::make_pair( num_vars, bits );
+  };
+
+  const auto key = std::make_pair( static_cast<uint32_t>( num_vars ), bits );
+  auto lower = 0u, upper = binary_num_sorted;
+  while ( lower < upper )
+  {
+    const auto mid = lower + ( upper - lower ) / 2u;
+    if ( key_at( mid ) < key )
+    {
+      lower = mid + 1u;
+    }
+    else
+    {
+      upper = mid;
+    }
+  }
+
+  if ( lower == binary_num_sorted || key_at( lower ) != key )
+  {
+    return nullptr;
+  }
+
+  uint32_t offset;
+  std::memcpy( &offset, binary_index + lower * xmg_minlib_index_entry_size + sizeof( uint64_t ) + sizeof( uint32_t ), sizeof( offset ) );
+  if ( offset > binary->size() )
+  {
+    throw "Error: corrupt binary XMG library";
   }
 
+  mapped_reader reader( binary->begin() + offset, binary->end() );
+  auto& entries = library[hex];
+  entries.push_back( xmg_minlib_read_record( reader, bits ) );
+  return &entries.front();
+}
+
+const xmg_minlib_entry& xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
+{
+  if ( const auto* entry = find_entry( hex ) )
+  {
+    return *entry;
+  }
+
+  insert_entry( hex, synthesize_entry( hex, true ) );
+  return library[hex].front();
+}
+
+/* does not access the library, such that it can be called concurrently */
+xmg_minlib_entry xmg_minlib_manager::synthesize_entry( const std::string& hex, bool exact_verbose ) const
+{
   auto exs_settings = std::make_shared<properties>();
-  exs_settings->set( "verbose", true );
+  exs_settings->set( "verbose", exact_verbose );
   exs_settings->set( "timeout", timeout );
+  exs_settings->set( "engine", engine );
+  exs_settings->set( "portfolio", portfolio );
+  exs_settings->set( "bounds", bounds );
   auto exs_statistics = std::make_shared<properties>();
 
   tt spec( convert_hex2bin( hex ) );
 
-  if ( verbose )
+  if ( verbose && exact_verbose )
   {
     std::cout << "[i] no entry for " << spec << " (" << hex << "), find with exact synthesis" << std::endl;
   }
@@ -123,7 +602,7 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
     const auto last_size = exs_statistics->get<unsigned>( "last_size" );
     exs_settings->set( "start", last_size + 1u );
 
-    if ( verbose )
+    if ( verbose && exact_verbose )
     {
       std::cout << "[i] timeout at size " << last_size << ", try with " << ( last_size + 1u ) << std::endl;
     }
@@ -133,7 +612,7 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
     if ( !(bool)xmg_exact )
     {
       /* could be done better */
-      if ( verbose )
+      if ( verbose && exact_verbose )
       {
         std::cout << "[i] last resort, fall back to heuristic" << std::endl;
       }
@@ -152,24 +631,36 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
     xmg = *xmg_exact;
   }
 
-  /* compute expression from XMG and add it to the library */
-  const auto expr = xmg_to_expression( xmg, xmg.outputs().front().first );
-  const auto str = expression_to_string( expr );
+  /* compute library entry from XMG */
+  return xmg_minlib_entry_from_expression( xmg_to_expression( xmg, xmg.outputs().front().first ), xmg_minlib_num_vars( hex ) );
+}
+
+void xmg_minlib_manager::insert_entry( const std::string& hex, const xmg_minlib_entry& entry )
+{
+  std::lock_guard<std::mutex> lock( update_mutex );
 
-  add_to_library( hex, str );
+  library[hex].push_back( entry );
 
   if ( verbose )
   {
-    std::cout << "[i] new entry: " << format_library_entry( hex, str ) << std::endl;
+    std::cout << "[i] new entry: " << format_library_entry( hex, expression_to_string( xmg_minlib_entry_to_expression( entry ) ) ) << std::endl;
   }
 
   if ( auto_update )
   {
-    update_out << format_library_entry( hex, str ) << std::endl;
+    uint64_t bits;
+    unsigned num_vars;
+
+    if ( !update_binary )
+    {
+      update_out << format_library_entry( hex, expression_to_string( xmg_minlib_entry_to_expression( entry ) ) ) << std::endl;
+    }
+    else if ( xmg_minlib_key( hex, bits, num_vars ) )
+    {
+      xmg_minlib_write_record( update_out, bits, entry );
+    }
     update_out.flush();
   }
-
-  return str;
 }
 
 npn_manager::npn_classifier_t make_classifier()
@@ -193,8 +684,14 @@ npn_manager::npn_classifier_t make_classifier()
 xmg_minlib_manager::xmg_minlib_manager( const properties::ptr& settings )
   : npn( 4096, make_classifier() )
 {
-  timeout = get( settings, "timeout", timeout );
-  verbose = get( settings, "verbose", verbose );
+  timeout   = get( settings, "timeout",   timeout );
+  engine    = get( settings, "engine",    engine );
+  portfolio = get( settings, "portfolio", portfolio );
+  verbose   = get( settings, "verbose",   verbose );
+
+  /* proven lower bounds are shared by all synthesis calls; the start values
+     of retries after timeouts are not proven and hence not cached */
+  bounds = std::make_shared<xmg_exact_bounds>();
 }
 
 xmg_minlib_manager::~xmg_minlib_manager()
@@ -207,14 +704,37 @@ xmg_minlib_manager::~xmg_minlib_manager()
 
 void xmg_minlib_manager::load_library_file( const std::string& filename, bool _auto_update )
 {
-  std::ifstream in( filename.c_str(), std::ifstream::in );
-  load_library( in );
-  in.close();
+  /* detect format */
+  auto is_binary = false;
+  {
+    std::ifstream in( filename.c_str(), std::ifstream::in | std::ifstream::binary );
+    uint32_t magic = 0u;
+    is_binary = in.read( reinterpret_cast<char*>( &magic ), sizeof( magic ) ) && magic == xmg_minlib_magic;
+  }
+
+  if ( is_binary )
+  {
+    load_binary_library( filename );
+  }
+  else
+  {
+    std::ifstream in( filename.c_str(), std::ifstream::in );
+    load_library( in );
+    in.close();
+  }
 
   if ( _auto_update )
   {
     auto_update = true;
-    update_out.open( filename.c_str(), std::ofstream::out | std::ofstream::app );
+    update_binary = is_binary || ( !boost::filesystem::exists( filename ) && boost::ends_with( filename, ".bin" ) );
+    update_out.open( filename.c_str(), std::ofstream::out | std::ofstream::app | std::ofstream::binary );
+
+    /* a new binary library starts with an empty sorted part */
+    if ( update_binary && !is_binary )
+    {
+      xmg_minlib_write_header( update_out, 0u, xmg_minlib_header_size );
+      update_out.flush();
+    }
   }
 }
 
@@ -226,6 +746,14 @@ void xmg_minlib_manager::load_library_string( const std::string& string )
 
 void xmg_minlib_manager::write_library_file( const std::string& filename, unsigned minsize )
 {
+  if ( boost::ends_with( filename, ".bin" ) )
+  {
+    write_binary_library_file( filename, minsize );
+    return;
+  }
+
+  load_all_entries();
+
   std::ofstream os( filename.c_str(), std::ofstream::out );
 
   for ( const auto& p : library )
@@ -235,9 +763,9 @@ void xmg_minlib_manager::write_library_file( const std::string& filename, unsign
       continue;
     }
 
-    for ( const auto& circ : p.second )
+    for ( const auto& entry : p.second )
     {
-      os << format_library_entry( p.first, circ ) << std::endl;
+      os << format_library_entry( p.first, expression_to_string( xmg_minlib_entry_to_expression( entry ) ) ) << std::endl;
     }
   }
 
@@ -248,24 +776,13 @@ xmg_graph xmg_minlib_manager::find_xmg( const tt& spec )
 {
   const auto numvars = tt_num_vars( spec );
 
-  std::vector<unsigned> perm;
-  boost::dynamic_bitset<> phase;
-  const auto npn_spec = npn.compute( spec, phase, perm );
-
   xmg_graph xmg;
   std::vector<xmg_function> pis;
   for ( auto i = 0u; i < numvars; ++i )
   {
-    xmg.create_pi( std::string( 1, 'a' + i ) );
-  }
-  for ( auto i = 0u; i < numvars; ++i )
-  {
-    pis.push_back( {xmg.inputs()[perm[i]].first, phase[perm[i]]} );
+    pis.push_back( xmg.create_pi( std::string( 1, 'a' + i ) ) );
   }
-  auto xfs_settings = std::make_shared<properties>();
-  xfs_settings->set( "primary_inputs", pis );
-  const auto min_xmg_expr = find_or_create_xmg( tt_to_hex( npn_spec ) );
-  xmg.create_po( xmg_from_string( xmg, min_xmg_expr, xfs_settings ) ^ phase[numvars], "f" );
+  xmg.create_po( rewrite_inplace( spec, xmg, pis ), "f" );
 
   return xmg;
 }
@@ -280,14 +797,86 @@ xmg_graph xmg_minlib_manager::find_xmg_no_npn( const tt& spec )
   {
     pis.push_back( xmg.create_pi( std::string( 1, 'a' + i ) ) );
   }
-  auto xfs_settings = std::make_shared<properties>();
-  xfs_settings->set( "primary_inputs", pis );
-  const auto min_xmg_expr = find_or_create_xmg( tt_to_hex( spec ) );
-  xmg.create_po( xmg_from_string( xmg, min_xmg_expr, xfs_settings ), "f" );
+  xmg.create_po( rewrite_inplace( spec, xmg, pis, false ), "f" );
 
   return xmg;
 }
 
+unsigned xmg_minlib_manager::prepare( const std::vector<tt>& specs, bool use_npn, unsigned num_threads )
+{
+  /* collect distinct missing entries, NPN canonization is not thread-safe
+     and therefore done here */
+  std::vector<std::string> missing;
+  std::unordered_set<std::string> visited;
+
+  for ( const auto& spec : specs )
+  {
+    std::string hex;
+    if ( use_npn )
+    {
+      std::vector<unsigned> perm;
+      boost::dynamic_bitset<> phase;
+      hex = tt_to_hex( npn.compute( spec, phase, perm ) );
+    }
+    else
+    {
+      hex = tt_to_hex( spec );
+    }
+
+    if ( !visited.insert( hex ).second ) { continue; }
+
+    if ( !find_entry( hex ) )
+    {
+      missing.push_back( hex );
+    }
+  }
+
+  if ( missing.empty() ) { return 0u; }
+
+  /* larger functions first, they are the most expensive ones */
+  std::stable_sort( missing.begin(), missing.end(), []( const std::string& a, const std::string& b ) { return a.size() > b.size(); } );
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] %d distinct functions, %d missing in library" ) % visited.size() % missing.size() << std::endl;
+  }
+
+  /* each call creates its own solver instance; entries are inserted as soon
+     as they are found, so that they are kept in the auto update file even if
+     a later computation fails */
+  work_stealing_pool pool( num_threads );
+  pool.parallel_for( 0u, missing.size(), [this, &missing]( std::size_t i, unsigned ) {
+      insert_entry( missing[i], synthesize_entry( missing[i], false ) );
+    } );
+
+  return missing.size();
+}
+
+xmg_function xmg_minlib_manager::rewrite_inplace( const tt& spec,
+                                                  xmg_graph& dest,
+                                                  const std::vector<xmg_function>& pi_mapping,
+                                                  bool use_npn )
+{
+  if ( !use_npn )
+  {
+    return xmg_minlib_instantiate( find_or_create_xmg( tt_to_hex( spec ) ), dest, pi_mapping );
+  }
+
+  const auto numvars = tt_num_vars( spec );
+
+  std::vector<unsigned> perm;
+  boost::dynamic_bitset<> phase;
+  const auto npn_spec = npn.compute( spec, phase, perm );
+
+  std::vector<xmg_function> pis;
+  for ( auto i = 0u; i < numvars; ++i )
+  {
+    pis.push_back( pi_mapping[perm[i]] ^ phase[perm[i]] );
+  }
+
+  return xmg_minlib_instantiate( find_or_create_xmg( tt_to_hex( npn_spec ) ), dest, pis ) ^ phase[numvars];
+}
+
 void xmg_minlib_manager::add_to_library( const xmg_graph& xmg )
 {
   auto sim_res = simulate_xmg( xmg, xmg_tt_simulator() ).at( xmg.outputs().front().first );
@@ -298,24 +887,25 @@ void xmg_minlib_manager::add_to_library( const xmg_graph& xmg )
     tt_shrink( sim_res, xmg.inputs().size() );
   }
 
-  /* compute expression from XMG and add it to the library */
-  const auto expr = xmg_to_expression( xmg, xmg.outputs().front().first );
-  const auto str = expression_to_string( expr );
-
-  add_to_library( tt_to_hex( sim_res ), str );
+  /* compute library entry from XMG and add it to the library */
+  const auto hex = tt_to_hex( sim_res );
+  library[hex].push_back( xmg_minlib_entry_from_expression( xmg_to_expression( xmg, xmg.outputs().front().first ), xmg_minlib_num_vars( hex ) ) );
 }
 
 bool xmg_minlib_manager::verify()
 {
   auto okay = true;
 
+  load_all_entries();
+
   for ( const auto& p : library )
   {
     tt spec( convert_hex2bin( p.first ) );
 
-    for ( const auto& circ : p.second )
+    for ( const auto& entry : p.second )
     {
-      tt spec_expr = tt_from_expression( parse_expression( circ ) );
+      const auto expr = xmg_minlib_entry_to_expression( entry );
+      tt spec_expr = tt_from_expression( expr );
 
       tt_align( spec, spec_expr );
 
@@ -323,7 +913,7 @@ bool xmg_minlib_manager::verify()
       {
         if ( verbose )
         {
-          std::cout << "[w] spec " << spec << " does not match with " << circ << std::endl;
+          std::cout << "[w] spec " << spec << " does not match with " << expression_to_string( expr ) << std::endl;
         }
         okay = false;
       }
@@ -337,6 +927,10 @@ void xmg_minlib_manager::print_statistics( std::ostream& os )
   os << "[i] circuit library:" << std::endl;
 
   os << boost::format( "[i] %d entries" ) % library.size() << std::endl;
+  if ( binary )
+  {
+    os << boost::format( "[i] %d entries in binary library" ) % binary_num_sorted << std::endl;
+  }
 
   npn.print_statistics( os );
 }
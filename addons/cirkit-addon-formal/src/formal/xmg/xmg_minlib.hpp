@@ -38,6 +38,8 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -45,13 +47,35 @@
 #include <boost/optional.hpp>
 
 #include <core/properties.hpp>
+#include <core/utils/mapped_file.hpp>
 #include <classical/utils/npn_manager.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_exact_sat.hpp>
 
 namespace cirkit
 {
 
+/* XMG structure of a library entry, which can be instantiated without
+   parsing an expression; node 0 is the constant, nodes 1 to num_vars are the
+   inputs and gates follow in topological order; a literal is 2 * node + c
+   where c is 1 for a complemented edge */
+struct xmg_minlib_entry
+{
+  unsigned              num_vars = 0u;
+  unsigned              output   = 0u;
+  std::vector<unsigned> gates;  /* four words per gate: type (0: MAJ, 1: XOR) and three fanin literals (0 for the third one of an XOR) */
+
+  inline unsigned num_gates() const { return gates.size() / 4u; }
+};
+
+/* Libraries can be stored as text (one `0x<hex> <expression>` line per entry)
+ * or in binary form.  Binary libraries are memory mapped, and entries of the
+ * sorted part are only decoded when they are looked up.  New entries are
+ * appended to the end of the file if auto_update is set.  See xmg_minlib.cpp
+ * for the binary format.  load_library_file detects the format from the
+ * file contents; write_library_file writes binary if the filename ends with
+ * `.bin`. */
 class xmg_minlib_manager
 {
 public:
@@ -64,9 +88,19 @@ public:
 
   xmg_graph find_xmg( const tt& spec );
   xmg_graph find_xmg_no_npn( const tt& spec );
+
+  /* makes sure that the library contains entries for all specs (or their NPN
+     classes if use_npn is true); every missing entry is computed only once
+     and missing entries are computed concurrently, each with its own solver
+     and timeout; returns the number of new entries */
+  unsigned prepare( const std::vector<tt>& specs, bool use_npn = true, unsigned num_threads = 0u );
+
+  /* instantiates the optimum XMG for spec in dest, inputs of spec are mapped
+     to pi_mapping */
   xmg_function rewrite_inplace( const tt& spec,
                                 xmg_graph& dest,
-                                const std::vector<xmg_function>& pi_mapping );
+                                const std::vector<xmg_function>& pi_mapping,
+                                bool use_npn = true );
 
   void add_to_library( const xmg_graph& xmg );
   bool verify();
@@ -75,19 +109,35 @@ public:
 
 private:
   void load_library( std::istream& in );
+  void load_binary_library( const std::string& filename );
+  void load_all_entries();
+  void write_binary_library_file( const std::string& filename, unsigned minsize );
   void add_to_library( const std::string& hex, const std::string& expr );
   std::string format_library_entry( const std::string& hex, const std::string& expr );
 
-  std::string find_or_create_xmg( const std::string& hex );
+  const xmg_minlib_entry* find_entry( const std::string& hex );
+  const xmg_minlib_entry& find_or_create_xmg( const std::string& hex );
+  xmg_minlib_entry synthesize_entry( const std::string& hex, bool exact_verbose ) const;
+  void insert_entry( const std::string& hex, const xmg_minlib_entry& entry );
 
 private:
-  std::unordered_map<std::string, std::vector<std::string>> library;
-  npn_manager                                               npn;
-  boost::optional<unsigned>                                 timeout;
-  bool                                                      verbose;
+  std::unordered_map<std::string, std::vector<xmg_minlib_entry>> library;
+  npn_manager                                                    npn;
+  boost::optional<unsigned>                                      timeout;
+  std::string                                                    engine = "z3";
+  unsigned                                                       portfolio = 1u;
+  xmg_exact_bounds::ptr                                          bounds;
+  bool                                                           verbose = false;
+
+  /* sorted part of a binary library, entries are decoded on demand */
+  std::unique_ptr<mapped_file> binary;
+  const char*                  binary_index      = nullptr;
+  unsigned                     binary_num_sorted = 0u;
 
   bool auto_update = false;
+  bool update_binary = false;
   std::ofstream update_out;
+  std::mutex update_mutex;
 
 public: /* libraries */
   static std::string npn2_s;
@@ -0,0 +1,136 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_from_lut
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/lut/lut_graph.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_simulate.hpp>
+#include <formal/xmg/xmg_from_lut.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* 5-input LUTs are not covered by the built-in libraries; AND5 and MAJ5,
+   each also with one complemented input, hence two NPN classes */
+const std::vector<std::string> luts = {"80000000", "40000000", "fee8e880", "fdd4d440"};
+
+lut_graph create_lut_graph()
+{
+  lut_graph lut;
+
+  std::vector<lut_graph::node_t> pis;
+  for ( auto i = 0u; i < 5u; ++i )
+  {
+    pis.push_back( lut.create_pi( std::string( 1, 'a' + i ) ) );
+  }
+
+  for ( auto i = 0u; i < luts.size(); ++i )
+  {
+    lut.create_po( lut.create_lut( luts[i], pis ), "f" + std::to_string( i ) );
+  }
+  /* the same truth table as the first LUT */
+  lut.create_po( lut.create_lut( luts[0u], {pis[4u], pis[3u], pis[2u], pis[1u], pis[0u]} ), "f" + std::to_string( luts.size() ) );
+
+  return lut;
+}
+
+xmg_graph map( const lut_graph& lut, unsigned num_threads, unsigned& num_synthesized )
+{
+  auto settings = std::make_shared<properties>();
+  auto statistics = std::make_shared<properties>();
+
+  /* the MIG libraries are used, as the XMG libraries are updated from
+     $CIRKIT_HOME */
+  settings->set( "noxor", true );
+  settings->set( "num_threads", num_threads );
+
+  const auto xmg = xmg_from_lut_mapping( lut.graph(), settings, statistics );
+  num_synthesized = statistics->get<unsigned>( "num_synthesized" );
+  return xmg;
+}
+
+std::vector<std::string> simulate( const xmg_graph& xmg )
+{
+  const auto sim = simulate_xmg( xmg, xmg_tt_simulator() );
+
+  std::vector<std::string> result;
+  for ( const auto& o : xmg.outputs() )
+  {
+    auto f = sim.at( o.first );
+    tt_shrink( f, xmg.inputs().size() );
+    result.push_back( tt_to_hex( f ) );
+  }
+  return result;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( num_synthesized )
+{
+  const auto lut = create_lut_graph();
+
+  unsigned num_synthesized;
+  const auto xmg = map( lut, 1u, num_synthesized );
+  BOOST_CHECK_EQUAL( num_synthesized, 2u );
+
+  auto expected = luts;
+  expected.push_back( luts[0u] );
+  const auto result = simulate( xmg );
+  BOOST_CHECK_EQUAL_COLLECTIONS( result.begin(), result.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( parallel_matches_sequential )
+{
+  const auto lut = create_lut_graph();
+
+  unsigned num_seq, num_par;
+  const auto xmg_seq = map( lut, 1u, num_seq );
+  const auto xmg_par = map( lut, 4u, num_par );
+
+  BOOST_CHECK_EQUAL( num_par, num_seq );
+  BOOST_CHECK_EQUAL( xmg_par.num_gates(), xmg_seq.num_gates() );
+
+  const auto result_seq = simulate( xmg_seq );
+  const auto result_par = simulate( xmg_par );
+  BOOST_CHECK_EQUAL_COLLECTIONS( result_par.begin(), result_par.end(), result_seq.begin(), result_seq.end() );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,336 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_minlib
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/utils/conversion_utils.hpp>
+#include <core/utils/string_utils.hpp>
+#include <classical/functions/npn_canonization.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_simulate.hpp>
+#include <formal/xmg/xmg_minlib.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* sizes of the binary format, see xmg_minlib.cpp */
+constexpr std::size_t header_size      = 16u;
+constexpr std::size_t index_entry_size = 16u;
+
+struct temporary_file
+{
+  temporary_file( const std::string& extension = ".bin" )
+    : path( ( boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "xmg_minlib-%%%%-%%%%" + extension ) ).string() )
+  {
+  }
+
+  ~temporary_file()
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove( path, ec );
+    boost::filesystem::remove( path + ".tmp", ec );
+  }
+
+  std::string path;
+};
+
+std::string read_file( const std::string& filename )
+{
+  std::ifstream in( filename.c_str(), std::ifstream::in | std::ifstream::binary );
+  return std::string( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+}
+
+void write_file( const std::string& filename, const std::string& contents )
+{
+  std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+  os.write( contents.data(), contents.size() );
+}
+
+template<typename T>
+void append_word( std::string& buffer, T value )
+{
+  buffer.append( reinterpret_cast<const char*>( &value ), sizeof( value ) );
+}
+
+uint32_t word_at( const std::string& buffer, std::size_t pos )
+{
+  uint32_t value;
+  std::memcpy( &value, &buffer[pos], sizeof( value ) );
+  return value;
+}
+
+void set_word_at( std::string& buffer, std::size_t pos, uint32_t value )
+{
+  std::memcpy( &buffer[pos], &value, sizeof( value ) );
+}
+
+/* hex strings of all entries in a text library */
+std::vector<std::string> library_keys( const std::string& library )
+{
+  std::vector<std::string> keys;
+  foreach_string( library, "\n", [&keys]( const std::string& line ) {
+      auto l = boost::trim_copy( line );
+      keys.push_back( l.substr( 2u, l.find( ' ' ) - 2u ) );
+    } );
+  return keys;
+}
+
+std::string simulate_hex( const xmg_graph& xmg, unsigned num_vars )
+{
+  auto result = simulate_xmg( xmg, xmg_tt_simulator() ).at( xmg.outputs().front().first );
+  tt_shrink( result, num_vars );
+  return tt_to_hex( result );
+}
+
+void check_lookup( xmg_minlib_manager& mgr, const std::string& hex )
+{
+  const tt spec( convert_hex2bin( hex ) );
+  BOOST_CHECK_EQUAL( simulate_hex( mgr.find_xmg_no_npn( spec ), tt_num_vars( spec ) ), hex );
+}
+
+/* a text library and its binary version */
+void write_binary_library( const std::string& filename )
+{
+  xmg_minlib_manager mgr;
+  mgr.load_library_string( xmg_minlib_manager::npn3_s );
+  mgr.load_library_string( xmg_minlib_manager::npn4_s );
+  mgr.write_library_file( filename, 0u );
+}
+
+/* all 3-variable functions that depend on all variables */
+std::vector<tt> full_support_functions3()
+{
+  std::vector<tt> specs;
+  for ( auto f = 0u; f < 256u; ++f )
+  {
+    const tt spec( 8u, f );
+    if ( tt_support_size( spec ) == 3u )
+    {
+      specs.push_back( spec );
+    }
+  }
+  return specs;
+}
+
+std::set<std::string> npn_classes( const std::vector<tt>& specs )
+{
+  std::set<std::string> classes;
+  for ( const auto& spec : specs )
+  {
+    boost::dynamic_bitset<> phase;
+    std::vector<unsigned> perm;
+    classes.insert( tt_to_hex( exact_npn_canonization( spec, phase, perm ) ) );
+  }
+  return classes;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( binary_round_trip )
+{
+  temporary_file file;
+  write_binary_library( file.path );
+
+  const auto contents = read_file( file.path );
+  BOOST_REQUIRE_GE( contents.size(), header_size );
+  const auto keys3 = library_keys( xmg_minlib_manager::npn3_s );
+  const auto keys4 = library_keys( xmg_minlib_manager::npn4_s );
+  BOOST_CHECK_EQUAL( word_at( contents, 8u ), keys3.size() + keys4.size() );
+  BOOST_CHECK_EQUAL( word_at( contents, 12u ), contents.size() );
+
+  /* every entry is looked up in the sorted part, instantiated, and simulated */
+  xmg_minlib_manager mgr;
+  mgr.load_library_file( file.path );
+  for ( const auto& keys : {keys3, keys4} )
+  {
+    for ( const auto& hex : keys )
+    {
+      check_lookup( mgr, hex );
+    }
+  }
+  BOOST_CHECK( mgr.verify() );
+}
+
+BOOST_AUTO_TEST_CASE( binary_appended_records )
+{
+  temporary_file file;
+  write_binary_library( file.path );
+  auto contents = read_file( file.path );
+
+  /* XOR of two variables: node 3 = [ab], output literal 6 */
+  append_word<uint64_t>( contents, 0x6 );
+  for ( auto w : {2u, 1u, 6u, 1u, 2u, 4u, 0u} )
+  {
+    append_word<uint32_t>( contents, w );
+  }
+
+  /* a record that claims one gate, whose gate words are missing */
+  append_word<uint64_t>( contents, 0x8 );
+  for ( auto w : {2u, 1u, 6u, 0u, 2u} )
+  {
+    append_word<uint32_t>( contents, w );
+  }
+  write_file( file.path, contents );
+
+  xmg_minlib_manager mgr;
+  BOOST_REQUIRE_NO_THROW( mgr.load_library_file( file.path ) );
+  check_lookup( mgr, "6" );
+  check_lookup( mgr, "69" );
+  check_lookup( mgr, "3cc3" );
+  BOOST_CHECK( mgr.verify() );
+
+  /* a record cut off within its header is ignored as well */
+  contents.resize( contents.size() - 10u );
+  write_file( file.path, contents );
+
+  xmg_minlib_manager mgr2;
+  BOOST_REQUIRE_NO_THROW( mgr2.load_library_file( file.path ) );
+  check_lookup( mgr2, "6" );
+}
+
+BOOST_AUTO_TEST_CASE( binary_corrupt_offsets )
+{
+  temporary_file file;
+  write_binary_library( file.path );
+  const auto contents = read_file( file.path );
+
+  /* offset of the first record in the index points behind the file */
+  {
+    auto corrupt = contents;
+    uint64_t bits;
+    std::memcpy( &bits, &corrupt[header_size], sizeof( bits ) );
+    const auto num_vars = word_at( corrupt, header_size + 8u );
+    set_word_at( corrupt, header_size + 12u, corrupt.size() + 64u );
+    write_file( file.path, corrupt );
+
+    xmg_minlib_manager mgr;
+    mgr.load_library_file( file.path );
+
+    std::string hex( 1u << ( num_vars - 2u ), '0' );
+    for ( auto i = 0u; i < hex.size(); ++i )
+    {
+      hex[hex.size() - 1u - i] = "0123456789abcdef"[( bits >> ( 4u * i ) ) & 0xf];
+    }
+    BOOST_CHECK_THROW( mgr.find_xmg_no_npn( tt( convert_hex2bin( hex ) ) ), const char* );
+
+    /* other entries are still accessible */
+    check_lookup( mgr, "3cc3" );
+  }
+
+  /* offset of a record points into the index */
+  {
+    auto corrupt = contents;
+    for ( auto i = 0u; i < word_at( corrupt, 8u ); ++i )
+    {
+      set_word_at( corrupt, header_size + i * index_entry_size + 12u, header_size );
+    }
+    write_file( file.path, corrupt );
+
+    xmg_minlib_manager mgr;
+    mgr.load_library_file( file.path );
+    BOOST_CHECK_THROW( mgr.find_xmg_no_npn( tt( convert_hex2bin( "3cc3" ) ) ), const char* );
+  }
+
+  /* offset of the appended records points behind the file */
+  {
+    auto corrupt = contents;
+    set_word_at( corrupt, 12u, corrupt.size() + 1u );
+    write_file( file.path, corrupt );
+
+    xmg_minlib_manager mgr;
+    BOOST_CHECK_THROW( mgr.load_library_file( file.path ), const char* );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( prepare_synthesizes_each_class_once )
+{
+  const auto specs = full_support_functions3();
+  const auto classes = npn_classes( specs );
+
+  /* new entries are appended to a text library */
+  temporary_file file( ".txt" );
+
+  {
+    xmg_minlib_manager mgr;
+    mgr.load_library_file( file.path, true );
+
+    BOOST_CHECK_EQUAL( mgr.prepare( specs, true, 4u ), classes.size() );
+    BOOST_CHECK_EQUAL( mgr.prepare( specs, true, 4u ), 0u );
+
+    for ( const auto& spec : specs )
+    {
+      BOOST_CHECK_EQUAL( simulate_hex( mgr.find_xmg( spec ), 3u ), tt_to_hex( spec ) );
+    }
+  }
+
+  const auto keys = library_keys( read_file( file.path ) );
+  BOOST_CHECK_EQUAL( keys.size(), classes.size() );
+  BOOST_CHECK( std::set<std::string>( keys.begin(), keys.end() ) == classes );
+}
+
+BOOST_AUTO_TEST_CASE( prepare_parallel_matches_sequential )
+{
+  const auto specs = full_support_functions3();
+
+  for ( auto use_npn : {true, false} )
+  {
+    xmg_minlib_manager seq, par;
+    const auto num_seq = seq.prepare( specs, use_npn, 1u );
+    BOOST_CHECK_EQUAL( par.prepare( specs, use_npn, 4u ), num_seq );
+    BOOST_CHECK_EQUAL( num_seq, use_npn ? npn_classes( specs ).size() : specs.size() );
+
+    for ( const auto& spec : specs )
+    {
+      const auto xmg_seq = use_npn ? seq.find_xmg( spec ) : seq.find_xmg_no_npn( spec );
+      const auto xmg_par = use_npn ? par.find_xmg( spec ) : par.find_xmg_no_npn( spec );
+
+      BOOST_CHECK_EQUAL( xmg_par.num_gates(), xmg_seq.num_gates() );
+      BOOST_CHECK_EQUAL( simulate_hex( xmg_par, 3u ), tt_to_hex( spec ) );
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -69,7 +69,7 @@ esopbs_command::esopbs_command( const environment::ptr& env )
     ( "aig,a",                        "read from AIG" )
     ( "exorcism,e",                   "use exorcism to optimize ESOP cover (only for --aig)" )
     ( "progress,p",                   "show progress" )
-    ( "experimental",                 "experimental method for single-output AIGs" )
+    ( "experimental",                 "experimental method for single-output AIGs (up to 256 inputs)" )
     ;
   add_new_option();
   be_verbose();
@@ -79,7 +79,10 @@ command::rules_t esopbs_command::validity_rules() const
 {
   return {
     file_exists_if_set( *this, filename, "filename" ),
-    has_store_element_if_set<aig_graph>( *this, env, "aig" )
+    has_store_element_if_set<aig_graph>( *this, env, "aig" ),
+    has_store_element_if_set<aig_graph>( *this, env, "experimental" ),
+    {[this]() { return !( is_set( "aig" ) || is_set( "experimental" ) ) || aig_info( env->store<aig_graph>().current() ).inputs.size() <= 256u; },
+     "ESOP extraction supports at most 256 inputs"}
   };
 }
 
@@ -122,11 +125,13 @@ bool esopbs_command::execute()
     const auto& aigs = env->store<aig_graph>();
 
     gia_graph gia( aigs.current() );
-    const auto cubes = gia_extract_cover2( gia, settings );
-    const auto cubes_opt = exorcism2( cubes, gia.num_inputs(), settings, statistics );
-    print_runtime( "runtime", "exorcism" );
+    with_cube_type( gia.num_inputs(), [this, &circuits, &gia, &settings]( auto tag ) {
+        const auto cubes = gia_extract_cover2<decltype( tag )>( gia, settings );
+        const auto cubes_opt = exorcism2( cubes, gia.num_inputs(), settings, statistics );
+        print_runtime( "runtime", "exorcism" );
 
-    esop_synthesis( circuits.current(), cubes_opt, gia.num_inputs(), settings, statistics );
+        esop_synthesis( circuits.current(), cubes_opt, gia.num_inputs(), settings, statistics );
+      } );
 
     print_runtime();
   }
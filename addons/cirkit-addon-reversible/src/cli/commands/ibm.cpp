@@ -48,6 +48,7 @@
 #include <reversible/functions/remove_dup_gates.hpp>
 #include <reversible/functions/ibm_helper.hpp>
 #include <reversible/io/write_qc.hpp>
+#include <reversible/mapping/coupling_graph.hpp>
 #include <reversible/io/print_circuit.hpp>
 #include <reversible/variable.hpp>
 #include <cli/commands/ibm.hpp>
@@ -59,6 +60,8 @@
 namespace cirkit
 {
 
+using boost::program_options::value;
+
 /******************************************************************************
  * Types                                                                      *
  ******************************************************************************/
@@ -80,6 +83,9 @@ ibm_command::ibm_command( const environment::ptr& env )
     ( "ibm_qx4,4", "The IBM Qx4 is the target")
     ( "verbose,v",  "verbose" )
     ( "swap,s", "use swap based instead of template transformations")
+    ( "coupling_graph,g", value( &filename ), "route onto coupling graph from file\n(number of qubits, followed by pairs of control and target)" )
+    ( "arch", value( &arch ), "route onto IBM architecture: qx2, qx4, or qx5" )
+    ( "threads", value_with_default( &threads ), "number of threads for placement search with -g or --arch (0: all cores)" )
     // ( "toffoli", value_with_default(&type), "transform Toffoli")
     ;
   add_new_option();
@@ -100,6 +106,29 @@ bool ibm_command::execute()
     auto& circuits = env->store<circuit>();
     circuit circ_working = circuits.current();
     circuit circ_IBM;
+
+    if ( is_set( "coupling_graph" ) || is_set( "arch" ) )
+    {
+        const auto graph = is_set( "coupling_graph" ) ? read_coupling_graph( filename ) : coupling_graph_from_architecture( arch );
+
+        auto settings = make_settings();
+        settings->set( "num_threads", threads );
+        circ_IBM = coupling_graph_mapping( circ_working, graph, std::vector<unsigned>(), settings, statistics );
+
+        if ( is_set( "rm_dup" ) )
+        {
+            circ_IBM = remove_dup_gates( circ_IBM );
+        }
+        if ( is_set( "new" ) )
+        {
+            circuits.extend();
+        }
+        circuits.current() = circ_IBM;
+
+        std::cout << "[i] estimated additional gates = " << statistics->get<unsigned>( "cost" ) << std::endl;
+        std::cout << "gates = " << circ_IBM.num_gates() << std::endl;
+        return true;
+    }
     // std::cout << " igates: " << circ_working.num_gates();
     unsigned start = circ_working.lines()+1;
     for(unsigned i = start ; i <= 5u; i++)
@@ -56,6 +56,9 @@ public:
   log_opt_t log() const;
 private:
 	// unsigned int type = 1;
+  std::string filename;
+  std::string arch = "qx2";
+  unsigned    threads = 0u;
 
 };
 
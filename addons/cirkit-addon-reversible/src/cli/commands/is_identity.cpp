@@ -26,17 +26,28 @@
 
 #include "is_identity.hpp"
 
+#include <boost/format.hpp>
+
 #include <alice/rules.hpp>
 
+#include <core/utils/program_options.hpp>
 #include <cli/reversible_stores.hpp>
 #include <reversible/functions/is_identity.hpp>
 
 namespace cirkit
 {
 
+using boost::program_options::value;
+
 is_identity_command::is_identity_command( const environment::ptr& env )
   : cirkit_command( env, "Check whether circuit computes identity" )
 {
+  opts.add_options()
+    ( "timeout,t",        value( &timeout ),                     "time limit in seconds" )
+    ( "sim_words",        value_with_default( &sim_words ),      "number of 64-bit words of random simulation patterns" )
+    ( "exhaustive_limit", value_with_default( &exhaustive_limit ), "simulate exhaustively up to this number of lines" )
+    ;
+  be_verbose();
 }
 
 command::rules_t is_identity_command::validity_rules() const
@@ -49,7 +60,22 @@ bool is_identity_command::execute()
 {
   const auto& circuits = env->store<circuit>();
 
-  if ( is_identity( circuits.current() ) )
+  auto settings = make_settings();
+  settings->set( "sim_words", sim_words );
+  settings->set( "exhaustive_limit", exhaustive_limit );
+  if ( is_set( "timeout" ) )
+  {
+    settings->set( "timeout", boost::optional<unsigned>( timeout ) );
+  }
+
+  const auto result = is_identity( circuits.current(), settings, statistics );
+  const auto decided_by = statistics->get<std::string>( "decided_by" );
+
+  if ( decided_by == "timeout" )
+  {
+    std::cout << "[w] timeout" << std::endl;
+  }
+  else if ( result )
   {
     std::cout << "[i] circuit represents the identity function" << std::endl;
   }
@@ -58,9 +84,23 @@ bool is_identity_command::execute()
     std::cout << "[i] circuit does not represent the identity function" << std::endl;
   }
 
+  if ( decided_by != "timeout" )
+  {
+    std::cout << "[i] decided by: " << decided_by << std::endl;
+  }
+  print_runtime();
+
   return true;
 }
 
+command::log_opt_t is_identity_command::log() const
+{
+  return log_opt_t({
+      {"runtime", statistics->get<double>( "runtime" )},
+      {"decided_by", statistics->get<std::string>( "decided_by" )}
+    });
+}
+
 }
 
 // Local Variables:
@@ -49,6 +49,14 @@ public:
 protected:
   rules_t validity_rules() const;
   bool execute();
+
+public:
+  log_opt_t log() const;
+
+private:
+  unsigned timeout          = 0u;
+  unsigned sim_words        = 16u;
+  unsigned exhaustive_limit = 16u;
 };
 
 }
@@ -26,6 +26,7 @@
 
 #include "rules.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 #include <reversible/circuit.hpp>
@@ -124,14 +125,15 @@ void swap_gates( circuit::const_iterator itGate, circuit::const_iterator nextGat
 
 void apply_rule_Rfive( gate& ga, gate& gb )
 {	
-	for( auto v = ga.controls().begin();  v != ga.controls().end(); ++v )
-		for( auto z = gb.controls().begin();  z != gb.controls().end(); ++z )
-			if( v->line() == z->line() && v->polarity() == z->polarity() )
-			{
-				ga.remove_control ( ga.controls().at( v - ga.controls().begin() ) );
-				gb.remove_control ( gb.controls().at( z - gb.controls().begin() ) );
-				--v; --z;
-			}
+	gate::control_container common;
+	for( const auto& v : ga.controls() )
+		if( std::find( gb.controls().begin(), gb.controls().end(), v ) != gb.controls().end() )
+			common.push_back( v );
+	for( const auto& v : common )
+	{
+		ga.remove_control ( v );
+		gb.remove_control ( v );
+	}
 }
 
 //Verifying if two adjacents gates are equal
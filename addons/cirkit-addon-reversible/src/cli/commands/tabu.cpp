@@ -26,32 +26,37 @@
 
 #include "tabu.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <time.h>
+#include <vector>
+#include <boost/range/iterator_range.hpp>
+#include <core/properties.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <alice/rules.hpp>
 #include <cli/reversible_stores.hpp>
 #include <reversible/circuit.hpp>
+#include <reversible/target_tags.hpp>
 #include <reversible/io/print_circuit.hpp>
-#include <reversible/functions/add_circuit.hpp>
-//#include <reversible/functions/add_gates.hpp>
 #include <reversible/functions/copy_circuit.hpp>
 #include <reversible/functions/clear_circuit.hpp>
-#include <reversible/functions/is_identity.hpp>
-#include <reversible/functions/reverse_circuit.hpp>
-
-//#include <reversible/pauli_tags.hpp>
-//#include <reversible/target_tags.hpp>
 
 #include <cli/commands/rules.hpp>
 #include <core/utils/program_options.hpp>
 
-
-typedef std::vector<std::vector<int>> matrix;
-
 namespace cirkit
 {
- 
+
+//Entry of the tabu list with its penalization
+struct tabu_entry
+{
+	int rule;
+	unsigned first;
+	unsigned second;
+	unsigned age;
+};
+
 tabu_command::tabu_command(const environment::ptr& env)
     : cirkit_command(env, "Tabu Search")
 {
@@ -62,6 +67,7 @@ tabu_command::tabu_command(const environment::ptr& env)
     ( "neighborhood,g",value_with_default(&neighborhood),	"Select the size of the neighborhood" )
     ( "optimization,t",value_with_default(&opt),				"Select the optimization. 0: gates (default), 1: quantum cost, 2: average of both" )
     ( "overlap,o",value_with_default(&overlap),			"Select the size of the overlap (%)" )
+    ( "threads",value_with_default(&threads),			"Select the number of threads to evaluate the neighborhood (0: all cores)" )
     ( "verbose,v",								"be verbose")
     ( "step,s",									"be verbose and step-by-step")
     ;
@@ -73,20 +79,6 @@ command::rules_t tabu_command::validity_rules() const
 	return {has_store_element<circuit>( env )};
 }
 
-//Any rule changed the truth table?
-bool changed_circuit(circuit circ)
-{
-	circuit aux;
-	reverse_circuit(circ, aux);
-	append_circuit(circ, aux);
-	if(!is_identity(circ))
-	{
-		std::cout << "Some rule changed the truth table of the circuit!" << std::endl;
-		return false;
-	}
-	return true;
-}
-
 int ncv_cost(unsigned int control)
 {
 	//Assuming negative control with the same cost
@@ -125,284 +117,69 @@ int t_depth(unsigned int control)
 	}
 }
 
-unsigned int circuit_ncv_cost(circuit& circ)
+unsigned int circuit_ncv_cost(const circuit& circ)
 {
 	unsigned int cost = 0;
-	for (auto g : circ)
+	for (const auto& g : circ)
  		cost += ncv_cost(g.controls().size());
  	return cost;
 }
 
-void list_rules( circuit circ, std::vector<std::vector<int>>& x, unsigned begin, unsigned end, bool verbose )
-{
-	for( circuit::const_iterator itGate = circ.begin() + begin, nextGate = ++( circ.begin() + begin );  nextGate != circ.begin() + end; ++itGate, ++nextGate )
-	{
-		unsigned int itGateIndex = itGate - circ.begin();
-		unsigned int nextGateIndex = nextGate - circ.begin();
-		int gaNCVCost, gbNCVCost, gaTdepth, gbTdepth; //Quantum cost of the gates
-		unsigned int gaControls, gbControls; //Controls of the gates
-
-		gate ga, gb;
-		
-		std::sort( itGate->controls().begin(), itGate->controls().end() );
-		std::sort( nextGate->controls().begin(), nextGate->controls().end() );
-		
-		ga.controls() = itGate->controls();
-		gb.controls() = nextGate->controls();
-		ga.targets() = itGate->targets();
-		gb.targets() = nextGate->targets();
-
-		gaControls = ga.controls().size();
-		gbControls = gb.controls().size();
-
-		gaNCVCost = ncv_cost(ga.controls().size());
-		gbNCVCost = ncv_cost(gb.controls().size());
-		gaTdepth = t_depth(ga.controls().size());
-		gbTdepth = t_depth(gb.controls().size());
-
-		if( verify_rule_Done( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D1] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be removed.\t\tCost=-2;\t\tQCost:" << -1*(gaNCVCost + gbNCVCost) << std::endl;
-			v.push_back(1);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(-2);
-			v.push_back(-1*(gaNCVCost + gbNCVCost));
-			x.push_back( v );
-		}
-	
-		apply_rule_Rfive( ga, gb );
-
-		if( verify_rule_Dtwo( ga, gb ) ) 
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[R5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
-			v.push_back(2);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(0);
-			x.push_back( v );
-		}
-
-		if( verify_rule_Dthree( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D3] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*(gaNCVCost-1) << std::endl;
-			v.push_back(3);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(-1);
-			v.push_back(-1*(gaNCVCost-1));
-			x.push_back( v );
-		}
-		
-		if( verify_rule_Dfour( ga, gb ) )
-		{
-			std::vector<int> v;
-			// if(verbose)
-			// 	std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost" << std::endl;
-			v.push_back(14);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(-1);
-			if(gaControls > gbControls)
-			{
-				v.push_back(-1*gaNCVCost);
-				if(verbose)
-					std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*gaNCVCost << std::endl;
-			}
-			else
-			{
-				if(verbose)
-					std::cout  << "[D4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be merged.\t\t\t--Cost;\t\tQCost:" << -1*gbNCVCost << std::endl;
-				v.push_back(-1*gbNCVCost);
-			}
-			x.push_back( v );
-		}
-
-		if( verify_rule_Rfour( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[R4] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
-			v.push_back(4);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(0);
-			x.push_back( v );
-		}
-		
-		if( verify_rule_Dfive( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can insert controls.\t\tNo cost change;\tQCost:" << ncv_cost(gaControls+1) + ncv_cost(gbControls+1) << std::endl;
-			v.push_back(5);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(ncv_cost(gaControls+1) + ncv_cost(gbControls+1));
-			x.push_back( v );
-		}
-		
-		if( verify_rule_Dfivee( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D5] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can remove controls.\t\tNo cost change;\tQCost:" << -1*(ncv_cost(gaControls+1) + ncv_cost(gbControls+1)) <<std::endl;
-			v.push_back(-5);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(-1*(ncv_cost(gaControls+1) + ncv_cost(gbControls+1)));
-			x.push_back( v );
-		}
-
-		if( verify_rule_Dsix( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D6] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\tNo cost change;" << std::endl;
-			v.push_back(6);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(0);
-			v.push_back(0);
-			x.push_back( v );
-		}
-
-		if( verify_rule_Dseven( ga, gb ) )
-		{
-			std::vector<int> v;
-			if(verbose)
-				std::cout  << "[D7] Gates ( " << itGateIndex << " - " << itGateIndex + 1 << " ) can be interchanged.\t\t++Cost;\t\tQCost:" << ncv_cost(gaControls + gbControls) << std::endl;
-			v.push_back(7);
-			v.push_back(itGateIndex);
-			v.push_back(nextGateIndex);
-			v.push_back(1);
-			v.push_back(ncv_cost(gaControls + gbControls));
-			x.push_back( v );
-		}
-	}
-
-}
-
-void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y )
+//Name of the rule as printed in verbose mode
+std::string rule_name(int rule)
 {
-	circuit::const_iterator itGate = circ.begin(), nextGate = circ.begin();
-	switch( x[y][0] )
-	{
+	switch(rule){
 		case 1:
-			apply_rule_Done( circ, x[y][1], x[y][2] );
-			break;
+			return "D1";
 		case 2:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			apply_rule_Dtwo( itGate, nextGate );
-			break;
+			return "D2";
 		case 3:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			apply_rule_Dthree( circ, itGate, nextGate );
-			break;
+			return "D3";
 		case 4:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			swap_gates( itGate, nextGate );
-			break;
+		case 6:
+			return "swap";
 		case 5:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			apply_rule_Dfive( itGate, nextGate );
-			break;
+			return "D5";
 		case -5:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			apply_rule_Dfivee( itGate, nextGate );
-			break;
-		case 6:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			swap_gates( itGate, nextGate );
-			break;
+			return "D5.1";
 		case 7:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			apply_rule_Dseven( circ, itGate, nextGate );
-			break;
+			return "D7";
 		case 14:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			apply_rule_Dfour( circ, itGate, nextGate );
-			break;
+			return "D4";
 		default:
-			std::cout << "Something got wrong!" << std::endl;
-			break;
+			return "?";
 	}
 }
 
-void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y, bool verbose )
+void apply_rule( circuit& circ, int rule, unsigned first, unsigned second )
 {
-	circuit::const_iterator itGate = circ.begin(), nextGate = circ.begin();
-	switch( x[y][0] )
+	circuit::const_iterator itGate = circ.begin() + first, nextGate = circ.begin() + second;
+	switch( rule )
 	{
 		case 1:
-			apply_rule_Done( circ, x[y][1], x[y][2] );
-			std::cout << "Rule D1 applied " << x[y][1] << " " << x[y][2] << std::endl;
+			apply_rule_Done( circ, first, second );
 			break;
 		case 2:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
 			apply_rule_Dtwo( itGate, nextGate );
-			std::cout << "Rule D2 applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		case 3:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
 			apply_rule_Dthree( circ, itGate, nextGate );
-			std::cout << "Rule D3 applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		case 4:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
+		case 6:
 			swap_gates( itGate, nextGate );
-			std::cout << "Rule swap applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		case 5:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
 			apply_rule_Dfive( itGate, nextGate );
-			std::cout << "Rule D5 applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		case -5:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
 			apply_rule_Dfivee( itGate, nextGate );
-			std::cout << "Rule D5.1 applied " << x[y][1] << " " << x[y][2] << std::endl;
-			break;
-		case 6:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
-			swap_gates( itGate, nextGate );
-			std::cout << "Rule swap applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		case 7:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
 			apply_rule_Dseven( circ, itGate, nextGate );
-			std::cout << "Rule D7 applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		case 14:
-			std::advance( itGate, x[y][1] );
-			std::advance( nextGate, x[y][2] );
 			apply_rule_Dfour( circ, itGate, nextGate );
-			std::cout << "Rule D4 applied " << x[y][1] << " " << x[y][2] << std::endl;
 			break;
 		default:
 			std::cout << "Something got wrong!" << std::endl;
@@ -410,100 +187,261 @@ void apply_rule( circuit& circ, std::vector<std::vector<int>> x, unsigned y, boo
 	}
 }
 
-//Sort the vector of the rules
-void sortrows(matrix& x, int col)
-{    
-	std::sort(	x.begin(),
-	      		x.end(),
-	      		[col](const std::vector<int>& lhs, const std::vector<int>& rhs) {
-	          		return lhs[col] < rhs[col];
-	      });
-}
-
-//Print vector
-void print_list(matrix& x)
+//Simulates the gates in [first, last) on bit-parallel patterns; lines are the (sorted)
+//lines touched by the window, state holds num_words words for each of them and controls
+//in fixed are assumed to be active
+void simulate_window( circuit::const_iterator first, circuit::const_iterator last, const std::vector<unsigned>& lines,
+                      const std::vector<variable>& fixed, unsigned num_words, std::vector<std::uint64_t>& state )
 {
-	for(unsigned i = 0; i < x.size(); ++i)
+	const auto index = [&lines]( unsigned line ) {
+		return std::lower_bound( lines.begin(), lines.end(), line ) - lines.begin();
+	};
+
+	std::vector<std::uint64_t> cond( num_words );
+	for ( const auto& g : boost::make_iterator_range( first, last ) )
 	{
-		for(unsigned j = 0; j < x[i].size(); ++j)
-			std::cout << x[i][j] << " ";
-		std::cout << std::endl;
+		std::fill( cond.begin(), cond.end(), ~UINT64_C( 0 ) );
+		for ( const auto& c : g.controls() )
+		{
+			if ( std::find( fixed.begin(), fixed.end(), c ) != fixed.end() )
+				continue;
+			const auto* v = &state[index( c.line() ) * num_words];
+			for ( auto w = 0u; w < num_words; ++w )
+				cond[w] &= c.polarity() ? v[w] : ~v[w];
+		}
+		for ( const auto& t : g.targets() )
+		{
+			auto* v = &state[index( t ) * num_words];
+			for ( auto w = 0u; w < num_words; ++w )
+				v[w] ^= cond[w];
+		}
 	}
-
 }
 
-//Function to decide which rule must be applied
-void choosing_rule(circuit& circ, matrix x, matrix& tp, bool verbose)
+//Do the windows before and after a move compute the same function? Only the
+//lines touched by the windows are simulated.  Controls shared by every gate of
+//both windows are fixed to their active value (otherwise both windows are the
+//identity) and the remaining lines are enumerated exhaustively; windows with
+//more than 16 remaining lines are not accepted
+bool equivalent_windows( circuit::const_iterator before_first, circuit::const_iterator before_last,
+                         circuit::const_iterator after_first, circuit::const_iterator after_last )
 {
-	bool insert;
-	//std::cout << t.size() << std::endl;
-	for(unsigned k = 0; k < x.size(); ++k)
-	{
-		if(x[k][3] < 0)
+	static const std::uint64_t projections[] = {
+		UINT64_C( 0xaaaaaaaaaaaaaaaa ), UINT64_C( 0xcccccccccccccccc ), UINT64_C( 0xf0f0f0f0f0f0f0f0 ),
+		UINT64_C( 0xff00ff00ff00ff00 ), UINT64_C( 0xffff0000ffff0000 ), UINT64_C( 0xffffffff00000000 )};
+
+	const auto windows = {boost::make_iterator_range( before_first, before_last ), boost::make_iterator_range( after_first, after_last )};
+
+	//common controls (line and polarity) of all gates
+	std::vector<variable> fixed;
+	auto first_gate = true;
+	std::vector<unsigned> targets;
+	for ( const auto& window : windows )
+		for ( const auto& g : window )
 		{
-			apply_rule(circ, x, k, verbose);
-			break;
-		}
-		insert = true;
-		for(unsigned i = 0; i < tp.size(); ++i)
-		{
-			if(x[k][0] == tp[i][0] && x[k][1] == tp[i][1] && x[k][2] == tp[i][2])
+			if ( !is_toffoli( g ) )
+				return false;
+			if ( first_gate )
 			{
-				insert = false;
-				break;
+				fixed.assign( g.controls().begin(), g.controls().end() );
+				first_gate = false;
 			}
+			else
+			{
+				fixed.erase( std::remove_if( fixed.begin(), fixed.end(), [&g]( const variable& v ) {
+							return std::find( g.controls().begin(), g.controls().end(), v ) == g.controls().end();
+						} ), fixed.end() );
+			}
+			targets.insert( targets.end(), g.targets().begin(), g.targets().end() );
 		}
-		if(insert)
-		{
-			x[k][3] = 0;
-			tp.push_back( x[k] );
-			apply_rule( circ, x, k, verbose );
-			break;
-		}
+	fixed.erase( std::remove_if( fixed.begin(), fixed.end(), [&targets]( const variable& v ) {
+				return std::find( targets.begin(), targets.end(), v.line() ) != targets.end();
+			} ), fixed.end() );
+
+	//remaining lines
+	std::vector<unsigned> lines = targets;
+	for ( const auto& window : windows )
+		for ( const auto& g : window )
+			for ( const auto& c : g.controls() )
+				if ( std::find( fixed.begin(), fixed.end(), c ) == fixed.end() )
+					lines.push_back( c.line() );
+	std::sort( lines.begin(), lines.end() );
+	lines.erase( std::unique( lines.begin(), lines.end() ), lines.end() );
+
+	const unsigned k = lines.size();
+	if ( k > 16u )
+		return false;
+	const unsigned num_words = k <= 6u ? 1u : 1u << ( k - 6u );
+
+	std::vector<std::uint64_t> state( k * num_words );
+	for ( auto j = 0u; j < k; ++j )
+		for ( auto w = 0u; w < num_words; ++w )
+			state[j * num_words + w] = j < 6u ? projections[j] : ( ( ( w >> ( j - 6u ) ) & 1u ) ? ~UINT64_C( 0 ) : UINT64_C( 0 ) );
+
+	auto state_after = state;
+	simulate_window( before_first, before_last, lines, fixed, num_words, state );
+	simulate_window( after_first, after_last, lines, fixed, num_words, state_after );
+	return state == state_after;
+}
+
+//Applies the rule on a copy of the two affected gates in the scratch circuit window;
+//the move is kept if the window is unchanged functionally and its cost deltas are taken from it
+bool evaluate_move( const circuit& circ, tabu_move& move, circuit& window )
+{
+	const auto first = circ.begin() + move.first, last = circ.begin() + move.second + 1;
+
+	while( window.num_gates() )
+		window.remove_gate_at( window.num_gates() - 1 );
+	window.append_gate() = *first;
+	window.append_gate() = *( first + 1 );
+
+	apply_rule( window, move.rule, 0u, 1u );
+	if ( !equivalent_windows( first, last, window.begin(), window.end() ) )
+		return false;
+
+	move.delta_gates = int( window.num_gates() ) - 2;
+	move.delta_qcost = int( circuit_ncv_cost( window ) ) - ncv_cost( first->controls().size() ) - ncv_cost( ( first + 1 )->controls().size() );
+	return true;
+}
+
+//Rules that can be applied to the adjacent gates index and index + 1
+void list_pair_rules( const circuit& circ, unsigned index, std::vector<tabu_move>& x, unsigned& rejected, circuit& window )
+{
+	gate ga = *( circ.begin() + index ), gb = *( circ.begin() + index + 1 );
+	std::vector<int> rules;
+
+	if( verify_rule_Done( ga, gb ) )
+		rules.push_back( 1 );
+
+	apply_rule_Rfive( ga, gb );
+
+	if( verify_rule_Dtwo( ga, gb ) )
+		rules.push_back( 2 );
+	if( verify_rule_Dthree( ga, gb ) )
+		rules.push_back( 3 );
+	if( verify_rule_Dfour( ga, gb ) )
+		rules.push_back( 14 );
+	if( verify_rule_Rfour( ga, gb ) )
+		rules.push_back( 4 );
+	if( verify_rule_Dfive( ga, gb ) )
+		rules.push_back( 5 );
+	if( verify_rule_Dfivee( ga, gb ) )
+		rules.push_back( -5 );
+	if( verify_rule_Dsix( ga, gb ) )
+		rules.push_back( 6 );
+	if( verify_rule_Dseven( ga, gb ) )
+		rules.push_back( 7 );
+
+	for( auto rule : rules )
+	{
+		tabu_move move{rule, index, index + 1, 0, 0};
+		if( evaluate_move( circ, move, window ) )
+			x.push_back( move );
+		else
+			++rejected;
 	}
-	for(unsigned i = 0; i < tp.size(); ++i)
-		++tp[i][3];
 }
 
-//Function to decide which rule must be applied
-void choosing_rule(circuit& circ, matrix x, matrix& tp)
+//List the valid moves in [begin, end), the pairs are evaluated in parallel
+//with one scratch circuit per worker
+void list_rules( circuit& circ, std::vector<tabu_move>& x, unsigned begin, unsigned end, work_stealing_pool& pool, std::vector<circuit>& windows, unsigned& rejected, bool verbose )
 {
-	bool insert;
-	//std::cout << t.size() << std::endl;
-	for(unsigned k = 0; k < x.size(); ++k)
+	//the rules compare sorted controls
+	for( unsigned i = begin; i < end; ++i )
+		std::sort( ( circ.begin() + i )->controls().begin(), ( circ.begin() + i )->controls().end() );
+
+	const unsigned pairs = end > begin + 1 ? end - begin - 1 : 0;
+	std::vector<std::vector<tabu_move>> pair_moves( pairs );
+	std::vector<unsigned> pair_rejected( pairs, 0u );
+
+	pool.parallel_for( 0u, pairs, [&]( std::size_t i, unsigned worker ) {
+		list_pair_rules( circ, begin + i, pair_moves[i], pair_rejected[i], windows[worker] );
+	}, 16u );
+
+	for( unsigned i = 0; i < pairs; ++i )
 	{
-		if(x[k][3] < 0)
+		for( const auto& m : pair_moves[i] )
 		{
-			apply_rule(circ, x, k);
-			break;
+			if( verbose )
+				std::cout  << "[" << rule_name( m.rule ) << "] Gates ( " << m.first << " - " << m.second << " )\t\tCost: " << m.delta_gates << ";\t\tQCost: " << m.delta_qcost << std::endl;
+			x.push_back( m );
 		}
-		insert = true;
-		for(unsigned i = 0; i < tp.size(); ++i)
+		rejected += pair_rejected[i];
+	}
+}
+
+//Value of a move for the selected optimization
+int move_cost(const tabu_move& m, unsigned opt)
+{
+	switch(opt){
+		case 0:
+			return m.delta_gates;
+		case 1:
+			return m.delta_qcost;
+		default:
+			return m.delta_gates + m.delta_qcost;
+	}
+}
+
+//Sort the list of moves
+void sortrows(std::vector<tabu_move>& x, unsigned opt)
+{    
+	std::stable_sort(	x.begin(),
+	      		x.end(),
+	      		[opt](const tabu_move& lhs, const tabu_move& rhs) {
+	          		return move_cost(lhs, opt) < move_cost(rhs, opt);
+	      });
+}
+
+//Print the list of moves
+void print_list(const std::vector<tabu_move>& x)
+{
+	for(const auto& m : x)
+		std::cout << m.rule << " " << m.first << " " << m.second << " " << m.delta_gates << " " << m.delta_qcost << std::endl;
+}
+
+//Print the tabu list
+void print_list(const std::vector<tabu_entry>& tp)
+{
+	for(const auto& e : tp)
+		std::cout << e.rule << " " << e.first << " " << e.second << " " << e.age << std::endl;
+}
+
+//Function to decide which rule must be applied, returns false if all moves are tabu
+bool choosing_rule(circuit& circ, const std::vector<tabu_move>& x, std::vector<tabu_entry>& tp, tabu_move& applied, bool verbose)
+{
+	bool found = false;
+	for(const auto& m : x)
+	{
+		//moves removing gates are never tabu
+		if(m.delta_gates < 0)
+			found = true;
+		else if(std::none_of(tp.begin(), tp.end(), [&m](const tabu_entry& e) { return e.rule == m.rule && e.first == m.first && e.second == m.second; }))
 		{
-			if(x[k][0] == tp[i][0] && x[k][1] == tp[i][1] && x[k][2] == tp[i][2])
-			{
-				insert = false;
-				break;
-			}
+			tp.push_back( {m.rule, m.first, m.second, 0u} );
+			found = true;
 		}
-		if(insert)
+
+		if(found)
 		{
-			x[k][3] = 0;
-			tp.push_back( x[k] );
-			apply_rule( circ, x, k );
+			apply_rule( circ, m.rule, m.first, m.second );
+			if(verbose)
+				std::cout << "Rule " << rule_name( m.rule ) << " applied " << m.first << " " << m.second << std::endl;
+			applied = m;
 			break;
 		}
 	}
-	for(unsigned i = 0; i < tp.size(); ++i)
-		++tp[i][3];	
+	for(auto& e : tp)
+		++e.age;
+	return found;
 }
 
 //Update the tabu list (penalization)
-void update_tabu_list(matrix& tp, int penalization)
+void update_tabu_list(std::vector<tabu_entry>& tp, unsigned penalization)
 {
 	for(unsigned i = 0; i < tp.size(); ++i)
 	{
-		if(tp[i][3] >= penalization)
+		if(tp[i].age >= penalization)
 		{
 			tp.erase(tp.begin()+i);
 			break;
@@ -511,113 +449,50 @@ void update_tabu_list(matrix& tp, int penalization)
 	}
 }
 
-//Save the minimum circuit found
-bool update_circuit(circuit& circ, circuit& min, unsigned opt)
+//Save the minimum circuit found; the comparison must be a strict order,
+//otherwise the search can alternate between two minima forever
+bool update_circuit(circuit& circ, circuit& min, unsigned qcost, unsigned& min_qcost, unsigned opt)
 {
+	bool better;
 	switch(opt){
 		case 0:
-			if(circ.num_gates() < min.num_gates())
-			{
-				clear_circuit(min);
-				copy_circuit(circ, min);
-				//std::cout << " Minimo: " << min.num_gates() << std::endl;
-				return true;
-			}
+			better = circ.num_gates() < min.num_gates() || (circ.num_gates() == min.num_gates() && qcost < min_qcost);
+			break;
+		case 1:
+			better = qcost < min_qcost;
+			break;
 		default:
-			if(circuit_ncv_cost(circ) < circuit_ncv_cost(min))
-			{
-				clear_circuit(min);
-				copy_circuit(circ, min);
-				//std::cout << " Minimo: " << min.num_gates() << std::endl;
-				return true;
-			}
+			better = circ.num_gates() + qcost < min.num_gates() + min_qcost;
+			break;
 	}
-	return false;
-}
-
-void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const properties::ptr& statistics, unsigned opt )
-{
-	properties_timer t( statistics );
-	unsigned stop = 0, begin, end;
-	bool finish = false;
-	matrix x; //list of possible rules of the current iteration
-	matrix tp; //tabu list with the penalization
-	circuit orig, min;
-
-	copy_circuit( circ, orig );
- 	copy_circuit( circ, min );
- 	// reverse_circuit( orig );
- 	begin = 0;
-	end = neighborhood;
-	overlap = (overlap * neighborhood) * 0.01;
-
-	while(!finish)
-	{ 	
-		if(end > circ.num_gates())
-		{
-			end = circ.num_gates();
-			if(end < neighborhood)
-			{
-				begin = 0;
-			}
-			else
-			{
-				begin = end - neighborhood;
-			}
-			finish = true;
-		}
-		else if(int(begin) < 0)
-		{
-			begin = 0;
-		}
-		//std::cout << "begin: " << begin << " end: " << end << std::endl;
-	 	stop = 0;
-	 	unsigned int improvement = circ.num_gates();
-	 	tp.clear();
-	 	while(stop < neighborhood * 50)
-	 	{
-	 		list_rules(circ, x, begin, end, false);
-	 		sortrows(x, opt+3);
-	 		choosing_rule(circ, x, tp);
-	 		update_tabu_list(tp, neighborhood);
-	 		if(!update_circuit(circ, min, opt))
-	 			++stop;
-	 		else
-	 			stop = 0;
-	 		x.clear();
-
-	 		if(end > circ.num_gates())
-				end = circ.num_gates();
-			if(circ.num_gates() == 0)
-			{
-				finish = true;
-				break;
-			}
-	 	}
-	 	clear_circuit(circ);
-	 	copy_circuit(min, circ);
-	 	improvement = improvement - min.num_gates();
-	 	//std::cout << "improvement: " << improvement << std::endl;
-	 	//std::cin.get();
-	 	begin = begin + (neighborhood - overlap) - improvement;
-	 	end = begin + neighborhood;
+	if(better)
+	{
+		clear_circuit(min);
+		copy_circuit(circ, min);
+		min_qcost = qcost;
+		return true;
 	}
-	clear_circuit(circ);
-	copy_circuit(min, circ);
+	return false;
 }
 
-void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const properties::ptr& statistics, unsigned opt, bool verbose, bool step )
+void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const properties::ptr& statistics, unsigned opt, unsigned num_threads, bool verbose, bool step )
 {
 	properties_timer t( statistics );
-	unsigned stop = 0, begin, end;
+	unsigned stop = 0, begin, end, moves = 0, rejected = 0;
 	bool finish = false;
-	matrix x; //list of possible rules of the current iteration
-	matrix tp; //tabu list with the penalization
-	circuit orig, min;
+	std::vector<tabu_move> x; //list of possible rules of the current iteration
+	std::vector<tabu_entry> tp; //tabu list with the penalization
+	tabu_move applied;
+	circuit min;
+	work_stealing_pool pool( num_threads );
+	std::vector<circuit> windows( pool.num_threads() );
+	for( auto& window : windows )
+		window.set_lines( circ.lines() );
+
+	//the quantum cost is only computed once and then kept up to date with the deltas of the moves
+	unsigned qcost = circuit_ncv_cost( circ ), min_qcost = qcost;
 
-	copy_circuit( circ, orig );
  	copy_circuit( circ, min );
- 	// reverse_circuit( orig );
  	begin = 0;
 	end = neighborhood;
 	overlap = (overlap * neighborhood) * 0.01;
@@ -641,32 +516,45 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 		{
 			begin = 0;
 		}
-		//std::cout << "begin: " << begin << " end: " << end << std::endl;
 	 	stop = 0;
 	 	tp.clear();
 	 	unsigned int improvement = circ.num_gates();
 	 	while(stop < neighborhood * 50)
 	 	{
-	 		std::cout << "++++++++++ ITERATION " << stop << " +++++++++++" << std::endl;
-	 		std::cout << circ << std::endl;
-	 		list_rules(circ, x, begin, end, verbose);
-	 		sortrows(x, opt+3);
-	 		std::cout << "++++++++++ BEGIN LIST OF RULES +++++++++++" << std::endl;
- 			print_list( x );
-	 		std::cout << "++++++++++   END LIST OF RULES +++++++++++" << std::endl;
-	 		choosing_rule(circ, x, tp, verbose);
+	 		if(verbose)
+	 		{
+	 			std::cout << "++++++++++ ITERATION " << stop << " +++++++++++" << std::endl;
+	 			std::cout << circ << std::endl;
+	 		}
+	 		list_rules(circ, x, begin, end, pool, windows, rejected, verbose);
+	 		sortrows(x, opt);
+	 		if(verbose)
+	 		{
+	 			std::cout << "++++++++++ BEGIN LIST OF RULES +++++++++++" << std::endl;
+	 			print_list( x );
+	 			std::cout << "++++++++++   END LIST OF RULES +++++++++++" << std::endl;
+	 		}
+	 		if(choosing_rule(circ, x, tp, applied, verbose))
+	 		{
+	 			qcost += applied.delta_qcost;
+	 			++moves;
+	 		}
 	 		update_tabu_list(tp, neighborhood);
- 			std::cout << "++++++++++ BEGIN TABU LIST +++++++++++" << std::endl;
- 			print_list( tp );
- 			std::cout << "++++++++++   END TABU LIST +++++++++++" << std::endl;	
-	 		if(!update_circuit(circ, min, opt))
+	 		if(verbose)
+	 		{
+	 			std::cout << "++++++++++ BEGIN TABU LIST +++++++++++" << std::endl;
+	 			print_list( tp );
+	 			std::cout << "++++++++++   END TABU LIST +++++++++++" << std::endl;
+	 		}
+	 		if(!update_circuit(circ, min, qcost, min_qcost, opt))
 	 		{
 	 			++stop;
 	 		}
 	 		else
 	 		{
 	 			stop = 0;
-	 			std::cout << "++++++++++ CIRCUIT UPDATED +++++++++++" << std::endl;
+	 			if(verbose)
+	 				std::cout << "++++++++++ CIRCUIT UPDATED +++++++++++" << std::endl;
 	 		}
 	 		x.clear();
 	 		if(step)
@@ -682,16 +570,17 @@ void tabu_search( circuit& circ, unsigned overlap, unsigned neighborhood, const
 	 	}
 	 	clear_circuit(circ);
 	 	copy_circuit(min, circ);
+	 	qcost = min_qcost;
 	 	improvement = improvement - min.num_gates();
-	 	//std::cout << "improvement: " << improvement << std::endl;
-	 	//std::cin.get();
 	 	begin = begin + (neighborhood - overlap) - improvement;
 	 	end = begin + neighborhood;
 	}
 	clear_circuit(circ);
 	copy_circuit(min, circ);
-}
 
+	set( statistics, "moves", moves );
+	set( statistics, "rejected_moves", rejected );
+}
 
 bool tabu_command::execute()
 {
@@ -704,12 +593,7 @@ bool tabu_command::execute()
  	
  	InitialQuantumCost = circuit_ncv_cost(circ);
 
- 	if ( is_set("verbose") && is_set("step") )
- 		tabu_search( circ, overlap, neighborhood, statistics, opt, true, true );
- 	else if ( is_set("verbose") && !is_set("step") )
- 		tabu_search( circ, overlap, neighborhood, statistics, opt, true, false );
- 	else
- 		tabu_search( circ, overlap, neighborhood, statistics, opt );
+ 	tabu_search( circ, overlap, neighborhood, statistics, opt, threads, is_set("verbose"), is_set("verbose") && is_set("step") );
 	if ( is_set( "new" ) )
         circuits.extend();    
  	circuits.current() = circ;
@@ -721,16 +605,20 @@ bool tabu_command::execute()
     std::cout << " Begin quantum cost: " << InitialQuantumCost <<std::endl; 
     std::cout << " Final quantum cost: " << FinalQuantumCost << std::endl;
     print_runtime();
-    
-    if (!changed_circuit(circ))
-    	std::cout << "BRRRRRR" << std::endl;
+
+    if ( const auto rejected = statistics->get<unsigned>( "rejected_moves" ) )
+    {
+      std::cout << "[w] " << rejected << " rule applications could not be shown to preserve the function of their window and were skipped" << std::endl;
+    }
 
 	return true;
 }
 
 command::log_opt_t tabu_command::log() const
 {
-  return log_opt_t({{"runtime", statistics->get<double>( "runtime" )}});
+  return log_opt_t({{"runtime", statistics->get<double>( "runtime" )},
+                    {"moves", statistics->get<unsigned>( "moves" )},
+                    {"rejected_moves", statistics->get<unsigned>( "rejected_moves" )}});
 }
 
 }
@@ -42,6 +42,32 @@
 namespace cirkit
 {
 
+//Candidate move: a rule applied to the adjacent gates first and second
+//with the exact change of the gate count and the quantum cost
+struct tabu_move
+{
+	int rule;
+	unsigned first;
+	unsigned second;
+	int delta_gates;
+	int delta_qcost;
+};
+
+//Applies rule to the adjacent gates first and second of circ
+void apply_rule( circuit& circ, int rule, unsigned first, unsigned second );
+
+//Exact functional comparison of two windows of Toffoli gates; returns false
+//when equivalence cannot be established
+bool equivalent_windows( circuit::const_iterator before_first, circuit::const_iterator before_last,
+                         circuit::const_iterator after_first, circuit::const_iterator after_last );
+
+//Fills the cost deltas of move if applying it keeps the function of its window
+bool evaluate_move( const circuit& circ, tabu_move& move, circuit& window );
+
+//Copies circ into min if it is strictly better according to opt
+//(0: gates then quantum cost, 1: quantum cost, otherwise: their sum)
+bool update_circuit( circuit& circ, circuit& min, unsigned qcost, unsigned& min_qcost, unsigned opt );
+
 class tabu_command : public cirkit_command
     {
     public:
@@ -57,6 +83,7 @@ private:
 	unsigned int penalization = 10u;
 	unsigned int neighborhood = 10u;
 	unsigned int overlap = 70u;
+	unsigned int threads = 0u;
 	
 public:
   log_opt_t log() const;
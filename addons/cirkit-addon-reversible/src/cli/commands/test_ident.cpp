@@ -49,10 +49,13 @@
 
 #include <cli/commands/rules.hpp>
 #include <core/utils/program_options.hpp>
+#include <boost/optional.hpp>
 
 
 namespace cirkit
 {
+
+using boost::program_options::value;
  
 test_ident_command::test_ident_command(const environment::ptr& env)
     : cirkit_command(env, "testing identities")
@@ -68,6 +71,8 @@ test_ident_command::test_ident_command(const environment::ptr& env)
     ( "add_templ,a", "add new templates")
     ( "print_templates,g", "print all templates graphically as identity circuits")
     ( "junk,j", "temporary test")
+    ( "identity,i", "check whether the current circuit computes the identity")
+    ( "timeout", value( &timeout ), "time limit in seconds for the identity check")
     ;
  //   add_new_option();
 }
@@ -294,6 +299,26 @@ bool test_ident_command::execute()
 		}
 	}
 
+	if( is_set( "identity" ))
+	{
+		auto settings = make_settings();
+		if ( is_set( "timeout" ) )
+		{
+			settings->set( "timeout", boost::optional<unsigned>( timeout ) );
+		}
+		const auto& circuits = env->store<circuit>();
+		const bool result = is_identity( circuits.current(), settings, statistics );
+		const auto decided_by = statistics->get<std::string>( "decided_by" );
+		if( decided_by == "timeout" )
+		{
+			std::cout << "[w] timeout" << std::endl;
+		}
+		else
+		{
+			std::cout << "[i] identity: " << ( result ? "yes" : "no" ) << " (decided by " << decided_by << ")" << std::endl;
+		}
+	}
+
 	if( is_set( "junk" ))
 	{
 		auto& circuits = env->store<circuit>();
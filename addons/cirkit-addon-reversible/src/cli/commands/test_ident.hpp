@@ -52,7 +52,7 @@ protected:
  // rules_t validity_rules() const;
 
 private:
-  
+  unsigned timeout = 0u;
 	
 public:
   log_opt_t log() const;
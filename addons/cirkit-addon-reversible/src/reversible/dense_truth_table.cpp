@@ -0,0 +1,244 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "dense_truth_table.hpp"
+
+#include <cassert>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/range/iterator_range.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+dense_truth_table::dense_truth_table( unsigned num_inputs, unsigned num_outputs )
+  : _num_inputs( num_inputs ),
+    _num_outputs( num_outputs ),
+    _columns( num_outputs, std::vector<std::uint64_t>( ( num_rows() + 63u ) >> 6u, 0u ) ),
+    _dont_cares( num_outputs ),
+    _constants( num_inputs, constant() ),
+    _garbage( num_outputs, false )
+{
+}
+
+void dense_truth_table::set_dont_care( std::uint64_t row, unsigned output, bool value )
+{
+  auto& mask = _dont_cares[output];
+  if ( mask.empty() )
+  {
+    if ( !value ) { return; }
+    mask.resize( _columns[output].size(), 0u );
+  }
+
+  const auto bit = std::uint64_t( 1u ) << ( row & 63u );
+  mask[row >> 6u] = value ? ( mask[row >> 6u] | bit ) : ( mask[row >> 6u] & ~bit );
+}
+
+std::uint64_t dense_truth_table::row_value( std::uint64_t row ) const
+{
+  assert( _num_outputs <= 64u );
+
+  std::uint64_t value = 0u;
+  for ( auto j = 0u; j < _num_outputs; ++j )
+  {
+    value = ( value << 1u ) | static_cast<std::uint64_t>( get( row, j ) );
+  }
+  return value;
+}
+
+void dense_truth_table::set_row_value( std::uint64_t row, std::uint64_t value )
+{
+  assert( _num_outputs <= 64u );
+
+  for ( auto j = 0u; j < _num_outputs; ++j )
+  {
+    set( row, j, ( value >> ( _num_outputs - 1u - j ) ) & 1u );
+  }
+}
+
+bool dense_truth_table::is_fully_specified() const
+{
+  for ( const auto& mask : _dont_cares )
+  {
+    for ( auto word : mask )
+    {
+      if ( word ) { return false; }
+    }
+  }
+  return true;
+}
+
+bool dense_truth_table::is_reversible() const
+{
+  if ( _num_inputs != _num_outputs || !is_fully_specified() )
+  {
+    return false;
+  }
+
+  boost::dynamic_bitset<> seen( num_rows() );
+  for ( std::uint64_t row = 0u; row < num_rows(); ++row )
+  {
+    const auto value = row_value( row );
+    if ( seen[value] ) { return false; }
+    seen.set( value );
+  }
+  return true;
+}
+
+dense_truth_table dense_truth_table_from_truth_table( const binary_truth_table& spec )
+{
+  const auto n = spec.num_inputs();
+  const auto m = spec.num_outputs();
+
+  dense_truth_table dense( n, m );
+
+  /* all rows are don't cares until they are specified */
+  boost::dynamic_bitset<> specified( dense.num_rows() * m );
+
+  for ( const auto& row : spec )
+  {
+    /* specified input bits and positions of don't cares */
+    std::uint64_t base = 0u;
+    std::vector<unsigned> free;
+
+    auto i = 0u;
+    for ( const auto& in : boost::make_iterator_range( row.first ) )
+    {
+      if ( in )
+      {
+        base |= static_cast<std::uint64_t>( *in ) << ( n - 1u - i );
+      }
+      else
+      {
+        free.push_back( n - 1u - i );
+      }
+      ++i;
+    }
+
+    const std::vector<boost::optional<bool>> out( row.second.first, row.second.second );
+
+    for ( std::uint64_t k = 0u; k < ( std::uint64_t( 1u ) << free.size() ); ++k )
+    {
+      auto r = base;
+      for ( auto f = 0u; f < free.size(); ++f )
+      {
+        r |= ( ( k >> f ) & 1u ) << free[f];
+      }
+
+      for ( auto j = 0u; j < m; ++j )
+      {
+        if ( out[j] )
+        {
+          dense.set( r, j, *out[j] );
+          specified.set( r * m + j );
+        }
+      }
+    }
+  }
+
+  for ( std::uint64_t r = 0u; r < dense.num_rows(); ++r )
+  {
+    for ( auto j = 0u; j < m; ++j )
+    {
+      if ( !specified[r * m + j] )
+      {
+        dense.set_dont_care( r, j );
+      }
+    }
+  }
+
+  dense.set_inputs( spec.inputs() );
+  dense.set_outputs( spec.outputs() );
+  dense.set_constants( spec.constants() );
+  dense.set_garbage( spec.garbage() );
+
+  return dense;
+}
+
+void dense_truth_table_to_truth_table( const dense_truth_table& dense, binary_truth_table& spec )
+{
+  spec.clear();
+
+  for ( std::uint64_t r = 0u; r < dense.num_rows(); ++r )
+  {
+    binary_truth_table::cube_type out( dense.num_outputs() );
+    for ( auto j = 0u; j < dense.num_outputs(); ++j )
+    {
+      if ( !dense.is_dont_care( r, j ) )
+      {
+        out[j] = dense.get( r, j );
+      }
+    }
+    spec.add_entry( number_to_truth_table_cube( r, dense.num_inputs() ), out );
+  }
+
+  spec.set_inputs( dense.inputs() );
+  spec.set_outputs( dense.outputs() );
+  spec.set_constants( dense.constants() );
+  spec.set_garbage( dense.garbage() );
+}
+
+std::ostream& operator<<( std::ostream& os, const dense_truth_table& spec )
+{
+  for ( std::uint64_t r = 0u; r < spec.num_rows(); ++r )
+  {
+    for ( auto i = 0u; i < spec.num_inputs(); ++i )
+    {
+      os << ( ( r >> ( spec.num_inputs() - 1u - i ) ) & 1u );
+    }
+
+    os << " ";
+
+    for ( auto j = 0u; j < spec.num_outputs(); ++j )
+    {
+      os << ( spec.is_dont_care( r, j ) ? '-' : ( spec.get( r, j ) ? '1' : '0' ) );
+    }
+
+    os << std::endl;
+  }
+
+  return os;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
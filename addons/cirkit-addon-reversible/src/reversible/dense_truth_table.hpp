@@ -0,0 +1,136 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file dense_truth_table.hpp
+ *
+ * @brief Dense truth table for reversible specifications
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef DENSE_TRUTH_TABLE_HPP
+#define DENSE_TRUTH_TABLE_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <reversible/circuit.hpp>
+#include <reversible/truth_table.hpp>
+
+namespace cirkit
+{
+
+/* Truth table that stores all 2^n rows
+ *
+ * Each output is a column of packed 64-bit words, bit r of a column is the
+ * value of the output in row r.  Row r assigns to input i the value of bit
+ * num_inputs() - 1 - i of r, i.e., rows are numbered as in
+ * truth_table_cube_to_number.  Don't cares are kept in a separate mask for
+ * each output, which is empty if the output is fully specified.
+ */
+class dense_truth_table
+{
+public:
+  explicit dense_truth_table( unsigned num_inputs = 0u, unsigned num_outputs = 0u );
+
+  inline unsigned num_inputs() const      { return _num_inputs; }
+  inline unsigned num_outputs() const     { return _num_outputs; }
+  inline std::uint64_t num_rows() const   { return std::uint64_t( 1u ) << _num_inputs; }
+
+  inline bool get( std::uint64_t row, unsigned output ) const
+  {
+    return ( _columns[output][row >> 6u] >> ( row & 63u ) ) & 1u;
+  }
+
+  inline void set( std::uint64_t row, unsigned output, bool value )
+  {
+    const auto mask = std::uint64_t( 1u ) << ( row & 63u );
+    auto& word = _columns[output][row >> 6u];
+    word = value ? ( word | mask ) : ( word & ~mask );
+  }
+
+  inline bool is_dont_care( std::uint64_t row, unsigned output ) const
+  {
+    return !_dont_cares[output].empty() && ( ( _dont_cares[output][row >> 6u] >> ( row & 63u ) ) & 1u );
+  }
+
+  void set_dont_care( std::uint64_t row, unsigned output, bool value = true );
+
+  /* all outputs of a row as a number, output 0 is the most significant bit */
+  std::uint64_t row_value( std::uint64_t row ) const;
+  void set_row_value( std::uint64_t row, std::uint64_t value );
+
+  inline const std::vector<std::uint64_t>& column( unsigned output ) const     { return _columns[output]; }
+  inline std::vector<std::uint64_t>& column( unsigned output )                 { return _columns[output]; }
+  inline const std::vector<std::uint64_t>& dont_cares( unsigned output ) const { return _dont_cares[output]; }
+
+  bool is_fully_specified() const;
+
+  /* fully specified and a bijection */
+  bool is_reversible() const;
+
+  /* meta data */
+  inline void set_inputs( const std::vector<std::string>& inputs )    { _inputs = inputs; }
+  inline const std::vector<std::string>& inputs() const               { return _inputs; }
+  inline void set_outputs( const std::vector<std::string>& outputs )  { _outputs = outputs; }
+  inline const std::vector<std::string>& outputs() const              { return _outputs; }
+  inline void set_constants( const std::vector<constant>& constants ) { _constants = constants; _constants.resize( _num_inputs, constant() ); }
+  inline const std::vector<constant>& constants() const               { return _constants; }
+  inline void set_garbage( const std::vector<bool>& garbage )         { _garbage = garbage; _garbage.resize( _num_outputs, false ); }
+  inline const std::vector<bool>& garbage() const                     { return _garbage; }
+
+private:
+  unsigned                                _num_inputs;
+  unsigned                                _num_outputs;
+
+  std::vector<std::vector<std::uint64_t>> _columns;
+  std::vector<std::vector<std::uint64_t>> _dont_cares;
+
+  std::vector<std::string>                _inputs;
+  std::vector<std::string>                _outputs;
+  std::vector<constant>                   _constants;
+  std::vector<bool>                       _garbage;
+};
+
+/* input cubes with don't cares are expanded, missing rows are don't cares */
+dense_truth_table dense_truth_table_from_truth_table( const binary_truth_table& spec );
+void dense_truth_table_to_truth_table( const dense_truth_table& dense, binary_truth_table& spec );
+
+std::ostream& operator<<( std::ostream& os, const dense_truth_table& spec );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
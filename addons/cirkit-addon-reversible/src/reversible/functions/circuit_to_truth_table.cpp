@@ -30,6 +30,7 @@
 
 #include <core/properties.hpp>
 #include <core/utils/bitset_utils.hpp>
+#include <reversible/target_tags.hpp>
 
 namespace cirkit
 {
@@ -77,6 +78,69 @@ namespace cirkit
     return true;
   }
 
+  bool circuit_to_truth_table( const circuit& circ, dense_truth_table& spec )
+  {
+    const auto n = circ.lines();
+    spec = dense_truth_table( n, n );
+
+    const auto num_words = spec.column( 0u ).size();
+    const auto last_mask = spec.num_rows() >= 64u ? ~std::uint64_t( 0u ) : ( ( std::uint64_t( 1u ) << spec.num_rows() ) - 1u );
+
+    /* line i has the value of bit n - 1 - i of the row */
+    static const std::uint64_t projections[] = { 0xaaaaaaaaaaaaaaaa, 0xcccccccccccccccc, 0xf0f0f0f0f0f0f0f0,
+                                                 0xff00ff00ff00ff00, 0xffff0000ffff0000, 0xffffffff00000000 };
+    for ( auto i = 0u; i < n; ++i )
+    {
+      const auto b = n - 1u - i;
+      auto& col = spec.column( i );
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        col[w] = b < 6u ? projections[b] : ( ( ( w >> ( b - 6u ) ) & 1u ) ? ~std::uint64_t( 0u ) : 0u );
+      }
+      col[num_words - 1u] &= last_mask;
+    }
+
+    /* simulate all rows at once, word by word */
+    for ( const auto& g : circ )
+    {
+      if ( !is_toffoli( g ) && !is_fredkin( g ) )
+      {
+        return false;
+      }
+
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        auto active = w + 1u == num_words ? last_mask : ~std::uint64_t( 0u );
+        for ( const auto& c : g.controls() )
+        {
+          const auto word = spec.column( c.line() )[w];
+          active &= c.polarity() ? word : ~word;
+        }
+
+        if ( is_toffoli( g ) )
+        {
+          spec.column( g.targets().front() )[w] ^= active;
+        }
+        else
+        {
+          auto& t1 = spec.column( g.targets()[0u] )[w];
+          auto& t2 = spec.column( g.targets()[1u] )[w];
+          const auto diff = ( t1 ^ t2 ) & active;
+          t1 ^= diff;
+          t2 ^= diff;
+        }
+      }
+    }
+
+    /* metadata */
+    spec.set_inputs( circ.inputs() );
+    spec.set_outputs( circ.outputs() );
+    spec.set_constants( circ.constants() );
+    spec.set_garbage( circ.garbage() );
+
+    return true;
+  }
+
 }
 
 // Local Variables:
@@ -41,6 +41,7 @@
 
 #include <core/functor.hpp>
 #include <reversible/circuit.hpp>
+#include <reversible/dense_truth_table.hpp>
 #include <reversible/truth_table.hpp>
 
 namespace cirkit
@@ -62,6 +63,21 @@ namespace cirkit
    */
   bool circuit_to_truth_table( const circuit& circ, binary_truth_table& spec, const functor<bool(boost::dynamic_bitset<>&, const circuit&, const boost::dynamic_bitset<>&)>& simulation );
 
+  /**
+   * @brief Generates a dense truth table from a circuit
+   *
+   * All rows are simulated at once, 64 rows per machine word.  Only Toffoli
+   * and Fredkin gates are supported.
+   *
+   * @param circ Circuit to be simulated
+   * @param spec Truth table to be constructed
+   *
+   * @return true on success, false if the circuit contains other gates
+   *
+   * @since  2.4
+   */
+  bool circuit_to_truth_table( const circuit& circ, dense_truth_table& spec );
+
 }
 
 #endif /* CIRCUIT_TO_TRUTH_TABLE_HPP */
@@ -42,6 +42,14 @@ namespace cirkit
   {
   }
 
+  void copy_metadata( const dense_truth_table& spec, circuit& circ )
+  {
+    circ.set_inputs( spec.inputs() );
+    circ.set_outputs( spec.outputs() );
+    circ.set_constants( spec.constants() );
+    circ.set_garbage( spec.garbage() );
+  }
+
   void copy_metadata( const circuit& base, circuit& circ, const copy_metadata_settings& settings )
   {
     circ.set_lines( base.lines() );
@@ -37,6 +37,7 @@
 #define COPY_METADATA_HPP
 
 #include <reversible/circuit.hpp>
+#include <reversible/dense_truth_table.hpp>
 #include <reversible/truth_table.hpp>
 
 namespace cirkit
@@ -166,6 +167,16 @@ namespace cirkit
     circ.set_garbage( spec.garbage() );
   }
 
+  /**
+   * @brief Copies meta-data from a dense specification to a circuit
+   *
+   * @param spec Dense truth table
+   * @param circ Circuit
+   *
+   * @since  2.4
+   */
+  void copy_metadata( const dense_truth_table& spec, circuit& circ );
+
   /**
    * @brief Copies meta-data from a circuit to another circuit
    *
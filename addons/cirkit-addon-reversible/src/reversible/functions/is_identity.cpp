@@ -26,15 +26,302 @@
 
 #include "is_identity.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/optional.hpp>
 #include <boost/range/combine.hpp>
 #include <boost/range/numeric.hpp>
 
+#include <core/utils/timer.hpp>
 #include <reversible/rcbdd.hpp>
+#include <reversible/target_tags.hpp>
 
 namespace cirkit
 {
 
-bool is_identity( const circuit& circ )
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* Toffoli or Fredkin gate with decoded controls */
+struct simple_gate_t
+{
+  std::vector<std::pair<unsigned, bool>> controls;
+  std::vector<unsigned>                  targets;
+};
+
+class identity_checker
+{
+public:
+  identity_checker( const circuit& circ, const properties::ptr& settings )
+    : circ( circ ),
+      n( circ.lines() ),
+      sim_words( get( settings, "sim_words", 16u ) ),
+      exhaustive_limit( get( settings, "exhaustive_limit", 16u ) ),
+      seed( get( settings, "seed", 0xcafeu ) ),
+      timeout( get( settings, "timeout", boost::optional<unsigned>() ) ),
+      verbose( get( settings, "verbose", false ) ),
+      start( std::chrono::steady_clock::now() )
+  {
+  }
+
+  /* returns false if the circuit contains gates that cannot be simulated */
+  bool decode()
+  {
+    for ( const auto& g : circ )
+    {
+      if ( !is_toffoli( g ) && !is_fredkin( g ) )
+      {
+        return false;
+      }
+
+      simple_gate_t sg;
+      for ( const auto& c : g.controls() )
+      {
+        sg.controls.push_back( {c.line(), c.polarity()} );
+      }
+      sg.targets.assign( g.targets().begin(), g.targets().end() );
+      gates.push_back( sg );
+    }
+    return true;
+  }
+
+  bool timed_out() const
+  {
+    return (bool)timeout && std::chrono::steady_clock::now() - start >= std::chrono::seconds( *timeout );
+  }
+
+  /* simulation phase: returns true if a difference was found */
+  bool simulate( bool& exhaustive )
+  {
+    exhaustive = n <= exhaustive_limit;
+
+    /* structured patterns */
+    const auto num_structured = 2u * n + 2u;
+    fill_inputs( ( num_structured + 63u ) / 64u, [this, num_structured]( std::uint64_t p, unsigned i ) {
+        if ( p >= num_structured ) { return false; }
+        if ( p < 2u ) { return p == 1u; }
+        return p < 2u + n ? ( p - 2u == i ) : ( p - 2u - n != i );
+      } );
+    if ( simulate_block() ) { return true; }
+
+    if ( exhaustive )
+    {
+      const auto num_rows = std::uint64_t( 1u ) << n;
+      for ( std::uint64_t first = 0u; first < num_rows; first += block_size * 64u )
+      {
+        if ( timed_out() ) { return false; }
+
+        const auto words = std::min<std::uint64_t>( block_size, ( num_rows - first + 63u ) / 64u );
+        fill_inputs( words, [first, num_rows]( std::uint64_t p, unsigned i ) {
+            return first + p < num_rows && ( ( ( first + p ) >> i ) & 1u );
+          } );
+        if ( simulate_block() ) { return true; }
+      }
+    }
+    else
+    {
+      std::mt19937_64 gen( seed );
+      for ( auto done = 0u; done < sim_words; done += block_size )
+      {
+        if ( timed_out() ) { return false; }
+
+        const auto words = std::min<std::uint64_t>( block_size, sim_words - done );
+        inputs.assign( n, std::vector<std::uint64_t>( words ) );
+        for ( auto& line : inputs )
+        {
+          for ( auto& w : line ) { w = gen(); }
+        }
+        if ( simulate_block() ) { return true; }
+      }
+    }
+
+    return false;
+  }
+
+  /* proof phase: each line is compared to its input on its output cone */
+  boost::optional<bool> prove()
+  {
+    Cudd mgr;
+    std::vector<BDD> vars;
+    for ( auto i = 0u; i < n; ++i )
+    {
+      vars.push_back( mgr.bddVar( i ) );
+    }
+
+    /* gates in the output cone of each line, smaller cones first */
+    std::vector<std::vector<unsigned>> cones( n );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      boost::dynamic_bitset<> lines( n );
+      lines.set( i );
+      for ( auto k = gates.size(); k-- > 0u; )
+      {
+        const auto& g = gates[k];
+        if ( std::none_of( g.targets.begin(), g.targets.end(), [&lines]( unsigned t ) { return lines[t]; } ) ) { continue; }
+
+        cones[i].push_back( k );
+        for ( const auto& c : g.controls ) { lines.set( c.first ); }
+        for ( auto t : g.targets ) { lines.set( t ); }
+      }
+      std::reverse( cones[i].begin(), cones[i].end() );
+    }
+
+    std::vector<unsigned> order( n );
+    for ( auto i = 0u; i < n; ++i ) { order[i] = i; }
+    std::stable_sort( order.begin(), order.end(), [&cones]( unsigned a, unsigned b ) { return cones[a].size() < cones[b].size(); } );
+
+    for ( auto i : order )
+    {
+      std::vector<BDD> f = vars;
+      for ( auto k : cones[i] )
+      {
+        if ( timed_out() ) { return boost::none; }
+
+        const auto& g = gates[k];
+        auto active = mgr.bddOne();
+        for ( const auto& c : g.controls )
+        {
+          active &= c.second ? f[c.first] : !f[c.first];
+        }
+
+        if ( g.targets.size() == 1u )
+        {
+          f[g.targets[0u]] ^= active;
+        }
+        else
+        {
+          const auto diff = ( f[g.targets[0u]] ^ f[g.targets[1u]] ) & active;
+          f[g.targets[0u]] ^= diff;
+          f[g.targets[1u]] ^= diff;
+        }
+      }
+
+      if ( f[i] != vars[i] )
+      {
+        if ( verbose )
+        {
+          std::cout << "[i] line " << i << " differs (cone with " << cones[i].size() << " gates)" << std::endl;
+        }
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  std::vector<bool> counterexample;
+
+private:
+  template<typename Fn>
+  void fill_inputs( std::uint64_t words, Fn&& value )
+  {
+    inputs.assign( n, std::vector<std::uint64_t>( words ) );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      for ( std::uint64_t p = 0u; p < 64u * words; ++p )
+      {
+        if ( value( p, i ) )
+        {
+          inputs[i][p >> 6u] |= std::uint64_t( 1u ) << ( p & 63u );
+        }
+      }
+    }
+  }
+
+  /* simulates all words in inputs, returns true and sets counterexample if some line differs */
+  bool simulate_block()
+  {
+    const auto words = inputs.front().size();
+    auto values = inputs;
+    std::vector<std::uint64_t> active( words );
+
+    for ( const auto& g : gates )
+    {
+      std::fill( active.begin(), active.end(), ~std::uint64_t( 0u ) );
+      for ( const auto& c : g.controls )
+      {
+        const auto& v = values[c.first];
+        for ( auto w = 0u; w < words; ++w )
+        {
+          active[w] &= c.second ? v[w] : ~v[w];
+        }
+      }
+
+      if ( g.targets.size() == 1u )
+      {
+        auto& t = values[g.targets[0u]];
+        for ( auto w = 0u; w < words; ++w ) { t[w] ^= active[w]; }
+      }
+      else
+      {
+        auto& t1 = values[g.targets[0u]];
+        auto& t2 = values[g.targets[1u]];
+        for ( auto w = 0u; w < words; ++w )
+        {
+          const auto diff = ( t1[w] ^ t2[w] ) & active[w];
+          t1[w] ^= diff;
+          t2[w] ^= diff;
+        }
+      }
+    }
+
+    for ( auto i = 0u; i < n; ++i )
+    {
+      for ( auto w = 0u; w < words; ++w )
+      {
+        const auto diff = values[i][w] ^ inputs[i][w];
+        if ( diff )
+        {
+          const auto bit = __builtin_ctzll( diff );
+          counterexample.resize( n );
+          for ( auto j = 0u; j < n; ++j )
+          {
+            counterexample[j] = ( inputs[j][w] >> bit ) & 1u;
+          }
+          if ( verbose )
+          {
+            std::cout << "[i] line " << i << " differs in simulation" << std::endl;
+          }
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+private:
+  const circuit& circ;
+  unsigned n;
+
+  unsigned sim_words;
+  unsigned exhaustive_limit;
+  unsigned seed;
+  boost::optional<unsigned> timeout;
+  bool verbose;
+
+  std::chrono::steady_clock::time_point start;
+
+  static constexpr std::uint64_t block_size = 64u;
+
+  std::vector<simple_gate_t> gates;
+  std::vector<std::vector<std::uint64_t>> inputs;
+};
+
+constexpr std::uint64_t identity_checker::block_size;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+bool is_identity_rcbdd( const circuit& circ )
 {
   rcbdd mgr;
   mgr.initialize_manager();
@@ -51,6 +338,80 @@ bool is_identity( const circuit& circ )
   return f == identity;
 }
 
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+bool is_identity( const circuit& circ, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer t( statistics );
+
+  if ( circ.num_gates() == 0u )
+  {
+    set( statistics, "decided_by", std::string( "simulation" ) );
+    return true;
+  }
+
+  identity_checker checker( circ, settings );
+
+  if ( !checker.decode() )
+  {
+    set( statistics, "decided_by", std::string( "bdd" ) );
+    return is_identity_rcbdd( circ );
+  }
+
+  /* phase 1: simulation */
+  bool exhaustive = false;
+  bool differs = false;
+  {
+    double runtime = 0.0;
+    {
+      reference_timer rt( &runtime );
+      differs = checker.simulate( exhaustive );
+    }
+    set( statistics, "simulation_runtime", runtime );
+  }
+
+  if ( differs )
+  {
+    set( statistics, "decided_by", std::string( "simulation" ) );
+    set( statistics, "counterexample", checker.counterexample );
+    return false;
+  }
+
+  if ( checker.timed_out() )
+  {
+    set( statistics, "decided_by", std::string( "timeout" ) );
+    return false;
+  }
+
+  if ( exhaustive )
+  {
+    set( statistics, "decided_by", std::string( "simulation" ) );
+    return true;
+  }
+
+  /* phase 2: proof on output cones */
+  boost::optional<bool> result;
+  {
+    double runtime = 0.0;
+    {
+      reference_timer rt( &runtime );
+      result = checker.prove();
+    }
+    set( statistics, "proof_runtime", runtime );
+  }
+
+  if ( !result )
+  {
+    set( statistics, "decided_by", std::string( "timeout" ) );
+    return false;
+  }
+
+  set( statistics, "decided_by", std::string( "bdd" ) );
+  return *result;
+}
+
 }
 
 // Local Variables:
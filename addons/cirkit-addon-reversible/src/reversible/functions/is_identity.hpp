@@ -36,12 +36,42 @@
 #ifndef IS_IDENTITY_HPP
 #define IS_IDENTITY_HPP
 
+#include <core/properties.hpp>
 #include <reversible/circuit.hpp>
 
 namespace cirkit
 {
 
-bool is_identity( const circuit& circ );
+/**
+ * @brief Checks whether a circuit computes the identity
+ *
+ * The check runs in two phases.  First, the circuit is simulated bit-parallel
+ * on structured patterns (all zeros, all ones, one-hot, and one-cold) and on
+ * random patterns, which quickly refutes most non-identities.  For circuits
+ * with at most `exhaustive_limit' lines simulation is exhaustive and also
+ * proves identity.  Otherwise, each line is proven separately on its output
+ * cone, i.e., only the gates that can influence the line are symbolically
+ * simulated using BDDs.  Circuits with gates other than Toffoli and Fredkin
+ * gates are checked on the characteristic function as before.
+ *
+ * Settings:
+ *   - sim_words (unsigned, 16): number of 64-bit words of random patterns
+ *   - exhaustive_limit (unsigned, 16): maximum number of lines for exhaustive simulation
+ *   - seed (unsigned, 0xcafe): seed for random patterns
+ *   - timeout (boost::optional<unsigned>, none): time limit in seconds
+ *   - verbose (bool, false): be verbose
+ *
+ * Statistics:
+ *   - runtime, simulation_runtime, proof_runtime (double)
+ *   - decided_by (std::string): "simulation", "bdd", or "timeout"
+ *   - counterexample (std::vector<bool>): input assignment (one value per line) if refuted by simulation
+ *
+ * If the time limit is exceeded, the function returns false and decided_by
+ * is set to "timeout".
+ */
+bool is_identity( const circuit& circ,
+                  const properties::ptr& settings = properties::ptr(),
+                  const properties::ptr& statistics = properties::ptr() );
 
 }
 
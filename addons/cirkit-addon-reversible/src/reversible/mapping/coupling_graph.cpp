@@ -0,0 +1,787 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "coupling_graph.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <tuple>
+
+#include <boost/format.hpp>
+
+#include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
+#include <reversible/pauli_tags.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/functions/copy_metadata.hpp>
+#include <reversible/functions/ibm_helper.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* CNOTs between two lines in the circuit; if symmetric, the cheaper
+   direction can be chosen when the gate is decomposed */
+struct line_interaction
+{
+  unsigned a;
+  unsigned b;
+  unsigned weight;
+  bool     symmetric;
+};
+
+const unsigned coupling_graph::infinity = std::numeric_limits<unsigned>::max() / 4u;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+std::vector<line_interaction> collect_interactions( const circuit& circ )
+{
+  std::map<std::tuple<unsigned, unsigned, bool>, unsigned> weights;
+
+  for ( const auto& g : circ )
+  {
+    const auto& controls = g.controls();
+    if ( controls.empty() )
+    {
+      continue;
+    }
+
+    const auto target = g.targets().front();
+
+    if ( is_toffoli( g ) && controls.size() == 1u )
+    {
+      weights[std::make_tuple( controls.front().line(), target, false )] += 1u;
+    }
+    else if ( is_v( g ) && controls.size() == 1u )
+    {
+      weights[std::make_tuple( controls.front().line(), target, true )] += 2u;
+    }
+    else if ( is_toffoli( g ) && controls.size() == 2u )
+    {
+      /* the Clifford+T decomposition has two CNOTs between each pair */
+      const auto ca = controls.front().line();
+      const auto cb = controls.back().line();
+      weights[std::make_tuple( ca, target, true )] += 2u;
+      weights[std::make_tuple( cb, target, true )] += 2u;
+      weights[std::make_tuple( ca, cb, true )] += 2u;
+    }
+  }
+
+  std::vector<line_interaction> interactions;
+  for ( const auto& p : weights )
+  {
+    interactions.push_back( {std::get<0>( p.first ), std::get<1>( p.first ), p.second, std::get<2>( p.first )} );
+  }
+  return interactions;
+}
+
+inline unsigned long long interaction_cost( const coupling_graph& graph, const line_interaction& i, unsigned qa, unsigned qb )
+{
+  auto c = graph.cost( qa, qb );
+  if ( i.symmetric )
+  {
+    c = std::min( c, graph.cost( qb, qa ) );
+  }
+  return static_cast<unsigned long long>( i.weight ) * c;
+}
+
+unsigned long long placement_cost( const coupling_graph& graph, const std::vector<line_interaction>& interactions, const std::vector<unsigned>& placement )
+{
+  auto cost = 0ull;
+  for ( const auto& i : interactions )
+  {
+    cost += interaction_cost( graph, i, placement[i.a], placement[i.b] );
+  }
+  return cost;
+}
+
+/* number of injective placements of k lines on n qubits, or limit + 1 if it exceeds limit */
+unsigned long long num_placements( unsigned k, unsigned n, unsigned long long limit )
+{
+  auto count = 1ull;
+  for ( auto i = 0u; i < k; ++i )
+  {
+    count *= ( n - i );
+    if ( count > limit )
+    {
+      return limit + 1ull;
+    }
+  }
+  return count;
+}
+
+/* index is interpreted in the mixed radix system n, n - 1, ..., n - k + 1 */
+std::vector<unsigned> decode_placement( unsigned long long index, unsigned k, unsigned n )
+{
+  std::vector<unsigned> placement( k );
+  std::vector<unsigned> free( n );
+  std::iota( free.begin(), free.end(), 0u );
+
+  for ( auto i = 0u; i < k; ++i )
+  {
+    const auto digit = index % ( n - i );
+    index /= ( n - i );
+    placement[i] = free[digit];
+    free.erase( free.begin() + digit );
+  }
+  return placement;
+}
+
+std::vector<unsigned> greedy_placement( const coupling_graph& graph, const std::vector<line_interaction>& interactions, unsigned k, unsigned start )
+{
+  const auto n = graph.num_qubits();
+
+  /* place lines with many CNOTs first */
+  std::vector<unsigned> total( k, 0u );
+  for ( const auto& i : interactions )
+  {
+    total[i.a] += i.weight;
+    total[i.b] += i.weight;
+  }
+  std::vector<unsigned> order( k );
+  std::iota( order.begin(), order.end(), 0u );
+  std::stable_sort( order.begin(), order.end(), [&total]( unsigned a, unsigned b ) { return total[a] > total[b]; } );
+
+  std::vector<unsigned> placement( k, n );
+  std::vector<bool> used( n, false );
+
+  placement[order.front()] = start;
+  used[start] = true;
+
+  for ( auto j = 1u; j < k; ++j )
+  {
+    const auto l = order[j];
+
+    auto best = std::numeric_limits<unsigned long long>::max();
+    auto best_q = 0u;
+
+    for ( auto q = 0u; q < n; ++q )
+    {
+      if ( used[q] ) continue;
+
+      /* only CNOTs with lines that are placed already */
+      auto cost = 0ull;
+      for ( const auto& i : interactions )
+      {
+        if ( i.a == l && placement[i.b] != n )
+        {
+          cost += interaction_cost( graph, i, q, placement[i.b] );
+        }
+        else if ( i.b == l && placement[i.a] != n )
+        {
+          cost += interaction_cost( graph, i, placement[i.a], q );
+        }
+      }
+
+      if ( cost < best )
+      {
+        best = cost;
+        best_q = q;
+      }
+    }
+
+    placement[l] = best_q;
+    used[best_q] = true;
+  }
+
+  return placement;
+}
+
+/* first-improvement hill climbing; a move places a line on another qubit
+   and swaps it with the line on that qubit (if any) */
+unsigned long long improve_placement( const coupling_graph& graph, const std::vector<line_interaction>& interactions, std::vector<unsigned>& placement, unsigned long long& num_candidates )
+{
+  const auto n = graph.num_qubits();
+  const auto k = placement.size();
+
+  std::vector<int> line_at( n, -1 );
+  for ( auto l = 0u; l < k; ++l )
+  {
+    line_at[placement[l]] = l;
+  }
+
+  auto cost = placement_cost( graph, interactions, placement );
+
+  auto improved = true;
+  while ( improved )
+  {
+    improved = false;
+
+    for ( auto l = 0u; l < k; ++l )
+    {
+      for ( auto q = 0u; q < n; ++q )
+      {
+        const auto p = placement[l];
+        if ( q == p ) continue;
+
+        const auto other = line_at[q];
+        placement[l] = q;
+        if ( other != -1 )
+        {
+          placement[other] = p;
+        }
+
+        ++num_candidates;
+        const auto new_cost = placement_cost( graph, interactions, placement );
+        if ( new_cost < cost )
+        {
+          cost = new_cost;
+          line_at[q] = l;
+          line_at[p] = other;
+          improved = true;
+        }
+        else
+        {
+          placement[l] = p;
+          if ( other != -1 )
+          {
+            placement[other] = q;
+          }
+        }
+      }
+    }
+  }
+
+  return cost;
+}
+
+void remap_gate( gate& g, const std::vector<unsigned>& placement )
+{
+  std::vector<unsigned> targets( g.targets().begin(), g.targets().end() );
+  for ( auto t : targets )
+  {
+    g.remove_target( t );
+  }
+  for ( auto t : targets )
+  {
+    g.add_target( placement[t] );
+  }
+
+  std::vector<variable> controls( g.controls().begin(), g.controls().end() );
+  for ( const auto& c : controls )
+  {
+    g.remove_control( c );
+  }
+  for ( const auto& c : controls )
+  {
+    g.add_control( make_var( placement[c.line()], c.polarity() ) );
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+coupling_graph::coupling_graph( unsigned num_qubits, const std::vector<std::pair<unsigned, unsigned>>& edges )
+  : _num_qubits( num_qubits ),
+    adjacency( num_qubits * num_qubits, 0 ),
+    distance( num_qubits * num_qubits, infinity ),
+    next_hop( num_qubits * num_qubits, num_qubits ),
+    routes( num_qubits * num_qubits )
+{
+  for ( const auto& e : edges )
+  {
+    if ( e.first >= num_qubits || e.second >= num_qubits || e.first == e.second )
+    {
+      throw boost::str( boost::format( "invalid edge (%d, %d) in coupling graph with %d qubits" ) % e.first % e.second % num_qubits );
+    }
+    adjacency[e.first * num_qubits + e.second] = 1;
+  }
+
+  compute_distances();
+  compute_routes();
+}
+
+bool coupling_graph::is_connected() const
+{
+  return std::none_of( distance.begin(), distance.end(), []( unsigned d ) { return d == infinity; } );
+}
+
+std::vector<std::vector<unsigned>> coupling_graph::cost_matrix() const
+{
+  std::vector<std::vector<unsigned>> costs( _num_qubits, std::vector<unsigned>( _num_qubits ) );
+  for ( auto c = 0u; c < _num_qubits; ++c )
+  {
+    for ( auto t = 0u; t < _num_qubits; ++t )
+    {
+      costs[c][t] = cost( c, t );
+    }
+  }
+  return costs;
+}
+
+void coupling_graph::append_routed_cnot( circuit& circ, unsigned control, unsigned target ) const
+{
+  const auto& r = routes[control * _num_qubits + target];
+  if ( control == target || r.cost >= infinity )
+  {
+    throw boost::str( boost::format( "cannot route CNOT(%d, %d)" ) % control % target );
+  }
+
+  const auto moving = r.move_target ? target : control;
+  const auto p = path( moving, r.meet );
+
+  auto current = moving;
+  for ( auto q : p )
+  {
+    append_swap( circ, current, q );
+    current = q;
+  }
+
+  if ( r.move_target )
+  {
+    append_adjacent_cnot( circ, control, r.meet );
+  }
+  else
+  {
+    append_adjacent_cnot( circ, r.meet, target );
+  }
+
+  /* move the qubit back */
+  for ( auto i = p.size(); i > 0u; --i )
+  {
+    append_swap( circ, p[i - 1u], i > 1u ? p[i - 2u] : moving );
+  }
+}
+
+void coupling_graph::print( std::ostream& os ) const
+{
+  for ( auto i = 0u; i < _num_qubits; ++i )
+  {
+    for ( auto j = 0u; j < _num_qubits; ++j )
+    {
+      os << ( has_edge( i, j ) ? "X " : "- " );
+    }
+    os << std::endl;
+  }
+
+  for ( auto i = 0u; i < _num_qubits; ++i )
+  {
+    for ( auto j = 0u; j < _num_qubits; ++j )
+    {
+      if ( cost( i, j ) >= infinity )
+      {
+        os << "inf ";
+      }
+      else
+      {
+        os << cost( i, j ) << " ";
+      }
+    }
+    os << std::endl;
+  }
+}
+
+/* Floyd-Warshall on the undirected graph, weighted by SWAP costs */
+void coupling_graph::compute_distances()
+{
+  const auto n = _num_qubits;
+
+  for ( auto i = 0u; i < n; ++i )
+  {
+    distance[i * n + i] = 0u;
+    next_hop[i * n + i] = i;
+
+    for ( auto j = 0u; j < n; ++j )
+    {
+      if ( i != j && ( has_edge( i, j ) || has_edge( j, i ) ) )
+      {
+        distance[i * n + j] = swap_cost( i, j );
+        next_hop[i * n + j] = j;
+      }
+    }
+  }
+
+  for ( auto k = 0u; k < n; ++k )
+  {
+    for ( auto i = 0u; i < n; ++i )
+    {
+      const auto dik = distance[i * n + k];
+      if ( dik == infinity ) continue;
+
+      for ( auto j = 0u; j < n; ++j )
+      {
+        const auto dkj = distance[k * n + j];
+        if ( dkj != infinity && dik + dkj < distance[i * n + j] )
+        {
+          distance[i * n + j] = dik + dkj;
+          next_hop[i * n + j] = next_hop[i * n + k];
+        }
+      }
+    }
+  }
+}
+
+/* Either the control is swapped to a neighbor of the target or vice versa.
+ * A shortest path to the chosen neighbor never passes the other qubit, since
+ * the neighbor before it on that path would be cheaper. */
+void coupling_graph::compute_routes()
+{
+  const auto n = _num_qubits;
+
+  for ( auto c = 0u; c < n; ++c )
+  {
+    for ( auto t = 0u; t < n; ++t )
+    {
+      auto& r = routes[c * n + t];
+      if ( c == t ) continue;
+
+      r.cost = infinity;
+
+      for ( auto q = 0u; q < n; ++q )
+      {
+        if ( q != t && ( has_edge( q, t ) || has_edge( t, q ) ) && distance[c * n + q] != infinity )
+        {
+          const auto cost = 2u * distance[c * n + q] + reverse_cost( q, t );
+          if ( cost < r.cost )
+          {
+            r.cost = cost;
+            r.meet = q;
+            r.move_target = false;
+          }
+        }
+
+        if ( q != c && ( has_edge( c, q ) || has_edge( q, c ) ) && distance[t * n + q] != infinity )
+        {
+          const auto cost = 2u * distance[t * n + q] + reverse_cost( c, q );
+          if ( cost < r.cost )
+          {
+            r.cost = cost;
+            r.meet = q;
+            r.move_target = true;
+          }
+        }
+      }
+    }
+  }
+}
+
+unsigned coupling_graph::reverse_cost( unsigned control, unsigned target ) const
+{
+  return has_edge( control, target ) ? 0u : 4u;
+}
+
+unsigned coupling_graph::swap_cost( unsigned a, unsigned b ) const
+{
+  return ( has_edge( a, b ) && has_edge( b, a ) ) ? 3u : 7u;
+}
+
+void coupling_graph::append_adjacent_cnot( circuit& circ, unsigned control, unsigned target ) const
+{
+  if ( has_edge( control, target ) )
+  {
+    append_cnot( circ, control, target );
+  }
+  else
+  {
+    append_hadamard( circ, control );
+    append_hadamard( circ, target );
+    append_cnot( circ, target, control );
+    append_hadamard( circ, control );
+    append_hadamard( circ, target );
+  }
+}
+
+void coupling_graph::append_swap( circuit& circ, unsigned a, unsigned b ) const
+{
+  if ( !has_edge( a, b ) )
+  {
+    std::swap( a, b );
+  }
+
+  append_cnot( circ, a, b );
+  append_adjacent_cnot( circ, b, a );
+  append_cnot( circ, a, b );
+}
+
+std::vector<unsigned> coupling_graph::path( unsigned from, unsigned to ) const
+{
+  std::vector<unsigned> p;
+  while ( from != to )
+  {
+    from = next_hop[from * _num_qubits + to];
+    p.push_back( from );
+  }
+  return p;
+}
+
+coupling_graph read_coupling_graph( const std::string& filename )
+{
+  std::ifstream in( filename.c_str(), std::ifstream::in );
+  if ( !in.is_open() )
+  {
+    throw boost::str( boost::format( "cannot open coupling graph %s" ) % filename );
+  }
+
+  unsigned num_qubits, v, w;
+  if ( !( in >> num_qubits ) )
+  {
+    throw boost::str( boost::format( "missing number of qubits in coupling graph %s" ) % filename );
+  }
+
+  std::vector<std::pair<unsigned, unsigned>> edges;
+  while ( in >> v >> w )
+  {
+    edges.push_back( {v, w} );
+  }
+
+  return coupling_graph( num_qubits, edges );
+}
+
+coupling_graph coupling_graph_from_architecture( const std::string& name )
+{
+  if ( name == "qx2" )
+  {
+    return coupling_graph( 5u, {{0, 1}, {0, 2}, {1, 2}, {3, 2}, {3, 4}, {4, 2}} );
+  }
+  else if ( name == "qx4" )
+  {
+    return coupling_graph( 5u, {{1, 0}, {2, 0}, {2, 1}, {3, 2}, {3, 4}, {2, 4}} );
+  }
+  else if ( name == "qx5" )
+  {
+    return coupling_graph( 16u, {{1, 0}, {1, 2}, {2, 3}, {3, 4}, {3, 14}, {5, 4}, {6, 5}, {6, 7}, {6, 11}, {7, 10}, {8, 7},
+                                 {9, 8}, {9, 10}, {11, 10}, {12, 5}, {12, 11}, {12, 13}, {13, 4}, {13, 14}, {15, 0}, {15, 2}, {15, 14}} );
+  }
+
+  throw boost::str( boost::format( "unknown architecture %s" ) % name );
+}
+
+std::vector<unsigned> find_placement( const circuit& circ, const coupling_graph& graph,
+                                      const properties::ptr& settings,
+                                      const properties::ptr& statistics )
+{
+  /* settings */
+  const auto num_threads      = get( settings, "num_threads",      0u );
+  const auto exhaustive_limit = get( settings, "exhaustive_limit", 40320u );
+  const auto verbose          = get( settings, "verbose",          false );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto k = circ.lines();
+  const auto n = graph.num_qubits();
+
+  if ( k > n )
+  {
+    throw boost::str( boost::format( "circuit has %d lines, but the coupling graph only %d qubits" ) % k % n );
+  }
+
+  const auto interactions = collect_interactions( circ );
+
+  work_stealing_pool pool( num_threads );
+
+  /* best (cost, candidate) per worker; ties are broken by the candidate for determinism */
+  using result_t = std::pair<unsigned long long, unsigned long long>;
+  std::vector<result_t> best( pool.num_threads(), result_t( std::numeric_limits<unsigned long long>::max(), 0ull ) );
+  std::vector<unsigned long long> candidates( pool.num_threads(), 0ull );
+
+  std::vector<unsigned> placement;
+  const auto count = num_placements( k, n, exhaustive_limit );
+
+  if ( count <= exhaustive_limit )
+  {
+    if ( verbose )
+    {
+      std::cout << boost::format( "[i] evaluate all %d placements" ) % count << std::endl;
+    }
+
+    pool.parallel_for( 0u, count, [&]( std::size_t i, unsigned worker ) {
+        const auto cost = placement_cost( graph, interactions, decode_placement( i, k, n ) );
+        best[worker] = std::min( best[worker], result_t( cost, i ) );
+        ++candidates[worker];
+      }, 64u );
+
+    placement = decode_placement( std::min_element( best.begin(), best.end() )->second, k, n );
+  }
+  else
+  {
+    if ( verbose )
+    {
+      std::cout << boost::format( "[i] local search from %d start qubits" ) % n << std::endl;
+    }
+
+    std::vector<std::vector<unsigned>> placements( n );
+    pool.parallel_for( 0u, n, [&]( std::size_t s, unsigned worker ) {
+        placements[s] = greedy_placement( graph, interactions, k, s );
+        const auto cost = improve_placement( graph, interactions, placements[s], candidates[worker] );
+        best[worker] = std::min( best[worker], result_t( cost, s ) );
+      } );
+
+    placement = placements[std::min_element( best.begin(), best.end() )->second];
+  }
+
+  const auto cost = placement_cost( graph, interactions, placement );
+  set( statistics, "cost", static_cast<unsigned>( std::min<unsigned long long>( cost, coupling_graph::infinity ) ) );
+  set( statistics, "num_candidates", std::accumulate( candidates.begin(), candidates.end(), 0ull ) );
+
+  return placement;
+}
+
+circuit coupling_graph_mapping( const circuit& circ, const coupling_graph& graph,
+                                std::vector<unsigned> placement,
+                                const properties::ptr& settings,
+                                const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto n = graph.num_qubits();
+
+  for ( const auto& g : circ )
+  {
+    if ( !g.controls().empty() && !( is_toffoli( g ) && g.controls().size() <= 2u ) && !( is_v( g ) && g.controls().size() == 1u ) )
+    {
+      throw std::string( "only single-qubit gates, CNOTs, controlled V gates, and Toffoli gates with two controls can be mapped" );
+    }
+  }
+
+  if ( placement.empty() )
+  {
+    placement = find_placement( circ, graph, settings, statistics );
+  }
+
+  if ( placement.size() != circ.lines() )
+  {
+    throw std::string( "placement must have one qubit for each line" );
+  }
+  std::vector<bool> used( n, false );
+  for ( auto q : placement )
+  {
+    if ( q >= n || used[q] )
+    {
+      throw std::string( "placement must map lines to distinct qubits of the coupling graph" );
+    }
+    used[q] = true;
+  }
+
+  /* lines are placed on their physical qubits, the other qubits are added */
+  circuit placed;
+  copy_metadata( circ, placed );
+  placed.set_lines( n );
+
+  std::vector<std::string> inputs( n ), outputs( n );
+  std::vector<constant> constants( n );
+  std::vector<bool> garbage( n, false );
+  for ( auto q = 0u; q < n; ++q )
+  {
+    inputs[q] = boost::str( boost::format( "i%d" ) % q );
+    outputs[q] = boost::str( boost::format( "o%d" ) % q );
+  }
+  for ( auto l = 0u; l < circ.lines(); ++l )
+  {
+    const auto q = placement[l];
+    inputs[q] = circ.inputs()[l];
+    outputs[q] = circ.outputs()[l];
+    constants[q] = circ.constants()[l];
+    garbage[q] = circ.garbage()[l];
+  }
+  placed.set_inputs( inputs );
+  placed.set_outputs( outputs );
+  placed.set_constants( constants );
+  placed.set_garbage( garbage );
+
+  for ( const auto& g : circ )
+  {
+    auto& ng = placed.append_gate();
+    ng = g;
+    remap_gate( ng, placement );
+  }
+
+  /* Toffoli gates are decomposed with the cached CNOT costs */
+  auto costs = graph.cost_matrix();
+  placed = transform_tof_clif( placed, costs, 3u );
+
+  circuit result;
+  copy_metadata( placed, result );
+
+  for ( const auto& g : placed )
+  {
+    if ( g.controls().empty() )
+    {
+      result.append_gate() = g;
+      continue;
+    }
+
+    const auto& c = g.controls().front();
+    auto control = c.line();
+    auto target = g.targets().front();
+
+    /* the coupling graph only supports positive controls, a negative control
+       is realized by inverting the control qubit around the gate */
+    if ( !c.polarity() )
+    {
+      append_not( result, c.line() );
+    }
+
+    if ( is_toffoli( g ) )
+    {
+      graph.append_routed_cnot( result, control, target );
+    }
+    else
+    {
+      /* controlled V in Clifford+T, CNOTs in the cheaper direction */
+      const auto adjoint = boost::any_cast<v_tag>( g.type() ).adjoint;
+      const auto v_target = target;
+      if ( graph.cost( target, control ) < graph.cost( control, target ) )
+      {
+        std::swap( control, target );
+      }
+
+      append_hadamard( result, v_target );
+      graph.append_routed_cnot( result, control, target );
+      append_pauli( result, target, pauli_axis::Z, 4u, !adjoint );
+      graph.append_routed_cnot( result, control, target );
+      append_pauli( result, control, pauli_axis::Z, 4u, adjoint );
+      append_pauli( result, target, pauli_axis::Z, 4u, adjoint );
+      append_hadamard( result, v_target );
+    }
+
+    if ( !c.polarity() )
+    {
+      append_not( result, c.line() );
+    }
+  }
+
+  return result;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,188 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file coupling_graph.hpp
+ *
+ * @brief Routing of Clifford+T circuits onto arbitrary coupling graphs
+ *
+ * A coupling graph has one vertex per physical qubit and a directed edge
+ * (c, t) for each CNOT(c, t) that is supported by the architecture.  On
+ * construction, the costs of all CNOTs are precomputed and cached: a CNOT
+ * is realized by moving one of its qubits next to the other one with SWAP
+ * gates along a shortest path, applying the (possibly reversed) CNOT, and
+ * moving the qubit back.  Costs are the number of gates that are added to
+ * the circuit, i.e., 4 Hadamard gates for a reversed CNOT and 3 CNOTs (plus
+ * 4 Hadamard gates if the edge is not bidirectional) for each SWAP.
+ *
+ * All matrices are stored row-major in contiguous vectors.
+ *
+ * @author Gerhard Dueck
+ * @since  2.4
+ */
+
+#ifndef COUPLING_GRAPH_HPP
+#define COUPLING_GRAPH_HPP
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <core/properties.hpp>
+#include <reversible/circuit.hpp>
+
+namespace cirkit
+{
+
+class coupling_graph
+{
+public:
+  /* edges are pairs (control, target) */
+  coupling_graph( unsigned num_qubits, const std::vector<std::pair<unsigned, unsigned>>& edges );
+
+  inline unsigned num_qubits() const { return _num_qubits; }
+
+  inline bool has_edge( unsigned control, unsigned target ) const { return adjacency[control * _num_qubits + target]; }
+
+  /* number of additional gates to realize CNOT( control, target ) */
+  inline unsigned cost( unsigned control, unsigned target ) const { return routes[control * _num_qubits + target].cost; }
+
+  /* true, if every CNOT can be realized */
+  bool is_connected() const;
+
+  /* cost matrix as expected by transform_tof_clif */
+  std::vector<std::vector<unsigned>> cost_matrix() const;
+
+  /* appends CNOT( control, target ) with all SWAP gates and Hadamard gates
+     that are required to realize it */
+  void append_routed_cnot( circuit& circ, unsigned control, unsigned target ) const;
+
+  void print( std::ostream& os ) const;
+
+  static const unsigned infinity;
+
+private:
+  struct route
+  {
+    unsigned cost = 0u;
+    unsigned meet = 0u;            /* qubit to which the moving qubit is swapped */
+    bool     move_target = false;  /* target moves next to control (otherwise control moves) */
+  };
+
+  void compute_distances();
+  void compute_routes();
+
+  /* number of additional gates to apply CNOT( control, target ) on adjacent qubits */
+  unsigned reverse_cost( unsigned control, unsigned target ) const;
+  unsigned swap_cost( unsigned a, unsigned b ) const;
+
+  void append_adjacent_cnot( circuit& circ, unsigned control, unsigned target ) const;
+  void append_swap( circuit& circ, unsigned a, unsigned b ) const;
+
+  /* qubits on the shortest path from (excluding) from to (including) to */
+  std::vector<unsigned> path( unsigned from, unsigned to ) const;
+
+private:
+  unsigned              _num_qubits;
+  std::vector<char>     adjacency; /* directed edges */
+  std::vector<unsigned> distance;  /* SWAP costs of shortest paths */
+  std::vector<unsigned> next_hop;  /* successor on shortest path */
+  std::vector<route>    routes;
+};
+
+/**
+ * @brief Reads a coupling graph
+ *
+ * The first number is the number of qubits, followed by one pair
+ * `control target` for each supported CNOT.  This is the same format as the
+ * one read by the `graph` command.
+ */
+coupling_graph read_coupling_graph( const std::string& filename );
+
+/**
+ * @brief Coupling graphs of IBM architectures
+ *
+ * Supported names are `qx2`, `qx4` (5 qubits each), and `qx5` (16 qubits).
+ */
+coupling_graph coupling_graph_from_architecture( const std::string& name );
+
+/**
+ * @brief Finds a placement of circuit lines on physical qubits
+ *
+ * Returns a vector that maps each line of circ to a physical qubit, such
+ * that the weighted sum of the CNOT costs is small.  If the number of
+ * injective placements does not exceed `exhaustive_limit`, all of them are
+ * evaluated in parallel.  Otherwise, a greedy placement from each physical
+ * qubit is improved with local search, in parallel for all start qubits.
+ *
+ * @settings
+ *
+   |------------------+------------------------------------------------+---------|
+   | Settings         | Description                                    | Default |
+   |------------------+------------------------------------------------+---------|
+   | num_threads      | Number of threads (0: all cores)               | 0u      |
+   | exhaustive_limit | Maximum number of placements for exhaustive    | 40320u  |
+   | verbose          | Be verbose                                     | false   |
+   |------------------+------------------------------------------------+---------|
+ *
+ * @statistics
+ *
+   |----------------+-----------------------------------------------------|
+   | Statistics     | Description                                         |
+   |----------------+-----------------------------------------------------|
+   | runtime        | Runtime in seconds                                  |
+   | cost           | Estimated number of additional gates                |
+   | num_candidates | Number of evaluated placements                      |
+   |----------------+-----------------------------------------------------|
+ */
+std::vector<unsigned> find_placement( const circuit& circ, const coupling_graph& graph,
+                                      const properties::ptr& settings = properties::ptr(),
+                                      const properties::ptr& statistics = properties::ptr() );
+
+/**
+ * @brief Maps a circuit onto a coupling graph
+ *
+ * The circuit may contain Clifford+T gates, NOT gates, CNOT gates, controlled
+ * V gates, and Toffoli gates with two controls.  The result has one line
+ * for each physical qubit, line l of circ is mapped to qubit placement[l].
+ * If placement is empty, it is computed with find_placement (settings and
+ * statistics are passed to it).
+ */
+circuit coupling_graph_mapping( const circuit& circ, const coupling_graph& graph,
+                                std::vector<unsigned> placement = std::vector<unsigned>(),
+                                const properties::ptr& settings = properties::ptr(),
+                                const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
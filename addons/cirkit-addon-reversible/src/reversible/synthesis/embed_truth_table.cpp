@@ -26,7 +26,11 @@
 
 #include "embed_truth_table.hpp"
 
+#include <cstdint>
+#include <limits>
+
 #include <boost/assign/std/vector.hpp>
+#include <boost/dynamic_bitset.hpp>
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
@@ -76,20 +80,88 @@ unsigned additional_garbage( const binary_truth_table& base, std::vector<unsigne
   return (unsigned)ceil( log( (double)mu ) / log( 2.0 ) );
 }
 
-struct minimal_hamming_distance
+/* free output values, sorted and with lazily removed entries */
+class free_values
 {
-  explicit minimal_hamming_distance( unsigned compare_to ) : compare_to( compare_to ) {}
+public:
+  free_values( const boost::dynamic_bitset<>& used ) : used( used )
+  {
+    for ( auto v = 0u; v < used.size(); ++v )
+    {
+      if ( !used[v] ) { values += v; }
+    }
+    count = values.size();
+  }
+
+  /* smallest free value with minimal hamming distance to i */
+  unsigned closest( unsigned i, unsigned bw )
+  {
+    /* enumerate values by increasing distance as long as this is cheaper than a scan */
+    std::uint64_t enumerated = 0u;
+    std::uint64_t level = 1u; /* binomial( bw, d ) */
+    for ( auto d = 0u; d <= bw && enumerated + level <= count; ++d )
+    {
+      auto best = std::numeric_limits<unsigned>::max();
+      if ( d == 0u )
+      {
+        if ( !used[i] ) { best = i; }
+      }
+      else
+      {
+        /* all masks with d bits in increasing order (Gosper's hack) */
+        for ( std::uint64_t mask = ( std::uint64_t( 1u ) << d ) - 1u; mask < ( std::uint64_t( 1u ) << bw ); )
+        {
+          const auto v = i ^ static_cast<unsigned>( mask );
+          if ( !used[v] && v < best ) { best = v; }
+
+          const auto c = mask & -mask;
+          const auto r = mask + c;
+          mask = ( ( ( r ^ mask ) >> 2u ) / c ) | r;
+        }
+      }
+
+      if ( best != std::numeric_limits<unsigned>::max() )
+      {
+        return best;
+      }
+
+      enumerated += level;
+      level = level * ( bw - d ) / ( d + 1u );
+    }
+
+    /* compact the list if most entries are used */
+    if ( 2u * count < values.size() )
+    {
+      values.erase( std::remove_if( values.begin(), values.end(), [this]( unsigned v ) { return used[v]; } ), values.end() );
+    }
+
+    auto best = std::numeric_limits<unsigned>::max();
+    auto best_distance = bw + 1u;
+    for ( auto v : values )
+    {
+      if ( used[v] ) { continue; }
+      const auto distance = hamming_distance( i, v );
+      if ( distance < best_distance )
+      {
+        best = v;
+        best_distance = distance;
+      }
+    }
+    return best;
+  }
 
-  bool operator()( unsigned x, unsigned y ) const
+  void remove()
   {
-    return hamming_distance( compare_to, x ) < hamming_distance( compare_to, y );
+    --count;
   }
 
 private:
-  unsigned compare_to;
+  const boost::dynamic_bitset<>& used;
+  std::vector<unsigned>          values;
+  std::uint64_t                  count;
 };
 
-bool embed_truth_table( binary_truth_table& spec, const binary_truth_table& base, const properties::ptr& settings, const properties::ptr& statistics )
+bool embed_truth_table( dense_truth_table& spec, const binary_truth_table& base, const properties::ptr& settings, const properties::ptr& statistics )
 {
   std::string garbage_name           = get<std::string>( settings, "garbage_name", "g" );
   std::vector<unsigned> output_order = get<std::vector<unsigned> >( settings, "output_order", std::vector<unsigned>() );
@@ -106,16 +178,17 @@ bool embed_truth_table( binary_truth_table& spec, const binary_truth_table& base
   assert( base.num_inputs() <= base.num_outputs() + ag );
 
   /* new number of bits */
-  std::map<unsigned, unsigned> new_spec;
   unsigned new_bw = base.num_outputs() + ag;
+  assert( new_bw < 32u );
 
-  /* all outputs which are left */
-  std::vector<unsigned> all_outputs( 1u << new_bw );
-  std::copy( boost::make_counting_iterator( 0u ), boost::make_counting_iterator( 1u << new_bw ), all_outputs.begin() );
+  spec = dense_truth_table( new_bw, new_bw );
+
+  /* rows that are assigned and output values that are taken */
+  boost::dynamic_bitset<> assigned( 1u << new_bw );
+  boost::dynamic_bitset<> used( 1u << new_bw );
 
   {
     /* greedy method */
-    std::map<unsigned,std::vector<unsigned> > output_assignments;
 
     /* output order */
     if ( output_order.size() != base.num_outputs() )
@@ -134,33 +207,18 @@ bool embed_truth_table( binary_truth_table& spec, const binary_truth_table& base
       }
     }
 
-    /* since you append the garbage to the end, just count the numbers */
-    for ( std::vector<unsigned>::const_iterator itValue = values.begin(); itValue != values.end(); ++itValue )
+    /* garbage values from 0..0 to 1..1 rebased to the left positions, they are increasing */
+    std::vector<unsigned> garbage_values;
+    for ( unsigned j = 0u; j < ( 1u << ag ); ++j )
     {
-      unsigned base = 0u;
-      for ( unsigned j = 0u; j < output_order.size(); ++j )
+      unsigned assignment = 0u;
+      for ( unsigned k = 0; k < ag; ++k )
       {
-        unsigned bit_in_value = !!( *itValue & ( 1u << ( output_order.size() - 1u - j ) ) );
-        unsigned bit_pos_in_base = new_bw - 1u - output_order.at( j );
-        base |= ( bit_in_value << bit_pos_in_base );
-      }
-
-      /* create the values from (value)0..0 to (value)1..1 with rebaset to output_order */
-      std::vector<unsigned> assignments;
-
-      for ( unsigned j = 0u; j < ( 1u << ag ); ++j )
-      {
-        unsigned assignment = base;
-        for ( unsigned k = 0; k < ag; ++k )
-        {
-          unsigned bit_in_value = !!( j & ( 1u << ( ag - 1u - k ) ) );
-          unsigned bit_pos_in_base = new_bw - 1u - left_positions.at( k );
-          assignment |= ( bit_in_value << bit_pos_in_base );
-        }
-        assignments += assignment;
+        unsigned bit_in_value = !!( j & ( 1u << ( ag - 1u - k ) ) );
+        unsigned bit_pos_in_base = new_bw - 1u - left_positions.at( k );
+        assignment |= ( bit_in_value << bit_pos_in_base );
       }
-
-      output_assignments[*itValue] = assignments;
+      garbage_values += assignment;
     }
 
     /* truth table is in order */
@@ -170,38 +228,56 @@ bool embed_truth_table( binary_truth_table& spec, const binary_truth_table& base
       binary_truth_table::cube_type in( it->first.first, it->first.second );
       unsigned number_in = truth_table_cube_to_number( in );
 
-      /* output value */
+      /* output value rebased to output_order */
       binary_truth_table::cube_type out( it->second.first, it->second.second );
       unsigned number = truth_table_cube_to_number( out );
 
-      /* best suiting element */
-      std::vector<unsigned>::iterator bestFit = std::min_element( output_assignments[number].begin(), output_assignments[number].end(), minimal_hamming_distance( number_in ) );
-      new_spec.insert( std::make_pair( number_in, *bestFit ) );
+      unsigned value_base = 0u;
+      for ( unsigned j = 0u; j < output_order.size(); ++j )
+      {
+        unsigned bit_in_value = !!( number & ( 1u << ( output_order.size() - 1u - j ) ) );
+        unsigned bit_pos_in_base = new_bw - 1u - output_order.at( j );
+        value_base |= ( bit_in_value << bit_pos_in_base );
+      }
+
+      /* best suiting element that is not yet taken, first one on ties */
+      auto best_fit = std::numeric_limits<unsigned>::max();
+      auto best_distance = new_bw + 1u;
+      for ( auto g : garbage_values )
+      {
+        const auto assignment = value_base | g;
+        if ( used[assignment] ) { continue; }
+
+        const auto distance = hamming_distance( number_in, assignment );
+        if ( distance < best_distance )
+        {
+          best_fit = assignment;
+          best_distance = distance;
+        }
+      }
+      assert( best_fit != std::numeric_limits<unsigned>::max() );
 
-      /* remove element from list */
-      all_outputs.erase( std::find( all_outputs.begin(), all_outputs.end(), *bestFit ) );
-      output_assignments[number].erase( bestFit );
+      if ( !assigned[number_in] )
+      {
+        assigned.set( number_in );
+        spec.set_row_value( number_in, best_fit );
+      }
+      used.set( best_fit );
     }
   }
 
+  free_values left( used );
   for ( unsigned i = 0u; i < ( 1u << new_bw ); ++i )
   {
-    if ( new_spec.find( i ) == new_spec.end() )
+    if ( !assigned[i] )
     {
-      std::vector<unsigned>::iterator bestFit = std::min_element( all_outputs.begin(), all_outputs.end(), minimal_hamming_distance( i ) );
-      new_spec.insert( std::make_pair( i, *bestFit ) );
-      all_outputs.erase( bestFit );
+      const auto best_fit = left.closest( i, new_bw );
+      spec.set_row_value( i, best_fit );
+      used.set( best_fit );
+      left.remove();
     }
   }
 
-  spec.clear();
-
-  for ( std::map<unsigned, unsigned>::const_iterator it = new_spec.begin(); it != new_spec.end(); ++it )
-  {
-    spec.add_entry( number_to_truth_table_cube( it->first, new_bw ),
-                    number_to_truth_table_cube( it->second, new_bw ) );
-  }
-
   /* meta-data */
   std::vector<std::string> inputs( new_bw, "i" );
   std::fill( inputs.begin(), inputs.begin() + cons, "0" );
@@ -232,6 +308,18 @@ bool embed_truth_table( binary_truth_table& spec, const binary_truth_table& base
   return true;
 }
 
+bool embed_truth_table( binary_truth_table& spec, const binary_truth_table& base, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  dense_truth_table dense;
+  if ( !embed_truth_table( dense, base, settings, statistics ) )
+  {
+    return false;
+  }
+
+  dense_truth_table_to_truth_table( dense, spec );
+  return true;
+}
+
 bool embed_truth_table( binary_truth_table& spec, const tt& base, const properties::ptr& settings, const properties::ptr& statistics )
 {
   const auto rbase = truth_table_from_bitset_direct( base );
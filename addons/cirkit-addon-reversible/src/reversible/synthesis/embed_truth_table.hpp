@@ -37,6 +37,7 @@
 #define EMBED_TRUTH_TABLE_HPP
 
 #include <classical/utils/truth_table_utils.hpp>
+#include <reversible/dense_truth_table.hpp>
 #include <reversible/truth_table.hpp>
 #include <reversible/synthesis/synthesis.hpp>
 
@@ -109,6 +110,19 @@ bool embed_truth_table( binary_truth_table& spec, const tt& base,
                         const properties::ptr& settings = properties::ptr(),
                         const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * @brief Embedding into a dense truth table
+ *
+ * Same embedding as above, taken output values are kept in a bitset and the
+ * remaining rows are filled by enumerating values with increasing hamming
+ * distance, which avoids the quadratic search over all output values.
+ *
+ * @since  2.4
+ */
+bool embed_truth_table( dense_truth_table& spec, const binary_truth_table& base,
+                        const properties::ptr& settings = properties::ptr(),
+                        const properties::ptr& statistics = properties::ptr() );
+
 /**
  * @brief Functor for the \ref revkit::embed_truth_table "embed_truth_table" algorithm
  *
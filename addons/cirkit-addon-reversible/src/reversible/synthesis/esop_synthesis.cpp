@@ -447,7 +447,8 @@ bool esop_synthesis( circuit& circ, const gia_graph& gia, const properties::ptr&
   return esop_synthesis( circ, esop, gia.num_inputs(), gia.num_outputs(), settings, statistics );
 }
 
-bool esop_synthesis( circuit& circ, const std::vector<cube2>& cubes, unsigned ninputs, const properties::ptr& settings, const properties::ptr& statistics )
+template<typename Cube>
+bool esop_synthesis( circuit& circ, const std::vector<Cube>& cubes, unsigned ninputs, const properties::ptr& settings, const properties::ptr& statistics )
 {
   const auto line_map = get( settings, "line_map", std::vector<unsigned>() );
 
@@ -476,9 +477,9 @@ bool esop_synthesis( circuit& circ, const std::vector<cube2>& cubes, unsigned ni
     gate::control_container controls;
     for ( auto i = 0u; i < ninputs; ++i )
     {
-      if ( ( cube.mask >> i ) & 1 )
+      if ( cube.has_var( i ) )
       {
-        controls.push_back( make_var( line_map.empty() ? i : line_map[i], ( cube.bits >> i ) & 1 ) );
+        controls.push_back( make_var( line_map.empty() ? i : line_map[i], cube.polarity( i ) ) );
       }
     }
     append_toffoli( circ, controls, ninputs );
@@ -487,6 +488,11 @@ bool esop_synthesis( circuit& circ, const std::vector<cube2>& cubes, unsigned ni
   return true;
 }
 
+template bool esop_synthesis<cube2>( circuit&, const std::vector<cube2>&, unsigned, const properties::ptr&, const properties::ptr& );
+template bool esop_synthesis<cube64>( circuit&, const std::vector<cube64>&, unsigned, const properties::ptr&, const properties::ptr& );
+template bool esop_synthesis<cube128>( circuit&, const std::vector<cube128>&, unsigned, const properties::ptr&, const properties::ptr& );
+template bool esop_synthesis<cube256>( circuit&, const std::vector<cube256>&, unsigned, const properties::ptr&, const properties::ptr& );
+
 pla_blif_synthesis_func esop_synthesis_func( properties::ptr settings, properties::ptr statistics )
 {
   pla_blif_synthesis_func f = [&settings, &statistics]( circuit& circ, const std::string& filename ) {
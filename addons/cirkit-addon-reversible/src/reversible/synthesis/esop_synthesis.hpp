@@ -40,6 +40,7 @@
 
 #include <core/properties.hpp>
 #include <classical/utils/cube2.hpp>
+#include <classical/utils/wide_cube.hpp>
 #include <classical/abc/abc_api.hpp>
 #include <classical/abc/gia/gia.hpp>
 #include <reversible/circuit.hpp>
@@ -210,7 +211,9 @@ bool esop_synthesis( circuit& circ, const gia_graph::esop_ptr& esop_cover, unsig
 
 bool esop_synthesis( circuit& circ, const gia_graph& gia, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
-bool esop_synthesis( circuit& circ, const std::vector<cube2>& cubes, unsigned ninputs, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
+/* Cube is cube2, cube64, cube128, or cube256 */
+template<typename Cube>
+bool esop_synthesis( circuit& circ, const std::vector<Cube>& cubes, unsigned ninputs, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 /**
  * @brief Functor for the \ref revkit::esop_synthesis "esop_synthesis" algorithm
@@ -41,6 +41,7 @@
 #include <core/utils/temporary_filename.hpp>
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/functions/linear_classification.hpp>
 #include <classical/functions/spectral_canonization.hpp>
 #include <classical/io/read_blif.hpp>
@@ -404,6 +405,161 @@ private:
   std::vector<int> output_luts;
 };
 
+/******************************************************************************
+ * LUT synthesis                                                              *
+ ******************************************************************************/
+
+inline void append_circuit_fast( circuit& dest, const circuit& src )
+{
+  auto& dest_s = boost::get<standard_circuit>( static_cast<circuit_variant&>( dest ) );
+  const auto& src_s = boost::get<standard_circuit>( static_cast<const circuit_variant&>( src ) );
+
+  boost::push_back( dest_s.gates, src_s.gates );
+  dest_s.annotations.insert( src_s.annotations.begin(), src_s.annotations.end() );
+}
+
+inline circuit get_fast_circuit( unsigned lines )
+{
+  standard_circuit c;
+  c.lines = lines;
+  return c;
+}
+
+void synthesize_lut_direct( circuit& circ, const xmg_graph& xmg, int index,
+                            const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla,
+                            const lhrs_params& params, lhrs_stats& stats )
+{
+  const auto lut = xmg_extract_lut( xmg, index );
+
+  stg_map_esop( circ, lut, line_map, params.map_esop_params, stats.map_esop_stats );
+}
+
+void synthesize_lut_lut_based( circuit& circ, const xmg_graph& xmg, int index,
+                               const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla,
+                               const lhrs_params& params, lhrs_stats& stats )
+{
+  const auto lut = xmg_extract_lut( xmg, index );
+
+  if ( params.max_func_size == 0u )
+  {
+    params.map_luts_params.max_cut_size = params.map_precomp_params.class_method == 0u ? 5 : 4;
+  }
+  else
+  {
+    params.map_luts_params.max_cut_size = params.max_func_size;
+  }
+
+  stg_map_luts( circ, lut, line_map, clean_ancilla, params.map_luts_params, stats.map_luts_stats );
+}
+
+void synthesize_lut_pick_best( circuit& circ, const xmg_graph& xmg, int index,
+                               const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla,
+                               const lhrs_params& params, lhrs_stats& stats )
+{
+  using candidate_t = std::pair<circuit, cost_t>;
+  std::vector<candidate_t> candidates;
+
+  const auto lut = xmg_extract_lut( xmg, index );
+
+  const auto old_strategy = params.map_luts_params.strategy;
+  for ( const auto& strategy : {stg_map_luts_params::mapping_strategy::mindb, stg_map_luts_params::mapping_strategy::bestfit} )
+  {
+    /* cut size 4 */
+    params.map_luts_params.strategy = strategy;
+    {
+      auto lcirc = get_fast_circuit( circ.lines() );
+      params.map_luts_params.max_cut_size = 4;
+      stg_map_luts( lcirc, lut, line_map, clean_ancilla, params.map_luts_params, stats.map_luts_stats );
+      if ( lcirc.num_gates() )
+      {
+        candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
+      }
+    }
+
+    /* cut size 5 */
+    if ( params.map_precomp_params.class_method == 0u )
+    {
+      auto lcirc = get_fast_circuit( circ.lines() );
+      params.map_luts_params.max_cut_size = 5;
+      stg_map_luts( lcirc, lut, line_map, clean_ancilla, params.map_luts_params, stats.map_luts_stats );
+      if ( lcirc.num_gates() )
+      {
+        candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
+      }
+    }
+  }
+
+  params.map_luts_params.strategy = old_strategy;
+
+  if ( !candidates.empty() )
+  {
+    const auto best_candidate = std::min_element( candidates.begin(), candidates.end(),
+                                                  []( const candidate_t& c1, const candidate_t& c2 ) {
+                                                    return c1.second < c2.second;
+                                                  } );
+
+    append_circuit_fast( circ, best_candidate->first );
+    ++stats.num_decomp_lut;
+    return;
+  }
+
+  stg_map_esop( circ, lut, line_map, params.map_esop_params, stats.map_esop_stats );
+}
+
+void synthesize_lut_shannon( circuit& circ, const xmg_graph& xmg, int index,
+                             const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla,
+                             const lhrs_params& params, lhrs_stats& stats )
+{
+  const auto lut = xmg_extract_lut( xmg, index );
+
+  stg_map_shannon( circ, lut, line_map, clean_ancilla, params.map_shannon_params, stats.map_shannon_stats );
+}
+
+/* appends the single-target gates for the LUT rooted at index to circ */
+void synthesize_lut( circuit& circ, const xmg_graph& xmg, int index,
+                     const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla,
+                     const lhrs_params& params, lhrs_stats& stats )
+{
+  switch ( params.mapping_strategy )
+  {
+  case lhrs_mapping_strategy::direct:
+    synthesize_lut_direct( circ, xmg, index, line_map, clean_ancilla, params, stats );
+    break;
+  case lhrs_mapping_strategy::lut_based_min_db:
+  case lhrs_mapping_strategy::lut_based_best_fit:
+    synthesize_lut_lut_based( circ, xmg, index, line_map, clean_ancilla, params, stats );
+    break;
+  case lhrs_mapping_strategy::lut_based_pick_best:
+    synthesize_lut_pick_best( circ, xmg, index, line_map, clean_ancilla, params, stats );
+    break;
+  case lhrs_mapping_strategy::shannon:
+    synthesize_lut_shannon( circ, xmg, index, line_map, clean_ancilla, params, stats );
+    break;
+  }
+}
+
+/* accumulates the statistics of LUT synthesis in a worker thread */
+void add_lut_synthesis_stats( lhrs_stats& stats, const lhrs_stats& other )
+{
+  stats.num_decomp_default                += other.num_decomp_default;
+  stats.num_decomp_lut                    += other.num_decomp_lut;
+
+  stats.map_esop_stats.cover_runtime      += other.map_esop_stats.cover_runtime;
+  stats.map_esop_stats.exorcism_runtime   += other.map_esop_stats.exorcism_runtime;
+  stats.map_luts_stats.mapping_runtime    += other.map_luts_stats.mapping_runtime;
+  stats.map_precomp_stats.class_runtime   += other.map_precomp_stats.class_runtime;
+
+  auto& precomp = stats.map_precomp_stats;
+  for ( auto i = 0u; i < precomp.class_counter.size(); ++i )
+  {
+    for ( auto j = 0u; j < precomp.class_counter[i].size(); ++j )
+    {
+      precomp.class_counter[i][j] += other.map_precomp_stats.class_counter[i][j];
+    }
+    precomp.class_hash[i].insert( other.map_precomp_stats.class_hash[i].begin(), other.map_precomp_stats.class_hash[i].end() );
+  }
+}
+
 /******************************************************************************
  * Manager                                                                    *
  ******************************************************************************/
@@ -425,9 +581,19 @@ public:
   {
     clear_circuit( circ );
 
-    const auto lines = order_heuristic->compute_steps();
+    const auto lines = [this]() {
+      increment_timer t( &stats.order_runtime );
+      return order_heuristic->compute_steps();
+    }();
     circ.set_lines( lines );
 
+    /* dump files are numbered in synthesis order, which requires sequential synthesis */
+    if ( params.num_threads != 1u && !params.onlylines && params.map_esop_params.dumpfile.empty() )
+    {
+      increment_timer t( &stats.synthesis_runtime );
+      synthesize_luts_parallel();
+    }
+
     std::vector<std::string> inputs( lines, "0" );
     std::vector<std::string> outputs( lines, "0" );
     std::vector<constant> constants( lines, false );
@@ -495,14 +661,14 @@ public:
       case lut_order_heuristic::compute:
         if ( !params.onlylines )
         {
-          synthesize_node( step.node, false, step.clean_ancilla );
+          synthesize_node( step.node, false, step.clean_ancilla, step_index - 1u );
         }
         break;
 
       case lut_order_heuristic::uncompute:
         if ( !params.onlylines )
         {
-          synthesize_node( step.node, true, step.clean_ancilla );
+          synthesize_node( step.node, true, step.clean_ancilla, step_index - 1u );
         }
         break;
       }
@@ -529,143 +695,72 @@ private:
     return mask;
   }
 
-  inline void synthesize_node( int index, bool lookup, const std::vector<unsigned>& clean_ancilla )
+  /* The order heuristic fixes the line of each LUT before any gate is
+   * created, hence the single-target gates of all compute and uncompute
+   * steps can be synthesized independently.  Each worker owns a copy of
+   * the parameters (LUT mapping modifies them) and its own statistics.
+   * The circuits are spliced in step order by synthesize_node. */
+  void synthesize_luts_parallel()
   {
-    /* track costs */
-    const auto begin = circ.num_gates();
-    const auto line_map = order_heuristic->compute_line_map( index );
-
-    switch ( params.mapping_strategy )
-    {
-    case lhrs_mapping_strategy::direct:
-      synthesize_node_direct( index, lookup, line_map, clean_ancilla );
-      break;
-    case lhrs_mapping_strategy::lut_based_min_db:
-    case lhrs_mapping_strategy::lut_based_best_fit:
-      synthesize_node_lut_based( index, lookup, line_map, clean_ancilla );
-      break;
-    case lhrs_mapping_strategy::lut_based_pick_best:
-      synthesize_node_pick_best( index, lookup, line_map, clean_ancilla );
-      break;
-    case lhrs_mapping_strategy::shannon:
-      synthesize_node_shannon( index, lookup, line_map, clean_ancilla );
-      break;
-    }
+    const auto& steps = order_heuristic->steps();
 
-    /* track costs */
-    if ( params.count_costs )
+    std::vector<unsigned> jobs;
+    for ( auto i = 0u; i < steps.size(); ++i )
     {
-      const auto end = circ.num_gates();
-      stats.gate_costs.push_back( costs( circ, begin, end, costs_by_gate_func( t_costs() ) ) );
-      stats.line_maps.push_back( line_map );
-      stats.affected_lines.push_back( get_index_vector( get_affected_lines( begin, end ) ) );
-      stats.clean_ancillas.push_back( clean_ancilla );
+      if ( steps[i].type == lut_order_heuristic::compute || steps[i].type == lut_order_heuristic::uncompute )
+      {
+        jobs.push_back( i );
+      }
     }
-  }
 
-  void synthesize_node_direct( int index, bool lookup, const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla )
-  {
-    const auto lut = xmg_extract_lut( xmg, index );
+    work_stealing_pool pool( params.num_threads );
+    std::vector<lhrs_params> local_params( pool.num_threads(), params );
+    std::vector<lhrs_stats> local_stats( pool.num_threads() );
 
-    const auto sp = pbar.subprogress();
-    stg_map_esop( circ, lut, line_map, params.map_esop_params, stats.map_esop_stats );
-  }
+    step_circuits.resize( steps.size() );
+    pool.parallel_for( 0u, jobs.size(), [&]( std::size_t j, unsigned worker ) {
+        const auto& step = steps[jobs[j]];
+        auto& lcirc = step_circuits[jobs[j]];
 
-  void synthesize_node_lut_based( int index, bool lookup, const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla )
-  {
-    const auto lut = xmg_extract_lut( xmg, index );
+        lcirc = get_fast_circuit( circ.lines() );
+        synthesize_lut( lcirc, xmg, step.node, order_heuristic->compute_line_map( step.node ), step.clean_ancilla,
+                        local_params[worker], local_stats[worker] );
+      } );
 
-    if ( params.max_func_size == 0u )
-    {
-      params.map_luts_params.max_cut_size = params.map_precomp_params.class_method == 0u ? 5 : 4;
-    }
-    else
+    for ( const auto& s : local_stats )
     {
-      params.map_luts_params.max_cut_size = params.max_func_size;
+      add_lut_synthesis_stats( stats, s );
     }
-
-    const auto sp = pbar.subprogress();
-    stg_map_luts( circ, lut, line_map, clean_ancilla, params.map_luts_params, stats.map_luts_stats );
-  }
-
-  inline void append_circuit_fast( const circuit& src )
-  {
-    auto& dest_s = boost::get<standard_circuit>( static_cast<circuit_variant&>( circ ) );
-    const auto& src_s = boost::get<standard_circuit>( static_cast<const circuit_variant&>( src ) );
-
-    boost::push_back( dest_s.gates, src_s.gates );
-  }
-
-  inline circuit get_fast_circuit() const
-  {
-    standard_circuit c;
-    c.lines = circ.lines();
-    return c;
   }
 
-  void synthesize_node_pick_best( int index, bool lookup, const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla )
+  inline void synthesize_node( int index, bool lookup, const std::vector<unsigned>& clean_ancilla, unsigned step_index )
   {
-    using candidate_t = std::pair<circuit, cost_t>;
-    std::vector<candidate_t> candidates;
-
-    const auto lut = xmg_extract_lut( xmg, index );
-
-    const auto sp = pbar.subprogress();
+    /* track costs */
+    const auto begin = circ.num_gates();
+    const auto line_map = order_heuristic->compute_line_map( index );
 
-    const auto old_strategy = params.map_luts_params.strategy;
-    for ( const auto& strategy : {stg_map_luts_params::mapping_strategy::mindb, stg_map_luts_params::mapping_strategy::bestfit} )
+    if ( !step_circuits.empty() )
     {
-      /* cut size 4 */
-      params.map_luts_params.strategy = strategy;
-      {
-        auto lcirc = get_fast_circuit();
-        params.map_luts_params.max_cut_size = 4;
-        stg_map_luts( lcirc, lut, line_map, clean_ancilla, params.map_luts_params, stats.map_luts_stats );
-        if ( lcirc.num_gates() )
-        {
-          candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
-        }
-      }
-
-      /* cut size 5 */
-      if ( params.map_precomp_params.class_method == 0u )
-      {
-        auto lcirc = get_fast_circuit();
-        params.map_luts_params.max_cut_size = 5;
-        stg_map_luts( lcirc, lut, line_map, clean_ancilla, params.map_luts_params, stats.map_luts_stats );
-        if ( lcirc.num_gates() )
-        {
-          candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
-        }
-      }
+      increment_timer t( &stats.splice_runtime );
+      append_circuit_fast( circ, step_circuits[step_index] );
     }
-
-    params.map_luts_params.strategy = old_strategy;
-
-    if ( !candidates.empty() )
+    else
     {
-      const auto best_candidate = std::min_element( candidates.begin(), candidates.end(),
-                                                    []( const candidate_t& c1, const candidate_t& c2 ) {
-                                                      return c1.second < c2.second;
-                                                    } );
-
-      append_circuit_fast( best_candidate->first );
-      ++stats.num_decomp_lut;
-      return;
+      const auto sp = pbar.subprogress();
+      synthesize_lut( circ, xmg, index, line_map, clean_ancilla, params, stats );
     }
 
-    stg_map_esop( circ, lut, line_map, params.map_esop_params, stats.map_esop_stats );
-  }
-
-  void synthesize_node_shannon( int index, bool lookup, const std::vector<unsigned>& line_map, const std::vector<unsigned>& clean_ancilla )
-  {
-    const auto lut = xmg_extract_lut( xmg, index );
-
-    const auto sp = pbar.subprogress();
-    stg_map_shannon( circ, lut, line_map, clean_ancilla, params.map_shannon_params, stats.map_shannon_stats );
+    /* track costs */
+    if ( params.count_costs )
+    {
+      const auto end = circ.num_gates();
+      stats.gate_costs.push_back( costs( circ, begin, end, costs_by_gate_func( t_costs() ) ) );
+      stats.line_maps.push_back( line_map );
+      stats.affected_lines.push_back( get_index_vector( get_affected_lines( begin, end ) ) );
+      stats.clean_ancillas.push_back( clean_ancilla );
+    }
   }
 
-
 private:
   circuit& circ;
   const xmg_graph& xmg;
@@ -674,6 +769,7 @@ private:
   lhrs_stats& stats;
 
   std::unordered_map<unsigned, circuit> computed_circuits;
+  std::vector<circuit> step_circuits; /* circuits of steps synthesized in parallel */
 
   std::shared_ptr<lut_order_heuristic> order_heuristic;
 
@@ -36,6 +36,7 @@
 #ifndef LHRS_PARAMS_HPP
 #define LHRS_PARAMS_HPP
 
+#include <cassert>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -69,11 +70,33 @@ struct lhrs_params
   {
   }
 
+  /* sub parameters are linked to the members of the copy */
+  lhrs_params( const lhrs_params& other )
+    : additional_ancilla( other.additional_ancilla ),
+      onlylines( other.onlylines ),
+      mapping_strategy( other.mapping_strategy ),
+      max_func_size( other.max_func_size ),
+      num_threads( other.num_threads ),
+      map_esop_params( other.map_esop_params ),
+      map_precomp_params( other.map_precomp_params ),
+      map_luts_params( other.map_luts_params ),
+      map_shannon_params( map_luts_params ),
+      progress( other.progress ),
+      verbose( other.verbose ),
+      count_costs( other.count_costs )
+  {
+    /* other.map_luts_params is linked as well, so the copy does not own its sub parameters */
+    assert( !map_luts_params.own_sub_params );
+    map_luts_params.map_esop_params    = &map_esop_params;
+    map_luts_params.map_precomp_params = &map_precomp_params;
+  }
+
   unsigned               additional_ancilla = 0u;
   bool                   onlylines          = false;                                       /* do not compute gates */
 
   lhrs_mapping_strategy  mapping_strategy   = lhrs_mapping_strategy::direct;               /* mapping strategy */
   unsigned               max_func_size      = 0u;                                          /* max function size for DB lookup, 0u: automatic based on class_method */
+  unsigned               num_threads        = 1u;                                          /* threads to synthesize LUTs after line allocation, 0u: number of cores */
 
   stg_map_esop_params         map_esop_params;
   stg_map_precomp_params      map_precomp_params;
@@ -113,7 +136,9 @@ struct lhrs_stats
   }
 
   double   runtime           = 0.0;
-  double   synthesis_runtime = 0.0;
+  double   order_runtime     = 0.0;  /* line allocation by order heuristic */
+  double   synthesis_runtime = 0.0;  /* LUT synthesis (wall clock, includes splicing) */
+  double   splice_runtime    = 0.0;  /* appending LUT circuits synthesized in parallel */
 
   unsigned num_decomp_default = 0u;
   unsigned num_decomp_lut     = 0u;
@@ -26,11 +26,11 @@
 
 #include "transformation_based_synthesis.hpp"
 
+#include <cstdint>
+
 #include <boost/assign/std/vector.hpp>
-#include <boost/range/algorithm.hpp>
+#include <boost/dynamic_bitset.hpp>
 
-#include <core/utils/bitset_utils.hpp>
-#include <core/utils/range_utils.hpp>
 #include <core/utils/timer.hpp>
 #include <reversible/circuit.hpp>
 #include <reversible/functions/add_gates.hpp>
@@ -38,7 +38,6 @@
 #include <reversible/functions/copy_metadata.hpp>
 #include <reversible/functions/fully_specified.hpp>
 #include <reversible/io/print_circuit.hpp>
-#include <reversible/utils/truth_table_helpers.hpp>
 
 #include "synthesis_utils_p.hpp"
 
@@ -56,106 +55,116 @@ enum direction_t
   direction_back, direction_front
 };
 
+/* reversible function as permutation with its inverse, inv[perm[x]] = x */
+struct permutation_t
+{
+  std::vector<std::uint32_t> perm;
+  std::vector<std::uint32_t> inv;
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
-/* returns true if all bits have been checked and false if while loop was broken */
-bool foreach_bit( const boost::dynamic_bitset<>& bits, std::function<bool(boost::dynamic_bitset<>::size_type)> func )
-{
-  auto bpos = bits.find_first();
-  while ( bpos != boost::dynamic_bitset<>::npos )
-  {
-    if ( !func( bpos ) ) return false;
-    bpos = bits.find_next( bpos );
-  }
-  return true;
-}
-
-gate::control_container get_control_lines_from_mask( const boost::dynamic_bitset<>& mask )
+/* bit b of a value corresponds to line lines - 1 - b */
+gate::control_container get_control_lines_from_mask( std::uint32_t mask, unsigned lines )
 {
   gate::control_container controls;
-  boost::dynamic_bitset<>::size_type pos = mask.find_first();
-  while ( pos != boost::dynamic_bitset<>::npos )
+  for ( auto pos = 0u; pos < lines; ++pos )
   {
-    controls += make_var( mask.size() - 1u - pos );
-    pos = mask.find_next( pos );
+    if ( ( mask >> pos ) & 1u )
+    {
+      controls += make_var( lines - 1u - pos );
+    }
   }
   return controls;
 }
 
-bitset_pair_vector_t& sort_truth_table( bitset_pair_vector_t& tt )
-{
-  typedef bitset_pair_vector_t::value_type value_type;
-  return boost::sort( tt, []( const value_type& p1, const value_type& p2 ) { return p1.first < p2.first; } );
-}
-
-unsigned hamming_distance( const std::pair<boost::dynamic_bitset<>, boost::dynamic_bitset<>>& p )
-{
-  return ( p.first ^ p.second ).count();
-}
-
-void basic_first_step( circuit& circ, bitset_pair_vector_t& tt )
+void basic_first_step( circuit& circ, permutation_t& p )
 {
-  boost::dynamic_bitset<>::size_type bpos = tt[0].second.find_first();
+  const auto value = p.perm[0u];
 
-  while ( bpos != boost::dynamic_bitset<>::npos )
+  for ( auto bpos = 0u; bpos < circ.lines(); ++bpos )
   {
-    prepend_not( circ, circ.lines() - 1u - bpos );
-    for ( auto& p : tt )
+    if ( ( value >> bpos ) & 1u )
     {
-      p.second.flip( bpos );
+      prepend_not( circ, circ.lines() - 1u - bpos );
     }
-    bpos = tt[0].second.find_next( bpos );
+  }
+
+  for ( auto x = 0u; x < p.perm.size(); ++x )
+  {
+    p.perm[x] ^= value;
+    p.inv[p.perm[x]] = x;
   }
 }
 
-void insert_toffoli_gate( circuit& circ, unsigned& pos, boost::dynamic_bitset<> controls, unsigned target, bitset_pair_vector_t& tt, direction_t dir )
+/* applies a controlled swap of the bits in mask_t (one bit for Toffoli, two bits for Fredkin) */
+void apply_gate( permutation_t& p, std::uint32_t controls, std::uint32_t mask_t, direction_t dir )
 {
-  insert_toffoli( circ, pos, get_control_lines_from_mask( controls ), circ.lines() - 1u - target );
+  /* rows in which the gate changes the value: controls are set and the target bits differ */
+  const auto is_swap = ( mask_t & ( mask_t - 1u ) ) != 0u;
+  const auto changes = [controls, mask_t, is_swap]( std::uint32_t v ) {
+    return ( v & controls ) == controls && ( !is_swap || ( ( v & mask_t ) != 0u && ( v & mask_t ) != mask_t ) );
+  };
 
-  for ( auto& p : tt )
+  if ( dir == direction_back )
   {
-    auto& bits = ( dir == direction_back ) ? p.second : p.first;
-    if ( ( bits & controls ) == controls )
+    for ( auto x = 0u; x < p.perm.size(); ++x )
     {
-      bits.flip( target );
+      if ( changes( p.perm[x] ) )
+      {
+        p.perm[x] ^= mask_t;
+        p.inv[p.perm[x]] = x;
+      }
     }
   }
-
-  if ( dir == direction_front )
+  else
   {
-    ++pos;
-    tt = sort_truth_table( tt );
+    /* gates are involutions, the new function is perm o g; every pair of rows is swapped once */
+    const auto low = mask_t & -mask_t;
+    for ( auto y = 0u; y < p.perm.size(); ++y )
+    {
+      if ( ( y & low ) && changes( y ) )
+      {
+        const auto z = y ^ mask_t;
+        std::swap( p.perm[y], p.perm[z] );
+        p.inv[p.perm[y]] = y;
+        p.inv[p.perm[z]] = z;
+      }
+    }
   }
 }
 
-void insert_fredkin_gate( circuit& circ, unsigned& pos, boost::dynamic_bitset<> controls, unsigned t1, unsigned t2, bitset_pair_vector_t& tt, direction_t dir )
+void insert_toffoli_gate( circuit& circ, unsigned& pos, std::uint32_t controls, unsigned target, permutation_t& p, direction_t dir )
 {
-  insert_fredkin( circ, pos, get_control_lines_from_mask( controls ), circ.lines() - 1u - t1, circ.lines() - 1u - t2 );
+  insert_toffoli( circ, pos, get_control_lines_from_mask( controls, circ.lines() ), circ.lines() - 1u - target );
+  apply_gate( p, controls, 1u << target, dir );
 
-  for ( auto& p : tt )
+  if ( dir == direction_front )
   {
-    auto& bits = ( dir == direction_back ) ? p.second : p.first;
-    if ( ( bits & controls ) == controls )
-    {
-      bool tmp = bits[t1]; bits[t1] = bits[t2]; bits[t2] = tmp;
-    }
+    ++pos;
   }
+}
+
+void insert_fredkin_gate( circuit& circ, unsigned& pos, std::uint32_t controls, unsigned t1, unsigned t2, permutation_t& p, direction_t dir )
+{
+  insert_fredkin( circ, pos, get_control_lines_from_mask( controls, circ.lines() ), circ.lines() - 1u - t1, circ.lines() - 1u - t2 );
+  apply_gate( p, controls, ( 1u << t1 ) | ( 1u << t2 ), dir );
 
   if ( dir == direction_front )
   {
     ++pos;
-    tt = sort_truth_table( tt );
   }
 }
 
-void adjust_line( circuit& circ, unsigned& pos, bitset_pair_vector_t& tt, unsigned line, direction_t dir, bool try_fredkin, bool fredkin_lookback )
+void adjust_line( circuit& circ, unsigned& pos, permutation_t& pm, std::uint32_t line, direction_t dir, bool try_fredkin, bool fredkin_lookback )
 {
-  unsigned bw = circ.lines();
+  const auto bw = circ.lines();
+  const auto all = bw == 32u ? ~std::uint32_t( 0u ) : ( ( std::uint32_t( 1u ) << bw ) - 1u );
 
-  auto input = tt[line].first;
-  auto output = tt[line].second;
+  const std::uint32_t input = line;
+  const std::uint32_t output = pm.perm[line];
   auto p = ( input ^ output ) & ( dir == direction_back ? input : output );
   auto q = ( input ^ output ) & ( dir == direction_back ? output : input );
   auto mask = dir == direction_back ? output : input;
@@ -169,80 +178,76 @@ void adjust_line( circuit& circ, unsigned& pos, bitset_pair_vector_t& tt, unsign
     {
       found = false;
 
-      auto b1 = p.find_first();
-      while ( b1 != boost::dynamic_bitset<>::npos )
+      for ( auto b1 = 0u; b1 < bw && !found; ++b1 )
       {
-        auto b2 = q.find_first();
-        while ( b2 != boost::dynamic_bitset<>::npos )
+        if ( !( ( p >> b1 ) & 1u ) ) { continue; }
+
+        for ( auto b2 = 0u; b2 < bw; ++b2 )
         {
-          auto mask_copy = mask;
-          mask_copy.reset( b1 );
-          mask_copy.reset( b2 );
+          if ( !( ( q >> b2 ) & 1u ) ) { continue; }
 
-          auto mask_compare = ( dir == direction_back ) ? input : output;
+          const auto mask_copy = mask & ~( ( 1u << b1 ) | ( 1u << b2 ) );
+          const auto mask_compare = ( dir == direction_back ) ? input : output;
           bool mask_valid = mask_copy > mask_compare;
 
           if ( !mask_valid && fredkin_lookback ) /* try harder */
           {
             mask_valid = true;
-            boost::dynamic_bitset<> current( bw );
+            std::uint32_t current = 0u;
             do {
-              if ( ( mask_copy & current ) == mask_copy && ( current[b1] != current[b2] ) )
+              if ( ( mask_copy & current ) == mask_copy && ( ( ( current >> b1 ) ^ ( current >> b2 ) ) & 1u ) )
               {
                 mask_valid = false;
                 break;
               }
-              inc( current );
+              current = ( current + 1u ) & all;
             } while ( current != mask_compare );
           }
 
           if ( mask_valid )
           {
-            //std::cout << "[i] insert fred on " << b1 << " and " << b2 << " with mask = " << mask_copy << std::endl;
-            insert_fredkin_gate( circ, pos, mask_copy, b1, b2, tt, dir );
-            p.reset( b1 );
-            q.reset( b2 );
-            mask.set( b1 );
-            mask.reset( b2 );
+            insert_fredkin_gate( circ, pos, mask_copy, b1, b2, pm, dir );
+            p &= ~( 1u << b1 );
+            q &= ~( 1u << b2 );
+            mask |= 1u << b1;
+            mask &= ~( 1u << b2 );
             found = true;
             break;
           }
-          b2 = q.find_next( b2 );
         }
-
-        if ( found ) break;
-        b1 = p.find_next( b1 );
       }
-    } while ( found);
+    } while ( found );
   }
 
   /* change 0 -> 1 */
-  auto bpos = p.find_first();
-  while ( bpos != boost::dynamic_bitset<>::npos )
+  for ( auto bpos = 0u; bpos < bw; ++bpos )
   {
-    insert_toffoli_gate( circ, pos, mask, bpos, tt, dir );
-    mask.set( bpos );
-    bpos = p.find_next( bpos );
+    if ( ( p >> bpos ) & 1u )
+    {
+      insert_toffoli_gate( circ, pos, mask, bpos, pm, dir );
+      mask |= 1u << bpos;
+    }
   }
 
   /* change 1 -> 0 */
-  bpos = q.find_first();
-  while ( bpos != boost::dynamic_bitset<>::npos )
+  for ( auto bpos = 0u; bpos < bw; ++bpos )
   {
-    mask.reset( bpos );
-    insert_toffoli_gate( circ, pos, mask, bpos, tt, dir );
-    bpos = q.find_next( bpos );
+    if ( ( q >> bpos ) & 1u )
+    {
+      mask &= ~( 1u << bpos );
+      insert_toffoli_gate( circ, pos, mask, bpos, pm, dir );
+    }
   }
 }
 
-void print_current_state( unsigned index, const circuit& circ, const bitset_pair_vector_t& tt )
+void print_current_state( unsigned index, const circuit& circ, const permutation_t& p )
 {
   std::cout << "[i] state at index " << index << std::endl;
   std::cout << "[i] current circuit: " << std::endl << circ << std::endl;
   std::cout << "[i] current spec: " << std::endl;
-  for ( auto p : tt )
+  for ( auto x = 0u; x < p.perm.size(); ++x )
   {
-    std::cout << p.first << " |-> " << p.second << std::endl;
+    std::cout << boost::dynamic_bitset<>( circ.lines(), x ) << " |-> " << boost::dynamic_bitset<>( circ.lines(), p.perm[x] ) << std::endl;
   }
   std::cout << std::endl;
 }
@@ -254,6 +259,21 @@ void print_current_state( unsigned index, const circuit& circ, const bitset_pair
 bool transformation_based_synthesis( circuit& circ, const binary_truth_table& spec,
                                      const properties::ptr& settings,
                                      const properties::ptr& statistics )
+{
+  /* truth table has to be fully specified */
+  if ( !fully_specified( spec ) )
+  {
+    clear_circuit( circ );
+    set_error_message( statistics, "truth table `spec` is not fully specified." );
+    return false;
+  }
+
+  return transformation_based_synthesis( circ, dense_truth_table_from_truth_table( spec ), settings, statistics );
+}
+
+bool transformation_based_synthesis( circuit& circ, const dense_truth_table& spec,
+                                     const properties::ptr& settings,
+                                     const properties::ptr& statistics )
 {
   /* Settings */
   const auto bidirectional    = get( settings, "bidirectional",    true  );
@@ -273,17 +293,37 @@ bool transformation_based_synthesis( circuit& circ, const binary_truth_table& sp
   clear_circuit( circ );
 
   /* truth table has to be fully specified */
-  if ( !fully_specified( spec ) )
+  if ( !spec.is_fully_specified() )
   {
     set_error_message( statistics, "truth table `spec` is not fully specified." );
     return false;
   }
 
-  /* truth table to bitsets */
-  bitset_pair_vector_t tt = truth_table_to_bitset_pair_vector( spec );
-  sort_truth_table( tt );
-
   const auto bw = spec.num_outputs();
+  if ( spec.num_inputs() != bw || bw > 32u )
+  {
+    set_error_message( statistics, "truth table `spec` is not reversible." );
+    return false;
+  }
+
+  /* truth table to permutation */
+  permutation_t p;
+  p.perm.resize( spec.num_rows() );
+  p.inv.resize( spec.num_rows() );
+
+  boost::dynamic_bitset<> seen( spec.num_rows() );
+  for ( std::uint64_t x = 0u; x < spec.num_rows(); ++x )
+  {
+    p.perm[x] = static_cast<std::uint32_t>( spec.row_value( x ) );
+    if ( seen[p.perm[x]] )
+    {
+      set_error_message( statistics, "truth table `spec` is not reversible." );
+      return false;
+    }
+    seen.set( p.perm[x] );
+    p.inv[p.perm[x]] = static_cast<std::uint32_t>( x );
+  }
+
   circ.set_lines( bw );
 
   /* copy metadata */
@@ -294,10 +334,10 @@ bool transformation_based_synthesis( circuit& circ, const binary_truth_table& sp
   {
     if ( verbose )
     {
-      print_current_state( 0u, circ, tt );
+      print_current_state( 0u, circ, p );
     }
 
-    basic_first_step( circ, tt );
+    basic_first_step( circ, p );
   }
 
   /* Step 2 */
@@ -305,16 +345,16 @@ bool transformation_based_synthesis( circuit& circ, const binary_truth_table& sp
   auto pos = 0u;
 
   direction_t dir = direction_back;
-  auto index = 0u;
+  std::uint32_t index = 0u;
 
-  for ( unsigned i = start_index; i < tt.size(); ++i )
+  for ( std::uint32_t i = start_index; i < p.perm.size(); ++i )
   {
     if ( verbose )
     {
-      print_current_state( i, circ, tt );
+      print_current_state( i, circ, p );
     }
 
-    if ( tt[i].first == tt[i].second )
+    if ( p.perm[i] == i )
     {
       continue;
     }
@@ -323,9 +363,8 @@ bool transformation_based_synthesis( circuit& circ, const binary_truth_table& sp
     index = i;
     if ( bidirectional )
     {
-      typedef bitset_pair_vector_t::value_type value_type;
-      const auto other_index = boost::find_if( tt, [&tt, &i]( const value_type& p ) { return p.second == tt[i].first; } ) - tt.begin();
-      if ( hamming_distance( tt[other_index] ) < hamming_distance( tt[i] ) )
+      const auto other_index = p.inv[i];
+      if ( __builtin_popcount( other_index ^ p.perm[other_index] ) < __builtin_popcount( i ^ p.perm[i] ) )
       {
         dir = direction_front;
         index = other_index;
@@ -336,7 +375,7 @@ bool transformation_based_synthesis( circuit& circ, const binary_truth_table& sp
     {
       std::cout << "[i] adjust line: " << index << std::endl;
     }
-    adjust_line( circ, pos, tt, index, dir, fredkin, fredkin_lookback );
+    adjust_line( circ, pos, p, index, dir, fredkin, fredkin_lookback );
   }
 
   return true;
@@ -38,6 +38,7 @@
 
 #include <core/properties.hpp>
 #include <reversible/circuit.hpp>
+#include <reversible/dense_truth_table.hpp>
 #include <reversible/truth_table.hpp>
 
 #include <reversible/synthesis/synthesis.hpp>
@@ -88,6 +89,27 @@ bool transformation_based_synthesis( circuit& circ, const binary_truth_table& sp
                                      const properties::ptr& settings = properties::ptr(),
                                      const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * @brief Transformation based synthesis on a dense truth table
+ *
+ * The specification is kept as a permutation together with its inverse, such
+ * that each inserted gate is applied in a single pass over all rows and the
+ * bidirectional lookup does not search the table.  It produces the same
+ * circuit as the version for binary_truth_table, which calls this function.
+ *
+ * @param circ       Empty Circuit
+ * @param spec       Reversible function with at most 32 variables
+ * @param settings   Settings (see above)
+ * @param statistics Statistics (see above)
+ *
+ * @return true if successful, false otherwise
+ *
+ * @since  2.4
+ */
+bool transformation_based_synthesis( circuit& circ, const dense_truth_table& spec,
+                                     const properties::ptr& settings = properties::ptr(),
+                                     const properties::ptr& statistics = properties::ptr() );
+
 /**
  * @brief Functor for the \ref revkit::transformation_based_synthesis "transformation_based_synthesis" algorithm
  *
@@ -27,8 +27,10 @@
 #include "young_subgroup_synthesis.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/assign/std/vector.hpp>
@@ -61,7 +63,8 @@ typedef std::vector<std::vector<int> > truth_table_column_t;
 class young_subgroup_synthesis_manager
 {
 public:
-  young_subgroup_synthesis_manager( circuit& circ, const binary_truth_table& spec ) : circ( circ ), spec( spec ), start( 0u )
+  young_subgroup_synthesis_manager( circuit& circ, truth_table_column_t&& in, truth_table_column_t&& out )
+    : circ( circ ), start( 0u ), vf_in( std::move( in ) ), vb_in( std::move( out ) )
   {
     /* initialize BDD variables */
     for ( unsigned i = 0u; i < circ.lines(); ++i )
@@ -105,23 +108,40 @@ public:
 
   void basic_first_step()
   {
-    unsigned bw = spec.num_inputs();
-    for (binary_truth_table::const_iterator it = spec.begin(); it != spec.end(); ++it)
+    vf_out = vf_in;
+    vb_out = vb_in;
+    for ( unsigned i = 0; i < vf_out.size(); ++i )
     {
-      std::vector<int> in_cube, out_cube;
-      binary_truth_table::in_const_iterator c = it->first.first;
-      binary_truth_table::out_const_iterator ci = it->second.first;
-      for (unsigned i = 0; i < bw; ++i)
-      {
-        in_cube.push_back(**(c + i));
-        out_cube.push_back(**(ci + i));
-      }
-      vf_in += in_cube;
-      vb_in += out_cube;
-      out_cube[pos] = -1;
-      in_cube[pos] = -1;
-      vf_out += in_cube;
-      vb_out += out_cube;
+      vf_out[i][pos] = -1;
+      vb_out[i][pos] = -1;
+    }
+  }
+
+  /* rows that only differ in position pos, in increasing order */
+  struct row_group
+  {
+    std::vector<unsigned> rows;
+    unsigned              cursor = 0u;
+  };
+  using row_index_t = std::unordered_map<std::uint64_t, row_group>;
+
+  std::uint64_t row_key( const truth_table_column_t::value_type& v ) const
+  {
+    std::uint64_t key = 0u;
+    for ( unsigned j = 0u; j < v.size(); ++j )
+    {
+      if ( j == pos ) continue;
+      key = ( key << 2u ) | static_cast<std::uint64_t>( v[j] + 1 );
+    }
+    return key;
+  }
+
+  void build_index( const truth_table_column_t& vect, row_index_t& index ) const
+  {
+    index.clear();
+    for ( unsigned i = 0u; i < vect.size(); ++i )
+    {
+      index[row_key( vect[i] )].rows += i;
     }
   }
 
@@ -135,6 +155,29 @@ public:
     return i;
   }
 
+  /* same as find, but in build_shape values at pos only change from -1, so
+     the first row in the group that is still -1 can be found with a cursor */
+  int find( const truth_table_column_t& vect, row_index_t& index, const truth_table_column_t::value_type& v )
+  {
+    if ( v[pos] != -1 || vect.front().size() > 32u )
+    {
+      return find( vect, v );
+    }
+
+    auto it = index.find( row_key( v ) );
+    if ( it == index.end() )
+    {
+      return vect.size();
+    }
+
+    auto& group = it->second;
+    while ( group.cursor < group.rows.size() && vect[group.rows[group.cursor]][pos] != -1 )
+    {
+      ++group.cursor;
+    }
+    return group.cursor < group.rows.size() ? group.rows[group.cursor] : vect.size();
+  }
+
   BDD get_control_function( const truth_table_column_t& in, const truth_table_column_t& out )
   {
     BDD bdd = cudd.bddZero();
@@ -204,6 +247,10 @@ public:
 
   void build_shape()
   {
+    row_index_t f_index, b_index;
+    build_index( vf_out, f_index );
+    build_index( vb_out, b_index );
+
     unsigned j = 0u, nb_cubes = 0u;
     while (j < vf_out.size())
     {
@@ -217,11 +264,11 @@ public:
       {
         std::vector<int> v = vf_out[k];
         vf_out[k][pos] = 0;
-        unsigned index = find(vf_out, v);
+        unsigned index = find(vf_out, f_index, v);
         vf_out[index][pos] = 1;
         v = vb_out[index];
         vb_out[index][pos] = 1;
-        index = find(vb_out, v);
+        index = find(vb_out, b_index, v);
         vb_out[index][pos] = 0;
         j = index;
         nb_cubes++;
@@ -264,7 +311,6 @@ public:
 
   Cudd cudd;
   circuit& circ;
-  const binary_truth_table& spec;
   std::vector<unsigned> adjusted_lines;
   unsigned pos, start;
   bool verbose;
@@ -273,14 +319,33 @@ public:
   truth_table_column_t vf_in, vf_out, vb_in, vb_out;
 };
 
-
-bool young_subgroup_synthesis(circuit& circ, const binary_truth_table& spec, properties::ptr settings, properties::ptr statistics)
+void run_young_subgroup_synthesis( circuit& circ, truth_table_column_t&& in, truth_table_column_t&& out, const properties::ptr& settings )
 {
   /* Settings */
   const auto verbose  = get( settings, "verbose",  false                             );
         auto ordering = get( settings, "ordering", std::vector<unsigned>()           );
   const auto esopmin  = get( settings, "esopmin",  dd_based_esop_optimization_func() );
 
+  // manager
+  young_subgroup_synthesis_manager mgr( circ, std::move( in ), std::move( out ) );
+  mgr.verbose = verbose;
+  mgr.esopmin = esopmin;
+
+  // variable ordering
+  if ( ordering.empty() )
+  {
+    boost::push_back( ordering, boost::irange( 0u, circ.lines() ) );
+  }
+
+  for ( auto i : ordering )
+  {
+    mgr.add_gates_for_line( i );
+  }
+}
+
+
+bool young_subgroup_synthesis(circuit& circ, const binary_truth_table& spec, properties::ptr settings, properties::ptr statistics)
+{
   properties_timer t( statistics );
 
   // circuit has to be empty
@@ -297,22 +362,61 @@ bool young_subgroup_synthesis(circuit& circ, const binary_truth_table& spec, pro
   // copy metadata
   copy_metadata(spec, circ);
 
-  // manager
-  young_subgroup_synthesis_manager mgr( circ, spec );
-  mgr.verbose = verbose;
-  mgr.esopmin = esopmin;
+  // truth table columns in the order of the rows in spec
+  unsigned bw = spec.num_inputs();
+  truth_table_column_t in, out;
+  for (binary_truth_table::const_iterator it = spec.begin(); it != spec.end(); ++it)
+  {
+    std::vector<int> in_cube, out_cube;
+    binary_truth_table::in_const_iterator c = it->first.first;
+    binary_truth_table::out_const_iterator ci = it->second.first;
+    for (unsigned i = 0; i < bw; ++i)
+    {
+      in_cube.push_back(**(c + i));
+      out_cube.push_back(**(ci + i));
+    }
+    in += in_cube;
+    out += out_cube;
+  }
 
-  // variable ordering
-  if ( ordering.empty() )
+  run_young_subgroup_synthesis( circ, std::move( in ), std::move( out ), settings );
+
+  return true;
+}
+
+bool young_subgroup_synthesis( circuit& circ, const dense_truth_table& spec, properties::ptr settings, properties::ptr statistics )
+{
+  properties_timer t( statistics );
+
+  // circuit has to be empty
+  clear_circuit( circ );
+
+  // truth table has to be fully specified
+  if ( !spec.is_fully_specified() || spec.num_inputs() != spec.num_outputs() )
   {
-    boost::push_back( ordering, boost::irange( 0u, spec.num_inputs() ) );
+    set_error_message( statistics, "truth table `spec` is not fully specified." );
+    return false;
   }
 
-  for ( auto i : ordering )
+  const auto bw = spec.num_inputs();
+  circ.set_lines( bw );
+
+  // copy metadata
+  copy_metadata( spec, circ );
+
+  // truth table columns in increasing row order
+  truth_table_column_t in( spec.num_rows(), std::vector<int>( bw ) ), out( spec.num_rows(), std::vector<int>( bw ) );
+  for ( std::uint64_t r = 0u; r < spec.num_rows(); ++r )
   {
-    mgr.add_gates_for_line( i );
+    for ( unsigned i = 0u; i < bw; ++i )
+    {
+      in[r][i]  = ( r >> ( bw - 1u - i ) ) & 1u;
+      out[r][i] = spec.get( r, i );
+    }
   }
 
+  run_young_subgroup_synthesis( circ, std::move( in ), std::move( out ), settings );
+
   return true;
 }
 
@@ -41,6 +41,7 @@
 #include <core/properties.hpp>
 
 #include <reversible/circuit.hpp>
+#include <reversible/dense_truth_table.hpp>
 #include <reversible/truth_table.hpp>
 
 #include <reversible/synthesis/synthesis.hpp>
@@ -49,6 +50,7 @@ namespace cirkit
 {
 
 bool young_subgroup_synthesis( circuit& circ, const binary_truth_table& spec, properties::ptr settings = properties::ptr(), properties::ptr statistics = properties::ptr() );
+bool young_subgroup_synthesis( circuit& circ, const dense_truth_table& spec, properties::ptr settings = properties::ptr(), properties::ptr statistics = properties::ptr() );
 
 truth_table_synthesis_func young_subgroup_synthesis_func( properties::ptr settings = std::make_shared<properties>(), properties::ptr statistics = std::make_shared<properties>() );
 
@@ -0,0 +1,220 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE coupling_graph
+
+#include <random>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <reversible/circuit.hpp>
+#include <reversible/pauli_tags.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/mapping/coupling_graph.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* simulates NOT and CNOT gates */
+boost::dynamic_bitset<> simulate_cnots( const circuit& circ, boost::dynamic_bitset<> state )
+{
+  for ( const auto& g : circ )
+  {
+    BOOST_REQUIRE( is_toffoli( g ) && g.controls().size() <= 1u );
+    if ( g.controls().empty() || state[g.controls().front().line()] == g.controls().front().polarity() )
+    {
+      state.flip( g.targets().front() );
+    }
+  }
+  return state;
+}
+
+circuit random_cnot_circuit( unsigned lines, unsigned gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+  circuit circ( lines );
+
+  for ( auto i = 0u; i < gates; ++i )
+  {
+    const auto c = gen() % lines;
+    const auto t = ( c + 1u + gen() % ( lines - 1u ) ) % lines;
+    append_cnot( circ, c, t );
+  }
+  return circ;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( costs )
+{
+  const auto qx2 = coupling_graph_from_architecture( "qx2" );
+
+  BOOST_CHECK_EQUAL( qx2.cost( 0u, 1u ), 0u );
+  BOOST_CHECK_EQUAL( qx2.cost( 1u, 0u ), 4u );
+  BOOST_CHECK_EQUAL( qx2.cost( 0u, 3u ), 14u ); /* swap 3 and 2, CNOT( 0, 2 ), swap back */
+  BOOST_CHECK( qx2.is_connected() );
+
+  const coupling_graph split( 4u, {{0u, 1u}, {2u, 3u}} );
+  BOOST_CHECK( !split.is_connected() );
+  BOOST_CHECK_EQUAL( split.cost( 0u, 2u ), coupling_graph::infinity );
+}
+
+BOOST_AUTO_TEST_CASE( routing_preserves_function )
+{
+  /* bidirectional line, such that routed circuits contain only CNOTs */
+  std::vector<std::pair<unsigned, unsigned>> edges;
+  for ( auto i = 0u; i + 1u < 8u; ++i )
+  {
+    edges.push_back( {i, i + 1u} );
+    edges.push_back( {i + 1u, i} );
+  }
+  const coupling_graph line( 8u, edges );
+
+  std::mt19937 gen( 42u );
+  for ( auto seed = 0u; seed < 10u; ++seed )
+  {
+    const auto circ = random_cnot_circuit( 6u, 30u, seed );
+    const auto placement = find_placement( circ, line );
+    const auto mapped = coupling_graph_mapping( circ, line, placement );
+
+    BOOST_REQUIRE_EQUAL( mapped.lines(), 8u );
+
+    for ( const auto& g : mapped )
+    {
+      if ( !g.controls().empty() )
+      {
+        BOOST_CHECK( line.has_edge( g.controls().front().line(), g.targets().front() ) );
+      }
+    }
+
+    for ( auto i = 0u; i < 20u; ++i )
+    {
+      boost::dynamic_bitset<> in( 6u, gen() ), in_mapped( 8u, 0u );
+      for ( auto l = 0u; l < 6u; ++l )
+      {
+        in_mapped[placement[l]] = in[l];
+      }
+
+      const auto out = simulate_cnots( circ, in );
+      const auto out_mapped = simulate_cnots( mapped, in_mapped );
+      for ( auto l = 0u; l < 6u; ++l )
+      {
+        BOOST_CHECK_EQUAL( out[l], out_mapped[placement[l]] );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( directed_architecture )
+{
+  const auto qx5 = coupling_graph_from_architecture( "qx5" );
+  const auto circ = random_cnot_circuit( 10u, 50u, 7u );
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "num_threads", 2u );
+  auto statistics = std::make_shared<properties>();
+
+  const auto mapped = coupling_graph_mapping( circ, qx5, std::vector<unsigned>(), settings, statistics );
+
+  /* every CNOT is supported, estimated cost is exact for CNOT circuits */
+  for ( const auto& g : mapped )
+  {
+    BOOST_CHECK( is_hadamard( g ) || qx5.has_edge( g.controls().front().line(), g.targets().front() ) );
+  }
+  BOOST_CHECK_EQUAL( mapped.num_gates(), circ.num_gates() + statistics->get<unsigned>( "cost" ) );
+}
+
+BOOST_AUTO_TEST_CASE( toffoli_and_v_gates )
+{
+  const auto qx4 = coupling_graph_from_architecture( "qx4" );
+
+  circuit circ( 3u );
+  append_toffoli( circ )( 0u, 1u )( 2u );
+  append_v( circ, std::vector<unsigned>{2u}, 0u, false );
+  append_cnot( circ, 1u, 0u );
+
+  const auto mapped = coupling_graph_mapping( circ, qx4 );
+
+  BOOST_CHECK_EQUAL( mapped.lines(), 5u );
+  for ( const auto& g : mapped )
+  {
+    BOOST_CHECK( g.controls().empty() || ( is_toffoli( g ) && qx4.has_edge( g.controls().front().line(), g.targets().front() ) ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( negative_controls )
+{
+  const coupling_graph line( 4u, {{0u, 1u}, {1u, 0u}, {1u, 2u}, {2u, 1u}, {2u, 3u}, {3u, 2u}} );
+
+  circuit circ( 4u );
+  append_cnot( circ, make_var( 0u, false ), 1u );
+  append_cnot( circ, make_var( 2u, false ), 0u );
+  append_cnot( circ, 1u, 3u );
+  append_cnot( circ, make_var( 3u, false ), 2u );
+
+  std::vector<unsigned> placement{0u, 1u, 2u, 3u};
+  const auto mapped = coupling_graph_mapping( circ, line, placement );
+
+  for ( const auto& g : mapped )
+  {
+    BOOST_CHECK( g.controls().empty() || g.controls().front().polarity() );
+  }
+
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    const boost::dynamic_bitset<> in( 4u, i );
+    const auto out = simulate_cnots( circ, in );
+    const auto out_mapped = simulate_cnots( mapped, in );
+    for ( auto l = 0u; l < 4u; ++l )
+    {
+      BOOST_CHECK_EQUAL( out[l], out_mapped[l] );
+    }
+  }
+
+  /* controlled V with a negative control */
+  circuit circ_v( 2u );
+  append_v( circ_v, gate::control_container{make_var( 1u, false )}, 0u, false );
+  const auto mapped_v = coupling_graph_mapping( circ_v, line, std::vector<unsigned>{0u, 1u} );
+  BOOST_CHECK( is_toffoli( mapped_v[0u] ) && mapped_v[0u].controls().empty() && mapped_v[0u].targets().front() == 1u );
+  BOOST_CHECK( is_toffoli( mapped_v[mapped_v.num_gates() - 1u] ) && mapped_v[mapped_v.num_gates() - 1u].targets().front() == 1u );
+  for ( const auto& g : mapped_v )
+  {
+    BOOST_CHECK( g.controls().empty() || g.controls().front().polarity() );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,233 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE is_identity
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <reversible/circuit.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/variable.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/functions/is_identity.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* Toffoli gate if target2 is none, Fredkin gate otherwise */
+struct gate_spec
+{
+  gate::control_container   controls;
+  unsigned                  target1;
+  boost::optional<unsigned> target2;
+};
+
+std::vector<gate_spec> random_gates( unsigned lines, unsigned num_gates, unsigned max_controls, std::mt19937& gen )
+{
+  std::vector<gate_spec> gates;
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    std::vector<unsigned> order( lines );
+    for ( auto l = 0u; l < lines; ++l ) { order[l] = l; }
+    std::shuffle( order.begin(), order.end(), gen );
+
+    gate_spec g;
+    g.target1 = order[0u];
+    auto next = 1u;
+    if ( gen() % 4u == 0u )
+    {
+      g.target2 = order[next++];
+    }
+    const auto num_controls = gen() % ( max_controls + 1u );
+    for ( auto c = 0u; c < num_controls && next < lines; ++c )
+    {
+      g.controls.push_back( make_var( order[next++], gen() % 2u == 0u ) );
+    }
+    gates.push_back( g );
+  }
+  return gates;
+}
+
+void append_gate( circuit& circ, const gate_spec& g )
+{
+  if ( g.target2 )
+  {
+    append_fredkin( circ, g.controls, g.target1, *g.target2 );
+  }
+  else
+  {
+    append_toffoli( circ, g.controls, g.target1 );
+  }
+}
+
+/* gates followed by their inverse, the gate at position skip of the inverse is left out */
+circuit mirrored_circuit( unsigned lines, const std::vector<gate_spec>& gates, boost::optional<unsigned> skip = boost::none )
+{
+  circuit circ;
+  circ.set_lines( lines );
+  for ( const auto& g : gates )
+  {
+    append_gate( circ, g );
+  }
+  for ( auto i = gates.size(); i-- > 0u; )
+  {
+    if ( skip && *skip == i ) { continue; }
+    append_gate( circ, gates[i] );
+  }
+  return circ;
+}
+
+/* simulation with positive and negative controls */
+std::vector<bool> simulate( const circuit& circ, std::vector<bool> values )
+{
+  for ( const auto& g : circ )
+  {
+    auto active = true;
+    for ( const auto& c : g.controls() )
+    {
+      active = active && values[c.line()] == c.polarity();
+    }
+    if ( !active ) { continue; }
+
+    std::vector<unsigned> targets( g.targets().begin(), g.targets().end() );
+    if ( is_fredkin( g ) )
+    {
+      const bool value = values[targets[0u]];
+      values[targets[0u]] = values[targets[1u]];
+      values[targets[1u]] = value;
+    }
+    else
+    {
+      values[targets[0u]] = !values[targets[0u]];
+    }
+  }
+  return values;
+}
+
+std::string decided_by( const properties::ptr& statistics )
+{
+  return statistics->get<std::string>( "decided_by" );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(small_circuits)
+{
+  std::mt19937 gen( 42u );
+
+  for ( auto round = 0u; round < 20u; ++round )
+  {
+    const auto lines = 3u + round % 8u;
+    const auto gates = random_gates( lines, 15u, 3u, gen );
+
+    /* exhaustive simulation */
+    auto statistics = std::make_shared<properties>();
+    BOOST_CHECK( is_identity( mirrored_circuit( lines, gates ), properties::ptr(), statistics ) );
+    BOOST_CHECK_EQUAL( decided_by( statistics ), "simulation" );
+
+    /* proof on output cones */
+    const auto settings = make_settings_from( std::make_pair( "exhaustive_limit", 0u ) );
+    BOOST_CHECK( is_identity( mirrored_circuit( lines, gates ), settings, statistics ) );
+    BOOST_CHECK_EQUAL( decided_by( statistics ), "bdd" );
+
+    /* without one gate, the circuit is the conjugate of that gate */
+    const auto circ = mirrored_circuit( lines, gates, gen() % gates.size() );
+    BOOST_CHECK( !is_identity( circ, properties::ptr(), statistics ) );
+    BOOST_CHECK_EQUAL( decided_by( statistics ), "simulation" );
+
+    /* the counterexample is not mapped to itself */
+    const auto cex = statistics->get<std::vector<bool>>( "counterexample" );
+    BOOST_REQUIRE_EQUAL( cex.size(), lines );
+    BOOST_CHECK( simulate( circ, cex ) != cex );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(large_circuits)
+{
+  std::mt19937 gen( 7u );
+  const auto lines = 40u;
+
+  for ( auto round = 0u; round < 5u; ++round )
+  {
+    const auto gates = random_gates( lines, 30u, 3u, gen );
+
+    auto statistics = std::make_shared<properties>();
+    BOOST_CHECK( is_identity( mirrored_circuit( lines, gates ), properties::ptr(), statistics ) );
+    BOOST_CHECK_EQUAL( decided_by( statistics ), "bdd" );
+    BOOST_CHECK( statistics->has_key( "simulation_runtime" ) );
+    BOOST_CHECK( statistics->has_key( "proof_runtime" ) );
+
+    /* random patterns activate a gate with few controls */
+    BOOST_CHECK( !is_identity( mirrored_circuit( lines, gates, round ), properties::ptr(), statistics ) );
+    BOOST_CHECK_EQUAL( decided_by( statistics ), "simulation" );
+  }
+
+  /* a gate that is active for a single assignment, which is not a structured pattern */
+  circuit circ;
+  circ.set_lines( lines );
+  gate::control_container controls;
+  for ( auto i = 1u; i < lines; ++i )
+  {
+    controls.push_back( make_var( i, i % 3u != 0u ) );
+  }
+  append_toffoli( circ, controls, 0u );
+
+  auto statistics = std::make_shared<properties>();
+  BOOST_CHECK( !is_identity( circ, properties::ptr(), statistics ) );
+  BOOST_CHECK_EQUAL( decided_by( statistics ), "bdd" );
+  BOOST_CHECK( !statistics->has_key( "counterexample" ) );
+
+  /* no time for the proof */
+  const auto settings = make_settings_from( std::make_pair( "timeout", boost::optional<unsigned>( 0u ) ) );
+  BOOST_CHECK( !is_identity( mirrored_circuit( lines, random_gates( lines, 30u, 3u, gen ) ), settings, statistics ) );
+  BOOST_CHECK_EQUAL( decided_by( statistics ), "timeout" );
+}
+
+BOOST_AUTO_TEST_CASE(empty_circuit)
+{
+  circuit circ;
+  circ.set_lines( 5u );
+
+  auto statistics = std::make_shared<properties>();
+  BOOST_CHECK( is_identity( circ, properties::ptr(), statistics ) );
+  BOOST_CHECK_EQUAL( decided_by( statistics ), "simulation" );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
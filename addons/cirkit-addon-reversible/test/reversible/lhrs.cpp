@@ -0,0 +1,153 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE lhrs
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_flow_map.hpp>
+#include <reversible/circuit.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/io/print_circuit.hpp>
+#include <reversible/synthesis/lhrs/lhrs.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+xmg_graph random_xmg( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  xmg_graph xmg;
+  std::vector<xmg_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( xmg.create_pi( "x" + std::to_string( i ) ) );
+  }
+
+  const auto pick = [&]() { return fs[gen() % fs.size()] ^ ( gen() % 2u == 0u ); };
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    fs.push_back( gen() % 4u == 0u ? xmg.create_xor( pick(), pick() ) : xmg.create_maj( pick(), pick(), pick() ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    xmg.create_po( fs[fs.size() - 1u - i], "y" + std::to_string( i ) );
+  }
+  return xmg;
+}
+
+circuit synthesize( const xmg_graph& xmg, lhrs_mapping_strategy strategy, unsigned num_threads )
+{
+  lhrs_params params;
+  params.mapping_strategy = strategy;
+  params.num_threads = num_threads;
+  params.sync();
+
+  lhrs_stats stats;
+  circuit circ;
+  BOOST_REQUIRE( lut_based_synthesis( circ, xmg, params, stats ) );
+  return circ;
+}
+
+std::string to_string( const circuit& circ )
+{
+  std::ostringstream os;
+  os << circ;
+  return os.str();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( params_copy )
+{
+  lhrs_params params;
+  params.map_esop_params.progress = true;
+  params.map_luts_params.max_cut_size = 6;
+  params.map_luts_params.satlut = true;
+  params.map_luts_params.area_iters = 5u;
+
+  const std::vector<lhrs_params> copies( 2u, params );
+  for ( const auto& copy : copies )
+  {
+    BOOST_CHECK_EQUAL( copy.map_luts_params.max_cut_size, 6 );
+    BOOST_CHECK( copy.map_luts_params.satlut );
+    BOOST_CHECK_EQUAL( copy.map_luts_params.area_iters, 5u );
+    BOOST_CHECK( !copy.map_luts_params.own_sub_params );
+
+    /* sub parameters refer to the copy, not to the original */
+    BOOST_CHECK( copy.map_luts_params.map_esop_params == &copy.map_esop_params );
+    BOOST_CHECK( copy.map_luts_params.map_precomp_params == &copy.map_precomp_params );
+    BOOST_CHECK( copy.map_shannon_params.map_luts_params == &copy.map_luts_params );
+    BOOST_CHECK( copy.map_luts_params.map_esop_params->progress );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( parallel_matches_sequential )
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    auto xmg = random_xmg( 6u, 40u, 3u, seed );
+    xmg_flow_map( xmg, make_settings_from( std::make_pair( "cut_size", 4u ) ) );
+
+    for ( auto strategy : {lhrs_mapping_strategy::direct, lhrs_mapping_strategy::shannon} )
+    {
+      const auto sequential = synthesize( xmg, strategy, 1u );
+      const auto parallel   = synthesize( xmg, strategy, 4u );
+
+      BOOST_REQUIRE_EQUAL( parallel.lines(), sequential.lines() );
+      BOOST_REQUIRE_EQUAL( parallel.num_gates(), sequential.num_gates() );
+
+      for ( auto i = 0u; i < sequential.num_gates(); ++i )
+      {
+        const auto& gs = sequential[i];
+        const auto& gp = parallel[i];
+
+        BOOST_CHECK_EQUAL( is_toffoli( gp ), is_toffoli( gs ) );
+        BOOST_CHECK( gp.controls() == gs.controls() );
+        BOOST_CHECK( gp.targets() == gs.targets() );
+      }
+      BOOST_CHECK_EQUAL( to_string( parallel ), to_string( sequential ) );
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,160 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE tabu
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <reversible/circuit.hpp>
+#include <reversible/variable.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/functions/copy_circuit.hpp>
+#include <cli/commands/rules.hpp>
+#include <cli/commands/tabu.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+gate::control_container controls( unsigned from, unsigned to )
+{
+  gate::control_container c;
+  for ( auto l = from; l < to; ++l )
+  {
+    c.push_back( make_var( l ) );
+  }
+  return c;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( window_validation )
+{
+  /* two equal gates with 20 controls are the identity */
+  circuit before( 21u ), after( 21u );
+  append_toffoli( before, controls( 0u, 20u ), 20u );
+  append_toffoli( before, controls( 0u, 20u ), 20u );
+  BOOST_CHECK( equivalent_windows( before.begin(), before.end(), after.begin(), after.end() ) );
+
+  tabu_move move{1, 0u, 1u, 0, 0};
+  circuit window( 21u );
+  BOOST_CHECK( evaluate_move( before, move, window ) );
+  BOOST_CHECK_EQUAL( move.delta_gates, -2 );
+
+  /* gates differing in the polarity of one of 20 controls which differ on 4 of 2^21 assignments */
+  circuit positive( 21u ), negative( 21u );
+  append_toffoli( positive, controls( 0u, 20u ), 20u );
+  auto c = controls( 0u, 20u );
+  c.back().set_polarity( false );
+  append_toffoli( negative, c, 20u );
+  BOOST_CHECK( !equivalent_windows( positive.begin(), positive.end(), negative.begin(), negative.end() ) );
+  BOOST_CHECK( equivalent_windows( positive.begin(), positive.end(), positive.begin(), positive.end() ) );
+
+  /* swapping non-commuting gates with 18 common controls */
+  circuit ordered( 20u ), swapped( 20u );
+  auto c1 = controls( 0u, 19u ), c2 = controls( 0u, 18u );
+  append_toffoli( ordered, c1, 19u );
+  append_toffoli( ordered, c2, 18u );
+  append_toffoli( swapped, c2, 18u );
+  append_toffoli( swapped, c1, 19u );
+  BOOST_CHECK( !equivalent_windows( ordered.begin(), ordered.end(), swapped.begin(), swapped.end() ) );
+
+  /* commuting gates without common controls on more than 16 lines are not accepted */
+  circuit disjoint( 19u ), disjoint_swapped( 19u );
+  append_toffoli( disjoint, controls( 0u, 9u ), 18u );
+  append_toffoli( disjoint, controls( 9u, 18u ), 18u );
+  append_toffoli( disjoint_swapped, controls( 9u, 18u ), 18u );
+  append_toffoli( disjoint_swapped, controls( 0u, 9u ), 18u );
+  BOOST_CHECK( !equivalent_windows( disjoint.begin(), disjoint.end(), disjoint_swapped.begin(), disjoint_swapped.end() ) );
+}
+
+BOOST_AUTO_TEST_CASE( rule_rfive )
+{
+  circuit circ( 5u );
+  append_toffoli( circ, gate::control_container{make_var( 0u ), make_var( 1u ), make_var( 2u )}, 4u );
+  append_toffoli( circ, gate::control_container{make_var( 0u ), make_var( 2u ), make_var( 3u )}, 4u );
+
+  /* common controls include the first one of both gates */
+  apply_rule_Rfive( circ[0u], circ[1u] );
+
+  BOOST_CHECK( circ[0u].controls() == gate::control_container{make_var( 1u )} );
+  BOOST_CHECK( circ[1u].controls() == gate::control_container{make_var( 3u )} );
+}
+
+BOOST_AUTO_TEST_CASE( update_circuit_order )
+{
+  circuit two( 3u ), three( 3u );
+  append_not( two, 0u );
+  append_not( two, 1u );
+  append_not( three, 0u );
+  append_not( three, 1u );
+  append_not( three, 2u );
+
+  /* gates first, then quantum cost */
+  {
+    circuit min;
+    copy_circuit( three, min );
+    auto min_qcost = 3u;
+    BOOST_CHECK( !update_circuit( three, min, 3u, min_qcost, 0u ) );
+    BOOST_CHECK( update_circuit( two, min, 10u, min_qcost, 0u ) );
+    BOOST_CHECK_EQUAL( min.num_gates(), 2u );
+    BOOST_CHECK_EQUAL( min_qcost, 10u );
+    BOOST_CHECK( !update_circuit( three, min, 1u, min_qcost, 0u ) );
+    BOOST_CHECK( !update_circuit( two, min, 10u, min_qcost, 0u ) );
+    BOOST_CHECK( update_circuit( two, min, 9u, min_qcost, 0u ) );
+    BOOST_CHECK_EQUAL( min_qcost, 9u );
+  }
+
+  /* quantum cost only */
+  {
+    circuit min;
+    copy_circuit( two, min );
+    auto min_qcost = 5u;
+    BOOST_CHECK( !update_circuit( two, min, 5u, min_qcost, 1u ) );
+    BOOST_CHECK( update_circuit( three, min, 4u, min_qcost, 1u ) );
+    BOOST_CHECK_EQUAL( min.num_gates(), 3u );
+  }
+
+  /* sum of gates and quantum cost */
+  {
+    circuit min;
+    copy_circuit( two, min );
+    auto min_qcost = 5u;
+    BOOST_CHECK( !update_circuit( three, min, 4u, min_qcost, 2u ) );
+    BOOST_CHECK( update_circuit( three, min, 3u, min_qcost, 2u ) );
+    BOOST_CHECK_EQUAL( min.num_gates(), 3u );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -27,12 +27,159 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE truth_table
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 #include <boost/test/output_test_stream.hpp>
 
+#include <core/properties.hpp>
+#include <classical/optimization/optimization.hpp>
+#include <reversible/circuit.hpp>
+#include <reversible/dense_truth_table.hpp>
 #include <reversible/truth_table.hpp>
+#include <reversible/functions/circuit_from_string.hpp>
+#include <reversible/functions/circuit_to_truth_table.hpp>
+#include <reversible/synthesis/embed_truth_table.hpp>
+#include <reversible/synthesis/transformation_based_synthesis.hpp>
+#include <reversible/synthesis/young_subgroup_synthesis.hpp>
 #include <reversible/utils/truth_table_helpers.hpp>
 
+using namespace cirkit;
+
+namespace
+{
+
+/* the circuits and embeddings below were computed with the implementations
+   on binary_truth_table before they were ported to dense_truth_table */
+const std::vector<std::vector<unsigned>> permutations = {
+  {7u, 0u, 1u, 3u, 4u, 2u, 6u, 5u}, /* 3_17 */
+  {1u, 0u, 3u, 2u, 5u, 7u, 4u, 6u},
+  {3u, 14u, 7u, 9u, 13u, 11u, 4u, 5u, 12u, 8u, 1u, 0u, 15u, 6u, 2u, 10u},
+  {12u, 9u, 2u, 10u, 4u, 5u, 7u, 11u, 0u, 14u, 8u, 15u, 3u, 1u, 6u, 13u}};
+
+struct tbs_result
+{
+  unsigned    permutation;
+  bool        bidirectional;
+  bool        fredkin;
+  bool        fredkin_lookback;
+  std::string circuit;
+};
+
+const std::vector<tbs_result> tbs_results = {
+  {0u, true, false, false, "t1 c,t2 c b,t3 b a c,t2 a b,t3 b a c,t3 c b a,t3 b a c,t2 b c"},
+  {0u, false, false, false, "t2 a b,t3 b a c,t3 c b a,t3 c a b,t2 a c,t2 b a,t2 c a,t3 c a b,t1 a,t1 b,t1 c"},
+  {0u, true, true, false, "t1 c,t2 c b,t3 b a c,t2 a b,t3 b a c,t3 c b a,t3 b a c,t2 b c"},
+  {0u, false, true, false, "t2 a b,t3 b a c,t3 c b a,t3 c a b,t2 a c,t2 b a,t2 c a,t3 c a b,t1 a,t1 b,t1 c"},
+  {0u, true, true, true, "t1 c,t2 c b,t3 b a c,t2 a b,f3 b c a,t2 b c"},
+  {1u, true, false, false, "t3 b a c,t3 c a b,t3 b a c,t1 c"},
+  {1u, false, false, false, "t3 b a c,t3 c a b,t3 b a c,t1 c"},
+  {1u, true, true, false, "t3 b a c,t3 c a b,t3 b a c,t1 c"},
+  {1u, false, true, false, "t3 b a c,t3 c a b,t3 b a c,t1 c"},
+  {1u, true, true, true, "f3 a c b,t1 c"},
+  {2u, true, false, false, "t3 c b d,t3 d b c,t3 c b a,t4 c b a d,t3 b a c,t4 c b a d,t3 c a d,t3 d a c,t2 a b,t3 b a d,t4 d c b a,t4 c b a d,t2 b d,t3 d c b,t3 d b c,t2 c b,t2 b c,t2 d a,t3 d a b,t1 c,t2 c d"},
+  {2u, false, false, false, "t4 c b a d,t4 d b a c,t4 c b a d,t3 b a c,t4 c b a d,t4 d c a b,t3 c a b,t4 c b a d,t3 d a b,t4 d b a c,t4 c b a d,t2 a c,t3 c a d,t4 d c b a,t4 d c a b,t3 d a c,t3 c b a,t4 c b a d,t4 d b a c,t3 d b a,t3 d a b,t2 a d,t2 b a,t3 d c a,t4 d c a b,t4 c b a d,t2 c b,t2 b c,t2 d a,t3 d a b,t1 c,t1 d"},
+  {2u, true, true, false, "t3 c b d,t3 d b c,t3 c b a,t4 c b a d,t3 b a c,t4 c b a d,t3 c a d,t3 d a c,t2 a b,t3 b a d,t4 d c b a,t4 c b a d,t2 b d,t3 d c b,t3 d b c,t2 c b,t2 b c,t2 d a,t3 d a b,t1 c,t2 c d"},
+  {2u, false, true, false, "t3 b a c,t3 c a b,t4 c b a d,t3 d a c,t3 c a d,t2 a b,t3 b a c,t4 c b a d,t4 d c b a,t4 d c a b,t3 d a c,t3 c b a,f4 b a c d,t3 d b a,t3 d a b,t2 a d,t2 b a,t3 d c a,f4 c a d b,t2 c b,t2 b c,t2 d a,t3 d a b,t1 c,t1 d"},
+  {2u, true, true, true, "t3 b a c,t2 a b,t4 d c a b,t3 b a d,t3 c a b,t3 d a c,t4 d c b a,t4 d c a b,t3 c a d,t3 c b a,t4 c b a d,t3 d b a,t3 d a b,t2 a d,t2 b d,t3 d c b,f2 c b,t2 d a,t3 d a b,t1 c,t2 c d"},
+  {3u, true, false, false, "t1 a,t2 d b,t2 c a,t2 b a,t4 c b a d,t3 b a c,t4 c b a d,t3 c a b,t3 b a c,t2 a b,t4 d c b a,t3 d b a,t3 d a b,t3 d c a"},
+  {3u, false, false, false, "t4 c b a d,t4 d b a c,t3 b a d,t4 d c a b,t4 c b a d,t3 c a b,t3 b a c,t3 d a b,t4 d b a c,t4 c b a d,t4 d c b a,t4 d c a b,t3 c b a,t4 c b a d,t3 d b a,t3 d a b,t2 b a,t2 a b,t3 d c a,t4 d c a b,t4 c b a d,t2 c a,t3 c a b,t2 d b,t1 a,t1 b"},
+  {3u, true, true, false, "t1 a,t2 d b,t2 c a,t2 b a,t4 c b a d,t3 b a c,t4 c b a d,t3 c a b,t3 b a c,t2 a b,t4 d c b a,t3 d b a,t3 d a b,t3 d c a"},
+  {3u, false, true, false, "t4 c b a d,t4 d c a b,t4 c b a d,t3 c a b,t3 b a c,t3 d a c,t4 d c b a,t4 d c a b,t3 c a d,t3 c b a,t4 c b a d,t3 d b a,t3 d a b,t2 b a,t2 a b,t3 d c a,f4 c a d b,t2 c a,t3 c a b,t2 d b,t1 a,t1 b"},
+  {3u, true, true, true, "t1 a,t2 d b,t2 c a,t2 b a,t3 b a d,f3 a c b,t3 d a b,t2 a b,f4 d c b a,f3 d b a,t3 d c a"}};
+
+const std::vector<std::string> young_subgroup_results = {
+  "t2 b a,t3 a -c b,t2 -b c,t3 a -c b,t3 -a c b,t3 b -c a,t3 -b c a,t3 b c a",
+  "t3 a c b,t3 -a -b c,t3 a -b c,t3 -a b c,t3 a -c b",
+  "t4 -b -c d a,t4 b -c d a,t4 b c d a,t4 a -c -d b,t4 -a c -d b,t4 -a -c d b,t4 a -b -d c,t4 -a b -d c,t4 -a -b -c d,t4 a -b -c d,t4 -a b -c d,t4 a -b c d,t4 -a b c d,t4 -a -b -d c,t4 a -b -d c,t4 -a -b d c,t4 -a b d c,t4 a b d c,t4 -a -c -d b,t4 -a c -d b,t4 a c -d b,t4 a c d b,t4 -b -c -d a,t4 -b c -d a,t4 -b -c d a,t4 b -c d a",
+  "t4 b -c -d a,t4 -b c -d a,t4 -b -c d a,t4 b -c d a,t4 b c d a,t4 a -c -d b,t4 -a c -d b,t4 -a -c d b,t4 a c d b,t4 a -b -d c,t4 -a b -c d,t4 -a -b c d,t4 a -b -d c,t4 -a b -d c,t4 -a b d c,t4 -a -c -d b,t4 a -c -d b,t4 -a c d b,t4 -b -c -d a,t4 b -c -d a,t4 -b c -d a,t4 b c -d a,t4 b -c d a"};
+
+binary_truth_table spec_from_permutation( const std::vector<unsigned>& permutation )
+{
+  const auto n = permutation.size() == 8u ? 3u : 4u;
+
+  binary_truth_table spec;
+  for ( auto i = 0u; i < permutation.size(); ++i )
+  {
+    spec.add_entry( number_to_truth_table_cube( i, n ), number_to_truth_table_cube( permutation[i], n ) );
+  }
+  return spec;
+}
+
+/* rows, constants, and garbage */
+std::string embedding_to_string( const binary_truth_table& spec )
+{
+  std::stringstream s;
+  s << spec;
+  for ( const auto& c : spec.constants() )
+  {
+    s << ( c ? ( *c ? "1" : "0" ) : "-" );
+  }
+  s << " ";
+  for ( auto g : spec.garbage() )
+  {
+    s << g;
+  }
+  return s.str();
+}
+
+void check_embedding( const binary_truth_table& base, const std::string& expected, const properties::ptr& settings = properties::ptr() )
+{
+  binary_truth_table spec;
+  BOOST_REQUIRE( embed_truth_table( spec, base, settings ) );
+  BOOST_CHECK_EQUAL( embedding_to_string( spec ), expected );
+
+  dense_truth_table dense;
+  BOOST_REQUIRE( embed_truth_table( dense, base, settings ) );
+  binary_truth_table back;
+  dense_truth_table_to_truth_table( dense, back );
+  BOOST_CHECK_EQUAL( embedding_to_string( back ), expected );
+}
+
+/* one cube per minterm over the support, such that the circuits of
+   young_subgroup_synthesis do not depend on an ESOP minimizer */
+dd_based_esop_optimization_func minterm_esop_func()
+{
+  auto settings = std::make_shared<properties>();
+  dd_based_esop_optimization_func f = [settings]( DdManager* dd, DdNode* node ) {
+    const auto on_cube = settings->get<cube_function_t>( "on_cube" );
+    const unsigned n = Cudd_ReadSize( dd );
+
+    std::vector<int> inputs( n );
+    const auto eval = [&]( unsigned a ) {
+      for ( auto j = 0u; j < n; ++j )
+      {
+        inputs[j] = ( a >> j ) & 1u;
+      }
+      return Cudd_Eval( dd, node, inputs.data() ) == Cudd_ReadOne( dd );
+    };
+
+    auto support = 0u;
+    for ( auto a = 0u; a < ( 1u << n ); ++a )
+    {
+      for ( auto j = 0u; j < n; ++j )
+      {
+        if ( eval( a ) != eval( a ^ ( 1u << j ) ) )
+        {
+          support |= 1u << j;
+        }
+      }
+    }
+
+    for ( auto a = 0u; a < ( 1u << n ); ++a )
+    {
+      if ( ( a & ~support ) || !eval( a ) ) { continue; }
+      on_cube( std::make_pair( boost::dynamic_bitset<>( n, a ), boost::dynamic_bitset<>( n, support ) ) );
+    }
+  };
+  f.init( settings, std::make_shared<properties>() );
+  return f;
+}
+
+}
+
 BOOST_AUTO_TEST_CASE(simple)
 {
   using boost::test_tools::output_test_stream;
@@ -65,6 +212,116 @@ BOOST_AUTO_TEST_CASE(simple)
   }
 }
 
+BOOST_AUTO_TEST_CASE(dense)
+{
+  using namespace cirkit;
+
+  /* x0 x1 x2 -> x0 x1 (x2 xor x0x1), with the last row reversed */
+  const unsigned values[] = { 0u, 1u, 2u, 3u, 4u, 5u, 7u, 6u };
+
+  binary_truth_table spec;
+  for ( unsigned i = 0u; i < 8u; ++i )
+  {
+    spec.add_entry( number_to_truth_table_cube( i, 3u ), number_to_truth_table_cube( values[i], 3u ) );
+  }
+
+  const auto dense = dense_truth_table_from_truth_table( spec );
+  BOOST_CHECK( dense.is_fully_specified() );
+  BOOST_CHECK( dense.is_reversible() );
+  for ( unsigned i = 0u; i < 8u; ++i )
+  {
+    BOOST_CHECK( dense.row_value( i ) == values[i] );
+  }
+
+  binary_truth_table back;
+  dense_truth_table_to_truth_table( dense, back );
+  BOOST_CHECK( truth_table_to_bitset_vector( back ) == truth_table_to_bitset_vector( spec ) );
+
+  circuit circ;
+  BOOST_CHECK( transformation_based_synthesis( circ, dense ) );
+
+  dense_truth_table sim;
+  BOOST_CHECK( circuit_to_truth_table( circ, sim ) );
+  for ( unsigned i = 0u; i < 8u; ++i )
+  {
+    BOOST_CHECK( sim.row_value( i ) == values[i] );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(tbs_regression)
+{
+  for ( const auto& r : tbs_results )
+  {
+    const auto spec = spec_from_permutation( permutations[r.permutation] );
+
+    auto settings = std::make_shared<properties>();
+    settings->set( "bidirectional", r.bidirectional );
+    settings->set( "fredkin", r.fredkin );
+    settings->set( "fredkin_lookback", r.fredkin_lookback );
+
+    circuit circ;
+    BOOST_REQUIRE( transformation_based_synthesis( circ, spec, settings ) );
+    BOOST_CHECK_EQUAL( circuit_to_string( circ ), r.circuit );
+
+    circuit circ_dense;
+    BOOST_REQUIRE( transformation_based_synthesis( circ_dense, dense_truth_table_from_truth_table( spec ), settings ) );
+    BOOST_CHECK_EQUAL( circuit_to_string( circ_dense ), r.circuit );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(embed_regression)
+{
+  /* full adder (sum, carry) */
+  binary_truth_table adder;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    const auto ones = ( i & 1u ) + ( ( i >> 1u ) & 1u ) + ( ( i >> 2u ) & 1u );
+    adder.add_entry( number_to_truth_table_cube( i, 3u ), number_to_truth_table_cube( ( ( ones & 1u ) << 1u ) | ( ones >> 1u ), 2u ) );
+  }
+  check_embedding( adder, "0000 0000\n0001 1001\n0010 1010\n0011 0111\n0100 1000\n0101 0101\n0110 0110\n0111 1111\n1000 1100\n1001 0001\n1010 0010\n1011 1011\n1100 0100\n1101 1101\n1110 1110\n1111 0011\n0--- 0011" );
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "output_order", std::vector<unsigned>( {2u, 0u} ) );
+  check_embedding( adder, "0000 0000\n0001 0011\n0010 0010\n0011 1001\n0100 0110\n0101 1101\n0110 1100\n0111 1111\n1000 1000\n1001 0001\n1010 1010\n1011 1011\n1100 0100\n1101 0101\n1110 1110\n1111 0111\n0--- 0101", settings );
+
+  /* majority, garbage lines only */
+  binary_truth_table maj;
+  for ( auto i = 0u; i < 8u; ++i )
+  {
+    const auto ones = ( i & 1u ) + ( ( i >> 1u ) & 1u ) + ( ( i >> 2u ) & 1u );
+    maj.add_entry( number_to_truth_table_cube( i, 3u ), number_to_truth_table_cube( ones >= 2u ? 1u : 0u, 1u ) );
+  }
+  check_embedding( maj, "000 000\n001 001\n010 010\n011 111\n100 011\n101 101\n110 110\n111 100\n--- 011" );
+
+  /* more outputs than inputs, constant lines only */
+  binary_truth_table wide;
+  const unsigned outputs[] = {0u, 3u, 5u, 6u};
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    wide.add_entry( number_to_truth_table_cube( i, 2u ), number_to_truth_table_cube( outputs[i], 3u ) );
+  }
+  check_embedding( wide, "000 000\n001 011\n010 101\n011 110\n100 100\n101 001\n110 010\n111 111\n0-- 000" );
+}
+
+BOOST_AUTO_TEST_CASE(young_subgroup_regression)
+{
+  for ( auto i = 0u; i < permutations.size(); ++i )
+  {
+    const auto spec = spec_from_permutation( permutations[i] );
+
+    auto settings = std::make_shared<properties>();
+    settings->set( "esopmin", minterm_esop_func() );
+
+    circuit circ;
+    BOOST_REQUIRE( young_subgroup_synthesis( circ, spec, settings ) );
+    BOOST_CHECK_EQUAL( circuit_to_string( circ ), young_subgroup_results[i] );
+
+    circuit circ_dense;
+    BOOST_REQUIRE( young_subgroup_synthesis( circ_dense, dense_truth_table_from_truth_table( spec ), settings ) );
+    BOOST_CHECK_EQUAL( circuit_to_string( circ_dense ), young_subgroup_results[i] );
+  }
+}
+
 // Local Variables:
 // c-basic-offset: 2
 // eval: (c-set-offset 'substatement-open 0)
@@ -169,6 +169,11 @@ int main( int argc, char ** argv )
   std::cout << format( "[i] run-time (wc):   %.2f" ) % wc_statistics->get<double>( "runtime" ) << std::endl;
   std::cout << format( "[i] run-time (ac):   %.2f" ) % ac_statistics->get<double>( "runtime" ) << std::endl;
 
+  if ( opts.is_set( "verbose" ) )
+  {
+    manager->dump_stats( std::cout );
+  }
+
   return 0;
 }
 
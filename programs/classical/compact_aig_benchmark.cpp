@@ -0,0 +1,182 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <random>
+
+#include <boost/format.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/aig.hpp>
+#include <classical/compact_aig/compact_aig.hpp>
+#include <classical/compact_aig/compact_aig_simulate.hpp>
+#include <classical/compact_aig/compact_aig_strash.hpp>
+#include <classical/functions/strash.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+/* random operand pairs, such that both representations get the same gates;
+   operands mainly refer to recently created gates to obtain deep designs */
+std::vector<std::pair<unsigned, unsigned>> random_operands( unsigned num_inputs, unsigned num_gates, unsigned window, unsigned seed )
+{
+  std::mt19937 gen( seed );
+  std::vector<std::pair<unsigned, unsigned>> operands( num_gates );
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto size = num_inputs + i;
+    const auto lower = size > window ? size - window : 0u;
+    std::uniform_int_distribution<unsigned> dist( 2u * lower, 2u * size - 1u );
+    operands[i] = {dist( gen ), dist( gen )};
+  }
+
+  return operands;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::format;
+
+  auto num_inputs = 256u;
+  auto num_gates  = 1000000u;
+  auto window     = 10000u;
+  auto seed       = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "inputs", value_with_default( &num_inputs ), "Number of inputs" )
+    ( "gates",  value_with_default( &num_gates ),  "Number of AND operations" )
+    ( "window", value_with_default( &window ),     "Fanin window" )
+    ( "seed",   value_with_default( &seed ),       "Random seed" )
+    ( "skip_aig_graph,s",                          "Only run compact AIG" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  const auto operands = random_operands( num_inputs, num_gates, window, seed );
+
+  /* compact AIG */
+  {
+    auto build_time = 0.0;
+    compact_aig caig;
+    {
+      reference_timer t( &build_time );
+      std::vector<compact_aig::literal> fs;
+      for ( auto i = 0u; i < num_inputs; ++i )
+      {
+        fs.push_back( caig.create_pi() );
+      }
+      for ( const auto& p : operands )
+      {
+        fs.push_back( caig.create_and( fs[p.first >> 1u] ^ ( p.first & 1u ), fs[p.second >> 1u] ^ ( p.second & 1u ) ) );
+      }
+      for ( auto i = 0u; i < 64u && i < fs.size(); ++i )
+      {
+        caig.create_po( fs[fs.size() - 1u - i] );
+      }
+    }
+
+    auto strash_statistics = std::make_shared<properties>();
+    const auto caig2 = compact_aig_strash( caig, properties::ptr(), strash_statistics );
+
+    auto sim_time = 0.0;
+    {
+      reference_timer t( &sim_time );
+      std::vector<uint64_t> words( caig2.num_inputs() * 4u );
+      std::mt19937_64 gen( seed );
+      for ( auto& w : words ) { w = gen(); }
+      compact_aig_simulate( caig2, words, 4u );
+    }
+
+    const auto& strash = caig.strash();
+    std::cout << "[i] compact_aig" << std::endl
+              << format( "[i]   gates:              %d (%d after strash)" ) % caig.num_gates() % caig2.num_gates() << std::endl
+              << format( "[i]   build time:         %.2f secs" ) % build_time << std::endl
+              << format( "[i]   strash time:        %.2f secs" ) % strash_statistics->get<double>( "runtime" ) << std::endl
+              << format( "[i]   simulation time:    %.2f secs (256 patterns)" ) % sim_time << std::endl
+              << format( "[i]   memory:             %.2f MB" ) % ( caig.memory() / 1048576.0 ) << std::endl
+              << format( "[i]   avg. probe length:  %.2f (max %d, load %.2f)" ) % strash.average_probe_length() % strash.max_probe_length() % strash.load_factor() << std::endl;
+  }
+
+  if ( opts.is_set( "skip_aig_graph" ) )
+  {
+    return 0;
+  }
+
+  /* aig_graph */
+  {
+    auto build_time = 0.0;
+    aig_graph aig;
+    {
+      reference_timer t( &build_time );
+      aig_initialize( aig );
+      std::vector<aig_function> fs;
+      for ( auto i = 0u; i < num_inputs; ++i )
+      {
+        fs.push_back( aig_create_pi( aig, boost::str( format( "x%d" ) % i ) ) );
+      }
+      for ( const auto& p : operands )
+      {
+        fs.push_back( aig_create_and( aig, fs[p.first >> 1u] ^ ( p.first & 1u ), fs[p.second >> 1u] ^ ( p.second & 1u ) ) );
+      }
+      for ( auto i = 0u; i < 64u && i < fs.size(); ++i )
+      {
+        aig_create_po( aig, fs[fs.size() - 1u - i], boost::str( format( "y%d" ) % i ) );
+      }
+    }
+
+    auto strash_time = 0.0;
+    aig_graph aig2;
+    {
+      reference_timer t( &strash_time );
+      aig_initialize( aig2 );
+      strash( aig, aig2 );
+    }
+
+    std::cout << "[i] aig_graph" << std::endl
+              << format( "[i]   gates:              %d (%d after strash)" ) % ( num_vertices( aig ) - num_inputs - 1u ) % ( num_vertices( aig2 ) - num_inputs - 1u ) << std::endl
+              << format( "[i]   build time:         %.2f secs" ) % build_time << std::endl
+              << format( "[i]   strash time:        %.2f secs" ) % strash_time << std::endl;
+  }
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,190 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <cstdint>
+#include <random>
+#include <thread>
+
+#include <boost/format.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/parallel_compute.hpp>
+#include <classical/io/read_aiger.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+/* random AIG in which gates mainly connect to recently created nodes, such
+   that the graph has many levels as in real designs */
+void create_random_aig( aig_graph& aig, unsigned num_inputs, unsigned num_gates, unsigned window, unsigned seed )
+{
+  aig_initialize( aig );
+  aig_info( aig ).enable_local_optimization = false;
+  aig_info( aig ).enable_strashing = false;
+
+  std::vector<aig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( aig_create_pi( aig, boost::str( boost::format( "x%d" ) % i ) ) );
+  }
+
+  std::mt19937 gen( seed );
+  std::bernoulli_distribution compl_dist;
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto lower = fs.size() > window ? fs.size() - window : 0u;
+    std::uniform_int_distribution<std::size_t> dist( lower, fs.size() - 1u );
+
+    const auto a = dist( gen );
+    auto b = dist( gen );
+    if ( a == b ) { b = ( b == lower ) ? fs.size() - 1u : lower; }
+    fs.push_back( aig_create_and( aig, fs[a] ^ compl_dist( gen ), fs[b] ^ compl_dist( gen ) ) );
+  }
+
+  for ( auto i = 0u; i < std::min<unsigned>( 64u, fs.size() ); ++i )
+  {
+    aig_create_po( aig, fs[fs.size() - 1u - i], boost::str( boost::format( "y%d" ) % i ) );
+  }
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::format;
+  using boost::program_options::value;
+
+  std::string filename;
+  auto num_inputs  = 128u;
+  auto num_gates   = 500000u;
+  auto window      = 1000u;
+  auto max_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  auto rounds      = 10u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "filename",    value( &filename ),                 "AIG filename (if not set, a random AIG is generated)" )
+    ( "inputs",      value_with_default( &num_inputs ),  "Number of inputs of random AIG" )
+    ( "gates",       value_with_default( &num_gates ),   "Number of gates of random AIG" )
+    ( "window",      value_with_default( &window ),      "Fanin window of random AIG" )
+    ( "max_threads", value_with_default( &max_threads ), "Scale from 1 to this number of threads" )
+    ( "rounds",      value_with_default( &rounds ),      "Number of simulation rounds (64 patterns each) per measurement" )
+    ( "seed",        value_with_default( &seed ),        "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || max_threads == 0u || rounds == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  aig_graph aig;
+  if ( opts.is_set( "filename" ) )
+  {
+    try
+    {
+      read_aiger( aig, filename );
+    }
+    catch ( const char* msg )
+    {
+      std::cerr << msg << std::endl;
+      return 2;
+    }
+  }
+  else
+  {
+    create_random_aig( aig, num_inputs, num_gates, window, seed );
+  }
+
+  const auto& info = aig_info( aig );
+  const aig_levelization levels( aig );
+  std::cout << format( "[i] nodes: %d   inputs: %d   outputs: %d   levels: %d" ) % num_vertices( aig ) % info.inputs.size() % info.outputs.size() % levels.num_levels() << std::endl;
+
+  std::mt19937_64 gen( seed );
+  std::vector<std::vector<uint64_t>> patterns( rounds, std::vector<uint64_t>( info.inputs.size() ) );
+  for ( auto& p : patterns )
+  {
+    for ( auto& w : p ) { w = gen(); }
+  }
+
+  const std::function<uint64_t( const uint64_t&, bool, const uint64_t&, bool )> on_and = []( const uint64_t& v1, bool c1, const uint64_t& v2, bool c2 ) {
+    return ( c1 ? ~v1 : v1 ) & ( c2 ? ~v2 : v2 );
+  };
+
+  std::vector<uint64_t> reference;
+  auto base_time = 0.0;
+
+  std::cout << "[i] threads   run-time   speedup   steals" << std::endl;
+  for ( auto t = 1u; t <= max_threads; ++t )
+  {
+    work_stealing_pool pool( t );
+    std::vector<uint64_t> values, signature( rounds );
+    auto runtime = 0.0;
+
+    {
+      reference_timer timer( &runtime );
+      for ( auto r = 0u; r < rounds; ++r )
+      {
+        const auto& p = patterns[r];
+        parallel_compute<uint64_t>( aig, pool, 0ull, [&p]( unsigned index ) { return p[index]; }, on_and, values );
+
+        for ( const auto& o : info.outputs )
+        {
+          signature[r] ^= o.first.complemented ? ~values[o.first.node] : values[o.first.node];
+        }
+      }
+    }
+
+    if ( t == 1u )
+    {
+      reference = signature;
+      base_time = runtime;
+    }
+    else if ( signature != reference )
+    {
+      std::cerr << "[e] simulation results differ for " << t << " threads" << std::endl;
+      return 3;
+    }
+
+    std::cout << format( "[i] %7d   %8.2f   %7.2f   %6d" ) % t % runtime % ( base_time / runtime ) % pool.num_steals() << std::endl;
+  }
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
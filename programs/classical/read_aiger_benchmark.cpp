@@ -0,0 +1,136 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <boost/format.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/aig.hpp>
+#include <classical/io/read_aiger.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+void print_result( const std::string& name, const aig_graph& aig, double runtime )
+{
+  using boost::format;
+
+  const auto& info = aig_info( aig );
+  std::cout << format( "[i] %s" ) % name << std::endl
+            << format( "[i]   inputs:   %d" ) % info.inputs.size() << std::endl
+            << format( "[i]   outputs:  %d" ) % info.outputs.size() << std::endl
+            << format( "[i]   gates:    %d" ) % ( num_vertices( aig ) - info.inputs.size() - 1u ) << std::endl
+            << format( "[i]   run-time: %.2f secs (best run)" ) % runtime << std::endl;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  std::string filename;
+  auto runs        = 3u;
+  auto num_threads = 0u;
+
+  program_options opts;
+  opts.add_options()
+    ( "filename",     value( &filename ),                 "AIG filename (in binary AIGER format, without latches)" )
+    ( "runs",         value_with_default( &runs ),        "Number of runs per reader" )
+    ( "threads",      value_with_default( &num_threads ), "Threads for decoding in read_aiger_mapped (0: all cores)" )
+    ( "no_strash,n",                                      "Do not strash gates (read_aiger_binary with noopt)" )
+    ( "skip_symbols,y",                                   "Do not read the symbol table in read_aiger_mapped" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || !opts.is_set( "filename" ) || runs == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  const auto noopt = opts.is_set( "no_strash" );
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "strash", !noopt );
+  settings->set( "symbols", !opts.is_set( "skip_symbols" ) );
+  settings->set( "num_threads", num_threads );
+
+  try
+  {
+    /* read_aiger_binary */
+    {
+      auto best = std::numeric_limits<double>::max();
+      aig_graph aig;
+      for ( auto i = 0u; i < runs; ++i )
+      {
+        auto runtime = 0.0;
+        aig = aig_graph();
+        {
+          reference_timer t( &runtime );
+          read_aiger_binary( aig, filename, noopt );
+        }
+        best = std::min( best, runtime );
+      }
+      print_result( "read_aiger_binary", aig, best );
+    }
+
+    /* read_aiger_mapped */
+    {
+      auto best = std::numeric_limits<double>::max();
+      aig_graph aig;
+      for ( auto i = 0u; i < runs; ++i )
+      {
+        auto runtime = 0.0;
+        aig = aig_graph();
+        {
+          reference_timer t( &runtime );
+          read_aiger_mapped( aig, filename, settings );
+        }
+        best = std::min( best, runtime );
+      }
+      print_result( "read_aiger_mapped", aig, best );
+    }
+  }
+  catch ( const char* msg )
+  {
+    std::cerr << msg << std::endl;
+    return 2;
+  }
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
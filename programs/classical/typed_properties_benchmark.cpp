@@ -0,0 +1,155 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <random>
+
+#include <boost/format.hpp>
+
+#include <core/properties.hpp>
+#include <core/utils/program_options.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_rewrite.hpp>
+
+using namespace cirkit;
+
+/* small random XMGs, like the cones that are rewritten per node or per LUT */
+std::vector<xmg_graph> random_cones( unsigned num_cones, unsigned num_inputs, unsigned num_gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+  std::vector<xmg_graph> cones( num_cones );
+
+  for ( auto& xmg : cones )
+  {
+    std::vector<xmg_function> fs;
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      fs.push_back( xmg.create_pi( boost::str( boost::format( "x%d" ) % i ) ) );
+    }
+
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+      std::uniform_int_distribution<unsigned> dist( 0u, fs.size() - 1u );
+      const auto a = fs[dist( gen )] ^ ( gen() & 1u );
+      const auto b = fs[dist( gen )] ^ ( gen() & 1u );
+      const auto c = fs[dist( gen )] ^ ( gen() & 1u );
+      fs.push_back( ( gen() % 3u == 0u ) ? xmg.create_xor( a, b ) : xmg.create_maj( a, b, c ) );
+    }
+
+    xmg.create_po( fs.back(), "f" );
+  }
+
+  return cones;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::format;
+
+  auto num_cones  = 1000u;
+  auto num_inputs = 6u;
+  auto num_gates  = 16u;
+  auto rounds     = 100u;
+  auto seed       = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "cones",  value_with_default( &num_cones ),  "Number of cones" )
+    ( "inputs", value_with_default( &num_inputs ), "Number of inputs per cone" )
+    ( "gates",  value_with_default( &num_gates ),  "Number of gates per cone" )
+    ( "rounds", value_with_default( &rounds ),     "Number of times each cone is rewritten" )
+    ( "seed",   value_with_default( &seed ),       "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  const auto cones = random_cones( num_cones, num_inputs, num_gates, seed );
+  const auto calls = static_cast<double>( num_cones ) * rounds;
+
+  /* properties, as done by callers that create settings for each call */
+  auto properties_time = 0.0;
+  auto properties_gates = 0ul;
+  {
+    reference_timer t( &properties_time );
+    for ( auto r = 0u; r < rounds; ++r )
+    {
+      for ( const auto& cone : cones )
+      {
+        const auto settings = std::make_shared<properties>();
+        const auto statistics = std::make_shared<properties>();
+        settings->set( "keep_bitmarks", false );
+        const auto result = xmg_rewrite_top_down( cone, rewrite_default_maj, rewrite_default_xor, settings, statistics );
+        properties_gates += result.num_gates();
+      }
+    }
+  }
+
+  /* typed parameters */
+  auto typed_time = 0.0;
+  auto typed_gates = 0ul;
+  {
+    reference_timer t( &typed_time );
+    xmg_rewrite_params params;
+    params.keep_bitmarks = false;
+    for ( auto r = 0u; r < rounds; ++r )
+    {
+      for ( const auto& cone : cones )
+      {
+        xmg_rewrite_stats stats;
+        const auto result = xmg_rewrite_top_down( cone, rewrite_default_maj, rewrite_default_xor, params, stats );
+        typed_gates += result.num_gates();
+      }
+    }
+  }
+
+  if ( properties_gates != typed_gates )
+  {
+    std::cout << "[e] results differ" << std::endl;
+    return 1;
+  }
+
+  std::cout << format( "[i] calls:      %d" ) % static_cast<unsigned long>( calls ) << std::endl
+            << format( "[i] properties: %.2f secs (%.2f us per call)" ) % properties_time % ( 1e6 * properties_time / calls ) << std::endl
+            << format( "[i] typed:      %.2f secs (%.2f us per call)" ) % typed_time % ( 1e6 * typed_time / calls ) << std::endl
+            << format( "[i] speedup:    %.2fx" ) % ( properties_time / typed_time ) << std::endl;
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -108,10 +108,12 @@ ALICE_BEGIN(cirkit)
 
   ADD_READ_COMMAND( aiger, "Aiger" );
   ADD_READ_COMMAND( bench, "Bench" );
+  ADD_READ_COMMAND( binary, "Binary network" );
   ADD_READ_COMMAND( pla, "PLA" );
   ADD_READ_COMMAND( verilog, "Verilog" );
   ADD_READ_COMMAND( yig, "YIG" );
   ADD_WRITE_COMMAND( aiger, "Aiger" );
+  ADD_WRITE_COMMAND( binary, "Binary network" );
   ADD_WRITE_COMMAND( edgelist, "Edge list" );
   ADD_WRITE_COMMAND( pla, "PLA" );
   ADD_WRITE_COMMAND( smt, "SMT-LIB2" );
@@ -33,6 +33,7 @@
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/utils/cube2.hpp>
+#include <classical/utils/wide_cube.hpp>
 
 namespace cirkit
 {
@@ -41,6 +42,7 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+template<typename Cube>
 class gia_extract_cover_manager
 {
 public:
@@ -56,7 +58,7 @@ public:
   gia_graph::esop_ptr run()
   {
     gia.foreach_input( [this]( int index, int i ) {
-        const auto c = cube2::elementary_cube( i );
+        const auto c = Cube::elementary_cube( i );
         cubes.append_singleton( index, c );
       } );
 
@@ -82,9 +84,9 @@ public:
 
         for ( auto j = 0; j < gia.num_inputs(); ++j )
         {
-          if ( ( c.mask >> j ) & 1 )
+          if ( c.has_var( j ) )
           {
-            abc::Vec_IntPush( level, ( j << 1u ) | !( ( c.bits >> j ) & 1 ) );
+            abc::Vec_IntPush( level, ( j << 1u ) | !c.polarity( j ) );
           }
         }
 
@@ -95,10 +97,10 @@ public:
     return gia_graph::esop_ptr( esop, &abc::Vec_WecFree );
   }
 
-  std::vector<cube2> run2()
+  std::vector<Cube> run2()
   {
     gia.foreach_input( [this]( int index, int i ) {
-        const auto c = cube2::elementary_cube( i );
+        const auto c = Cube::elementary_cube( i );
         cubes.append_singleton( index, c );
       } );
 
@@ -121,7 +123,7 @@ public:
   }
 
 private:
-  using cube_vec_t = std::vector<cube2>;
+  using cube_vec_t = std::vector<Cube>;
 
   void prepare_child( int index, bool cpl, cube_vec_t& v )
   {
@@ -134,13 +136,13 @@ private:
     {
       if ( cubes.size( index ) == 0u )
       {
-        v.push_back( cube2::one_cube() );
+        v.push_back( Cube::one_cube() );
       }
       else
       {
         auto first = cubes.at( index, 0u );
         auto offset = 0u;
-        if ( first == cube2::one_cube() )
+        if ( first == Cube::one_cube() )
         {
           offset = 1u;
         }
@@ -152,7 +154,7 @@ private:
         }
         else
         {
-          v.push_back( cube2::one_cube() );
+          v.push_back( Cube::one_cube() );
         }
         cubes.copy_to( index, v, offset );
       }
@@ -171,7 +173,7 @@ private:
     for ( const auto& c1 : cubes1 )
     {
       /* left child is 1 function */
-      if ( c1 == cube2::one_cube() )
+      if ( c1 == Cube::one_cube() )
       {
         for ( const auto& c2 : cubes2 )
         {
@@ -182,14 +184,14 @@ private:
 
       for ( const auto& c2 : cubes2 )
       {
-        if ( c2 == cube2::one_cube() )
+        if ( c2 == Cube::one_cube() )
         {
           add_to_levels( c1 );
           continue;
         }
 
         auto p = c1 & c2;
-        if ( p != cube2::zero_cube() )
+        if ( p != Cube::zero_cube() )
         {
           add_to_levels( p );
         }
@@ -206,7 +208,7 @@ private:
     cubes.append_vector( index, res );
   }
 
-  void add_to_levels( const cube2& c )
+  void add_to_levels( const Cube& c )
   {
     const auto level = c.num_literals();
 
@@ -218,7 +220,7 @@ private:
       return;
     }
 
-    if ( c == cube2::one_cube() )
+    if ( c == Cube::one_cube() )
     {
       levels.add( 0u, c );
       return;
@@ -252,10 +254,10 @@ private:
 
 private:
   const gia_graph& gia;
-  flat_2d_vector<cube2> cubes;
+  flat_2d_vector<Cube> cubes;
   cube_vec_t cubes1;
   cube_vec_t cubes2;
-  hash_buckets<cube2> levels;
+  hash_buckets<Cube> levels;
 
   bool minimize = true;
   bool progress = false;
@@ -273,16 +275,26 @@ private:
 
 gia_graph::esop_ptr gia_extract_cover( const gia_graph& gia, const properties::ptr& settings, const properties::ptr& statistics )
 {
-  gia_extract_cover_manager mgr( gia, settings );
-  return mgr.run();
+  gia_graph::esop_ptr esop( nullptr, &abc::Vec_WecFree );
+  with_cube_type( gia.num_inputs(), [&]( auto tag ) {
+      gia_extract_cover_manager<decltype( tag )> mgr( gia, settings );
+      esop = mgr.run();
+    } );
+  return esop;
 }
 
-std::vector<cube2> gia_extract_cover2( const gia_graph& gia, const properties::ptr& settings, const properties::ptr& statistics )
+template<typename Cube>
+std::vector<Cube> gia_extract_cover2( const gia_graph& gia, const properties::ptr& settings, const properties::ptr& statistics )
 {
-  gia_extract_cover_manager mgr( gia, settings );
+  gia_extract_cover_manager<Cube> mgr( gia, settings );
   return mgr.run2();
 }
 
+template std::vector<cube2>   gia_extract_cover2<cube2>( const gia_graph&, const properties::ptr&, const properties::ptr& );
+template std::vector<cube64>  gia_extract_cover2<cube64>( const gia_graph&, const properties::ptr&, const properties::ptr& );
+template std::vector<cube128> gia_extract_cover2<cube128>( const gia_graph&, const properties::ptr&, const properties::ptr& );
+template std::vector<cube256> gia_extract_cover2<cube256>( const gia_graph&, const properties::ptr&, const properties::ptr& );
+
 }
 
 // Local Variables:
@@ -29,7 +29,9 @@
  *
  * @brief ESOP cover extraction
  *
- * For now it's limited to single-output AIGs with at most 32 inputs
+ * gia_extract_cover2 is limited to single-output AIGs, the cube type
+ * determines the maximum number of inputs (see wide_cube.hpp);
+ * gia_extract_cover throws a std::string for more than 256 inputs
  *
  * @author Mathias Soeken
  * @since  2.3
@@ -41,12 +43,14 @@
 #include <core/properties.hpp>
 #include <classical/abc/gia/gia.hpp>
 #include <classical/utils/cube2.hpp>
+#include <classical/utils/wide_cube.hpp>
 
 namespace cirkit
 {
 
 gia_graph::esop_ptr gia_extract_cover( const gia_graph& gia, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
-std::vector<cube2> gia_extract_cover2( const gia_graph& gia, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
+template<typename Cube = cube2>
+std::vector<Cube> gia_extract_cover2( const gia_graph& gia, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 }
 
@@ -40,6 +40,7 @@
 
 #include <core/utils/bitset_utils.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/dd/arithmetic.hpp>
 #include <classical/dd/bdd_to_truth_table.hpp>
 #include <classical/dd/characteristic.hpp>
@@ -202,18 +203,47 @@ boost::multiprecision::uint256_t error_rate( const std::vector<bdd>& f, const st
                                              const properties::ptr& settings,
                                              const properties::ptr& statistics )
 {
+  const auto num_threads = get( settings, "num_threads", 1u );
+
   properties_timer t( statistics );
 
   assert_valid( f, fhat );
 
-  auto h = f.front().manager->bdd_bot();
-
-  for ( auto i = 0u; i < f.size(); ++i )
+  if ( num_threads == 1u )
   {
-    h = h || ( f[i] ^ fhat[i] );
+    auto h = f.front().manager->bdd_bot();
+
+    for ( auto i = 0u; i < f.size(); ++i )
+    {
+      h = h || ( f[i] ^ fhat[i] );
+    }
+
+    return count_solutions( h );
   }
 
-  return count_solutions( h );
+  /* compute the differences of all outputs concurrently and combine them
+     in a balanced OR tree */
+  auto mgr = f.front().manager;
+  std::vector<bdd> h( f.size() );
+  work_stealing_pool pool( num_threads );
+  run_concurrent( *mgr, [&]() {
+      pool.parallel_for( 0u, f.size(), [&]( std::size_t i, unsigned ) {
+          h[i] = f[i] ^ fhat[i];
+        } );
+
+      for ( auto stride = 1u; stride < h.size(); stride <<= 1u )
+      {
+        pool.parallel_for( 0u, ( h.size() + 2u * stride - 1u ) / ( 2u * stride ), [&]( std::size_t i, unsigned ) {
+            const auto j = 2u * stride * i;
+            if ( j + stride < h.size() )
+            {
+              h[j] = h[j] || h[j + stride];
+            }
+          } );
+      }
+    } );
+
+  return count_solutions( h.front() );
 }
 
 boost::multiprecision::uint256_t worst_case( const std::vector<bdd>& f, const std::vector<bdd>& fhat,
@@ -0,0 +1,215 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "compact_aig.hpp"
+
+#include <boost/graph/topological_sort.hpp>
+
+#include <classical/utils/aig_utils.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+constexpr compact_aig::literal compact_aig::no_fanin;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+compact_aig::compact_aig( std::size_t reserve )
+  : _strash( reserve << 1u )
+{
+  nodes.reserve( reserve + 1u );
+
+  /* constant */
+  nodes.push_back( {no_fanin, no_fanin} );
+}
+
+compact_aig::literal compact_aig::get_constant( bool value ) const
+{
+  return make_literal( 0u, value );
+}
+
+compact_aig::literal compact_aig::create_pi( const std::string& name )
+{
+  const auto n = static_cast<node>( nodes.size() );
+  nodes.push_back( {no_fanin, no_fanin} );
+  _inputs.push_back( n );
+  _input_names.push_back( name );
+  return make_literal( n, false );
+}
+
+void compact_aig::create_po( literal f, const std::string& name )
+{
+  _outputs.push_back( f );
+  _output_names.push_back( name );
+}
+
+compact_aig::literal compact_aig::create_and( literal a, literal b )
+{
+  const auto n = static_cast<node>( nodes.size() );
+
+  if ( _enable_structural_hashing )
+  {
+    if ( a > b ) { std::swap( a, b ); }
+
+    /* constants and trivial cases */
+    if ( a == 0u )         { return 0u; }
+    if ( a == 1u )         { return b; }
+    if ( a == b )          { return a; }
+    if ( ( a ^ b ) == 1u ) { return 0u; }
+
+    const auto key = ( static_cast<uint64_t>( a ) << 32u ) | b;
+    const auto r = _strash.insert( key, n );
+    if ( !r.second )
+    {
+      return make_literal( r.first, false );
+    }
+  }
+
+  nodes.push_back( {a, b} );
+  return make_literal( n, false );
+}
+
+compact_aig::literal compact_aig::create_nand( literal a, literal b )
+{
+  return create_and( a, b ) ^ 1u;
+}
+
+compact_aig::literal compact_aig::create_or( literal a, literal b )
+{
+  return create_nand( a ^ 1u, b ^ 1u );
+}
+
+compact_aig::literal compact_aig::create_xor( literal a, literal b )
+{
+  return create_or( create_and( a, b ^ 1u ), create_and( a ^ 1u, b ) );
+}
+
+compact_aig::literal compact_aig::create_ite( literal c, literal t, literal e )
+{
+  return create_or( create_and( c, t ), create_and( c ^ 1u, e ) );
+}
+
+std::size_t compact_aig::memory() const
+{
+  return nodes.capacity() * sizeof( node_t ) + _inputs.capacity() * sizeof( node ) + _outputs.capacity() * sizeof( literal ) + _strash.memory();
+}
+
+compact_aig compact_aig_from_aig( const aig_graph& aig )
+{
+  const auto& info = aig_info( aig );
+  assert( info.cis.empty() && "latches are not supported" );
+
+  compact_aig caig( num_vertices( aig ) );
+  caig.set_name( info.model_name );
+
+  std::vector<compact_aig::literal> lits( num_vertices( aig ), compact_aig::no_fanin );
+  lits[info.constant] = caig.get_constant( false );
+
+  for ( const auto& input : info.inputs )
+  {
+    const auto it = info.node_names.find( input );
+    lits[input] = caig.create_pi( it == info.node_names.end() ? std::string() : it->second );
+  }
+
+  std::vector<aig_node> topsort( num_vertices( aig ) );
+  boost::topological_sort( aig, topsort.begin() );
+
+  const auto& complementmap = boost::get( boost::edge_complement, aig );
+
+  for ( auto n : topsort )
+  {
+    if ( out_degree( n, aig ) == 0u ) { continue; }
+
+    const auto edges = boost::out_edges( n, aig );
+    const auto e0 = *edges.first;
+    const auto e1 = *std::next( edges.first );
+
+    lits[n] = caig.create_and( lits[boost::target( e0, aig )] ^ static_cast<unsigned>( complementmap[e0] ),
+                               lits[boost::target( e1, aig )] ^ static_cast<unsigned>( complementmap[e1] ) );
+  }
+
+  for ( const auto& output : info.outputs )
+  {
+    caig.create_po( lits[output.first.node] ^ static_cast<unsigned>( output.first.complemented ), output.second );
+  }
+
+  return caig;
+}
+
+aig_graph compact_aig_to_aig( const compact_aig& caig )
+{
+  aig_graph aig;
+  aig_initialize( aig, caig.name() );
+  auto& info = aig_info( aig );
+
+  std::vector<aig_function> fs( caig.size() );
+  fs[0u] = {info.constant, false};
+
+  for ( auto i = 0u; i < caig.num_inputs(); ++i )
+  {
+    fs[caig.inputs()[i]] = aig_create_pi( aig, caig.input_name( i ) );
+  }
+
+  const auto to_function = [&fs]( compact_aig::literal l ) {
+    return fs[compact_aig::get_node( l )] ^ compact_aig::is_complemented( l );
+  };
+
+  for ( auto n = 1u; n < caig.size(); ++n )
+  {
+    if ( !caig.is_and( n ) ) { continue; }
+    fs[n] = aig_create_and( aig, to_function( caig.fanin0( n ) ), to_function( caig.fanin1( n ) ) );
+  }
+
+  for ( auto i = 0u; i < caig.num_outputs(); ++i )
+  {
+    const auto f = to_function( caig.outputs()[i] );
+    if ( f.node == info.constant )
+    {
+      info.constant_used = true;
+    }
+    aig_create_po( aig, f, caig.output_name( i ) );
+  }
+
+  return aig;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
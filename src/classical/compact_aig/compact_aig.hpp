@@ -0,0 +1,145 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file compact_aig.hpp
+ *
+ * @brief Array-based AIG with 32-bit literals
+ *
+ * In contrast to aig_graph, which is based on boost's adjacency_list, this
+ * AIG stores all nodes in one contiguous array.  Each node consists of two
+ * fanin literals, where a literal is twice the node index plus the
+ * complement bit as in the AIGER format.  Node 0 is the constant 0 and
+ * inputs have no fanins.  Since gates can only be created from existing
+ * literals, the node array is always in topological order.  Structural
+ * hashing uses an open-addressing strash_table on the packed fanin
+ * literals.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef COMPACT_AIG_HPP
+#define COMPACT_AIG_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <core/utils/strash_table.hpp>
+#include <classical/aig.hpp>
+
+namespace cirkit
+{
+
+class compact_aig
+{
+public:
+  using literal = uint32_t;
+  using node    = uint32_t;
+
+  struct node_t
+  {
+    literal fanin0;
+    literal fanin1;
+  };
+
+  /* fanin literal of inputs and the constant */
+  static constexpr literal no_fanin = 0xffffffffu;
+
+public:
+  explicit compact_aig( std::size_t reserve = 0u );
+
+  static inline literal make_literal( node n, bool complemented ) { return ( n << 1u ) | static_cast<literal>( complemented ); }
+  static inline node    get_node( literal l )                     { return l >> 1u; }
+  static inline bool    is_complemented( literal l )              { return ( l & 1u ) == 1u; }
+
+  literal get_constant( bool value ) const;
+  literal create_pi( const std::string& name = std::string() );
+  void create_po( literal f, const std::string& name = std::string() );
+  literal create_and( literal a, literal b );
+  literal create_nand( literal a, literal b );
+  literal create_or( literal a, literal b );
+  literal create_xor( literal a, literal b );
+  literal create_ite( literal c, literal t, literal e );
+
+  inline std::size_t size() const        { return nodes.size(); }
+  inline unsigned num_inputs() const     { return _inputs.size(); }
+  inline unsigned num_outputs() const    { return _outputs.size(); }
+  inline unsigned num_gates() const      { return nodes.size() - _inputs.size() - 1u; }
+
+  inline bool is_constant( node n ) const { return n == 0u; }
+  inline bool is_input( node n ) const    { return n != 0u && nodes[n].fanin0 == no_fanin; }
+  inline bool is_and( node n ) const      { return nodes[n].fanin0 != no_fanin; }
+
+  inline literal fanin0( node n ) const   { return nodes[n].fanin0; }
+  inline literal fanin1( node n ) const   { return nodes[n].fanin1; }
+
+  inline const std::vector<node_t>& node_array() const { return nodes; }
+  inline const std::vector<node>& inputs() const       { return _inputs; }
+  inline const std::vector<literal>& outputs() const   { return _outputs; }
+  inline const std::string& input_name( unsigned i ) const  { return _input_names[i]; }
+  inline const std::string& output_name( unsigned i ) const { return _output_names[i]; }
+  inline void set_input_name( unsigned i, const std::string& name )  { _input_names[i] = name; }
+  inline void set_output_name( unsigned i, const std::string& name ) { _output_names[i] = name; }
+
+  inline const std::string& name() const           { return _name; }
+  inline void set_name( const std::string& name )   { _name = name; }
+
+  /* if disabled, gates are created without lookup and local optimization,
+     e.g., when reading trusted inputs; the strash table is not updated */
+  inline void set_structural_hashing( bool enabled ) { _enable_structural_hashing = enabled; }
+  inline bool has_structural_hashing() const         { return _enable_structural_hashing; }
+
+  inline const strash_table<uint64_t>& strash() const { return _strash; }
+
+  std::size_t memory() const;
+
+private:
+  std::vector<node_t>      nodes;
+  std::vector<node>        _inputs;
+  std::vector<literal>     _outputs;
+  std::vector<std::string> _input_names;
+  std::vector<std::string> _output_names;
+  std::string              _name;
+
+  bool                     _enable_structural_hashing = true;
+  strash_table<uint64_t>   _strash;
+};
+
+/* conversion from and to the adjacency_list based AIG (combinational part only) */
+compact_aig compact_aig_from_aig( const aig_graph& aig );
+aig_graph compact_aig_to_aig( const compact_aig& caig );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,143 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "compact_aig_cuts.hpp"
+
+#include <cassert>
+
+#include <core/utils/timer.hpp>
+#include <classical/functions/cuts/fixed_cut.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+using compact_aig_cut_t = fixed_cut<8u>;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+compact_aig_cuts::compact_aig_cuts( const compact_aig& caig, unsigned k, unsigned priority )
+  : _caig( caig ),
+    _k( k ),
+    _priority( priority ),
+    data( caig.size() )
+{
+  assert( k <= compact_aig_cut_t::max_size );
+  enumerate();
+}
+
+unsigned compact_aig_cuts::total_cut_count() const
+{
+  return data.sets_count();
+}
+
+double compact_aig_cuts::enumeration_time() const
+{
+  return _enumeration_time;
+}
+
+unsigned compact_aig_cuts::memory() const
+{
+  return data.memory();
+}
+
+unsigned compact_aig_cuts::count( compact_aig::node node ) const
+{
+  return data.count( node );
+}
+
+boost::iterator_range<paged_memory::iterator> compact_aig_cuts::cuts( compact_aig::node node )
+{
+  return data.sets( node );
+}
+
+void compact_aig_cuts::enumerate()
+{
+  reference_timer t( &_enumeration_time );
+
+  /* cuts are kept in fixed-size form for all nodes during enumeration */
+  std::vector<std::vector<compact_aig_cut_t>> node_cuts( _caig.size() );
+  std::vector<compact_aig_cut_t> local_cuts;
+
+  node_cuts[0u].push_back( compact_aig_cut_t() );
+  data.assign_empty( 0u );
+
+  for ( auto n = 1u; n < _caig.size(); ++n )
+  {
+    if ( !_caig.is_and( n ) )
+    {
+      node_cuts[n].push_back( compact_aig_cut_t::singleton( n ) );
+      data.assign_singleton( n, n );
+      continue;
+    }
+
+    local_cuts.clear();
+    compact_aig_cut_t new_cut;
+    for ( const auto& c1 : node_cuts[compact_aig::get_node( _caig.fanin0( n ) )] )
+    {
+      for ( const auto& c2 : node_cuts[compact_aig::get_node( _caig.fanin1( n ) )] )
+      {
+        if ( new_cut.merge( c1, c2, _k ) )
+        {
+          add_cut_with_dominance_filter( local_cuts, new_cut );
+        }
+      }
+    }
+
+    std::stable_sort( local_cuts.begin(), local_cuts.end(), []( const compact_aig_cut_t& c1, const compact_aig_cut_t& c2 ) { return c1.size() < c2.size(); } );
+    if ( local_cuts.size() > _priority )
+    {
+      local_cuts.resize( _priority );
+    }
+
+    data.append_begin( n );
+    for ( const auto& c : local_cuts )
+    {
+      data.append_set( n, c.to_vector() );
+    }
+    data.append_singleton( n, n );
+
+    local_cuts.push_back( compact_aig_cut_t::singleton( n ) );
+    node_cuts[n] = local_cuts;
+  }
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,82 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file compact_aig_cuts.hpp
+ *
+ * @brief Cut enumeration for compact AIGs based on paged memory
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef COMPACT_AIG_CUTS_HPP
+#define COMPACT_AIG_CUTS_HPP
+
+#include <boost/range/iterator_range.hpp>
+
+#include <core/utils/paged_memory.hpp>
+#include <classical/compact_aig/compact_aig.hpp>
+
+namespace cirkit
+{
+
+class compact_aig_cuts final
+{
+public:
+  using cut = paged_memory::set;
+
+  /* at most 8 leaves per cut, at most priority cuts (plus trivial cut) per node */
+  compact_aig_cuts( const compact_aig& caig, unsigned k, unsigned priority = 8u );
+
+  unsigned total_cut_count() const;
+  double enumeration_time() const;
+
+  unsigned memory() const;
+  unsigned count( compact_aig::node node ) const;
+  boost::iterator_range<paged_memory::iterator> cuts( compact_aig::node node );
+
+private:
+  void enumerate();
+
+private:
+  const compact_aig& _caig;
+  unsigned           _k;
+  unsigned           _priority;
+  paged_memory       data;
+
+  double             _enumeration_time = 0.0;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,281 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "compact_aig_io.hpp"
+
+#include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+unsigned compact_aiger_decode( std::istream& in )
+{
+  auto i = 0u;
+  auto res = 0u;
+
+  while ( true )
+  {
+    const auto c = in.get();
+    if ( c == std::char_traits<char>::eof() ) { throw "Error: unexpected end of file in AND section"; }
+    res |= ( ( c & 0x7F ) << ( 7 * i++ ) );
+    if ( !( c & 0x80 ) ) { break; }
+  }
+
+  return res;
+}
+
+void compact_aiger_encode( std::ostream& os, unsigned x )
+{
+  while ( x & ~0x7fu )
+  {
+    os.put( static_cast<char>( ( x & 0x7fu ) | 0x80u ) );
+    x >>= 7u;
+  }
+  os.put( static_cast<char>( x ) );
+}
+
+void read_compact_aiger_symbols( compact_aig& caig, std::istream& in )
+{
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    if ( line.empty() ) { continue; }
+    if ( line[0] == 'c' ) { break; }
+    if ( line[0] != 'i' && line[0] != 'o' ) { continue; }
+
+    const auto space = line.find( ' ' );
+    if ( space == std::string::npos ) { continue; }
+
+    const auto pos = std::stoul( line.substr( 1u, space - 1u ) );
+    const auto name = line.substr( space + 1u );
+
+    if ( line[0] == 'i' && pos < caig.num_inputs() )
+    {
+      caig.set_input_name( pos, name );
+    }
+    else if ( line[0] == 'o' && pos < caig.num_outputs() )
+    {
+      caig.set_output_name( pos, name );
+    }
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+void read_aiger( compact_aig& caig, std::istream& in, bool noopt )
+{
+  std::string line;
+  std::getline( in, line );
+  if ( in.fail() ) { throw "Error: could not read input file (check path and permissions)"; }
+
+  std::istringstream header( line );
+  std::string sig;
+  unsigned num_ids, num_inputs, num_latches, num_outputs, num_ands;
+  header >> sig >> num_ids >> num_inputs >> num_latches >> num_outputs >> num_ands;
+  if ( header.fail() || ( sig != "aag" && sig != "aig" ) ) { throw "Error: expect 'aag M I L O A' or 'aig M I L O A' as header"; }
+  if ( num_latches != 0u ) { throw "Error: latches are not supported yet"; }
+  if ( num_ids != num_inputs + num_ands ) { throw "Error: broken AIGER header"; }
+
+  const auto binary = sig == "aig";
+
+  caig = compact_aig( num_ids );
+  caig.set_structural_hashing( !noopt );
+
+  /* AIGER variable to literal in caig */
+  std::vector<compact_aig::literal> lits( num_ids + 1u, compact_aig::no_fanin );
+  lits[0u] = caig.get_constant( false );
+  const auto map_literal = [&lits]( unsigned l ) {
+    if ( lits[l >> 1u] == compact_aig::no_fanin ) { throw "Error: literal used before its definition"; }
+    return lits[l >> 1u] ^ ( l & 1u );
+  };
+
+  /* inputs */
+  if ( binary )
+  {
+    for ( auto i = 1u; i <= num_inputs; ++i )
+    {
+      lits[i] = caig.create_pi();
+    }
+  }
+  else
+  {
+    for ( auto i = 0u; i < num_inputs; ++i )
+    {
+      unsigned lit;
+      in >> lit;
+      if ( in.fail() || ( lit & 1u ) || ( lit >> 1u ) > num_ids ) { throw "Error: could not parse input definition"; }
+      lits[lit >> 1u] = caig.create_pi();
+    }
+  }
+
+  /* outputs */
+  std::vector<unsigned> oids( num_outputs );
+  for ( auto& oid : oids )
+  {
+    in >> oid;
+    if ( in.fail() || ( oid >> 1u ) > num_ids ) { throw "Error: could not parse output definition"; }
+  }
+
+  /* gates */
+  if ( binary )
+  {
+    std::getline( in, line ); /* rest of last output line */
+    for ( auto i = num_inputs + 1u; i <= num_ids; ++i )
+    {
+      const auto g  = i << 1u;
+      const auto o1 = g - compact_aiger_decode( in );
+      const auto o2 = o1 - compact_aiger_decode( in );
+      lits[i] = caig.create_and( map_literal( o1 ), map_literal( o2 ) );
+    }
+  }
+  else
+  {
+    /* gates in ASCII files may be in any order */
+    std::vector<std::pair<unsigned, unsigned>> defs( num_ids + 1u, {0u, 0u} );
+    std::vector<unsigned> order( num_ands );
+    for ( auto& lhs : order )
+    {
+      unsigned rhs0, rhs1;
+      in >> lhs >> rhs0 >> rhs1;
+      if ( in.fail() || ( lhs & 1u ) || ( lhs >> 1u ) > num_ids ) { throw "Error: could not parse gate definition"; }
+      lhs >>= 1u;
+      defs[lhs] = {rhs0, rhs1};
+    }
+    std::getline( in, line );
+
+    std::vector<unsigned> stack;
+    for ( auto root : order )
+    {
+      stack.push_back( root );
+      while ( !stack.empty() )
+      {
+        const auto v = stack.back();
+        if ( lits[v] != compact_aig::no_fanin ) { stack.pop_back(); continue; }
+
+        const auto c0 = defs[v].first >> 1u, c1 = defs[v].second >> 1u;
+        if ( lits[c0] == compact_aig::no_fanin || lits[c1] == compact_aig::no_fanin )
+        {
+          if ( stack.size() > num_ids ) { throw "Error: cyclic gate definition"; }
+          if ( lits[c0] == compact_aig::no_fanin ) { stack.push_back( c0 ); }
+          if ( lits[c1] == compact_aig::no_fanin ) { stack.push_back( c1 ); }
+          continue;
+        }
+
+        lits[v] = caig.create_and( map_literal( defs[v].first ), map_literal( defs[v].second ) );
+        stack.pop_back();
+      }
+    }
+  }
+
+  for ( auto oid : oids )
+  {
+    caig.create_po( map_literal( oid ) );
+  }
+
+  read_compact_aiger_symbols( caig, in );
+}
+
+void read_aiger( compact_aig& caig, const std::string& filename, bool noopt )
+{
+  std::ifstream in( filename.c_str(), std::ifstream::in | std::ifstream::binary );
+  read_aiger( caig, in, noopt );
+  caig.set_name( boost::filesystem::path( filename ).stem().string() );
+}
+
+void write_aiger( const compact_aig& caig, std::ostream& os )
+{
+  /* AIGER requires inputs to be the first variables */
+  std::vector<unsigned> index( caig.size(), 0u );
+  auto next = 1u;
+  for ( auto input : caig.inputs() )
+  {
+    index[input] = next++;
+  }
+  for ( auto n = 1u; n < caig.size(); ++n )
+  {
+    if ( caig.is_and( n ) ) { index[n] = next++; }
+  }
+
+  const auto map_literal = [&index]( compact_aig::literal l ) {
+    return ( index[compact_aig::get_node( l )] << 1u ) | ( l & 1u );
+  };
+
+  os << "aig " << ( next - 1u ) << " " << caig.num_inputs() << " 0 " << caig.num_outputs() << " " << caig.num_gates() << std::endl;
+
+  for ( auto o : caig.outputs() )
+  {
+    os << map_literal( o ) << std::endl;
+  }
+
+  for ( auto n = 1u; n < caig.size(); ++n )
+  {
+    if ( !caig.is_and( n ) ) { continue; }
+
+    auto r0 = map_literal( caig.fanin0( n ) );
+    auto r1 = map_literal( caig.fanin1( n ) );
+    if ( r0 < r1 ) { std::swap( r0, r1 ); }
+
+    const auto lhs = index[n] << 1u;
+    compact_aiger_encode( os, lhs - r0 );
+    compact_aiger_encode( os, r0 - r1 );
+  }
+
+  for ( auto i = 0u; i < caig.num_inputs(); ++i )
+  {
+    if ( !caig.input_name( i ).empty() ) { os << "i" << i << " " << caig.input_name( i ) << std::endl; }
+  }
+  for ( auto i = 0u; i < caig.num_outputs(); ++i )
+  {
+    if ( !caig.output_name( i ).empty() ) { os << "o" << i << " " << caig.output_name( i ) << std::endl; }
+  }
+}
+
+void write_aiger( const compact_aig& caig, const std::string& filename )
+{
+  std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+  write_aiger( caig, os );
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
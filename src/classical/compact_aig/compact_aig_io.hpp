@@ -0,0 +1,65 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file compact_aig_io.hpp
+ *
+ * @brief I/O routines for compact AIGs
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef COMPACT_AIG_IO_HPP
+#define COMPACT_AIG_IO_HPP
+
+#include <iostream>
+#include <string>
+
+#include <classical/compact_aig/compact_aig.hpp>
+
+namespace cirkit
+{
+
+/* reads ASCII (aag) and binary (aig) AIGER files without latches; if noopt
+   is true, gates are neither strashed nor simplified such that node indexes
+   correspond to the AIGER variables; structural hashing stays disabled
+   afterwards (use compact_aig_strash to obtain a strashed AIG) */
+void read_aiger( compact_aig& caig, std::istream& in, bool noopt = false );
+void read_aiger( compact_aig& caig, const std::string& filename, bool noopt = false );
+
+void write_aiger( const compact_aig& caig, std::ostream& os );
+void write_aiger( const compact_aig& caig, const std::string& filename );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
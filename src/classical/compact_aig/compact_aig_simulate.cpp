@@ -0,0 +1,103 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "compact_aig_simulate.hpp"
+
+#include <cassert>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+std::vector<uint64_t> compact_aig_simulate_nodes( const compact_aig& caig, const std::vector<uint64_t>& input_words, unsigned num_words )
+{
+  assert( input_words.size() == caig.num_inputs() * num_words );
+
+  std::vector<uint64_t> values( caig.size() * num_words, 0ull );
+
+  for ( auto i = 0u; i < caig.num_inputs(); ++i )
+  {
+    std::copy( input_words.begin() + i * num_words, input_words.begin() + ( i + 1u ) * num_words,
+               values.begin() + caig.inputs()[i] * num_words );
+  }
+
+  /* nodes are in topological order */
+  const auto& nodes = caig.node_array();
+  for ( auto n = 1u; n < caig.size(); ++n )
+  {
+    if ( nodes[n].fanin0 == compact_aig::no_fanin ) { continue; }
+
+    const auto m0 = uint64_t( 0 ) - ( nodes[n].fanin0 & 1u );
+    const auto m1 = uint64_t( 0 ) - ( nodes[n].fanin1 & 1u );
+    const auto* v0 = &values[compact_aig::get_node( nodes[n].fanin0 ) * num_words];
+    const auto* v1 = &values[compact_aig::get_node( nodes[n].fanin1 ) * num_words];
+    auto* v = &values[n * num_words];
+
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      v[w] = ( v0[w] ^ m0 ) & ( v1[w] ^ m1 );
+    }
+  }
+
+  return values;
+}
+
+std::vector<uint64_t> compact_aig_simulate( const compact_aig& caig, const std::vector<uint64_t>& input_words, unsigned num_words )
+{
+  const auto values = compact_aig_simulate_nodes( caig, input_words, num_words );
+
+  std::vector<uint64_t> outputs( caig.num_outputs() * num_words );
+  for ( auto i = 0u; i < caig.num_outputs(); ++i )
+  {
+    const auto o = caig.outputs()[i];
+    const auto m = uint64_t( 0 ) - ( o & 1u );
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      outputs[i * num_words + w] = values[compact_aig::get_node( o ) * num_words + w] ^ m;
+    }
+  }
+
+  return outputs;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,65 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file compact_aig_simulate.hpp
+ *
+ * @brief Bit-parallel simulation of compact AIGs
+ *
+ * Patterns are given as num_words 64-bit words per input, where word w of
+ * input i is at position i * num_words + w.  Results use the same layout
+ * for nodes or outputs, respectively.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef COMPACT_AIG_SIMULATE_HPP
+#define COMPACT_AIG_SIMULATE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <classical/compact_aig/compact_aig.hpp>
+
+namespace cirkit
+{
+
+/* simulation values for all nodes (non-complemented) */
+std::vector<uint64_t> compact_aig_simulate_nodes( const compact_aig& caig, const std::vector<uint64_t>& input_words, unsigned num_words = 1u );
+
+/* simulation values for all outputs */
+std::vector<uint64_t> compact_aig_simulate( const compact_aig& caig, const std::vector<uint64_t>& input_words, unsigned num_words = 1u );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
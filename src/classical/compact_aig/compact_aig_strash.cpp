@@ -0,0 +1,105 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "compact_aig_strash.hpp"
+
+#include <core/utils/timer.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+compact_aig compact_aig_strash( const compact_aig& caig,
+                                const properties::ptr&,
+                                const properties::ptr& statistics )
+{
+  properties_timer t( statistics );
+
+  /* mark nodes in the transitive fanin of the outputs (reverse topological order) */
+  std::vector<unsigned char> reachable( caig.size(), 0u );
+  for ( auto o : caig.outputs() )
+  {
+    reachable[compact_aig::get_node( o )] = 1u;
+  }
+  for ( auto n = caig.size(); n-- > 1u; )
+  {
+    if ( reachable[n] && caig.is_and( n ) )
+    {
+      reachable[compact_aig::get_node( caig.fanin0( n ) )] = 1u;
+      reachable[compact_aig::get_node( caig.fanin1( n ) )] = 1u;
+    }
+  }
+
+  compact_aig dest( caig.num_gates() );
+  dest.set_name( caig.name() );
+
+  std::vector<compact_aig::literal> lits( caig.size(), 0u );
+  for ( auto i = 0u; i < caig.num_inputs(); ++i )
+  {
+    lits[caig.inputs()[i]] = dest.create_pi( caig.input_name( i ) );
+  }
+
+  const auto map_literal = [&lits]( compact_aig::literal l ) {
+    return lits[compact_aig::get_node( l )] ^ ( l & 1u );
+  };
+
+  for ( auto n = 1u; n < caig.size(); ++n )
+  {
+    if ( !reachable[n] || !caig.is_and( n ) ) { continue; }
+    lits[n] = dest.create_and( map_literal( caig.fanin0( n ) ), map_literal( caig.fanin1( n ) ) );
+  }
+
+  for ( auto i = 0u; i < caig.num_outputs(); ++i )
+  {
+    dest.create_po( map_literal( caig.outputs()[i] ), caig.output_name( i ) );
+  }
+
+  if ( statistics )
+  {
+    statistics->set( "removed_gates", static_cast<unsigned>( caig.num_gates() - dest.num_gates() ) );
+  }
+
+  return dest;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -28,6 +28,7 @@
 
 #include <boost/assign/std/vector.hpp>
 
+#include <classical/functions/parallel_compute.hpp>
 #include <classical/utils/aig_utils.hpp>
 
 using namespace boost::assign;
@@ -93,6 +94,29 @@ std::vector<bdd> aig_to_bdd( const aig_graph& aig, const bdd_manager_ptr& mgr )
   return fs;
 }
 
+std::vector<bdd> aig_to_bdd( const aig_graph& aig, const bdd_manager_ptr& mgr, unsigned num_threads )
+{
+  auto info = aig_info( aig );
+
+  std::vector<bdd> values;
+  run_concurrent( *mgr, [&]() {
+      parallel_compute<bdd>( aig, mgr->bdd_bot(),
+                             [&mgr]( unsigned pos ) { return mgr->bdd_var( pos ); },
+                             []( const bdd& v1, bool c1, const bdd& v2, bool c2 ) {
+                               return ( c1 ? !v1 : v1 ) && ( c2 ? !v2 : v2 );
+                             },
+                             values, num_threads );
+    } );
+
+  std::vector<bdd> fs;
+  for ( const auto& out : info.outputs )
+  {
+    fs += out.first.complemented ? !values[out.first.node] : values[out.first.node];
+  }
+
+  return fs;
+}
+
 }
 
 // Local Variables:
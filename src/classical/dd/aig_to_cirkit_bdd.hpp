@@ -61,6 +61,11 @@ public:
 
 std::vector<bdd> aig_to_bdd( const aig_graph& aig, const bdd_manager_ptr& mgr );
 
+/* builds the BDDs of all gates of one level concurrently in the shared
+   manager, which is in concurrent mode during the call (see run_concurrent);
+   num_threads = 0 uses as many threads as there are cores */
+std::vector<bdd> aig_to_bdd( const aig_graph& aig, const bdd_manager_ptr& mgr, unsigned num_threads );
+
 }
 
 #endif
@@ -26,6 +26,9 @@
 
 #include "bdd.hpp"
 
+#include <algorithm>
+#include <future>
+#include <utility>
 #include <vector>
 
 #include <boost/assign/std/vector.hpp>
@@ -55,125 +58,128 @@ enum class bdd_operation {
  * Private functions                                                          *
  ******************************************************************************/
 
-/******************************************************************************
- * Public functions                                                           *
- ******************************************************************************/
-
-bdd_manager::bdd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
-  : dd_manager( nvars, log_max_objs, verbose ) {}
-
-bdd_manager::~bdd_manager() {}
-
-unsigned bdd_manager::bdd_and( unsigned f, unsigned g )
+unsigned bdd_manager::apply( unsigned op, unsigned f, unsigned g, unsigned depth )
 {
   /* terminating cases */
-  if ( f == 0u ) { return 0u; }
-  if ( g == 0u ) { return 0u; }
-  if ( f == 1u ) { return g; }
-  if ( g == 1u ) { return f; }
-  if ( f == g )  { return f; }
+  switch ( (bdd_operation)op )
+  {
+  case bdd_operation::_and:
+    if ( f == 0u ) { return 0u; }
+    if ( g == 0u ) { return 0u; }
+    if ( f == 1u ) { return g; }
+    if ( g == 1u ) { return f; }
+    if ( f == g )  { return f; }
+    break;
+  case bdd_operation::_or:
+    if ( f == 0u ) { return g; }
+    if ( g == 0u ) { return f; }
+    if ( f == 1u ) { return 1u; }
+    if ( g == 1u ) { return 1u; }
+    if ( f == g )  { return f; }
+    break;
+  case bdd_operation::_xor:
+    if ( f == 0u ) { return g; }
+    if ( g == 0u ) { return f; }
+    if ( f == g )  { return 0u; }
+    break;
+  default:
+    assert( false );
+  }
 
   /* commutativity */
-  if ( f > g ) { return bdd_and( g, f ); }
+  if ( f > g ) { std::swap( f, g ); }
 
-  const auto r = cache.lookup( f, g, (unsigned)bdd_operation::_and );
+  const auto r = cache.lookup( f, g, op );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
+  const auto  v     = std::min( node1.var, node2.var );
+
+  const auto f0 = node1.var == v ? node1.low  : f;
+  const auto f1 = node1.var == v ? node1.high : f;
+  const auto g0 = node2.var == v ? node2.low  : g;
+  const auto g1 = node2.var == v ? node2.high : g;
+
   unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
+  if ( depth < fork_depth && try_fork() )
   {
-    rlow = bdd_and( node1.low, g );
-    rhigh = bdd_and( node1.high, g );
-  }
-  else if ( node1.var > node2.var )
-  {
-    rlow = bdd_and( f, node2.low );
-    rhigh = bdd_and( f, node2.high );
+    auto low = std::async( std::launch::async, [this, op, f0, g0, depth]() {
+        try
+        {
+          const auto res = apply( op, f0, g0, depth + 1u );
+          active_forks.fetch_sub( 1u, std::memory_order_relaxed );
+          return res;
+        }
+        catch ( ... )
+        {
+          /* the exception is rethrown by low.get() */
+          active_forks.fetch_sub( 1u, std::memory_order_relaxed );
+          throw;
+        }
+      } );
+    rhigh = apply( op, f1, g1, depth + 1u );
+    rlow  = low.get();
   }
   else
   {
-    rlow = bdd_and( node1.low, node2.low );
-    rhigh = bdd_and( node1.high, node2.high );
+    rlow  = apply( op, f0, g0, depth + 1u );
+    rhigh = apply( op, f1, g1, depth + 1u );
   }
 
-  auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
-  return cache.insert( f, g, (unsigned)bdd_operation::_and, idx );
+  auto idx = unique_create( v, rhigh, rlow );
+  return cache.insert( f, g, op, idx );
 }
 
-unsigned bdd_manager::bdd_or( unsigned f, unsigned g )
+unsigned bdd_manager::apply_forked( unsigned op, unsigned f, unsigned g )
 {
-  /* terminating cases */
-  if ( f == 0u ) { return g; }
-  if ( g == 0u ) { return f; }
-  if ( f == 1u ) { return 1u; }
-  if ( g == 1u ) { return 1u; }
-  if ( f == g )  { return f; }
-
-  /* commutativity */
-  if ( f > g ) { return bdd_or( g, f ); }
-
-  const auto r = cache.lookup( f, g, (unsigned)bdd_operation::_or );
-  if ( r >= 0 ) { return r; }
-
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
-  unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
-  {
-    rlow = bdd_or( node1.low, g );
-    rhigh = bdd_or( node1.high, g );
-  }
-  else if ( node1.var > node2.var )
-  {
-    rlow = bdd_or( f, node2.low );
-    rhigh = bdd_or( f, node2.high );
-  }
-  else
+  if ( fork_depth == 0u )
   {
-    rlow = bdd_or( node1.low, node2.low );
-    rhigh = bdd_or( node1.high, node2.high );
+    return apply( op, f, g, 0u );
   }
 
-  auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
-  return cache.insert( f, g, (unsigned)bdd_operation::_or, idx );
+  /* forked threads require the concurrent mode, all of them have finished
+     when apply returns or throws */
+  unsigned r;
+  run_concurrent( *this, [&]() { r = apply( op, f, g, 0u ); } );
+  return r;
 }
 
-unsigned bdd_manager::bdd_xor( unsigned f, unsigned g )
+bool bdd_manager::try_fork()
 {
-  /* terminating cases */
-  if ( f == 0u ) { return g; }
-  if ( g == 0u ) { return f; }
-  if ( f == g )  { return 0u; }
+  auto active = active_forks.load( std::memory_order_relaxed );
+  while ( active + 1u < _num_threads )
+  {
+    if ( active_forks.compare_exchange_weak( active, active + 1u, std::memory_order_relaxed ) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
 
-  /* commutativity */
-  if ( f > g ) { return bdd_xor( g, f ); }
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
 
-  const auto r = cache.lookup( f, g, (unsigned)bdd_operation::_xor );
-  if ( r >= 0 ) { return r; }
+bdd_manager::bdd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
+  : dd_manager( nvars, log_max_objs, verbose ) {}
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
-  unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
-  {
-    rlow = bdd_xor( node1.low, g );
-    rhigh = bdd_xor( node1.high, g );
-  }
-  else if ( node1.var > node2.var )
-  {
-    rlow = bdd_xor( f, node2.low );
-    rhigh = bdd_xor( f, node2.high );
-  }
-  else
-  {
-    rlow = bdd_xor( node1.low, node2.low );
-    rhigh = bdd_xor( node1.high, node2.high );
-  }
+bdd_manager::~bdd_manager() {}
 
-  auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
-  return cache.insert( f, g, (unsigned)bdd_operation::_xor, idx );
+unsigned bdd_manager::bdd_and( unsigned f, unsigned g )
+{
+  return apply_forked( (unsigned)bdd_operation::_and, f, g );
+}
+
+unsigned bdd_manager::bdd_or( unsigned f, unsigned g )
+{
+  return apply_forked( (unsigned)bdd_operation::_or, f, g );
+}
+
+unsigned bdd_manager::bdd_xor( unsigned f, unsigned g )
+{
+  return apply_forked( (unsigned)bdd_operation::_xor, f, g );
 }
 
 unsigned bdd_manager::bdd_not( unsigned f )
@@ -185,7 +191,7 @@ unsigned bdd_manager::bdd_not( unsigned f )
   const auto r = cache.lookup( f, f, (unsigned)bdd_operation::_not );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
 
   auto rlow = bdd_not( node.low );
   auto rhigh = bdd_not( node.high );
@@ -199,7 +205,7 @@ unsigned bdd_manager::bdd_cof0( unsigned f, unsigned v )
   /* terminating cases */
   if ( f <= 1u ) { return f; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
   if ( node.var > v ) { return f; }
 
   const auto r = cache.lookup( f, v, (unsigned)bdd_operation::cof0 );
@@ -224,7 +230,7 @@ unsigned bdd_manager::bdd_cof1( unsigned f, unsigned v )
   /* terminating cases */
   if ( f <= 1u ) { return f; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
   if ( node.var > v ) { return f; }
 
   const auto r = cache.lookup( f, v, (unsigned)bdd_operation::cof1 );
@@ -249,8 +255,8 @@ unsigned bdd_manager::bdd_exists( unsigned f, unsigned g )
   /* terminating cases */
   if ( g == 1u || f <= 1u ) { return f; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
 
   if ( node1.var > node2.var )
   {
@@ -294,8 +300,8 @@ unsigned bdd_manager::bdd_constrain( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::constrain );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
 
   unsigned idx;
 
@@ -339,8 +345,8 @@ unsigned bdd_manager::bdd_restrict( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::restrict );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
 
   unsigned idx;
 
@@ -399,7 +405,7 @@ unsigned bdd_manager::bdd_round_to( unsigned f, unsigned level, unsigned cop, un
   const auto r = cache.lookup( f, level, cop );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
 
   auto idx = 0u;
   if ( node.var < level )
@@ -446,7 +452,7 @@ unsigned bdd_manager::bdd_round( unsigned f, unsigned level )
   const auto r = cache.lookup( f, level, (unsigned)bdd_operation::round );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
 
   auto idx = 0u;
   if ( node.var < level )
@@ -469,6 +475,17 @@ unsigned bdd_manager::bdd_round( unsigned f, unsigned level )
   return cache.insert( f, level, (unsigned)bdd_operation::round, idx );
 }
 
+void bdd_manager::set_num_threads( unsigned num_threads, unsigned fork_depth )
+{
+  _num_threads     = std::max( num_threads, 1u );
+  this->fork_depth = _num_threads > 1u ? fork_depth : 0u;
+}
+
+unsigned bdd_manager::num_threads() const
+{
+  return _num_threads;
+}
+
 bdd_manager_ptr bdd_manager::create( unsigned nvars, unsigned log_max_objs, bool verbose )
 {
   return std::make_shared<bdd_manager>( nvars, log_max_objs, verbose );
@@ -496,15 +513,14 @@ std::ostream& operator<<( std::ostream& os, const bdd_manager& mgr )
     os << i << ": " << mgr.nodes[i] << std::endl;
   }
 
-  auto * q = mgr.unique;
-
-  while ( q != mgr.unique + mgr.nodes.size() )
+  for ( auto i = 0u; i < mgr.nodes.size(); ++i )
   {
-    if ( *q )
+    auto q = mgr.unique[i].load();
+    while ( q )
     {
-      os << *q << ": " << mgr.nodes[*q] << std::endl;
+      os << q << ": " << mgr.nodes[q] << std::endl;
+      q = mgr.nexts[q].load();
     }
-    ++q;
   }
 
   return os;
@@ -514,11 +530,25 @@ bdd& bdd::operator=( const bdd& other )
 {
   if ( this == &other ) { return *this; }
   assert( !manager || manager == other.manager );
+  if ( other.manager ) { other.manager->ref( other.index ); }
+  if ( manager )       { manager->deref( index ); }
   manager = other.manager;
   index   = other.index;
   return *this;
 }
 
+bdd& bdd::operator=( bdd&& other )
+{
+  if ( this == &other ) { return *this; }
+  assert( !manager || manager == other.manager );
+  if ( manager ) { manager->deref( index ); }
+  manager       = other.manager;
+  index         = other.index;
+  other.manager = nullptr;
+  other.index   = 0u;
+  return *this;
+}
+
 unsigned bdd::var() const
 {
   return manager->get_var( index );
@@ -537,66 +567,78 @@ bdd bdd::low() const
 bdd bdd::operator&&( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_and( index, other.index ) );
 }
 
 bdd bdd::operator||( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_or( index, other.index ) );
 }
 
 bdd bdd::operator^( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_xor( index, other.index ) );
 }
 
 bdd bdd::operator!() const
 {
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_not( index ) );
 }
 
 bdd bdd::cof0( unsigned v ) const
 {
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_cof0( index, v ) );
 }
 
 bdd bdd::cof1( unsigned v ) const
 {
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_cof1( index, v ) );
 }
 
 bdd bdd::exists( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_exists( index, other.index ) );
 }
 
 bdd bdd::constrain( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_constrain( index, other.index ) );
 }
 
 bdd bdd::restrict( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_restrict( index, other.index ) );
 }
 
 bdd bdd::round_down( unsigned level ) const
 {
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_round_down( index, level ) );
 }
 
 bdd bdd::round_up( unsigned level ) const
 {
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_round_up( index, level ) );
 }
 
 bdd bdd::round( unsigned level ) const
 {
+  manager->maybe_collect_garbage();
   return bdd( manager, manager->bdd_round( index, level ) );
 }
 
@@ -41,6 +41,7 @@
 #include <boost/call_traits.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <map>
@@ -55,13 +56,16 @@ struct bdd
 {
   using const_param_ref = boost::call_traits < bdd >::const_reference;
 
+  /* handles hold a reference to their node, which protects it from
+     garbage collection; handles must not outlive their manager */
   bdd() : manager( nullptr ), index( 0u ) {}
-  bdd( bdd_manager* manager, unsigned index )
-    : manager( manager ),
-      index( index ) {}
-  bdd( const bdd& other ) : manager( other.manager ), index( other.index ) {}
+  bdd( bdd_manager* manager, unsigned index );
+  bdd( const bdd& other );
+  bdd( bdd&& other ) : manager( other.manager ), index( other.index ) { other.manager = nullptr; other.index = 0u; }
+  ~bdd();
 
   bdd& operator=( const bdd& other );
+  bdd& operator=( bdd&& other );
 
   unsigned var() const;
   bdd high() const;
@@ -120,16 +124,58 @@ public:
 
   unsigned unique_create( unsigned var, unsigned high, unsigned low );
 
+  /* If num_threads is larger than 1, bdd_and, bdd_or, and bdd_xor run in
+     concurrent mode (see run_concurrent) and compute the low cofactor of
+     the top variable in a separate thread in the first fork_depth recursion
+     levels, as long as less than num_threads - 1 of such threads are
+     running. */
+  void set_num_threads( unsigned num_threads, unsigned fork_depth = 6u );
+  unsigned num_threads() const;
+
   static bdd_manager_ptr create( unsigned nvars, unsigned log_max_objs, bool verbose = false );
 
+  /* garbage collection is triggered automatically by the operations on
+     bdd handles, the unsigned-based operations above never collect; hence,
+     nodes that are only stored as indexes are not protected */
+  using dd_manager::collect_garbage;
+  using dd_manager::maybe_collect_garbage;
+
 private:
+  unsigned apply( unsigned op, unsigned f, unsigned g, unsigned depth );
+  unsigned apply_forked( unsigned op, unsigned f, unsigned g );
+  bool try_fork();
+
   unsigned bdd_round_to( unsigned f, unsigned level, unsigned cop, unsigned to );
   unsigned bdd_round_to( unsigned f, unsigned level, unsigned cop, unsigned to, const std::map<unsigned, boost::multiprecision::uint256_t>& count_map );
 
+private:
+  unsigned              _num_threads = 1u;
+  unsigned              fork_depth = 0u;
+  std::atomic<unsigned> active_forks{0u};
+
 public:
   friend std::ostream& operator<<( std::ostream& os, const bdd_manager& mgr );
 };
 
+inline bdd::bdd( bdd_manager* manager, unsigned index )
+  : manager( manager ),
+    index( index )
+{
+  if ( manager ) { manager->ref( index ); }
+}
+
+inline bdd::bdd( const bdd& other )
+  : manager( other.manager ),
+    index( other.index )
+{
+  if ( manager ) { manager->ref( index ); }
+}
+
+inline bdd::~bdd()
+{
+  if ( manager ) { manager->deref( index ); }
+}
+
 }
 
 #endif
@@ -26,12 +26,15 @@
 
 #include "dd_manager.hpp"
 
-#include <cstring>
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <vector>
 
 #include <boost/format.hpp>
 
+#include <core/utils/timer.hpp>
+
 namespace cirkit
 {
 
@@ -47,28 +50,82 @@ hash_cache::hash_cache( size_type log_size )
 
 int hash_cache::lookup( unsigned arg0, unsigned arg1, unsigned arg2 )
 {
+  assert( arg2 < 128u );
+
   auto& ent = entry( arg0, arg1, arg2 );
-  bool hit = std::get<0>( ent ) == arg0 && std::get<1>( ent ) == arg1 && std::get<2>( ent ) == arg2;
 
-  if ( hit ) {
-    ++nhit;
-  } else {
-    ++nmiss;
+  const auto tag = ent.tag.load( concurrent ? std::memory_order_acquire : std::memory_order_relaxed );
+  bool hit = ( tag & 0xffu ) == ( arg2 << 1u ) &&
+             ent.arg0.load( std::memory_order_relaxed ) == arg0 &&
+             ent.arg1.load( std::memory_order_relaxed ) == arg1;
+  const auto res = ent.res.load( std::memory_order_relaxed );
+
+  /* entry was overwritten while reading it */
+  if ( concurrent )
+  {
+    std::atomic_thread_fence( std::memory_order_acquire );
+    hit = hit && ent.tag.load( std::memory_order_relaxed ) == tag;
   }
 
-  return hit ? std::get<3>( ent ) : -1;
+  count( hit ? nhit : nmiss );
+
+  return hit ? res : -1;
 }
 
 int hash_cache::insert( unsigned arg0, unsigned arg1, unsigned arg2, int res )
 {
+  assert( arg2 < 128u );
+
   auto& ent = entry( arg0, arg1, arg2 );
-  std::get<0>( ent ) = arg0;
-  std::get<1>( ent ) = arg1;
-  std::get<2>( ent ) = arg2;
-  std::get<3>( ent ) = res;
+
+  /* skip if another thread is writing this entry */
+  auto tag = ent.tag.load( std::memory_order_relaxed );
+  if ( concurrent )
+  {
+    if ( ( tag & 1u ) || !ent.tag.compare_exchange_strong( tag, tag | 1u, std::memory_order_acquire, std::memory_order_relaxed ) )
+    {
+      return res;
+    }
+    std::atomic_thread_fence( std::memory_order_release );
+  }
+
+  ent.arg0.store( arg0, std::memory_order_relaxed );
+  ent.arg1.store( arg1, std::memory_order_relaxed );
+  ent.res.store( res, std::memory_order_relaxed );
+  ent.tag.store( ( ( ( tag >> 8u ) + 1u ) << 8u ) | ( arg2 << 1u ), std::memory_order_release );
+
   return res;
 }
 
+void hash_cache::set_concurrent( bool concurrent )
+{
+  this->concurrent = concurrent;
+}
+
+void hash_cache::clear()
+{
+  container_type( data.size() ).swap( data );
+}
+
+void hash_cache::resize( size_type log_size )
+{
+  container_type old( 1 << log_size );
+  old.swap( data );
+  mask = ( 1 << log_size ) - 1u;
+
+  const auto c = concurrent;
+  concurrent = false;
+  for ( const auto& ent : old )
+  {
+    const auto tag = ent.tag.load( std::memory_order_relaxed );
+    if ( tag >> 8u ) /* entry has been written */
+    {
+      insert( ent.arg0.load( std::memory_order_relaxed ), ent.arg1.load( std::memory_order_relaxed ), ( tag & 0xffu ) >> 1u, ent.res.load( std::memory_order_relaxed ) );
+    }
+  }
+  concurrent = c;
+}
+
 std::size_t hash_cache::cache_size() const
 {
   return data.size();
@@ -93,6 +150,108 @@ std::ostream& operator<<( std::ostream& os, const dd_node& z )
  * Private functions                                                          *
  ******************************************************************************/
 
+unsigned dd_manager::allocate()
+{
+  unsigned slot;
+
+  if ( concurrent )
+  {
+    /* the node table cannot grow while other threads access it, hence
+       the counter must never pass the capacity */
+    slot = nnodes.load( std::memory_order_relaxed );
+    do
+    {
+      if ( slot >= nodes.size() )
+      {
+        throw dd_capacity_exceeded();
+      }
+    } while ( !nnodes.compare_exchange_weak( slot, slot + 1u, std::memory_order_relaxed ) );
+    return slot;
+  }
+
+  if ( free_list )
+  {
+    slot      = free_list;
+    free_list = nexts[slot].load( std::memory_order_relaxed );
+    --nfree;
+  }
+  else
+  {
+    if ( nnodes.load( std::memory_order_relaxed ) == nodes.size() )
+    {
+      grow();
+    }
+    slot = nnodes.load( std::memory_order_relaxed );
+    nnodes.store( slot + 1u, std::memory_order_relaxed );
+  }
+
+  peak = std::max( peak, size() );
+  return slot;
+}
+
+void dd_manager::grow()
+{
+  const auto old_capacity = nodes.size();
+  const auto capacity     = old_capacity << 1u;
+
+  nodes.resize( capacity, {-1u, -1u, -1u} );
+
+  /* free list is kept in nexts */
+  auto* _nexts = new std::atomic<unsigned>[capacity]();
+  auto* _refs  = new std::atomic<unsigned>[capacity]();
+  for ( auto i = 0u; i < old_capacity; ++i )
+  {
+    _nexts[i].store( nexts[i].load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    _refs[i].store( refs[i].load( std::memory_order_relaxed ), std::memory_order_relaxed );
+  }
+  delete[] unique;
+  delete[] nexts;
+  delete[] refs;
+  unique = new std::atomic<unsigned>[capacity]();
+  nexts  = _nexts;
+  refs   = _refs;
+  mask   = capacity - 1u;
+
+  rehash();
+
+  auto log_size = 0u;
+  while ( ( 1u << log_size ) < capacity ) { ++log_size; }
+  cache.resize( log_size );
+
+  gc_threshold = capacity - ( capacity >> 2u );
+  ++ngrow;
+}
+
+/* rebuilds the unique table from all live nodes */
+void dd_manager::rehash()
+{
+  for ( auto i = 0u; i < nodes.size(); ++i )
+  {
+    unique[i].store( 0u, std::memory_order_relaxed );
+  }
+
+  const auto n = nnodes.load( std::memory_order_relaxed );
+  for ( auto z = nvars + 2u; z < n; ++z )
+  {
+    const auto& node = nodes[z];
+    if ( node.var == -1u ) { continue; } /* free slot */
+
+    auto& head = unique[unique_index( node.var, node.high, node.low )];
+    nexts[z].store( head.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    head.store( z, std::memory_order_relaxed );
+  }
+}
+
+void dd_manager::collect_garbage_and_grow()
+{
+  collect_garbage();
+
+  if ( size() > ( nodes.size() >> 1u ) )
+  {
+    grow();
+  }
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -102,14 +261,15 @@ dd_manager::dd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
 {
   assert( log_max_objs > 0u );
 
-  const auto _nobjs = 1 << log_max_objs;
+  /* node table must at least hold the terminals and variable nodes */
+  auto _nobjs = 1u << log_max_objs;
+  while ( _nobjs < nvars + 2u ) { _nobjs <<= 1u; }
   nodes.resize( _nobjs, {-1u, -1u, -1u } );
   mask   = _nobjs - 1u;
-  unique = new unsigned[_nobjs];
-  nexts  = new unsigned[_nobjs];
-
-  memset( unique, 0, sizeof( unsigned ) * _nobjs );
-  memset( nexts,  0, sizeof( unsigned ) * _nobjs );
+  unique = new std::atomic<unsigned>[_nobjs]();
+  nexts  = new std::atomic<unsigned>[_nobjs]();
+  refs   = new std::atomic<unsigned>[_nobjs]();
+  gc_threshold = _nobjs - ( _nobjs >> 2u );
 
   /* terminals, value is determined by index */
   nodes[0] = {nvars, -1u, -1u};
@@ -122,17 +282,35 @@ dd_manager::dd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
   }
 
   nnodes = 2u + nvars;
+  peak   = nnodes;
 }
 
 dd_manager::~dd_manager()
 {
   delete[] unique;
   delete[] nexts;
+  delete[] refs;
 }
 
 unsigned dd_manager::size() const
 {
-  return nnodes;
+  return std::min<unsigned>( nnodes.load( std::memory_order_relaxed ), nodes.size() ) - nfree;
+}
+
+unsigned dd_manager::capacity() const
+{
+  return nodes.size();
+}
+
+void dd_manager::reserve( unsigned n )
+{
+  assert( !concurrent );
+
+  /* the free list is not used in concurrent mode */
+  while ( nodes.size() - nnodes.load( std::memory_order_relaxed ) < n )
+  {
+    grow();
+  }
 }
 
 unsigned dd_manager::get_var( unsigned z ) const
@@ -150,10 +328,106 @@ unsigned dd_manager::get_low( unsigned z ) const
   return nodes.at( z ).low;
 }
 
+void dd_manager::set_concurrent( bool concurrent )
+{
+  this->concurrent = concurrent;
+  cache.set_concurrent( concurrent );
+}
+
+bool dd_manager::is_concurrent() const
+{
+  return concurrent;
+}
+
+void dd_manager::set_auto_gc( bool auto_gc )
+{
+  this->auto_gc = auto_gc;
+}
+
+unsigned dd_manager::collect_garbage()
+{
+  assert( !concurrent );
+
+  auto pause = 0.0;
+  unsigned collected = 0u;
+
+  {
+    reference_timer t( &pause );
+
+    const auto n = nnodes.load( std::memory_order_relaxed );
+
+    /* mark */
+    std::vector<unsigned char> marked( n, 0u );
+    std::vector<unsigned> stack;
+    for ( auto z = nvars + 2u; z < n; ++z )
+    {
+      if ( !refs[z].load( std::memory_order_relaxed ) || marked[z] ) { continue; }
+
+      stack.push_back( z );
+      marked[z] = 1u;
+      while ( !stack.empty() )
+      {
+        const auto& node = nodes[stack.back()];
+        stack.pop_back();
+
+        for ( auto c : {node.high, node.low} )
+        {
+          if ( c >= nvars + 2u && !marked[c] )
+          {
+            marked[c] = 1u;
+            stack.push_back( c );
+          }
+        }
+      }
+    }
+
+    /* sweep, the free list is rebuilt such that it also contains slots
+       that were wasted in concurrent mode */
+    free_list = 0u;
+    nfree     = 0u;
+    for ( auto z = n - 1u; z >= nvars + 2u; --z )
+    {
+      if ( marked[z] ) { continue; }
+
+      if ( nodes[z].var != -1u )
+      {
+        nodes[z] = {-1u, -1u, -1u};
+        ++collected;
+      }
+      nexts[z].store( free_list, std::memory_order_relaxed );
+      free_list = z;
+      ++nfree;
+    }
+
+    rehash();
+    cache.clear();
+  }
+
+  ++ngc;
+  ncollected  += collected;
+  gc_time     += pause;
+  gc_max_pause = std::max( gc_max_pause, pause );
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] garbage collection freed %d nodes in %.2f secs" ) % collected % pause << std::endl;
+  }
+
+  return collected;
+}
+
 void dd_manager::dump_stats(std::ostream &stream) const
 {
   stream << boost::format ("-- Variables:   %9d\n") % nvars;
-  stream << boost::format ("-- Nodes:       %9d\n") % nnodes;
+  stream << boost::format ("-- Nodes:       %9d\n") % size();
+  stream << boost::format ("-- Peak-nodes:  %9d\n") % peak;
+  stream << boost::format ("-- Capacity:    %9d\n") % nodes.size();
+  stream << boost::format ("-- Resizes:     %9d\n") % ngrow;
+  stream << boost::format ("-- Wasted:      %9d\n") % nwasted.load();
+  stream << boost::format ("-- GC-runs:     %9d\n") % ngc;
+  stream << boost::format ("-- GC-freed:    %9d\n") % ncollected;
+  stream << boost::format ("-- GC-time:     %9.4f\n") % gc_time;
+  stream << boost::format ("-- GC-max-pause:%9.4f\n") % gc_max_pause;
   stream << boost::format ("-- Cache-size:  %9d\n") % cache.cache_size();
   stream << boost::format ("-- Cache-miss:  %9d\n") % cache.miss();
   stream << boost::format ("-- Cache-hit:   %9d\n") % cache.hit();
@@ -167,36 +441,68 @@ unsigned dd_manager::unique_lookup( unsigned var, unsigned high, unsigned low )
     return var + 2u;
   }
 
-  const auto hash  = ( 12582917 * (int)var + 4256249 * (int)high + 741457 * (int)low );
-  const auto index = hash & mask;
-  auto*      q     = unique + index;
+  auto* q    = unique + unique_index( var, high, low );
+  auto  slot = 0u;
 
-  while ( *q )
+  while ( true )
   {
-    if ( nodes.at( *q ).var == var && nodes.at( *q ).high == high && nodes.at( *q ).low == low )
+    auto cur = q->load( std::memory_order_acquire );
+    while ( cur )
     {
-      return *q;
+      if ( nodes.at( cur ).var == var && nodes.at( cur ).high == high && nodes.at( cur ).low == low )
+      {
+        if ( slot )
+        {
+          nodes[slot].var = -1u;
+          nwasted.fetch_add( 1u, std::memory_order_relaxed );
+        }
+        return cur;
+      }
+      q   = nexts + cur;
+      cur = q->load( std::memory_order_acquire );
     }
-    q = nexts + *q;
-  }
 
-  if ( nnodes == nodes.size() )
-  {
-    std::cerr << "[e] dd capacity exceeded" << std::endl;
-    assert( false );
-  }
+    /* allocate once, the node is only visible after it has been linked */
+    if ( !slot )
+    {
+      const auto _mask = mask;
+      slot = allocate();
+      nodes[slot].var  = var;
+      nodes[slot].high = high;
+      nodes[slot].low  = low;
+      nexts[slot].store( 0u, std::memory_order_relaxed );
+
+      /* node table has grown, all chains have been rebuilt */
+      if ( mask != _mask )
+      {
+        q = unique + unique_index( var, high, low );
+        while ( auto cur = q->load( std::memory_order_relaxed ) )
+        {
+          q = nexts + cur;
+        }
+      }
+    }
+
+    if ( !concurrent )
+    {
+      q->store( slot, std::memory_order_relaxed );
+      break;
+    }
 
-  *q = nnodes++;
-  nodes[*q].var  = var;
-  nodes[*q].high = high;
-  nodes[*q].low  = low;
+    /* on failure, another thread appended a node to this chain */
+    auto expected = 0u;
+    if ( q->compare_exchange_strong( expected, slot, std::memory_order_release, std::memory_order_relaxed ) )
+    {
+      break;
+    }
+  }
 
   if ( verbose )
   {
-    // std::cout << boost::format( "[i] created entry (%d, %d, %d) at index %d" ) % var % high % low % *q << std::endl;
+    // std::cout << boost::format( "[i] created entry (%d, %d, %d) at index %d" ) % var % high % low % slot << std::endl;
   }
 
-  return *q;
+  return slot;
 }
 
 }
@@ -37,6 +37,8 @@
 #ifndef DD_MANAGER_HPP
 #define DD_MANAGER_HPP
 
+#include <atomic>
+#include <exception>
 #include <memory>
 #include <ostream>
 #include <vector>
@@ -44,10 +46,40 @@
 namespace cirkit
 {
 
+/* thrown by node allocation in concurrent mode if the node table is full,
+   since it cannot grow while other threads access it */
+class dd_capacity_exceeded : public std::exception
+{
+public:
+  virtual const char * what() const throw()
+  {
+    return "dd capacity exceeded in concurrent mode";
+  }
+};
+
+/* Computed table
+ *
+ * Direct-mapped and lossy: an insertion overwrites the previous entry in
+ * its slot.  The third argument is an operation code and must be less
+ * than 128; it is stored together with a sequence counter in the tag of
+ * an entry, whose least significant bit is set while the entry is being
+ * written.  In concurrent mode, writers acquire this bit with
+ * compare-and-swap and skip the insertion if another thread is writing
+ * the entry, and readers that observe a change of the tag report a miss.
+ * Hence, lookup and insert can be called concurrently without locks.  The
+ * hit and miss counters are not synchronized and therefore only
+ * approximate under concurrent access.
+ */
 class hash_cache
 {
 public:
-  using value_type     = std::tuple<unsigned, unsigned, unsigned, int>;
+  struct value_type
+  {
+    std::atomic<unsigned> tag{0u}; /* sequence counter (24 bits), arg2 (7 bits), busy (1 bit) */
+    std::atomic<unsigned> arg0{0u};
+    std::atomic<unsigned> arg1{0u};
+    std::atomic<int>      res{0};
+  };
   using container_type = std::vector<value_type>;
   using size_type      = container_type::size_type;
 
@@ -56,6 +88,15 @@ public:
   int lookup( unsigned arg0, unsigned arg1, unsigned arg2 );
   int insert( unsigned arg0, unsigned arg1, unsigned arg2, int res );
 
+  void set_concurrent( bool concurrent );
+
+  /* invalidates all entries */
+  void clear();
+
+  /* changes the number of entries to 2^log_size and re-inserts all valid
+     entries; must not be called concurrently with lookup or insert */
+  void resize( size_type log_size );
+
   std::size_t cache_size() const;
 
   std::size_t hit () const;
@@ -66,12 +107,18 @@ private:
     return data[( 12582917 * (int)arg0 + 4256249 * (int)arg1 + 741457 * (int)arg2 ) & mask];
   }
 
+  inline static void count( std::atomic<std::size_t>& counter )
+  {
+    counter.store( counter.load( std::memory_order_relaxed ) + 1u, std::memory_order_relaxed );
+  }
+
 private:
   container_type data;
   unsigned mask;
+  bool concurrent = false;
 
-  unsigned nhit;
-  unsigned nmiss;
+  std::atomic<std::size_t> nhit;
+  std::atomic<std::size_t> nmiss;
 };
 
 struct dd_node
@@ -88,6 +135,20 @@ struct dd_node
 
 std::ostream& operator<<( std::ostream& os, const dd_node& z );
 
+/* Node storage
+ *
+ * The node table initially has 2^log_max_objs entries.  In sequential mode
+ * it doubles when it is full, and the unique table and the computed table
+ * are rehashed accordingly.  Since indexes stay valid, this can happen
+ * during an operation, but references into the node table must not be
+ * held across calls to unique_lookup.
+ *
+ * Handles can protect nodes by reference counts (see ref and deref).
+ * Terminals and variable nodes are never collected and therefore not
+ * counted.  A garbage collection frees all nodes that are not reachable
+ * from a referenced node, it puts their slots into a free list, which is
+ * used for allocation in sequential mode, and clears the computed table.
+ */
 class dd_manager
 {
 public:
@@ -96,28 +157,175 @@ public:
 
   inline unsigned num_vars() const { return nvars; }
 
+  /* number of live nodes, including terminals and variable nodes */
   unsigned size() const;
 
+  /* number of node slots */
+  unsigned capacity() const;
+
+  /* grows the node table until at least n slots can be allocated in
+     concurrent mode; must not be called in concurrent mode */
+  void reserve( unsigned n );
+
   unsigned get_var( unsigned z ) const;
   unsigned get_high( unsigned z ) const;
   unsigned get_low( unsigned z ) const;
 
+  /* enables the thread-safe mode of the unique table and the computed
+     table, required before the manager is accessed from several threads;
+     in sequential mode no atomic read-modify-write operations are used */
+  void set_concurrent( bool concurrent );
+  bool is_concurrent() const;
+
+  inline void ref( unsigned z )
+  {
+    if ( z < nvars + 2u ) { return; }
+    if ( concurrent )
+    {
+      refs[z].fetch_add( 1u, std::memory_order_relaxed );
+    }
+    else
+    {
+      refs[z].store( refs[z].load( std::memory_order_relaxed ) + 1u, std::memory_order_relaxed );
+    }
+  }
+
+  inline void deref( unsigned z )
+  {
+    if ( z < nvars + 2u ) { return; }
+    if ( concurrent )
+    {
+      refs[z].fetch_sub( 1u, std::memory_order_relaxed );
+    }
+    else
+    {
+      refs[z].store( refs[z].load( std::memory_order_relaxed ) - 1u, std::memory_order_relaxed );
+    }
+  }
+
+  /* automatic garbage collection at safe points, see maybe_collect_garbage */
+  void set_auto_gc( bool auto_gc );
+
   void dump_stats ( std::ostream& stream ) const;
 
 protected:
+  /* frees all nodes which are not reachable from a referenced node and
+     returns their number; only valid if all nodes in use are referenced,
+     must not be called in concurrent mode */
+  unsigned collect_garbage();
+
+  /* to be called when no operation is in progress: collects garbage if more
+     than 3/4 of the node table is in use, and grows the node table if still
+     more than half of it is in use afterwards */
+  inline void maybe_collect_garbage()
+  {
+    if ( auto_gc && !concurrent && size() >= gc_threshold )
+    {
+      collect_garbage_and_grow();
+    }
+  }
+
+  /* in concurrent mode, new nodes are appended to the end of a collision
+     chain with compare-and-swap, and threads that lose the race continue
+     to search the chain from the node appended by the winner */
   unsigned unique_lookup( unsigned var, unsigned high, unsigned low );
 
+private:
+  inline unsigned unique_index( unsigned var, unsigned high, unsigned low ) const
+  {
+    return ( 12582917 * (int)var + 4256249 * (int)high + 741457 * (int)low ) & mask;
+  }
+
+  unsigned allocate();
+  void grow();
+  void rehash();
+  void collect_garbage_and_grow();
+
 protected:
-  unsigned             nvars;
-  unsigned             nnodes = 0u;
-  unsigned             mask = 0u;
-  hash_cache           cache;
-  std::vector<dd_node> nodes;
-  bool                 verbose;
-  unsigned *           unique;
-  unsigned *           nexts;
+  unsigned                nvars;
+  std::atomic<unsigned>   nnodes{0u};
+  unsigned                mask = 0u;
+  hash_cache              cache;
+  std::vector<dd_node>    nodes;
+  bool                    verbose;
+  bool                    concurrent = false;
+  std::atomic<unsigned> * unique;
+  std::atomic<unsigned> * nexts;
+  std::atomic<unsigned> * refs;
+
+  /* slots that were allocated by a thread that lost an insertion race */
+  std::atomic<unsigned>   nwasted{0u};
+
+  /* free slots, linked by nexts */
+  unsigned                free_list = 0u;
+  unsigned                nfree = 0u;
+
+  bool                    auto_gc = true;
+  unsigned                gc_threshold = 0u;
+
+  /* statistics */
+  unsigned                peak = 0u;
+  unsigned                ngc = 0u;
+  unsigned long           ncollected = 0ul;
+  double                  gc_time = 0.0;
+  double                  gc_max_pause = 0.0;
+  unsigned                ngrow = 0u;
+};
+
+/* enables the concurrent mode of a manager while in scope and restores the
+   previous mode afterwards, also if an operation throws dd_capacity_exceeded */
+class concurrent_scope
+{
+public:
+  explicit concurrent_scope( dd_manager& mgr )
+    : mgr( mgr ),
+      previous( mgr.is_concurrent() )
+  {
+    mgr.set_concurrent( true );
+  }
+
+  ~concurrent_scope()
+  {
+    mgr.set_concurrent( previous );
+  }
+
+  concurrent_scope( const concurrent_scope& ) = delete;
+  concurrent_scope& operator=( const concurrent_scope& ) = delete;
+
+private:
+  dd_manager& mgr;
+  bool        previous;
 };
 
+/* calls fn in concurrent mode; if the node table is full, fn is called again
+   after all its threads have finished and the node table has been doubled,
+   hence fn must compute its results from scratch.  If the manager is already
+   in concurrent mode, the table cannot grow here and the exception is passed
+   on to the caller that enabled it. */
+template<typename Fn>
+void run_concurrent( dd_manager& mgr, Fn&& fn )
+{
+  if ( mgr.is_concurrent() )
+  {
+    fn();
+    return;
+  }
+
+  while ( true )
+  {
+    try
+    {
+      concurrent_scope scope( mgr );
+      fn();
+      return;
+    }
+    catch ( const dd_capacity_exceeded& )
+    {
+      mgr.reserve( mgr.capacity() );
+    }
+  }
+}
+
 }
 
 #endif
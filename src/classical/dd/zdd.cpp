@@ -70,8 +70,8 @@ unsigned zdd_manager::zdd_diff( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::diff );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   unsigned rlow, rhigh, idx;
   if ( node1.var < node2.var )
   {
@@ -104,8 +104,8 @@ unsigned zdd_manager::zdd_union( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::_union );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   unsigned rlow, rhigh;
   if ( node1.var < node2.var )
   {
@@ -136,8 +136,8 @@ unsigned zdd_manager::zdd_intersection( unsigned z1, unsigned z2 )
   /* commutativity */
   if ( z1 > z2 ) { return zdd_intersection( z2, z1 ); }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   if ( node1.var < node2.var )
   {
     return zdd_intersection( node1.low, z2 );
@@ -170,8 +170,8 @@ unsigned zdd_manager::zdd_symmetric_difference( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::symmetric_difference );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   unsigned rlow, rhigh;
   if ( node1.var < node2.var )
   {
@@ -195,8 +195,8 @@ unsigned zdd_manager::zdd_symmetric_difference( unsigned z1, unsigned z2 )
 unsigned zdd_manager::zdd_join( unsigned z1, unsigned z2 )
 {
   /* swapping */
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   /* commutativity */
   if ( node1.var < node2.var || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_join( z2, z1 ); }
@@ -230,8 +230,8 @@ unsigned zdd_manager::zdd_join( unsigned z1, unsigned z2 )
 unsigned zdd_manager::zdd_meet( unsigned z1, unsigned z2 )
 {
   /* swapping */
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   /* commutativity */
   if ( node1.var < node2.var || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_join( z2, z1 ); }
@@ -263,8 +263,8 @@ unsigned zdd_manager::zdd_meet( unsigned z1, unsigned z2 )
 unsigned zdd_manager::zdd_delta( unsigned z1, unsigned z2 )
 {
   /* swapping */
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   /* commutativity */
   if ( node1.var < node2.var || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_delta( z2, z1 ); }
@@ -303,8 +303,8 @@ unsigned zdd_manager::zdd_nonsub( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::nonsub );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   unsigned rlow, rhigh;
 
@@ -333,8 +333,8 @@ unsigned zdd_manager::zdd_nonsup( unsigned z1, unsigned z2 )
   if ( z2 == 0u ) { return z1; }
   if ( z1 == z2 ) { return 0u; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   if ( node1.var > node2.var )
   {
@@ -371,7 +371,7 @@ unsigned zdd_manager::zdd_minhit( unsigned z )
   const auto r = cache.lookup( z, z, (unsigned)zdd_operation::minhit );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( z );
+  const auto node = nodes.at( z );
   auto rtmp = zdd_union( node.low, node.high );
   auto rlow = zdd_minhit( rtmp );
   rtmp = zdd_minhit( node.low );
@@ -0,0 +1,561 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bit_parallel_simulation.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <boost/graph/topological_sort.hpp>
+
+#include <core/utils/timer.hpp>
+#include <classical/utils/aig_utils.hpp>
+#include <classical/mig/mig_utils.hpp>
+
+#if defined( __GNUC__ ) && defined( __x86_64__ )
+#define CIRKIT_SIMULATION_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+using gate_t   = bit_parallel_simulator::gate_t;
+using kernel_t = void(*)( std::uint64_t*, const gate_t*, std::size_t, std::size_t, unsigned );
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+inline std::uint64_t literal_mask( std::uint32_t lit )
+{
+  return -static_cast<std::uint64_t>( lit & 1u );
+}
+
+inline std::uint64_t splitmix64( std::uint64_t& state )
+{
+  auto z = ( state += 0x9e3779b97f4a7c15ull );
+  z = ( z ^ ( z >> 30u ) ) * 0xbf58476d1ce4e5b9ull;
+  z = ( z ^ ( z >> 27u ) ) * 0x94d049bb133111ebull;
+  return z ^ ( z >> 31u );
+}
+
+/* evaluates words [from, num_words) of one gate */
+inline void simulate_gate_scalar( std::uint64_t* arena, const gate_t& g, std::uint64_t* out, unsigned from, unsigned num_words )
+{
+  const auto* a = arena + ( g.fanin[0] >> 1u ) * num_words;
+  const auto* b = arena + ( g.fanin[1] >> 1u ) * num_words;
+  const auto ma = literal_mask( g.fanin[0] );
+  const auto mb = literal_mask( g.fanin[1] );
+
+  switch ( g.type )
+  {
+  case bit_parallel_simulator::gate_type::and_gate:
+    for ( auto w = from; w < num_words; ++w )
+    {
+      out[w] = ( a[w] ^ ma ) & ( b[w] ^ mb );
+    }
+    break;
+
+  case bit_parallel_simulator::gate_type::xor_gate:
+    for ( auto w = from; w < num_words; ++w )
+    {
+      out[w] = a[w] ^ b[w] ^ ma ^ mb;
+    }
+    break;
+
+  case bit_parallel_simulator::gate_type::maj_gate:
+    {
+      const auto* c = arena + ( g.fanin[2] >> 1u ) * num_words;
+      const auto mc = literal_mask( g.fanin[2] );
+      for ( auto w = from; w < num_words; ++w )
+      {
+        const auto x = a[w] ^ ma, y = b[w] ^ mb, z = c[w] ^ mc;
+        out[w] = ( x & y ) | ( z & ( x | y ) );
+      }
+    }
+    break;
+  }
+}
+
+void simulate_scalar( std::uint64_t* arena, const gate_t* gates, std::size_t num_gates, std::size_t first_node, unsigned num_words )
+{
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    simulate_gate_scalar( arena, gates[i], arena + ( first_node + i ) * num_words, 0u, num_words );
+  }
+}
+
+#ifdef CIRKIT_SIMULATION_DISPATCH
+
+__attribute__(( target( "avx2" ) ))
+void simulate_avx2( std::uint64_t* arena, const gate_t* gates, std::size_t num_gates, std::size_t first_node, unsigned num_words )
+{
+  const auto vec_words = num_words & ~3u;
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto& g = gates[i];
+    auto* out = arena + ( first_node + i ) * num_words;
+    const auto* a = arena + ( g.fanin[0] >> 1u ) * num_words;
+    const auto* b = arena + ( g.fanin[1] >> 1u ) * num_words;
+    const auto ma = _mm256_set1_epi64x( literal_mask( g.fanin[0] ) );
+    const auto mb = _mm256_set1_epi64x( literal_mask( g.fanin[1] ) );
+
+    switch ( g.type )
+    {
+    case bit_parallel_simulator::gate_type::and_gate:
+      for ( auto w = 0u; w < vec_words; w += 4u )
+      {
+        const auto x = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + w ) ), ma );
+        const auto y = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + w ) ), mb );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + w ), _mm256_and_si256( x, y ) );
+      }
+      break;
+
+    case bit_parallel_simulator::gate_type::xor_gate:
+      {
+        const auto m = _mm256_xor_si256( ma, mb );
+        for ( auto w = 0u; w < vec_words; w += 4u )
+        {
+          const auto x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + w ) );
+          const auto y = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + w ) );
+          _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + w ), _mm256_xor_si256( _mm256_xor_si256( x, y ), m ) );
+        }
+      }
+      break;
+
+    case bit_parallel_simulator::gate_type::maj_gate:
+      {
+        const auto* c = arena + ( g.fanin[2] >> 1u ) * num_words;
+        const auto mc = _mm256_set1_epi64x( literal_mask( g.fanin[2] ) );
+        for ( auto w = 0u; w < vec_words; w += 4u )
+        {
+          const auto x = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + w ) ), ma );
+          const auto y = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + w ) ), mb );
+          const auto z = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( c + w ) ), mc );
+          const auto r = _mm256_or_si256( _mm256_and_si256( x, y ), _mm256_and_si256( z, _mm256_or_si256( x, y ) ) );
+          _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + w ), r );
+        }
+      }
+      break;
+    }
+
+    if ( vec_words != num_words )
+    {
+      simulate_gate_scalar( arena, g, out, vec_words, num_words );
+    }
+  }
+}
+
+__attribute__(( target( "avx512f" ) ))
+void simulate_avx512( std::uint64_t* arena, const gate_t* gates, std::size_t num_gates, std::size_t first_node, unsigned num_words )
+{
+  const auto vec_words = num_words & ~7u;
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto& g = gates[i];
+    auto* out = arena + ( first_node + i ) * num_words;
+    const auto* a = arena + ( g.fanin[0] >> 1u ) * num_words;
+    const auto* b = arena + ( g.fanin[1] >> 1u ) * num_words;
+    const auto ma = _mm512_set1_epi64( literal_mask( g.fanin[0] ) );
+    const auto mb = _mm512_set1_epi64( literal_mask( g.fanin[1] ) );
+
+    switch ( g.type )
+    {
+    case bit_parallel_simulator::gate_type::and_gate:
+      for ( auto w = 0u; w < vec_words; w += 8u )
+      {
+        const auto x = _mm512_xor_si512( _mm512_loadu_si512( a + w ), ma );
+        const auto y = _mm512_xor_si512( _mm512_loadu_si512( b + w ), mb );
+        _mm512_storeu_si512( out + w, _mm512_and_si512( x, y ) );
+      }
+      break;
+
+    case bit_parallel_simulator::gate_type::xor_gate:
+      {
+        const auto m = _mm512_xor_si512( ma, mb );
+        for ( auto w = 0u; w < vec_words; w += 8u )
+        {
+          /* 0x96 is the truth table of the 3-input XOR */
+          const auto r = _mm512_ternarylogic_epi64( _mm512_loadu_si512( a + w ), _mm512_loadu_si512( b + w ), m, 0x96 );
+          _mm512_storeu_si512( out + w, r );
+        }
+      }
+      break;
+
+    case bit_parallel_simulator::gate_type::maj_gate:
+      {
+        const auto* c = arena + ( g.fanin[2] >> 1u ) * num_words;
+        const auto mc = _mm512_set1_epi64( literal_mask( g.fanin[2] ) );
+        for ( auto w = 0u; w < vec_words; w += 8u )
+        {
+          const auto x = _mm512_xor_si512( _mm512_loadu_si512( a + w ), ma );
+          const auto y = _mm512_xor_si512( _mm512_loadu_si512( b + w ), mb );
+          const auto z = _mm512_xor_si512( _mm512_loadu_si512( c + w ), mc );
+          /* 0xe8 is the truth table of the 3-input majority */
+          _mm512_storeu_si512( out + w, _mm512_ternarylogic_epi64( x, y, z, 0xe8 ) );
+        }
+      }
+      break;
+    }
+
+    if ( vec_words != num_words )
+    {
+      simulate_gate_scalar( arena, g, out, vec_words, num_words );
+    }
+  }
+}
+
+#endif
+
+enum class simulation_kernel { scalar, avx2, avx512 };
+
+simulation_kernel best_kernel()
+{
+#ifdef CIRKIT_SIMULATION_DISPATCH
+  static const auto kernel = []() {
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx512f" ) ) { return simulation_kernel::avx512; }
+    if ( __builtin_cpu_supports( "avx2" ) )    { return simulation_kernel::avx2; }
+    return simulation_kernel::scalar;
+  }();
+  return kernel;
+#else
+  return simulation_kernel::scalar;
+#endif
+}
+
+/* vector kernels only pay off if at least one full vector per gate is filled */
+simulation_kernel select_kernel( unsigned num_words )
+{
+  const auto kernel = best_kernel();
+  if ( kernel == simulation_kernel::avx512 && num_words >= 8u ) { return simulation_kernel::avx512; }
+  if ( kernel != simulation_kernel::scalar && num_words >= 4u ) { return simulation_kernel::avx2; }
+  return simulation_kernel::scalar;
+}
+
+kernel_t kernel_function( simulation_kernel kernel )
+{
+  switch ( kernel )
+  {
+#ifdef CIRKIT_SIMULATION_DISPATCH
+  case simulation_kernel::avx512: return &simulate_avx512;
+  case simulation_kernel::avx2:   return &simulate_avx2;
+#endif
+  default:                        return &simulate_scalar;
+  }
+}
+
+template<typename Node, typename Graph>
+std::vector<Node> topological_gate_order( const Graph& g )
+{
+  std::vector<Node> topsort( num_vertices( g ) );
+  boost::topological_sort( g, topsort.begin() );
+  return topsort;
+}
+
+/******************************************************************************
+ * bit_parallel_simulator                                                     *
+ ******************************************************************************/
+
+bit_parallel_simulator::bit_parallel_simulator( unsigned num_words )
+  : _num_words( num_words )
+{
+  assert( num_words > 0u );
+}
+
+std::uint32_t bit_parallel_simulator::create_pi()
+{
+  /* inputs must be created before the gates such that they are contiguous */
+  assert( _gates.empty() );
+  return ++_num_inputs << 1u;
+}
+
+std::uint32_t bit_parallel_simulator::create_and( std::uint32_t a, std::uint32_t b )
+{
+  assert( ( a >> 1u ) < num_nodes() && ( b >> 1u ) < num_nodes() );
+  _gates.push_back( {{a, b, 0u}, gate_type::and_gate} );
+  return ( num_nodes() - 1u ) << 1u;
+}
+
+std::uint32_t bit_parallel_simulator::create_xor( std::uint32_t a, std::uint32_t b )
+{
+  assert( ( a >> 1u ) < num_nodes() && ( b >> 1u ) < num_nodes() );
+  _gates.push_back( {{a, b, 0u}, gate_type::xor_gate} );
+  return ( num_nodes() - 1u ) << 1u;
+}
+
+std::uint32_t bit_parallel_simulator::create_maj( std::uint32_t a, std::uint32_t b, std::uint32_t c )
+{
+  assert( ( a >> 1u ) < num_nodes() && ( b >> 1u ) < num_nodes() && ( c >> 1u ) < num_nodes() );
+  _gates.push_back( {{a, b, c}, gate_type::maj_gate} );
+  return ( num_nodes() - 1u ) << 1u;
+}
+
+void bit_parallel_simulator::create_po( std::uint32_t f )
+{
+  assert( ( f >> 1u ) < num_nodes() );
+  _outputs.push_back( f );
+}
+
+void bit_parallel_simulator::set_num_words( unsigned num_words )
+{
+  assert( num_words > 0u );
+  _num_words = num_words;
+  _arena.clear();
+}
+
+std::uint64_t* bit_parallel_simulator::input_words( unsigned index )
+{
+  assert( index < _num_inputs );
+
+  _arena.resize( static_cast<std::size_t>( num_nodes() ) * _num_words, 0u );
+  return &_arena[( 1u + index ) * static_cast<std::size_t>( _num_words )];
+}
+
+void bit_parallel_simulator::set_random_inputs( std::uint64_t seed )
+{
+  _arena.resize( static_cast<std::size_t>( num_nodes() ) * _num_words, 0u );
+
+  auto state = seed;
+  const auto end = ( 1u + _num_inputs ) * static_cast<std::size_t>( _num_words );
+  for ( auto i = static_cast<std::size_t>( _num_words ); i < end; ++i )
+  {
+    _arena[i] = splitmix64( state );
+  }
+}
+
+void bit_parallel_simulator::simulate()
+{
+  _arena.resize( static_cast<std::size_t>( num_nodes() ) * _num_words, 0u );
+
+  /* constant */
+  std::fill( _arena.begin(), _arena.begin() + _num_words, 0u );
+
+  kernel_function( select_kernel( _num_words ) )( _arena.data(), _gates.data(), _gates.size(), 1u + _num_inputs, _num_words );
+}
+
+const std::uint64_t* bit_parallel_simulator::node_words( unsigned node ) const
+{
+  assert( node < num_nodes() && !_arena.empty() );
+  return &_arena[node * static_cast<std::size_t>( _num_words )];
+}
+
+std::uint64_t bit_parallel_simulator::output_word( unsigned index, unsigned word ) const
+{
+  const auto f = _outputs[index];
+  return node_words( f >> 1u )[word] ^ literal_mask( f );
+}
+
+std::uint64_t bit_parallel_simulator::output_popcount( unsigned index ) const
+{
+  std::uint64_t count = 0u;
+  for ( auto w = 0u; w < _num_words; ++w )
+  {
+    count += __builtin_popcountll( output_word( index, w ) );
+  }
+  return count;
+}
+
+std::size_t bit_parallel_simulator::memory() const
+{
+  return _arena.capacity() * sizeof( std::uint64_t ) + _gates.capacity() * sizeof( gate_t );
+}
+
+const char* bit_parallel_simulator::kernel_name() const
+{
+  switch ( select_kernel( _num_words ) )
+  {
+  case simulation_kernel::avx512: return "avx512";
+  case simulation_kernel::avx2:   return "avx2";
+  default:                        return "scalar";
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+bit_parallel_simulator bit_parallel_simulator_from_aig( const aig_graph& aig, unsigned num_words )
+{
+  const auto& info = aig_info( aig );
+
+  bit_parallel_simulator sim( num_words );
+  std::vector<std::uint32_t> lits( num_vertices( aig ), 0u );
+
+  for ( const auto& input : info.inputs )
+  {
+    lits[input] = sim.create_pi();
+  }
+
+  const auto to_lit = [&lits]( const aig_function& f ) { return lits[f.node] ^ static_cast<std::uint32_t>( f.complemented ); };
+
+  for ( const auto& node : topological_gate_order<aig_node>( aig ) )
+  {
+    if ( out_degree( node, aig ) == 0u ) { continue; }
+
+    const auto children = get_children( aig, node );
+    lits[node] = sim.create_and( to_lit( children[0u] ), to_lit( children[1u] ) );
+  }
+
+  for ( const auto& output : info.outputs )
+  {
+    sim.create_po( to_lit( output.first ) );
+  }
+
+  return sim;
+}
+
+bit_parallel_simulator bit_parallel_simulator_from_xmg( const xmg_graph& xmg, unsigned num_words )
+{
+  bit_parallel_simulator sim( num_words );
+  std::vector<std::uint32_t> lits( xmg.size(), 0u );
+
+  for ( const auto& input : xmg.inputs() )
+  {
+    lits[input.first] = sim.create_pi();
+  }
+
+  const auto to_lit = [&lits]( const xmg_function& f ) { return lits[f.node] ^ static_cast<std::uint32_t>( f.complemented ); };
+
+  for ( const auto& node : xmg.topological_nodes() )
+  {
+    if ( xmg.is_input( node ) ) { continue; }
+
+    const auto children = xmg.children( node );
+    if ( xmg.is_xor( node ) )
+    {
+      lits[node] = sim.create_xor( to_lit( children[0u] ), to_lit( children[1u] ) );
+    }
+    else
+    {
+      lits[node] = sim.create_maj( to_lit( children[0u] ), to_lit( children[1u] ), to_lit( children[2u] ) );
+    }
+  }
+
+  for ( const auto& output : xmg.outputs() )
+  {
+    sim.create_po( to_lit( output.first ) );
+  }
+
+  return sim;
+}
+
+bit_parallel_simulator bit_parallel_simulator_from_mig( const mig_graph& mig, unsigned num_words )
+{
+  const auto& info = mig_info( mig );
+
+  bit_parallel_simulator sim( num_words );
+  std::vector<std::uint32_t> lits( num_vertices( mig ), 0u );
+
+  for ( const auto& input : info.inputs )
+  {
+    lits[input] = sim.create_pi();
+  }
+
+  const auto to_lit = [&lits]( const mig_function& f ) { return lits[f.node] ^ static_cast<std::uint32_t>( f.complemented ); };
+
+  for ( const auto& node : topological_gate_order<mig_node>( mig ) )
+  {
+    if ( out_degree( node, mig ) == 0u ) { continue; }
+
+    const auto children = get_children( mig, node );
+    lits[node] = sim.create_maj( to_lit( children[0u] ), to_lit( children[1u] ), to_lit( children[2u] ) );
+  }
+
+  for ( const auto& output : info.outputs )
+  {
+    sim.create_po( to_lit( output.first ) );
+  }
+
+  return sim;
+}
+
+unsigned bit_parallel_num_words( unsigned num_nodes, std::size_t memory_budget )
+{
+  const auto words = memory_budget / ( sizeof( std::uint64_t ) * std::max( num_nodes, 1u ) );
+
+  /* multiples of 8 words keep all vector lanes busy */
+  if ( words >= 64u ) { return 64u; }
+  if ( words >= 8u )  { return words & ~7u; }
+  return std::max<unsigned>( words, 1u );
+}
+
+std::vector<std::uint64_t> bit_parallel_random_simulation( bit_parallel_simulator& sim, std::uint64_t num_patterns,
+                                                           const properties::ptr& settings,
+                                                           const properties::ptr& statistics )
+{
+  /* settings */
+  const auto seed = get( settings, "seed", static_cast<std::uint64_t>( 0xcafe ) );
+
+  std::vector<std::uint64_t> ones( sim.num_outputs(), 0u );
+
+  const auto patterns_per_round = 64u * static_cast<std::uint64_t>( sim.num_words() );
+  const auto rounds = std::max<std::uint64_t>( 1u, ( num_patterns + patterns_per_round - 1u ) / patterns_per_round );
+
+  double runtime{};
+  {
+    reference_timer t( &runtime );
+
+    /* round seeds are drawn from their own generator, such that the pattern
+       streams of the rounds do not overlap */
+    auto seed_state = seed;
+    for ( auto r = 0ull; r < rounds; ++r )
+    {
+      sim.set_random_inputs( splitmix64( seed_state ) );
+      sim.simulate();
+
+      for ( auto i = 0u; i < sim.num_outputs(); ++i )
+      {
+        ones[i] += sim.output_popcount( i );
+      }
+    }
+  }
+
+  if ( statistics )
+  {
+    statistics->set( "runtime", runtime );
+    statistics->set( "num_patterns", rounds * patterns_per_round );
+    statistics->set( "patterns_per_second", runtime > 0.0 ? ( rounds * patterns_per_round ) / runtime : 0.0 );
+    statistics->set( "kernel", std::string( sim.kernel_name() ) );
+  }
+
+  return ones;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
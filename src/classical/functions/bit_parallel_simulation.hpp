@@ -0,0 +1,152 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bit_parallel_simulation.hpp
+ *
+ * @brief Bit-parallel simulation engine for AIGs, XMGs, and MIGs
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef BIT_PARALLEL_SIMULATION_HPP
+#define BIT_PARALLEL_SIMULATION_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/xmg/xmg.hpp>
+
+namespace cirkit
+{
+
+/* Bit-parallel simulation engine
+ *
+ * The network is flattened into an array of gates in topological order.
+ * Node 0 is the constant, nodes 1 to num_inputs() are the inputs, and the
+ * remaining nodes are the gates.  Signals are literals ( node << 1 | c ).
+ *
+ * Each node owns num_words() consecutive 64-bit words in one contiguous
+ * arena, i.e., 64 * num_words() patterns are simulated in one pass.  Gates
+ * are evaluated with AVX-512 or AVX2 kernels if the CPU supports them, and
+ * with a portable scalar kernel otherwise.
+ */
+class bit_parallel_simulator
+{
+public:
+  enum class gate_type : std::uint32_t { and_gate, xor_gate, maj_gate };
+
+  struct gate_t
+  {
+    std::uint32_t fanin[3];
+    gate_type     type;
+  };
+
+public:
+  explicit bit_parallel_simulator( unsigned num_words = 1u );
+
+  /* construction, all fanins must have been created before */
+  std::uint32_t create_pi();
+  std::uint32_t create_and( std::uint32_t a, std::uint32_t b );
+  std::uint32_t create_xor( std::uint32_t a, std::uint32_t b );
+  std::uint32_t create_maj( std::uint32_t a, std::uint32_t b, std::uint32_t c );
+  void create_po( std::uint32_t f );
+
+  /* resizes the arena, input words are reset to 0 */
+  void set_num_words( unsigned num_words );
+
+  inline unsigned num_words() const   { return _num_words; }
+  inline unsigned num_inputs() const  { return _num_inputs; }
+  inline unsigned num_outputs() const { return _outputs.size(); }
+  inline unsigned num_gates() const   { return _gates.size(); }
+  inline unsigned num_nodes() const   { return 1u + _num_inputs + _gates.size(); }
+  inline const std::vector<gate_t>& gates() const          { return _gates; }
+  inline const std::vector<std::uint32_t>& outputs() const { return _outputs; }
+
+  /* num_words() words of the i-th input */
+  std::uint64_t* input_words( unsigned index );
+  void set_random_inputs( std::uint64_t seed );
+
+  void simulate();
+
+  /* values after simulate(), output words take the complement into account */
+  const std::uint64_t* node_words( unsigned node ) const;
+  std::uint64_t output_word( unsigned index, unsigned word ) const;
+  std::uint64_t output_popcount( unsigned index ) const;
+
+  /* memory of the arena in bytes */
+  std::size_t memory() const;
+
+  /* name of the kernel that simulate() runs for num_words() words ("avx512",
+     "avx2", or "scalar"), chosen at runtime */
+  const char* kernel_name() const;
+
+private:
+  unsigned                   _num_words;
+  unsigned                   _num_inputs = 0u;
+  std::vector<gate_t>        _gates;
+  std::vector<std::uint32_t> _outputs;
+  std::vector<std::uint64_t> _arena;
+};
+
+/* outputs are in the order of the outputs of the network */
+bit_parallel_simulator bit_parallel_simulator_from_aig( const aig_graph& aig, unsigned num_words = 1u );
+bit_parallel_simulator bit_parallel_simulator_from_xmg( const xmg_graph& xmg, unsigned num_words = 1u );
+bit_parallel_simulator bit_parallel_simulator_from_mig( const mig_graph& mig, unsigned num_words = 1u );
+
+/* a number of words such that the arena stays within the given budget */
+unsigned bit_parallel_num_words( unsigned num_nodes, std::size_t memory_budget = 1u << 25u );
+
+/* Simulates num_patterns random patterns (rounded up to a multiple of
+ * 64 * num_words()) and returns for each output the number of patterns for
+ * which it evaluates to 1.
+ *
+ * settings:
+ *   seed:                 seed for the random patterns (default: 0xcafe)
+ *
+ * statistics:
+ *   runtime:              run-time in seconds
+ *   num_patterns:         number of simulated patterns
+ *   patterns_per_second:  simulation throughput
+ *   kernel:               name of the simulation kernel
+ */
+std::vector<std::uint64_t> bit_parallel_random_simulation( bit_parallel_simulator& sim, std::uint64_t num_patterns,
+                                                           const properties::ptr& settings = properties::ptr(),
+                                                           const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
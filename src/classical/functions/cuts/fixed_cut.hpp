@@ -0,0 +1,168 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file fixed_cut.hpp
+ *
+ * @brief Cuts with a fixed maximum number of leaves
+ *
+ * A cut stores its leaves as a sorted array of at most MaxK node indexes
+ * together with a 64-bit signature, in which bit (i mod 64) is set for each
+ * leaf i.  Merging two cuts is a merge of two sorted arrays and the
+ * signature allows to reject most dominance checks without looking at the
+ * leaves.  The memory per cut is independent of the size of the graph.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef FIXED_CUT_HPP
+#define FIXED_CUT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cirkit
+{
+
+template<unsigned MaxK>
+class fixed_cut
+{
+public:
+  using iterator = typename std::array<uint32_t, MaxK>::const_iterator;
+
+  static constexpr unsigned max_size = MaxK;
+
+  fixed_cut() = default;
+
+  static fixed_cut singleton( uint32_t leaf )
+  {
+    fixed_cut c;
+    c._leaves[0u] = leaf;
+    c._size = 1u;
+    c._signature = leaf_signature( leaf );
+    return c;
+  }
+
+  template<typename Iterator>
+  static fixed_cut from_sorted_range( Iterator begin, Iterator end )
+  {
+    fixed_cut c;
+    for ( auto it = begin; it != end; ++it )
+    {
+      c._leaves[c._size++] = *it;
+      c._signature |= leaf_signature( *it );
+    }
+    return c;
+  }
+
+  static inline uint64_t leaf_signature( uint32_t leaf ) { return 1ull << ( leaf & 63u ); }
+
+  inline unsigned size() const       { return _size; }
+  inline uint64_t signature() const  { return _signature; }
+  inline iterator begin() const      { return _leaves.begin(); }
+  inline iterator end() const        { return _leaves.begin() + _size; }
+  inline uint32_t operator[]( unsigned i ) const { return _leaves[i]; }
+
+  /* sets this cut to the union of a and b; returns false if the union has more than k leaves */
+  bool merge( const fixed_cut& a, const fixed_cut& b, unsigned k )
+  {
+    /* fast reject by counting distinct signature bits (lower bound on size) */
+    _signature = a._signature | b._signature;
+    if ( static_cast<unsigned>( __builtin_popcountll( _signature ) ) > k ) { return false; }
+
+    auto i = 0u, j = 0u;
+    _size = 0u;
+    while ( i < a._size && j < b._size )
+    {
+      if ( _size == k ) { return false; }
+      if ( a._leaves[i] < b._leaves[j] )      { _leaves[_size++] = a._leaves[i++]; }
+      else if ( a._leaves[i] > b._leaves[j] ) { _leaves[_size++] = b._leaves[j++]; }
+      else                                    { _leaves[_size++] = a._leaves[i++]; ++j; }
+    }
+    while ( i < a._size ) { if ( _size == k ) { return false; } _leaves[_size++] = a._leaves[i++]; }
+    while ( j < b._size ) { if ( _size == k ) { return false; } _leaves[_size++] = b._leaves[j++]; }
+    return true;
+  }
+
+  /* true, if all leaves of this cut are contained in other */
+  bool dominates( const fixed_cut& other ) const
+  {
+    if ( _size > other._size || ( _signature & other._signature ) != _signature ) { return false; }
+
+    auto j = 0u;
+    for ( auto i = 0u; i < _size; ++i )
+    {
+      while ( j < other._size && other._leaves[j] < _leaves[i] ) { ++j; }
+      if ( j == other._size || other._leaves[j] != _leaves[i] ) { return false; }
+      ++j;
+    }
+    return true;
+  }
+
+  bool operator==( const fixed_cut& other ) const
+  {
+    return _size == other._size && _signature == other._signature && std::equal( begin(), end(), other.begin() );
+  }
+
+  std::vector<unsigned> to_vector() const
+  {
+    return std::vector<unsigned>( begin(), end() );
+  }
+
+private:
+  std::array<uint32_t, MaxK> _leaves;
+  unsigned                   _size = 0u;
+  uint64_t                   _signature = 0ull;
+};
+
+/* adds cut to a list of cuts unless it is dominated by some cut in the
+   list; cuts in the list that are dominated by cut are removed; returns
+   true, if cut was added */
+template<typename Cut>
+bool add_cut_with_dominance_filter( std::vector<Cut>& cuts, const Cut& cut )
+{
+  for ( const auto& other : cuts )
+  {
+    if ( other.dominates( cut ) ) { return false; }
+  }
+
+  cuts.erase( std::remove_if( cuts.begin(), cuts.end(), [&cut]( const Cut& other ) { return cut.dominates( other ); } ), cuts.end() );
+  cuts.push_back( cut );
+  return true;
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -26,23 +26,20 @@
 
 #include "paged.hpp"
 
+#include <limits>
+#include <algorithm>
 #include <map>
-#include <mutex>
 
-#include <core/utils/bitset_utils.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/functions/compute_levels.hpp>
 #include <classical/functions/parallel_compute.hpp>
 #include <classical/functions/simulate_aig.hpp>
 
-#include <boost/assign/std/vector.hpp>
-#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/range/algorithm.hpp>
-#include <boost/range/numeric.hpp>
-
-using namespace boost::assign;
 
 namespace cirkit
 {
@@ -55,17 +52,49 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+template<typename Cut>
+std::vector<Cut> fixed_cuts_from_paged( const boost::iterator_range<paged_memory::iterator>& sets )
+{
+  std::vector<Cut> cuts;
+  for ( const auto& s : sets )
+  {
+    cuts.push_back( Cut::from_sorted_range( s.begin(), s.end() ) );
+  }
+  return cuts;
+}
+
+template<typename Cut>
+std::vector<Cut> fixed_cuts_from_record( const paged_memory_page::record& r )
+{
+  std::vector<Cut> cuts;
+  paged_memory_page::foreach_set( r, 0u, [&cuts]( const unsigned*, const unsigned* begin, const unsigned* end ) {
+      cuts.push_back( Cut::from_sorted_range( begin, end ) );
+    } );
+  return cuts;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
-paged_aig_cuts::paged_aig_cuts( const aig_graph& aig, unsigned k, bool parallel, unsigned priority )
+constexpr unsigned paged_aig_cuts::max_cut_size;
+
+paged_aig_cuts::paged_aig_cuts( const aig_graph& aig, unsigned k, bool parallel, unsigned priority, const properties::ptr& statistics )
   : _aig( aig ),
     _k( k ),
     _priority( priority ),
-    data( num_vertices( _aig ) )
+    data( num_vertices( _aig ) ),
+    _levels( num_vertices( _aig ), 0u )
 {
-  _levels = compute_levels( aig );
+  if ( k > max_cut_size )
+  {
+    throw boost::str( boost::format( "cut size %d exceeds the maximum cut size %d" ) % k % max_cut_size );
+  }
+
+  for ( const auto& p : compute_levels( aig ) )
+  {
+    _levels[p.first] = p.second;
+  }
 
   if ( parallel )
   {
@@ -75,6 +104,13 @@ paged_aig_cuts::paged_aig_cuts( const aig_graph& aig, unsigned k, bool parallel,
   {
     enumerate();
   }
+
+  if ( statistics )
+  {
+    statistics->set( "runtime", _enumeration_time );
+    statistics->set( "total_cuts", total_cut_count() );
+    statistics->set( "cuts_per_second", _enumeration_time > 0.0 ? total_cut_count() / _enumeration_time : 0.0 );
+  }
 }
 
 unsigned paged_aig_cuts::total_cut_count() const
@@ -140,7 +176,6 @@ void paged_aig_cuts::enumerate()
   boost::topological_sort( _aig, topsort.begin() );
 
   /* loop */
-  _top_index = 0u;
   for ( auto n : topsort )
   {
     if ( out_degree( n, _aig ) == 0u )
@@ -165,112 +200,105 @@ void paged_aig_cuts::enumerate()
       const auto n1 = *it++;
       const auto n2 = *it;
 
-      enumerate_node_with_bitsets( n, n1, n2 );
+      enumerate_node( n, n1, n2 );
 
       data.append_singleton( n, n );
     }
-
-    _top_index++;
   }
 }
 
 void paged_aig_cuts::enumerate_parallel()
 {
   reference_timer t( &_enumeration_time );
-  std::mutex mutex;
 
-  /* constant */
-  data.assign_empty( 0u );
+  const aig_levelization levels( _aig );
+  work_stealing_pool pool;
 
-  auto on_input = [this, &mutex]( aig_node n ) {
-    mutex.lock();
-    this->data.assign_singleton( n, n );
-    mutex.unlock();
-  };
+  std::vector<paged_memory_page> pages( pool.num_threads() );
+  std::vector<paged_memory_page::record> records( num_vertices( _aig ) );
 
-  const auto size = boost::num_vertices( _aig );
-  auto on_and = [this, &mutex, &size]( aig_node n, const aig_function& c1, const aig_function& c2 ) {
-    const auto local_cuts = this->enumerate_local_cuts( c1.node, c2.node, size );
+  /* constant and inputs */
+  auto& page0 = pages[0u];
+  for ( auto i = levels.level_begin( 0u ); i < levels.level_end( 0u ); ++i )
+  {
+    const auto n = levels.node( i );
 
-    mutex.lock();
-    this->data.append_begin( n );
-    for ( const auto& cut : local_cuts )
+    page0.begin_record();
+    if ( n == 0u )
+    {
+      page0.append_empty();
+    }
+    else
     {
-      this->data.append_set( n, get_index_vector( cut.first ) );
+      page0.append_singleton( n );
     }
+    records[n] = page0.end_record();
+  }
+
+  /* gates, the cuts of all children are final when a level is processed */
+  for ( auto l = 1u; l < levels.num_levels(); ++l )
+  {
+    const auto level_size = levels.level_end( l ) - levels.level_begin( l );
+    const auto grain_size = std::max<std::size_t>( 16u, level_size / ( 8u * pool.num_threads() ) );
 
-    this->data.append_singleton( n, n );
-    mutex.unlock();
-  };
+    pool.parallel_for( levels.level_begin( l ), levels.level_end( l ), [&]( std::size_t i, unsigned worker ) {
+        const auto n = levels.node( i );
+        auto& page = pages[worker];
+
+        const auto local_cuts = enumerate_local_cuts( fixed_cuts_from_record<fixed_cut_t>( records[levels.child0( n ).node] ),
+                                                      fixed_cuts_from_record<fixed_cut_t>( records[levels.child1( n ).node] ) );
+
+        page.begin_record();
+        for ( const auto& cut : local_cuts )
+        {
+          page.append_set( cut.first.begin(), cut.first.end() );
+        }
+        page.append_singleton( n );
+        records[n] = page.end_record();
+      }, grain_size );
+  }
 
-  parallel_process( _aig, on_input, on_and );
+  /* compaction */
+  for ( auto n = 0u; n < records.size(); ++n )
+  {
+    if ( records[n].data )
+    {
+      data.assign_record( n, records[n] );
+    }
+  }
 }
 
-std::vector<std::pair<boost::dynamic_bitset<>, unsigned>> paged_aig_cuts::enumerate_local_cuts( aig_node n1, aig_node n2, unsigned max_cut_size )
+std::vector<paged_aig_cuts::local_cut_t> paged_aig_cuts::enumerate_local_cuts( const std::vector<fixed_cut_t>& cuts1, const std::vector<fixed_cut_t>& cuts2 ) const
 {
-  std::vector<std::pair<boost::dynamic_bitset<>, unsigned>> local_cuts;
+  std::vector<local_cut_t> local_cuts;
 
-  for ( const auto& c1 : cuts( n1 ) )
+  fixed_cut_t new_cut;
+  for ( const auto& c1 : cuts1 )
   {
-    for ( const auto& c2 : cuts( n2 ) )
+    for ( const auto& c2 : cuts2 )
     {
-      auto min_level = std::numeric_limits<unsigned>::max();
-      boost::dynamic_bitset<> new_cut( max_cut_size );
-      auto f = [&new_cut, &min_level, this]( unsigned pos ) {
-        new_cut.set( pos );
-        min_level = std::min( min_level, this->_levels.at( pos ) );
-      };
-      std::for_each( c1.begin(), c1.end(), f );
-      std::for_each( c2.begin(), c2.end(), f );
-
-      const auto size = new_cut.count();
+      if ( !new_cut.merge( c1, c2, _k ) ) { continue; }
 
-      if ( size <= _k )
+      /* dominated by an existing cut? */
+      if ( boost::find_if( local_cuts, [&new_cut]( const local_cut_t& c ) { return c.first.dominates( new_cut ); } ) != local_cuts.end() )
       {
-        auto first_subsume = true;
-        auto add = true;
-
-        auto l = 0u;
-        while ( l < local_cuts.size() )
-        {
-          auto cut = local_cuts[l].first;
-
-          /* same cut */
-          if ( cut == new_cut ) { add = false; break; }
-
-          /* cut subsumes new_cut */
-          if ( ( cut & new_cut ) == new_cut ) { add = false; break; }
-
-          /* new_cut subsumes cut */
-          if ( ( cut & new_cut ) == cut )
-          {
-            add = false;
-            if ( first_subsume )
-            {
-              local_cuts[l] = {new_cut, min_level};
-              first_subsume = false;
-            }
-            else
-            {
-              local_cuts[l] = local_cuts.back();
-              local_cuts.pop_back();
-            }
-          }
-
-          ++l;
-        }
+        continue;
+      }
 
-        if ( add )
-        {
-          local_cuts += std::make_pair( new_cut, min_level );
-        }
+      auto min_level = std::numeric_limits<unsigned>::max();
+      for ( auto leaf : new_cut )
+      {
+        min_level = std::min( min_level, _levels[leaf] );
       }
+
+      /* remove cuts dominated by the new one */
+      local_cuts.erase( std::remove_if( local_cuts.begin(), local_cuts.end(), [&new_cut]( const local_cut_t& c ) { return new_cut.dominates( c.first ); } ), local_cuts.end() );
+      local_cuts.push_back( {new_cut, min_level} );
     }
   }
 
-  boost::sort( local_cuts, []( const std::pair<boost::dynamic_bitset<>, unsigned>& e1,
-                               const std::pair<boost::dynamic_bitset<>, unsigned>& e2 ) {
-                 return ( e1.second > e2.second ) || ( e1.second == e2.second && e1.first.count() < e2.first.count() ); } );
+  boost::sort( local_cuts, []( const local_cut_t& e1, const local_cut_t& e2 ) {
+                 return ( e1.second > e2.second ) || ( e1.second == e2.second && e1.first.size() < e2.first.size() ); } );
 
   if ( local_cuts.size() > _priority )
   {
@@ -280,11 +308,11 @@ std::vector<std::pair<boost::dynamic_bitset<>, unsigned>> paged_aig_cuts::enumer
   return local_cuts;
 }
 
-void paged_aig_cuts::enumerate_node_with_bitsets( aig_node n, aig_node n1, aig_node n2 )
+void paged_aig_cuts::enumerate_node( aig_node n, aig_node n1, aig_node n2 )
 {
-  for ( const auto& cut : enumerate_local_cuts( n1, n2, _top_index ) )
+  for ( const auto& cut : enumerate_local_cuts( fixed_cuts_from_paged<fixed_cut_t>( cuts( n1 ) ), fixed_cuts_from_paged<fixed_cut_t>( cuts( n2 ) ) ) )
   {
-    data.append_set( n, get_index_vector( cut.first ) );
+    data.append_set( n, cut.first.begin(), cut.first.end() );
   }
 }
 
@@ -36,14 +36,14 @@
 #ifndef CUTS_PAGED_HPP
 #define CUTS_PAGED_HPP
 
-#include <map>
 #include <vector>
 
-#include <boost/dynamic_bitset.hpp>
 #include <boost/range/iterator_range.hpp>
 
+#include <core/properties.hpp>
 #include <core/utils/paged_memory.hpp>
 #include <classical/aig.hpp>
+#include <classical/functions/cuts/fixed_cut.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
 namespace cirkit
@@ -54,7 +54,14 @@ class paged_aig_cuts final
 public:
   using cut = paged_memory::set;
 
-  paged_aig_cuts( const aig_graph& aig, unsigned k, bool parallel = true, unsigned priority = 8u );
+  /* largest supported k */
+  static constexpr unsigned max_cut_size = 16u;
+
+  /* parallel enumeration uses all cores
+   *
+   * statistics: runtime, total_cuts, cuts_per_second */
+  paged_aig_cuts( const aig_graph& aig, unsigned k, bool parallel = true, unsigned priority = 8u,
+                  const properties::ptr& statistics = properties::ptr() );
 
   unsigned total_cut_count() const;
   double enumeration_time() const;
@@ -67,10 +74,20 @@ public:
   unsigned depth( aig_node node, const cut& c ) const;
 
 private:
-  void enumerate();
-  void enumerate_node_with_bitsets( aig_node n, aig_node n1, aig_node n2 );
-  std::vector<std::pair<boost::dynamic_bitset<>, unsigned>> enumerate_local_cuts( aig_node n1, aig_node n2, unsigned max_cut_size );
+  using fixed_cut_t = fixed_cut<max_cut_size>;
+  using local_cut_t = std::pair<fixed_cut_t, unsigned>;
 
+  void enumerate();
+  void enumerate_node( aig_node n, aig_node n1, aig_node n2 );
+  std::vector<local_cut_t> enumerate_local_cuts( const std::vector<fixed_cut_t>& cuts1, const std::vector<fixed_cut_t>& cuts2 ) const;
+
+  /* Parallel enumeration
+   *
+   * Nodes are processed level by level on a work_stealing_pool, hence the
+   * cuts of all children are final when a node is processed.  Each worker
+   * writes into its own paged_memory_page, no locks are involved.  Finally,
+   * all records are compacted into data.
+   */
   void enumerate_parallel();
 
 private:
@@ -81,9 +98,7 @@ private:
 
   double                       _enumeration_time = 0.0;
 
-  unsigned                     _top_index = 0u; /* index when doing topo traversal */
-
-  std::map<aig_node, unsigned> _levels;
+  std::vector<unsigned>        _levels;
 };
 
 }
@@ -26,6 +26,10 @@
 
 #include "parallel_compute.hpp"
 
+#include <algorithm>
+
+#include <boost/graph/topological_sort.hpp>
+
 namespace cirkit
 {
 
@@ -37,71 +41,134 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+/* enough work per chunk to amortize the atomic claim in the pool */
+std::size_t parallel_grain_size( std::size_t level_size, unsigned num_threads )
+{
+  return std::max<std::size_t>( 64u, level_size / ( 8u * num_threads ) );
+}
+
 /******************************************************************************
- * Public functions                                                           *
+ * aig_levelization                                                           *
  ******************************************************************************/
 
-void parallel_process(
-    const aig_graph& aig,
-    const std::function<void( aig_node )>& on_input,
-    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and )
+aig_levelization::aig_levelization( const aig_graph& aig )
 {
-  /* topological order */
-  std::vector<aig_node> topsort( num_vertices( aig ) );
+  const auto n = num_vertices( aig );
+
+  /* topological order (children before parents) */
+  std::vector<aig_node> topsort( n );
   boost::topological_sort( aig, topsort.begin() );
 
-  boost::dynamic_bitset<>              processed( num_vertices( aig ) );
-  std::mutex                           vector_mutex;
-  std::vector<std::thread>             workers;
-  std::vector<std::condition_variable> guards( num_vertices( aig ) );
-  std::vector<std::mutex>              guard_locks( num_vertices( aig ) );
-  processed.set( 0u );
+  const auto& complementmap = boost::get( boost::edge_complement, aig );
 
-  for ( auto n : topsort )
-  {
-    /* primary input */
-    if ( out_degree( n, aig ) == 0u )
-    {
-      if ( n == 0u ) { continue; }
+  std::vector<unsigned> levels( n, 0u );
+  children.resize( 2u * n );
+  auto max_level = 0u;
 
-      workers.emplace_back( [&vector_mutex, &processed, n, &on_input, &guards, &guard_locks]() {
-          on_input( n );
-          vector_mutex.lock();
-          processed.set( n );
-          vector_mutex.unlock();
+  for ( auto node : topsort )
+  {
+    if ( out_degree( node, aig ) == 0u ) { continue; }
 
-          std::unique_lock<std::mutex> lck( guard_locks[n] );
-          guards[n].notify_all();
-        } );
-    }
-    else
+    auto i = 0u;
+    for ( const auto& edge : boost::make_iterator_range( boost::out_edges( node, aig ) ) )
     {
-      const auto children = get_children( aig, n );
-
-      workers.emplace_back( [&vector_mutex, &processed, n, &on_and, children, &guards, &guard_locks]() {
-          {
-            std::unique_lock<std::mutex> lck( guard_locks[children[0].node] );
-            while ( !processed[children[0].node] ) { guards[children[0].node].wait( lck ); }
-          }
-          {
-            std::unique_lock<std::mutex> lck( guard_locks[children[1].node] );
-            while ( !processed[children[1].node] ) { guards[children[1].node].wait( lck ); }
-          }
-
-          on_and( n, children[0], children[1] );
-          vector_mutex.lock();
-          processed.set( n );
-          vector_mutex.unlock();
-
-          std::unique_lock<std::mutex> lck( guard_locks[n] );
-          guards[n].notify_all();
-        } );
+      const auto child = boost::target( edge, aig );
+      children[2u * node + i++] = {child, complementmap[edge]};
+      levels[node] = std::max( levels[node], levels[child] + 1u );
     }
+    max_level = std::max( max_level, levels[node] );
   }
 
-  for ( auto& worker : workers )
+  /* counting sort by level */
+  offsets.assign( max_level + 2u, 0u );
+  for ( auto node = 0u; node < n; ++node )
+  {
+    ++offsets[levels[node] + 1u];
+  }
+  for ( auto l = 1u; l < offsets.size(); ++l )
+  {
+    offsets[l] += offsets[l - 1u];
+  }
+
+  nodes.resize( n );
+  auto pos = offsets;
+  for ( auto node = 0u; node < n; ++node )
+  {
+    nodes[pos[levels[node]]++] = node;
+  }
+}
+
+unsigned aig_levelization::num_levels() const
+{
+  return offsets.size() - 1u;
+}
+
+std::size_t aig_levelization::level_begin( unsigned level ) const
+{
+  return offsets[level];
+}
+
+std::size_t aig_levelization::level_end( unsigned level ) const
+{
+  return offsets[level + 1u];
+}
+
+aig_node aig_levelization::node( std::size_t i ) const
+{
+  return nodes[i];
+}
+
+const aig_function& aig_levelization::child0( aig_node n ) const
+{
+  return children[2u * n];
+}
+
+const aig_function& aig_levelization::child1( aig_node n ) const
+{
+  return children[2u * n + 1u];
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+void parallel_process(
+    const aig_graph& aig,
+    const std::function<void( aig_node )>& on_input,
+    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and,
+    unsigned num_threads )
+{
+  work_stealing_pool pool( num_threads );
+  parallel_process( aig, pool, on_input, on_and );
+}
+
+void parallel_process(
+    const aig_graph& aig,
+    work_stealing_pool& pool,
+    const std::function<void( aig_node )>& on_input,
+    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and )
+{
+  if ( num_vertices( aig ) == 0u ) { return; }
+
+  const aig_levelization levels( aig );
+
+  /* level 0: constant and inputs */
+  pool.parallel_for( levels.level_begin( 0u ), levels.level_end( 0u ),
+                     [&levels, &on_input]( std::size_t i, unsigned ) {
+                       const auto n = levels.node( i );
+                       if ( n != 0u ) { on_input( n ); }
+                     },
+                     parallel_grain_size( levels.level_end( 0u ) - levels.level_begin( 0u ), pool.num_threads() ) );
+
+  /* AND gates level by level */
+  for ( auto l = 1u; l < levels.num_levels(); ++l )
   {
-    worker.join();
+    pool.parallel_for( levels.level_begin( l ), levels.level_end( l ),
+                       [&levels, &on_and]( std::size_t i, unsigned ) {
+                         const auto n = levels.node( i );
+                         on_and( n, levels.child0( n ), levels.child1( n ) );
+                       },
+                       parallel_grain_size( levels.level_end( l ) - levels.level_begin( l ), pool.num_threads() ) );
   }
 }
 
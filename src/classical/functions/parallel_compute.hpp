@@ -36,100 +36,124 @@
 #ifndef PARALLEL_COMPUTE_HPP
 #define PARALLEL_COMPUTE_HPP
 
-#include <condition_variable>
 #include <functional>
 #include <iostream>
-#include <mutex>
-#include <thread>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
-#include <boost/graph/topological_sort.hpp>
 
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/aig.hpp>
 #include <classical/utils/aig_utils.hpp>
 
 namespace cirkit
 {
 
+/* Parallel evaluation engine
+ *
+ * The nodes of the AIG are partitioned into levels, where the constant and
+ * all inputs are on level 0 and each AND gate is on a level one larger than
+ * the maximum level of its children.  Levels are processed one after the
+ * other, and all nodes of one level are processed on a fixed-size
+ * work_stealing_pool.  Hence, when a callback is called for some node, the
+ * callbacks for both its children have already returned.
+ *
+ * If num_threads is 0, the number of threads equals the number of cores.
+ */
+
+class aig_levelization
+{
+public:
+  explicit aig_levelization( const aig_graph& aig );
+
+  unsigned num_levels() const;
+  std::size_t level_begin( unsigned level ) const;
+  std::size_t level_end( unsigned level ) const;
+
+  /* i-th node in level order */
+  aig_node node( std::size_t i ) const;
+
+  /* children of an AND gate */
+  const aig_function& child0( aig_node n ) const;
+  const aig_function& child1( aig_node n ) const;
+
+private:
+  std::vector<aig_node>     nodes;
+  std::vector<std::size_t>  offsets;
+  std::vector<aig_function> children;
+};
+
+void parallel_process(
+    const aig_graph& aig,
+    const std::function<void( aig_node )>& on_input,
+    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and,
+    unsigned num_threads = 0u );
+
+void parallel_process(
+    const aig_graph& aig,
+    work_stealing_pool& pool,
+    const std::function<void( aig_node )>& on_input,
+    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and );
+
+namespace detail
+{
+
+/* wraps values such that std::vector<bool> is not specialized, which would
+   not allow concurrent writes to different elements */
+template<typename T>
+struct parallel_compute_value
+{
+  T value;
+};
+
+}
+
 template<typename T>
 void parallel_compute(
-    const aig_graph& aig, const T& constant_result,
+    const aig_graph& aig, work_stealing_pool& pool, const T& constant_result,
     const std::function<T( unsigned )>& on_input,
     const std::function<T( const T&, bool, const T&, bool )>& on_and,
     std::vector<T>& computed_values )
 {
-  /* topological order */
-  std::vector<aig_node> topsort( num_vertices( aig ) );
-  boost::topological_sort( aig, topsort.begin() );
-
   const auto& info = aig_info( aig );
+  const auto n = num_vertices( aig );
 
-  computed_values.resize( num_vertices( aig ) );
-  boost::dynamic_bitset<>              computed( num_vertices( aig ) );
-  std::mutex                           vector_mutex;
-  std::vector<std::thread>             workers;
-  std::vector<std::condition_variable> guards( num_vertices( aig ) );
-  std::vector<std::mutex>              guard_locks( num_vertices( aig ) );
-  computed.set( 0u );
-  computed_values[0u] = constant_result;
-
-  for ( auto n : topsort )
+  /* input indexes, nodes which are not inputs get inputs.size() as in aig_input_index */
+  std::vector<unsigned> input_index( n, info.inputs.size() );
+  for ( auto i = 0u; i < info.inputs.size(); ++i )
   {
-    /* primary input */
-    if ( out_degree( n, aig ) == 0u )
-    {
-      if ( n == 0u ) { continue; }
-
-      const auto index = aig_input_index( info, n );
-      workers.emplace_back( [&vector_mutex, &computed_values, &computed, n, &on_input, index, &guards, &guard_locks]() {
-          const auto v = on_input( index );
-          vector_mutex.lock();
-          computed_values[n] = v;
-          computed.set( n );
-          vector_mutex.unlock();
-
-          std::unique_lock<std::mutex> lck( guard_locks[n] );
-          guards[n].notify_all();
-        } );
-    }
-    else
-    {
-      const auto children = get_children( aig, n );
-
-      workers.emplace_back( [&vector_mutex, &computed_values, &computed, n, &on_and, children, &guards, &guard_locks]() {
-          {
-            std::unique_lock<std::mutex> lck( guard_locks[children[0].node] );
-            while ( !computed[children[0].node] ) { guards[children[0].node].wait( lck ); }
-          }
-          {
-            std::unique_lock<std::mutex> lck( guard_locks[children[1].node] );
-            while ( !computed[children[1].node] ) { guards[children[1].node].wait( lck ); }
-          }
-
-          const auto v = on_and( computed_values[children[0].node], children[0].complemented,
-                                 computed_values[children[1].node], children[1].complemented );
-          vector_mutex.lock();
-          computed_values[n] = v;
-          computed.set( n );
-          vector_mutex.unlock();
-
-          std::unique_lock<std::mutex> lck( guard_locks[n] );
-          guards[n].notify_all();
-        } );
-    }
+    input_index[info.inputs[i]] = i;
   }
 
-  for ( auto& worker : workers )
+  std::vector<detail::parallel_compute_value<T>> values( n );
+  values[0u].value = constant_result;
+
+  parallel_process( aig, pool,
+                    [&]( aig_node node ) {
+                      values[node].value = on_input( input_index[node] );
+                    },
+                    [&]( aig_node node, const aig_function& c1, const aig_function& c2 ) {
+                      values[node].value = on_and( values[c1.node].value, c1.complemented, values[c2.node].value, c2.complemented );
+                    } );
+
+  computed_values.resize( n );
+  for ( auto i = 0u; i < n; ++i )
   {
-    worker.join();
+    computed_values[i] = std::move( values[i].value );
   }
 }
 
-void parallel_process(
-    const aig_graph& aig,
-    const std::function<void( aig_node )>& on_input,
-    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and );
+template<typename T>
+void parallel_compute(
+    const aig_graph& aig, const T& constant_result,
+    const std::function<T( unsigned )>& on_input,
+    const std::function<T( const T&, bool, const T&, bool )>& on_and,
+    std::vector<T>& computed_values,
+    unsigned num_threads = 0u )
+{
+  work_stealing_pool pool( num_threads );
+  parallel_compute( aig, pool, constant_result, on_input, on_and, computed_values );
+}
 
 /* this is a usage demo */
 void parallel_simulate( const aig_graph& aig, const boost::dynamic_bitset<>& pattern );
@@ -0,0 +1,147 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file binary_network.hpp
+ *
+ * @brief Binary file format for XMGs and MIGs
+ *
+ * The file is a sequence of 32-bit words in host byte order, except for the type
+ * array and the characters of names:
+ *
+ *   header     | binary_network_header
+ *   types      | one byte per node (binary_network_node_type), padded to 4 bytes
+ *   fanins     | 3 literals per node ( node << 1 | complemented ), unused fanins are 0
+ *   outputs    | one literal per output
+ *   cover      | for each LUT: node, #leafs, leaf_1, ..., leaf_k
+ *   names      | model name, input names, output names (each: length, characters)
+ *
+ * Nodes are stored in topological order with the constant at index 0 and
+ * the inputs in the order of the input list.  Fanins of gates are stored
+ * normalized and sorted as they are kept in the network, such that a loader
+ * can add them without normalization and without strash lookup.  Since the
+ * header and the type array are padded, the fanin array is aligned and can
+ * be used directly from a memory mapped file.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef BINARY_NETWORK_HPP
+#define BINARY_NETWORK_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include <core/utils/mapped_file.hpp>
+
+namespace cirkit
+{
+
+constexpr uint32_t binary_network_magic   = 0x424e4b43; /* "CKNB" */
+constexpr uint32_t binary_network_version = 1u;
+
+enum binary_network_kind : uint32_t
+{
+  binary_network_xmg = 0u,
+  binary_network_mig = 1u
+};
+
+enum binary_network_flags : uint32_t
+{
+  binary_network_native_xor           = 1u << 0u,
+  binary_network_structural_hashing   = 1u << 1u,
+  binary_network_inverter_propagation = 1u << 2u,
+  binary_network_constant_used        = 1u << 3u,  /* a fanin or an output refers to the constant */
+  binary_network_has_cover            = 1u << 4u
+};
+
+enum binary_network_node_type : uint8_t
+{
+  binary_network_constant = 0u,
+  binary_network_input    = 1u,
+  binary_network_maj      = 2u,
+  binary_network_xor      = 3u
+};
+
+struct binary_network_header
+{
+  uint32_t magic = binary_network_magic;
+  uint32_t version = binary_network_version;
+  uint32_t kind = binary_network_xmg;
+  uint32_t flags = 0u;
+  uint32_t num_nodes = 0u;  /* including the constant */
+  uint32_t num_inputs = 0u;
+  uint32_t num_outputs = 0u;
+  uint32_t num_maj = 0u;
+  uint32_t num_xor = 0u;
+  uint32_t cut_size = 0u;   /* of the cover */
+  uint32_t num_luts = 0u;
+  uint32_t padding = 0u;
+};
+
+static_assert( sizeof( binary_network_header ) == 48u, "header must be packed" );
+
+inline void binary_network_write_words( std::ostream& os, const uint32_t* words, std::size_t count )
+{
+  os.write( reinterpret_cast<const char*>( words ), count * sizeof( uint32_t ) );
+}
+
+inline void binary_network_write_string( std::ostream& os, const std::string& s )
+{
+  const uint32_t length = s.size();
+  binary_network_write_words( os, &length, 1u );
+  os.write( s.data(), s.size() );
+}
+
+inline uint32_t binary_network_types_size( uint32_t num_nodes )
+{
+  return ( num_nodes + 3u ) & ~3u;
+}
+
+/* reads and checks the header of a network of the given kind */
+inline binary_network_header binary_network_read_header( mapped_reader& reader, binary_network_kind kind )
+{
+  const auto header = reader.read<binary_network_header>();
+
+  if ( header.magic != binary_network_magic )     { throw "Error: not a binary network file"; }
+  if ( header.version != binary_network_version ) { throw "Error: unsupported binary network version"; }
+  if ( header.kind != kind )                      { throw "Error: binary network file contains another network type"; }
+  if ( header.num_nodes == 0u || header.num_inputs >= header.num_nodes ) { throw "Error: broken binary network header"; }
+
+  return header;
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -27,8 +27,12 @@
 #include "read_aiger.hpp"
 
 #include <classical/utils/aig_utils.hpp>
+#include <core/utils/mapped_file.hpp>
 #include <core/utils/range_utils.hpp>
+#include <core/utils/strash_table.hpp>
 #include <core/utils/string_utils.hpp>
+#include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/assign/std/vector.hpp>
@@ -37,6 +41,8 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/range/counting_range.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 
@@ -344,6 +350,131 @@ unsigned aiger_decode( std::istream& in )
   return res;
 }
 
+/* skips spaces and parses an unsigned number */
+const char* aiger_parse_unsigned( const char* p, const char* end, unsigned& value )
+{
+  while ( p != end && *p == ' ' ) { ++p; }
+  if ( p == end || *p < '0' || *p > '9' ) { throw "Error: expected number"; }
+
+  value = 0u;
+  for ( ; p != end && *p >= '0' && *p <= '9'; ++p )
+  {
+    value = 10u * value + ( *p - '0' );
+  }
+  return p;
+}
+
+const char* aiger_skip_line( const char* p, const char* end )
+{
+  while ( p != end && *p != '\n' ) { ++p; }
+  return p == end ? p : p + 1;
+}
+
+/* decodes a variable-length number, returns the position after it */
+inline const char* aiger_decode( const char* p, const char* end, uint32_t& value )
+{
+  value = 0u;
+  for ( auto shift = 0u; ; shift += 7u )
+  {
+    if ( p == end || shift > 28u ) { throw "Error: broken AND section"; }
+    const auto c = static_cast<unsigned char>( *p++ );
+    value |= static_cast<uint32_t>( c & 0x7f ) << shift;
+    if ( !( c & 0x80 ) ) { return p; }
+  }
+}
+
+/* decodes deltas.size() numbers starting at begin; returns the end of the last one
+ *
+ * Every number ends with a byte whose most significant bit is 0.  For large
+ * sections, the range is split into chunks and the end bytes in each chunk
+ * are counted in parallel.  A prefix sum over these counts gives the index of
+ * the first number that ends in each chunk, such that all chunks can be
+ * decoded in parallel.  The range may extend beyond the AND section.
+ */
+const char* aiger_decode_deltas( const char* begin, const char* end, std::vector<uint32_t>& deltas, unsigned num_threads )
+{
+  const std::size_t min_chunk_size = 1u << 18u;
+  const auto count = deltas.size();
+
+  if ( num_threads == 1u || static_cast<std::size_t>( end - begin ) < 2u * min_chunk_size )
+  {
+    auto p = begin;
+    for ( auto& d : deltas )
+    {
+      p = aiger_decode( p, end, d );
+    }
+    return p;
+  }
+
+  work_stealing_pool pool( num_threads );
+
+  const auto length = static_cast<std::size_t>( end - begin );
+  const auto num_chunks = std::min<std::size_t>( 4u * pool.num_threads(), length / min_chunk_size );
+  const auto chunk_begin = [&]( std::size_t c ) { return begin + c * length / num_chunks; };
+
+  std::vector<std::size_t> first( num_chunks + 1u, 0u );
+  pool.parallel_for( 0u, num_chunks, [&]( std::size_t c, unsigned ) {
+      first[c + 1u] = std::count_if( chunk_begin( c ), chunk_begin( c + 1u ), []( char b ) { return !( static_cast<unsigned char>( b ) & 0x80 ); } );
+    } );
+
+  for ( auto c = 0u; c < num_chunks; ++c )
+  {
+    first[c + 1u] += first[c];
+  }
+  if ( first[num_chunks] < count ) { throw "Error: unexpected end of file in AND section"; }
+
+  std::vector<const char*> last( num_chunks, nullptr );
+  pool.parallel_for( 0u, num_chunks, [&]( std::size_t c, unsigned ) {
+      if ( first[c] >= count ) { return; }
+
+      /* start at the first number that ends in this chunk */
+      auto p = chunk_begin( c );
+      while ( p != begin && ( static_cast<unsigned char>( p[-1] ) & 0x80 ) ) { --p; }
+
+      const auto to = std::min( first[c + 1u], count );
+      for ( auto k = first[c]; k < to; ++k )
+      {
+        p = aiger_decode( p, end, deltas[k] );
+      }
+      last[c] = p;
+    } );
+
+  const auto c = std::upper_bound( first.begin(), first.end(), count - 1u ) - first.begin() - 1u;
+  return count == 0u ? begin : last[c];
+}
+
+/* reads i and o entries until the comment section */
+void aiger_read_symbols( aig_graph& aig, const char* p, const char* end )
+{
+  auto& info = aig_info( aig );
+
+  while ( p != end && *p != 'c' )
+  {
+    const auto type = *p;
+    const auto line_end = std::find( p, end, '\n' );
+
+    if ( type == 'i' || type == 'o' )
+    {
+      unsigned pos;
+      p = aiger_parse_unsigned( p + 1, line_end, pos );
+      if ( p != line_end && *p == ' ' ) { ++p; }
+      std::string name( p, line_end );
+      if ( name.empty() ) { name = "unknown"; }
+
+      if ( type == 'i' && pos < info.inputs.size() )
+      {
+        info.node_names[info.inputs[pos]] = name;
+      }
+      else if ( type == 'o' && pos < info.outputs.size() )
+      {
+        info.outputs[pos].second = name;
+      }
+    }
+
+    p = line_end == end ? end : line_end + 1;
+  }
+}
+
 void read_aiger_binary( aig_graph& aig, std::istream& in, bool noopt )
 {
   std::string line;
@@ -435,6 +566,169 @@ void read_aiger_binary( aig_graph& aig, const std::string& filename, bool noopt
   in.close();
 }
 
+void read_aiger_mapped( aig_graph& aig, const std::string& filename,
+                        const properties::ptr& settings,
+                        const properties::ptr& statistics )
+{
+  /* settings */
+  const auto strash      = get( settings, "strash",      true );
+  const auto symbols     = get( settings, "symbols",     true );
+  const auto num_threads = get( settings, "num_threads", 0u );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  mapped_file file( filename );
+  const auto end = file.end();
+
+  /* header */
+  auto p = file.begin();
+  if ( end - p < 3 || std::string( p, 3u ) != "aig" ) { throw "Error: expect 'aig M I L O A' as header"; }
+
+  unsigned num_ids, num_inputs, num_latches, num_outputs, num_ands;
+  p = aiger_parse_unsigned( p + 3, end, num_ids );
+  p = aiger_parse_unsigned( p, end, num_inputs );
+  p = aiger_parse_unsigned( p, end, num_latches );
+  p = aiger_parse_unsigned( p, end, num_outputs );
+  p = aiger_parse_unsigned( p, end, num_ands );
+  p = aiger_skip_line( p, end );
+
+  if ( num_latches != 0u ) { throw "Error: latches are not supported yet"; }
+  if ( num_ids != num_inputs + num_ands ) { throw "Error: broken AIGER header"; }
+
+  /* outputs */
+  std::vector<unsigned> oids( num_outputs );
+  for ( auto& oid : oids )
+  {
+    p = aiger_skip_line( aiger_parse_unsigned( p, end, oid ), end );
+    if ( ( oid >> 1u ) > num_ids ) { throw "Error: could not parse output definition"; }
+  }
+
+  /* AND section */
+  std::vector<uint32_t> deltas( 2u * num_ands );
+  p = aiger_decode_deltas( p, end, deltas, num_threads );
+
+  /* create AIG */
+  aig_initialize( aig, boost::filesystem::path( filename ).stem().string() );
+  auto& info = aig_info( aig );
+
+  if ( !strash )
+  {
+    info.enable_strashing = info.enable_local_optimization = false;
+  }
+
+  std::vector<aig_function> fs;
+  fs.reserve( num_ids + 1u );
+  fs.push_back( {info.constant, false} );
+  ntimes( num_inputs, [&]() { fs.push_back( aig_create_pi( aig, "" ) ); } );
+
+  /* gates are added directly instead of through aig_create_and, which
+     searches and updates the strash map for every gate */
+  auto vertex_names = boost::get( boost::vertex_name, aig );
+  const auto& complement = boost::get( boost::edge_complement, aig );
+  const auto add_and = [&]( const aig_function& left, const aig_function& right ) {
+    const auto node = add_vertex( aig );
+    vertex_names[node] = 2u * node;
+    complement[add_edge( node, left.node, aig ).first] = left.complemented;
+    complement[add_edge( node, right.node, aig ).first] = right.complemented;
+    return aig_function{node, false};
+  };
+
+  /* packed literals of the ordered children to node, the strash map is filled at the end */
+  strash_table<uint64_t> table( strash ? 2u * num_ands : 0u );
+  std::vector<std::pair<std::pair<aig_function, aig_function>, aig_function>> strash_entries;
+  const auto literal = []( const aig_function& f ) { return ( static_cast<uint64_t>( f.node ) << 1u ) | static_cast<uint64_t>( f.complemented ); };
+
+  for ( auto i = 0u; i < num_ands; ++i )
+  {
+    const auto g = ( num_inputs + i + 1u ) << 1u;
+    if ( deltas[2u * i] == 0u || deltas[2u * i] > g || deltas[2u * i + 1u] > g - deltas[2u * i] ) { throw "Error: broken AND section"; }
+
+    const auto o1 = g - deltas[2u * i];
+    const auto o2 = o1 - deltas[2u * i + 1u];
+
+    if ( o1 <= 1u || o2 <= 1u )
+    {
+      info.constant_used = true;
+    }
+
+    const auto left  = make_function( fs[o1 >> 1u], o1 & 1u );
+    const auto right = make_function( fs[o2 >> 1u], o2 & 1u );
+
+    if ( !strash )
+    {
+      fs.push_back( add_and( left, right ) );
+      continue;
+    }
+
+    /* same simplifications as in aig_create_and */
+    if ( left.node == info.constant )
+    {
+      fs.push_back( left.complemented ? right : aig_get_constant( aig, false ) );
+    }
+    else if ( right.node == info.constant )
+    {
+      fs.push_back( right.complemented ? left : aig_get_constant( aig, false ) );
+    }
+    else if ( left.node == right.node )
+    {
+      fs.push_back( left == right ? left : aig_get_constant( aig, false ) );
+    }
+    else
+    {
+      const auto key = left.node < right.node ? std::make_pair( left, right ) : std::make_pair( right, left );
+      const auto existing = table.find( ( literal( key.first ) << 32u ) | literal( key.second ) );
+      if ( existing != table.empty )
+      {
+        fs.push_back( {existing, false} );
+      }
+      else
+      {
+        const auto f = add_and( left, right );
+        table.insert( ( literal( key.first ) << 32u ) | literal( key.second ), f.node );
+        strash_entries.push_back( {key, f} );
+        fs.push_back( f );
+      }
+    }
+  }
+
+  /* inserting sorted entries with hint takes constant time each */
+  std::sort( strash_entries.begin(), strash_entries.end() );
+  for ( const auto& e : strash_entries )
+  {
+    info.strash.emplace_hint( info.strash.end(), e.first, e.second );
+  }
+
+  for ( auto oid : oids )
+  {
+    if ( oid <= 1u )
+    {
+      info.constant_used = true;
+    }
+    aig_create_po( aig, make_function( fs[oid >> 1u], oid & 1u ), "" );
+  }
+
+  /* symbol table */
+  const std::size_t symbol_offset = p - file.begin();
+  if ( statistics )
+  {
+    statistics->set( "symbol_offset", symbol_offset );
+  }
+
+  if ( symbols )
+  {
+    aiger_read_symbols( aig, p, end );
+  }
+}
+
+void read_aiger_symbols( aig_graph& aig, const std::string& filename, std::size_t offset )
+{
+  mapped_file file( filename );
+  if ( offset > file.size() ) { throw "Error: symbol table offset exceeds file size"; }
+
+  aiger_read_symbols( aig, file.begin() + offset, file.end() );
+}
+
 }
 
 // Local Variables:
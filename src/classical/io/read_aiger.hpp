@@ -37,6 +37,8 @@
 #define READ_AIGER_HPP
 
 #include <classical/aig.hpp>
+#include <core/properties.hpp>
+#include <cstddef>
 #include <iostream>
 #include <string>
 
@@ -53,6 +55,27 @@ void read_aiger( aig_graph& aig, std::string& comment, const std::string& filena
 void read_aiger_binary( aig_graph& aig, std::istream& in, bool noopt = false );
 void read_aiger_binary( aig_graph& aig, const std::string& filename, bool noopt = false );
 
+/* reads binary AIGER files without latches from a memory mapped file; the
+ * delta encoded AND section is decoded in one pass into a literal array, for
+ * large files in parallel, before the AIG is constructed
+ *
+ * settings:
+ *   strash      (true)  strash and simplify gates; disable for trusted inputs,
+ *                       node indexes then correspond to the AIGER variables
+ *   symbols     (true)  read the symbol table; if false, it is skipped and can
+ *                       be read later with read_aiger_symbols
+ *   num_threads (0)     threads for decoding, 0 uses all cores
+ *
+ * statistics:
+ *   runtime, symbol_offset (position of the symbol table in the file)
+ */
+void read_aiger_mapped( aig_graph& aig, const std::string& filename,
+                        const properties::ptr& settings = properties::ptr(),
+                        const properties::ptr& statistics = properties::ptr() );
+
+/* reads input and output names of the symbol table starting at offset */
+void read_aiger_symbols( aig_graph& aig, const std::string& filename, std::size_t offset );
+
 }
 
 #endif
@@ -203,12 +203,16 @@ mig_function mig_create_maj( mig_graph& mig, const mig_function& a, const mig_fu
   mig_function children[] = {a, b, c};
   std::sort( children, children + 3 );
 
-  const auto key = std::make_tuple( children[0], children[1], children[2] );
-
-  const auto it = info.strash.find( key );
-  if ( it != info.strash.end() )
+  const auto literal = []( const mig_function& f ) {
+    assert( f.node < ( 1u << 31u ) );
+    return ( static_cast<uint32_t>( f.node ) << 1u ) | static_cast<uint32_t>( f.complemented );
+  };
+  const strash_key3 key( literal( children[0] ), literal( children[1] ), literal( children[2] ) );
+
+  const auto existing = info.strash.find( key );
+  if ( existing != info.strash.empty )
   {
-    return it->second;
+    return { existing, false };
   }
 
   mig_node node = add_vertex( mig );
@@ -224,7 +228,8 @@ mig_function mig_create_maj( mig_graph& mig, const mig_function& a, const mig_fu
   complement[eb] = children[1].complemented;
   complement[ec] = children[2].complemented;
 
-  return info.strash[key] = { node, false };
+  info.strash.insert( key, node );
+  return { node, false };
 }
 
 mig_function mig_create_and( mig_graph& mig, const mig_function& a, const mig_function& b )
@@ -38,6 +38,7 @@
 
 #include <core/properties.hpp>
 #include <core/utils/graph_utils.hpp>
+#include <core/utils/strash_table.hpp>
 #include <classical/traits.hpp>
 
 namespace cirkit
@@ -82,7 +83,7 @@ struct mig_graph_info
   std::map<detail::mig_traits_t::vertex_descriptor, std::string>               node_names;
   std::vector<std::pair<mig_function, std::string> >                           outputs;
   std::vector<detail::mig_traits_t::vertex_descriptor>                         inputs;
-  std::map<std::tuple<mig_function, mig_function, mig_function>, mig_function> strash;
+  strash_table<strash_key3>                                                    strash; /* packed literals of sorted children to node */
 };
 
 namespace detail
@@ -0,0 +1,203 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mig_binary.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include <core/utils/mapped_file.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/io/binary_network.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+inline uint32_t mig_binary_literal( const mig_function& f )
+{
+  return ( static_cast<uint32_t>( f.node ) << 1u ) | static_cast<uint32_t>( f.complemented );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+void mig_write_binary( const mig_graph& mig, const std::string& filename,
+                       const properties::ptr&,
+                       const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  const auto& info = boost::get_property( mig, boost::graph_name );
+
+  binary_network_header header;
+  header.kind        = binary_network_mig;
+  header.flags       = binary_network_structural_hashing | ( info.constant_used ? binary_network_constant_used : 0u );
+  header.num_nodes   = num_vertices( mig );
+  header.num_inputs  = info.inputs.size();
+  header.num_outputs = info.outputs.size();
+  header.num_maj     = header.num_nodes - header.num_inputs - 1u;
+
+  std::vector<uint8_t>  types( binary_network_types_size( header.num_nodes ), binary_network_constant );
+  std::vector<uint32_t> fanins( 3u * header.num_nodes, 0u );
+
+  /* MIGs are only built by appending nodes, i.e., node indexes are in
+     topological order and the inputs appear in the order of the input list */
+  auto next_input = 0u;
+  for ( auto n = 1u; n < header.num_nodes; ++n )
+  {
+    if ( out_degree( n, mig ) == 0u )
+    {
+      if ( next_input == info.inputs.size() || info.inputs[next_input++] != n ) { throw "Error: MIG inputs are not in order"; }
+      types[n] = binary_network_input;
+      continue;
+    }
+
+    std::vector<mig_function> cs;
+    for ( const auto& e : boost::make_iterator_range( out_edges( n, mig ) ) )
+    {
+      cs.push_back( mig_to_function( mig, e ) );
+    }
+    std::sort( cs.begin(), cs.end() );
+
+    if ( cs.back().node >= n ) { throw "Error: MIG is not in topological order"; }
+
+    types[n] = binary_network_maj;
+    std::transform( cs.begin(), cs.end(), fanins.begin() + 3u * n, mig_binary_literal );
+  }
+
+  std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+  os.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+  os.write( reinterpret_cast<const char*>( types.data() ), types.size() );
+  binary_network_write_words( os, fanins.data(), fanins.size() );
+  for ( const auto& o : info.outputs )
+  {
+    const auto literal = mig_binary_literal( o.first );
+    binary_network_write_words( os, &literal, 1u );
+  }
+
+  binary_network_write_string( os, info.model_name );
+  for ( const auto& i : info.inputs )
+  {
+    const auto it = info.node_names.find( i );
+    binary_network_write_string( os, it == info.node_names.end() ? std::string() : it->second );
+  }
+  for ( const auto& o : info.outputs )
+  {
+    binary_network_write_string( os, o.second );
+  }
+}
+
+mig_graph mig_read_binary( const std::string& filename,
+                           const properties::ptr&,
+                           const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  mapped_file file( filename );
+  mapped_reader reader( file.begin(), file.end() );
+
+  const auto header = binary_network_read_header( reader, binary_network_mig );
+
+  /* type and fanin arrays are used in place */
+  const auto types  = reinterpret_cast<const uint8_t*>( reader.skip( binary_network_types_size( header.num_nodes ) ) );
+  const auto fanins = reinterpret_cast<const uint32_t*>( reader.skip( 3u * header.num_nodes * sizeof( uint32_t ) ) );
+
+  mig_graph mig;
+  mig_initialize( mig );
+
+  auto& info = boost::get_property( mig, boost::graph_name );
+  info.constant_used = header.flags & binary_network_constant_used;
+  info.strash.reserve( header.num_maj );
+
+  const auto& complement = boost::get( boost::edge_complement, mig );
+
+  for ( auto i = 1u; i < header.num_nodes; ++i )
+  {
+    const auto node = add_vertex( mig );
+    assert( node == i );
+
+    switch ( types[i] )
+    {
+    case binary_network_input:
+      info.inputs.push_back( node );
+      break;
+    case binary_network_maj:
+      {
+        const auto* f = fanins + 3u * i;
+        if ( !( f[0] < f[1] && f[1] < f[2] && ( f[2] >> 1u ) < i ) ) { throw "Error: fanins of majority gate are not normalized"; }
+
+        for ( auto j = 0u; j < 3u; ++j )
+        {
+          complement[add_edge( node, f[j] >> 1u, mig ).first] = f[j] & 1u;
+        }
+        info.strash.insert( strash_key3( f[0], f[1], f[2] ), node );
+      }
+      break;
+    default:
+      throw "Error: unknown node type in binary network";
+    }
+  }
+
+  if ( info.inputs.size() != header.num_inputs ) { throw "Error: node counts do not match binary network header"; }
+
+  std::vector<uint32_t> outputs( header.num_outputs );
+  reader.read( outputs.data(), outputs.size() );
+
+  info.model_name = reader.read_string();
+  for ( auto n : info.inputs )
+  {
+    info.node_names[n] = reader.read_string();
+  }
+  for ( auto o : outputs )
+  {
+    if ( ( o >> 1u ) >= header.num_nodes ) { throw "Error: output refers to a node that is not defined"; }
+    info.outputs.push_back( {mig_function{o >> 1u, static_cast<bool>( o & 1u )}, reader.read_string()} );
+  }
+
+  return mig;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
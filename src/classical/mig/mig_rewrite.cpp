@@ -115,6 +115,8 @@ mig_graph mig_rewrite_top_down( const mig_graph& mig,
     mig_create_po( mig_new, mig_rewrite_top_down_rec( mig, po.first.node, mig_new, on_maj, old_to_new ) ^ po.first.complemented, po.second );
   }
 
+  mig_strash_statistics( mig_new, statistics );
+
   return mig_new;
 }
 
@@ -151,6 +153,8 @@ mig_graph mig_rewrite_bottom_up( const mig_graph& mig,
     mig_create_po( mig_new, old_to_new[po.first.node] ^ po.first.complemented, po.second );
   }
 
+  mig_strash_statistics( mig_new, statistics );
+
   return mig_new;
 }
 
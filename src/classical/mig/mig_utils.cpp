@@ -77,6 +77,11 @@ void mig_print_stats( const mig_graph& mig, std::ostream& os )
   os << boost::format( "[i] %20s: i/o = %7d / %7d  maj = %7d  lev = %4d" ) % name % n % info.outputs.size() % ( boost::num_vertices( mig ) - n - 1u ) % depth << std::endl;
 }
 
+void mig_strash_statistics( const mig_graph& mig, const properties::ptr& statistics )
+{
+  set_strash_statistics( statistics, "strash", mig_info( mig ).strash );
+}
+
 std::vector<mig_function> get_children( const mig_graph& mig, const mig_node& node )
 {
   std::vector<mig_function> children;
@@ -39,6 +39,7 @@
 #include <iostream>
 #include <map>
 
+#include <core/properties.hpp>
 #include <classical/mig/mig.hpp>
 
 namespace cirkit
@@ -60,6 +61,9 @@ inline mig_function make_function( const mig_function& f, bool complemented )
 }
 
 void mig_print_stats( const mig_graph& mig, std::ostream& os = std::cout );
+
+/* load factor and probe lengths of the strash table (keys strash_*) */
+void mig_strash_statistics( const mig_graph& mig, const properties::ptr& statistics );
 std::vector<mig_function> get_children( const mig_graph& mig, const mig_node& node );
 
 unsigned number_of_complemented_edges( const mig_graph& mig );
@@ -26,12 +26,17 @@
 
 #include "exorcism2.hpp"
 
-#include <boost/circular_buffer.hpp>
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <unordered_set>
+
 #include <boost/format.hpp>
 
 #include <core/utils/buckets.hpp>
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 
 namespace cirkit
 {
@@ -40,37 +45,51 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+template<typename Cube>
+using cube_pair = std::pair<Cube, Cube>;
+
+template<typename Cube>
+struct cube_pair_hash
+{
+  std::size_t operator()( const cube_pair<Cube>& p ) const
+  {
+    return ( std::hash<Cube>()( p.first ) * 0x9e3779b97f4a7c15ull ) ^ std::hash<Cube>()( p.second );
+  }
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+template<typename Cube>
 class exorcism2_manager
 {
 public:
-  exorcism2_manager( const std::vector<cube2>& original, int num_vars, const properties::ptr& settings )
+  /* max_iterations bounds the number of outer iterations in run (0: until no more gain) */
+  exorcism2_manager( const std::vector<Cube>& original, int num_vars, bool progress, bool verbose, unsigned max_iterations = 0u )
     : cubes( num_vars + 1 ),
       num_vars( num_vars ),
       init_cubes_size( original.size() ),
 
-      pairs( 2u ),
+      pairs( 5u ),
+      queued( 5u ),
       pairs_tmp( 5u ),
 
-      progress( get( settings, "progress", false ) )
+      progress( progress ),
+      max_iterations( max_iterations )
   {
-    for ( auto i = 2; i <= 4; ++i )
-    {
-      pairs.push_back( boost::circular_buffer<std::pair<cube2, cube2>>( original.size() * original.size() ) );
-    }
-
     for ( const auto& c : original )
     {
       add_cube( c );
     }
 
-    print_stats();
+    if ( verbose )
+    {
+      print_stats();
+    }
   }
 
-  std::vector<cube2> run()
+  std::vector<Cube> run()
   {
     unsigned gain{};
     unsigned rounds = 0u;
@@ -147,9 +166,9 @@ public:
       {
         ++rounds;
       }
-    } while ( rounds <= 2u );
+    } while ( rounds <= 2u && ( max_iterations == 0u || iteration < max_iterations ) );
 
-    std::vector<cube2> res;
+    std::vector<Cube> res;
 
     for ( auto i = 0; i <= num_vars; ++i )
     {
@@ -160,7 +179,7 @@ public:
   }
 
 private:
-  int add_cube( const cube2& c, bool add = true )
+  int add_cube( const Cube& c, bool add = true )
   {
     const auto lits = c.num_literals();
 
@@ -190,13 +209,34 @@ private:
     cubes.add( lits, last_added = c );
     for ( auto d = 2; d <= max_dist; ++d )
     {
-      std::copy( pairs_tmp[d].begin(), pairs_tmp[d].end(), std::back_inserter( pairs[d] ) );
+      for ( const auto& p : pairs_tmp[d] )
+      {
+        push_pair( d, p );
+      }
     }
 
     return 0;
   }
 
-  int pair_with_others( const cube2& c, unsigned level )
+  /* a pair is queued at most once, regardless of its orientation */
+  void push_pair( unsigned d, const cube_pair<Cube>& p )
+  {
+    const auto key = p.first < p.second ? p : std::make_pair( p.second, p.first );
+    if ( queued[d].insert( key ).second )
+    {
+      pairs[d].push_back( p );
+    }
+  }
+
+  cube_pair<Cube> pop_pair( unsigned d )
+  {
+    const auto p = pairs[d].front();
+    pairs[d].pop_front();
+    queued[d].erase( p.first < p.second ? p : std::make_pair( p.second, p.first ) );
+    return p;
+  }
+
+  int pair_with_others( const Cube& c, unsigned level )
   {
     for ( auto it = cubes.begin( level ); it != cubes.end( level ); ++it )
     {
@@ -223,16 +263,13 @@ private:
   {
     const auto old_size = cubes.size();
 
-    auto& ps = pairs[2u];
-
-    const auto num_pairs = ps.size();
+    const auto num_pairs = pairs[2u].size();
 
     int c1_size{}, c2_size{};
 
     for ( auto i = 0u; i < num_pairs; ++i )
     {
-      const auto p = ps.front();
-      ps.pop_front();
+      const auto p = pop_pair( 2u );
 
       c1_size = p.first.num_literals();
       if ( cubes.find( c1_size, p.first ) == -1 ) continue;
@@ -276,7 +313,7 @@ private:
         {
           cubes.add( c1_size, p.first );
           cubes.add( c2_size, p.second );
-          ps.push_back( p );
+          push_pair( 2u, p );
         }
       }
     }
@@ -288,19 +325,17 @@ private:
   {
     const auto old_size = cubes.size();
 
-    auto& ps = pairs[3u];
-    const auto num_pairs = ps.size();
+    const auto num_pairs = pairs[3u].size();
 
     int c1_size{}, c2_size{};
 
-    // std::sort( ps.begin(), ps.end(), []( const std::pair<cube2, cube2>& a, const std::pair<cube2, cube2>& b ) {
+    // std::sort( ps.begin(), ps.end(), []( const std::pair<Cube, Cube>& a, const std::pair<Cube, Cube>& b ) {
     //     return a.first.num_literals() + a.second.num_literals() < b.first.num_literals() + b.second.num_literals();
     //   } );
 
     for ( auto i = 0u; i < num_pairs; ++i )
     {
-      const auto p = ps.front();
-      ps.pop_front();
+      const auto p = pop_pair( 3u );
 
       c1_size = p.first.num_literals();
       if ( cubes.find( c1_size, p.first ) == -1 ) continue;
@@ -374,7 +409,7 @@ private:
       {
         cubes.add( c1_size, p.first );
         cubes.add( c2_size, p.second );
-        ps.push_back( p );
+        push_pair( 3u, p );
       }
     }
 
@@ -392,16 +427,19 @@ private:
   }
 
 private:
-  hash_buckets<cube2> cubes;
+  hash_buckets<Cube> cubes;
   int num_vars;
   int init_cubes_size;
 
-  std::vector<boost::circular_buffer<std::pair<cube2, cube2>>> pairs;
-  std::vector<std::vector<std::pair<cube2, cube2>>> pairs_tmp;
+  /* pairs are only kept for cubes in literal-count buckets within max_dist,
+     the queues grow on demand and contain each pair at most once */
+  std::vector<std::deque<cube_pair<Cube>>> pairs;
+  std::vector<std::unordered_set<cube_pair<Cube>, cube_pair_hash<Cube>>> queued;
+  std::vector<std::vector<std::pair<Cube, Cube>>> pairs_tmp;
 
   /* bookkeeping */
-  cube2 last_added;
-  cube2 last_removed;
+  Cube last_added;
+  Cube last_removed;
   int saved_lits = 0;
 
   /* control algorithm */
@@ -410,6 +448,7 @@ private:
   bool reshape = false;
 
   bool progress = false;
+  unsigned max_iterations = 0u;
 
   unsigned cube_groups2[8] = {2, 0, 1, 2,
                               0, 2, 2, 1};
@@ -422,18 +461,182 @@ private:
                                0, 0, 2, 0, 2, 1, 2, 1, 1};
 };
 
+/* splits a cover into groups of cubes with pairwise disjoint supports, the
+   constant cube (empty support) forms its own group */
+template<typename Cube>
+std::vector<std::vector<Cube>> partition_cover( const std::vector<Cube>& cover, int num_vars )
+{
+  /* union-find over variables */
+  std::vector<int> parent( num_vars + 1 );
+  std::iota( parent.begin(), parent.end(), 0 );
+
+  const auto find = [&parent]( int v ) {
+    while ( parent[v] != v )
+    {
+      v = parent[v] = parent[parent[v]];
+    }
+    return v;
+  };
+
+  /* first variable of each cube, num_vars represents the constant cube */
+  std::vector<int> first_var( cover.size(), num_vars );
+
+  for ( auto i = 0u; i < cover.size(); ++i )
+  {
+    for ( auto v = 0; v < num_vars; ++v )
+    {
+      if ( !cover[i].has_var( v ) ) continue;
+
+      if ( first_var[i] == num_vars )
+      {
+        first_var[i] = v;
+      }
+      else
+      {
+        const auto r = find( v );
+        const auto first = find( first_var[i] );
+        if ( r != first )
+        {
+          parent[r] = first;
+        }
+      }
+    }
+  }
+
+  std::vector<int> group_of( num_vars + 1, -1 );
+  std::vector<std::vector<Cube>> groups;
+  for ( auto i = 0u; i < cover.size(); ++i )
+  {
+    const auto& c = cover[i];
+    const auto root = find( first_var[i] );
+    if ( group_of[root] == -1 )
+    {
+      group_of[root] = groups.size();
+      groups.emplace_back();
+    }
+    groups[group_of[root]].push_back( c );
+  }
+
+  return groups;
+}
+
+/* minimizes all covers in parallel, one task per cover */
+template<typename Cube>
+void minimize_covers( std::vector<std::vector<Cube>>& covers, int num_vars, work_stealing_pool& pool, bool progress, bool verbose, unsigned max_iterations )
+{
+  /* large covers first for better load balancing */
+  std::vector<unsigned> order( covers.size() );
+  std::iota( order.begin(), order.end(), 0u );
+  std::stable_sort( order.begin(), order.end(), [&covers]( unsigned a, unsigned b ) { return covers[a].size() > covers[b].size(); } );
+
+  pool.parallel_for( 0u, order.size(), [&]( std::size_t i, unsigned ) {
+      auto& cover = covers[order[i]];
+      if ( cover.size() < 2u ) return;
+
+      exorcism2_manager<Cube> mgr( cover, num_vars, progress, verbose, max_iterations );
+      cover = mgr.run();
+    } );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
-std::vector<cube2> exorcism2( const std::vector<cube2>& cubes, int num_vars, const properties::ptr& settings, const properties::ptr& statistics )
+template<typename Cube>
+std::vector<Cube> exorcism2( const std::vector<Cube>& cubes, int num_vars, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  return exorcism2( std::vector<std::vector<Cube>>{cubes}, num_vars, settings, statistics ).front();
+}
+
+template<typename Cube>
+std::vector<std::vector<Cube>> exorcism2( const std::vector<std::vector<Cube>>& covers, int num_vars, const properties::ptr& settings, const properties::ptr& statistics )
 {
+  /* settings */
+  const auto progress       = get( settings, "progress",       false );
+  const auto verbose        = get( settings, "verbose",        false );
+  const auto num_threads    = get( settings, "num_threads",    1u );
+  const auto partition      = get( settings, "partition",      true );
+  const auto merge          = get( settings, "merge",          true );
+  const auto merge_interval = get( settings, "merge_interval", 0u );
+
+  /* timer */
   properties_timer t( statistics );
 
-  exorcism2_manager mgr( cubes, num_vars, settings );
-  return mgr.run();
+  work_stealing_pool pool( num_threads );
+
+  auto result = covers;
+  auto num_partitions = 0u;
+  auto merge_rounds = 0u;
+
+  if ( !partition )
+  {
+    minimize_covers( result, num_vars, pool, progress && result.size() == 1u, verbose, 0u );
+  }
+  else
+  {
+    const auto cover_size = [&result]() {
+      return std::accumulate( result.begin(), result.end(), 0ul, []( unsigned long s, const std::vector<Cube>& c ) { return s + c.size(); } );
+    };
+
+    while ( true )
+    {
+      const auto old_size = cover_size();
+
+      /* minimize disjoint-support groups of all outputs together */
+      std::vector<std::vector<Cube>> groups;
+      std::vector<unsigned> output_of;
+      for ( auto o = 0u; o < result.size(); ++o )
+      {
+        for ( auto& g : partition_cover( result[o], num_vars ) )
+        {
+          groups.push_back( std::move( g ) );
+          output_of.push_back( o );
+        }
+      }
+      num_partitions = std::max<unsigned>( num_partitions, groups.size() );
+
+      minimize_covers( groups, num_vars, pool, false, verbose, merge_interval );
+
+      for ( auto& c : result )
+      {
+        c.clear();
+      }
+      for ( auto i = 0u; i < groups.size(); ++i )
+      {
+        std::copy( groups[i].begin(), groups[i].end(), std::back_inserter( result[output_of[i]] ) );
+      }
+
+      /* exorlinks across partitions on the merged covers */
+      if ( merge && groups.size() > result.size() )
+      {
+        ++merge_rounds;
+        minimize_covers( result, num_vars, pool, progress && result.size() == 1u, verbose, merge_interval );
+      }
+
+      if ( merge_interval == 0u || cover_size() >= old_size )
+      {
+        break;
+      }
+    }
+  }
+
+  set( statistics, "num_partitions", num_partitions );
+  set( statistics, "merge_rounds", merge_rounds );
+
+  return result;
 }
 
+#define EXORCISM2_INSTANTIATE( Cube ) \
+  template std::vector<Cube> exorcism2<Cube>( const std::vector<Cube>&, int, const properties::ptr&, const properties::ptr& ); \
+  template std::vector<std::vector<Cube>> exorcism2<Cube>( const std::vector<std::vector<Cube>>&, int, const properties::ptr&, const properties::ptr& );
+
+EXORCISM2_INSTANTIATE( cube2 )
+EXORCISM2_INSTANTIATE( cube64 )
+EXORCISM2_INSTANTIATE( cube128 )
+EXORCISM2_INSTANTIATE( cube256 )
+
+#undef EXORCISM2_INSTANTIATE
+
 }
 
 // Local Variables:
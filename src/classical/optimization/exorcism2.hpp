@@ -27,7 +27,7 @@
 /**
  * @file exorcism2.hpp
  *
- * @brief Exorcism implementation (single output)
+ * @brief Exorcism implementation (single and multiple outputs)
  *
  * @author Mathias Soeken
  * @since  2.3
@@ -40,11 +40,56 @@
 
 #include <core/properties.hpp>
 #include <classical/utils/cube2.hpp>
+#include <classical/utils/wide_cube.hpp>
 
 namespace cirkit
 {
 
-std::vector<cube2> exorcism2( const std::vector<cube2>& cubes, int num_vars, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
+/**
+ * @brief Exorcism for single-output covers
+ *
+ * Cube can be cube2 (up to 32 inputs), cube64, cube128, or cube256, use
+ * with_cube_type to select the type from the number of inputs at runtime.
+ */
+template<typename Cube>
+std::vector<Cube> exorcism2( const std::vector<Cube>& cubes, int num_vars, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
+
+/**
+ * @brief Exorcism for multi-output covers
+ *
+ * Each entry of covers is the ESOP cover of one output.  If partition is
+ * set, every cover is split into groups of cubes with disjoint supports
+ * and the groups of all outputs are minimized in parallel.  Afterwards
+ * (if merge is set) the groups are merged and each output is minimized
+ * once more to find exorlinks across groups.  With a non-zero
+ * merge_interval, group and merged minimization are interrupted after
+ * that many iterations and the covers are re-partitioned until the
+ * number of cubes no longer decreases.
+ *
+ * @param settings The following settings are possible
+ *                 +----------------+----------+---------+
+ *                 | Name           | Type     | Default |
+ *                 +----------------+----------+---------+
+ *                 | num_threads    | unsigned | 1u      |
+ *                 | partition      | bool     | true    |
+ *                 | merge          | bool     | true    |
+ *                 | merge_interval | unsigned | 0u      |
+ *                 | progress       | bool     | false   |
+ *                 | verbose        | bool     | false   |
+ *                 +----------------+----------+---------+
+ *                 If num_threads is 0, the number of cores is used.
+ *
+ * @param statistics The following statistics are given
+ *                 +----------------+----------+----------------------------------------+
+ *                 | Name           | Type     | Description                            |
+ *                 +----------------+----------+----------------------------------------+
+ *                 | runtime        | double   | total runtime                          |
+ *                 | num_partitions | unsigned | maximum number of groups in one round  |
+ *                 | merge_rounds   | unsigned | number of merged minimization rounds   |
+ *                 +----------------+----------+----------------------------------------+
+ */
+template<typename Cube>
+std::vector<std::vector<Cube>> exorcism2( const std::vector<std::vector<Cube>>& covers, int num_vars, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 }
 
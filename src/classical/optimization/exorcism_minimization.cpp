@@ -32,6 +32,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
@@ -53,7 +54,6 @@ namespace abc
 {
 extern cinfo g_CoverInfo;
 extern int s_fDecreaseLiterals;
-int Abc_ExorcismMain( Vec_Wec_t * vEsop, int nIns, int nOuts, char * pFileNameOut, int Quality, int Verbosity, int nCubesMax, int fUseQCost );
 Gia_Man_t * Eso_ManCompute( Gia_Man_t * pGia, int fVerbose, Vec_Wec_t ** pvRes );
 
 void AddCubesToStartingCover( Vec_Wec_t * vEsop );
@@ -71,6 +71,14 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+/* ABC's exorcism keeps the cover in global variables, only one call per
+   process can be active at a time */
+std::mutex& exorcism_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
 class exorcism_processor : public pla_processor
 {
 public:
@@ -425,103 +433,49 @@ void reduce_cover( bool progress, exorcism_script script )
 }
 
 /******************************************************************************
- * Public functions                                                           *
+ * Exorcism core                                                              *
  ******************************************************************************/
 
-void exorcism_minimization( DdManager * cudd, DdNode * f, const properties::ptr& settings, const properties::ptr& statistics )
-{
-  return exorcism_minimization( bdd_to_cubes( cudd, f ), settings, statistics );
-}
-
-void exorcism_minimization( const cube_vec_t& cubes, const properties::ptr& settings, const properties::ptr& statistics )
+struct exorcism_job
 {
-  const auto verbose      = get( settings, "verbose",      false );
-  const auto on_cube      = get( settings, "on_cube",      cube_function_t() );
-  const auto esopname     = get( settings, "esopname",     std::string( "/tmp/test.esop" ) );
-  const auto skip_parsing = get( settings, "skip_parsing", false );
-
-  properties_timer t( statistics );
-
-  if ( cubes.empty() )
-  {
-    return;
-  }
-
-  abc::Vec_Wec_t *esop = abc::Vec_WecAlloc( 0u );
-
-  for ( const auto& cube : cubes )
-  {
-    auto * level = abc::Vec_WecPushLevel( esop );
-
-    for ( auto i = 0u; i < cube.length(); ++i )
-    {
-      if ( !cube.care()[i] ) { continue; }
-
-      abc::Vec_IntPush( level, ( i << 1u ) | !cube.bits()[i] );
-    }
-    abc::Vec_IntPush( level, -1 );
-  }
-
-  if ( verbose )
-  {
-    abc::Vec_WecPrint( esop, 0 );
-  }
-
-  /* redict STDOUT because of one output line in Abc_ExorcismMain */
-  abc::Abc_ExorcismMain( esop, cubes.front().length(), 1, const_cast<char*>( esopname.c_str() ), 2, verbose, 20000, 0 );
-
-  abc::Vec_WecFree( esop );
-
-  /* Parse */
-  if ( !skip_parsing )
-  {
-    exorcism_processor p( on_cube );
-    pla_parser( esopname, p );
-
-    set( statistics, "cube_count", p.cube_count() );
-    set( statistics, "literal_count", p.literal_count() );
-  }
-}
+  unsigned        ninputs;
+  unsigned        noutputs;
+  unsigned        quality;
+  unsigned        cubes_max;
+  exorcism_script script;
+  bool            progress;
+  int             verbosity;
+};
 
-gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsigned ninputs, unsigned noutputs,
-                                           const properties::ptr& settings,
-                                           const properties::ptr& statistics )
+/* operates on ABC's global cover, the caller must hold exorcism_mutex */
+abc::Vec_Wec_t* reduce_esop( abc::Vec_Wec_t* esop, const exorcism_job& job, double& opt_time )
 {
-  /* settings */
-  const auto quality      = get( settings, "quality",      2u );
-  const auto cubes_max    = get( settings, "cubes_max",    1000000u );
-  const auto script       = get( settings, "script",       exorcism_script::def_wo4 );
-  const auto progress     = get( settings, "progress",     false );
-  const auto verbose      = get( settings, "verbose",      false );
-  const auto very_verbose = get( settings, "very_verbose", false );
-
-  properties_timer t( statistics );
-
   /* initialize */
   memset( &abc::g_CoverInfo, 0, sizeof( abc::cinfo ) );
-  abc::g_CoverInfo.Quality = static_cast<int>( quality );
-  abc::g_CoverInfo.Verbosity = very_verbose ? 2 : ( verbose ? 1 : 0 );
-  abc::g_CoverInfo.nCubesMax = static_cast<int>( cubes_max );
+  abc::g_CoverInfo.Quality = static_cast<int>( job.quality );
+  abc::g_CoverInfo.Verbosity = job.verbosity;
+  abc::g_CoverInfo.nCubesMax = static_cast<int>( job.cubes_max );
+  abc::s_fDecreaseLiterals = 0;
   abc::PrepareBitSetModule();
 
-  int rbits = ( ninputs * 2 ) % ( sizeof(unsigned) * 8 );
-  int twords = ( ninputs * 2 ) / ( sizeof(unsigned) * 8 ) + ( rbits > 0 );
-  abc::g_CoverInfo.nVarsIn = ninputs;
+  int rbits = ( job.ninputs * 2 ) % ( sizeof(unsigned) * 8 );
+  int twords = ( job.ninputs * 2 ) / ( sizeof(unsigned) * 8 ) + ( rbits > 0 );
+  abc::g_CoverInfo.nVarsIn = job.ninputs;
   abc::g_CoverInfo.nWordsIn = twords;
 
-  rbits = ( noutputs * 2 ) % ( sizeof(unsigned) * 8 );
-  twords = ( noutputs * 2 ) / ( sizeof(unsigned) * 8 ) + ( rbits > 0 );
-  abc::g_CoverInfo.nVarsOut = noutputs;
+  rbits = ( job.noutputs * 2 ) % ( sizeof(unsigned) * 8 );
+  twords = ( job.noutputs * 2 ) / ( sizeof(unsigned) * 8 ) + ( rbits > 0 );
+  abc::g_CoverInfo.nVarsOut = job.noutputs;
   abc::g_CoverInfo.nWordsOut = twords;
   abc::g_CoverInfo.cIDs = 1;
 
-  abc::g_CoverInfo.nCubesBefore = abc::Vec_WecSize( esop.get() );
+  abc::g_CoverInfo.nCubesBefore = abc::Vec_WecSize( esop );
 
   if ( abc::g_CoverInfo.nCubesBefore > abc::g_CoverInfo.nCubesMax )
   {
     std::cout << boost::format( "[e] the size of the starting cover is too large: %d (allowed: %d)" )
       % abc::g_CoverInfo.nCubesBefore % abc::g_CoverInfo.nCubesMax << std::endl;
-    return gia_graph::esop_ptr( nullptr, &abc::Vec_WecFree );
+    return nullptr;
   }
 
   /* prepare internal data structures */
@@ -529,7 +483,7 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
   if ( !abc::AllocateCover( abc::g_CoverInfo.nCubesAlloc, abc::g_CoverInfo.nWordsIn, abc::g_CoverInfo.nWordsOut ) )
   {
     std::cout << "[e] not enough memory to allocate cover" << std::endl;
-    return gia_graph::esop_ptr( nullptr, &abc::Vec_WecFree );
+    return nullptr;
   }
 
   abc::AllocateCubeSets( abc::g_CoverInfo.nVarsIn, abc::g_CoverInfo.nVarsOut );
@@ -537,14 +491,14 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
   if ( !abc::AllocateQueques( abc::g_CoverInfo.nCubesAlloc * 4 ) )
   {
     std::cout << "[e] not enough memory to allocate queques" << std::endl;
-    return gia_graph::esop_ptr( nullptr, &abc::Vec_WecFree );
+    return nullptr;
   }
 
   /* reduce */
-  abc::AddCubesToStartingCover( esop.get() );
+  abc::AddCubesToStartingCover( esop );
   {
-    properties_timer t( statistics, "exorcism_opt_time" );
-    reduce_cover( progress, script );
+    increment_timer t( &opt_time );
+    reduce_cover( job.progress, job.script );
   }
 
   /* extract cover */
@@ -557,7 +511,7 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
   {
     level = abc::Vec_WecPushLevel( esop_opt );
 
-    for ( auto v = 0u; v < ninputs; ++v )
+    for ( auto v = 0u; v < job.ninputs; ++v )
     {
       switch ( GetVar( p, v ) )
       {
@@ -577,7 +531,7 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
         {
           abc::Vec_IntPush( level, -coutputs - 1 );
         }
-        if ( ++coutputs == noutputs ) break;
+        if ( ++coutputs == job.noutputs ) break;
       }
     }
   }
@@ -586,6 +540,107 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
   abc::DelocateCover();
   abc::DelocateQueques();
 
+  return esop_opt;
+}
+
+/* ABC's global cover is shared by all threads, calls are serialized */
+abc::Vec_Wec_t* run_exorcism( abc::Vec_Wec_t * esop, const exorcism_job& job, double& opt_time )
+{
+  std::lock_guard<std::mutex> lock( exorcism_mutex() );
+  return reduce_esop( esop, job, opt_time );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+void exorcism_minimization( DdManager * cudd, DdNode * f, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  return exorcism_minimization( bdd_to_cubes( cudd, f ), settings, statistics );
+}
+
+void exorcism_minimization( const cube_vec_t& cubes, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  const auto verbose      = get( settings, "verbose",      false );
+  const auto on_cube      = get( settings, "on_cube",      cube_function_t() );
+  const auto esopname     = get( settings, "esopname",     std::string( "/tmp/test.esop" ) );
+  const auto skip_parsing = get( settings, "skip_parsing", false );
+
+  properties_timer t( statistics );
+
+  if ( cubes.empty() )
+  {
+    return;
+  }
+
+  abc::Vec_Wec_t *esop = abc::Vec_WecAlloc( 0u );
+
+  for ( const auto& cube : cubes )
+  {
+    auto * level = abc::Vec_WecPushLevel( esop );
+
+    for ( auto i = 0u; i < cube.length(); ++i )
+    {
+      if ( !cube.care()[i] ) { continue; }
+
+      abc::Vec_IntPush( level, ( i << 1u ) | !cube.bits()[i] );
+    }
+    abc::Vec_IntPush( level, -1 );
+  }
+
+  if ( verbose )
+  {
+    abc::Vec_WecPrint( esop, 0 );
+  }
+
+  const exorcism_job job{ static_cast<unsigned>( cubes.front().length() ), 1u, 2u, 20000u, exorcism_script::def, false, verbose ? 1 : 0 };
+
+  auto opt_time = 0.0;
+  gia_graph::esop_ptr esop_opt( run_exorcism( esop, job, opt_time ), &abc::Vec_WecFree );
+  abc::Vec_WecFree( esop );
+
+  if ( !esop_opt )
+  {
+    return;
+  }
+
+  /* the ESOP file is written and parsed while holding the lock since the default name is shared */
+  static std::mutex esop_file_mutex;
+  std::lock_guard<std::mutex> lock( esop_file_mutex );
+
+  write_esop( esop_opt, job.ninputs, job.noutputs, esopname );
+
+  /* Parse */
+  if ( !skip_parsing )
+  {
+    exorcism_processor p( on_cube );
+    pla_parser( esopname, p );
+
+    set( statistics, "cube_count", p.cube_count() );
+    set( statistics, "literal_count", p.literal_count() );
+  }
+}
+
+gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsigned ninputs, unsigned noutputs,
+                                           const properties::ptr& settings,
+                                           const properties::ptr& statistics )
+{
+  /* settings */
+  const auto quality      = get( settings, "quality",      2u );
+  const auto cubes_max    = get( settings, "cubes_max",    1000000u );
+  const auto script       = get( settings, "script",       exorcism_script::def_wo4 );
+  const auto progress     = get( settings, "progress",     false );
+  const auto verbose      = get( settings, "verbose",      false );
+  const auto very_verbose = get( settings, "very_verbose", false );
+
+  properties_timer t( statistics );
+
+  const exorcism_job job{ ninputs, noutputs, quality, cubes_max, script, progress, very_verbose ? 2 : ( verbose ? 1 : 0 ) };
+
+  auto opt_time = 0.0;
+  auto * esop_opt = run_exorcism( esop.get(), job, opt_time );
+  set( statistics, "exorcism_opt_time", opt_time );
+
   return gia_graph::esop_ptr( esop_opt, &abc::Vec_WecFree );
 }
 
@@ -189,6 +189,10 @@ unsigned tcount( unsigned c, unsigned n )
  * -------------------------------------------------------------------------- *
  * stores a list of cubes and manages cube pairs                              *
  *                                                                            *
+ * cube ids are indexed by their number of literals, two cubes of distance d  *
+ * differ in at most d literals, so only buckets within the distance are      *
+ * searched for pairs and equal cubes                                         *
+ *                                                                            *
  * methods                                                                    *
  * - add_cube                                                                 *
  * - compute_pairs                                                            *
@@ -196,10 +200,6 @@ unsigned tcount( unsigned c, unsigned n )
  * - invalidate_cube                                                          *
  * - shuffle_pairs                                                            *
  *                                                                            *
- *                                                                            *
- *                                                                            *
- *                                                                            *
- *                                                                            *
  ******************************************************************************/
 
 class exorcismq_cube_store
@@ -246,6 +246,7 @@ public:
   inline void set_numvars( unsigned _n )
   {
     n = _n;
+    buckets.resize( n + 1u );
   }
 
   void add_cube( exorcismq_cube& cube )
@@ -283,9 +284,11 @@ public:
       const auto id = free_ids.front();
       free_ids.pop();
       cubes[id] = cube;
+      buckets[cube.num_literals()].push_back( id );
     }
     else
     {
+      buckets[cube.num_literals()].push_back( cubes.size() );
       cubes.push_back( cube );
     }
   }
@@ -370,19 +373,21 @@ public:
   std::pair<cube_vec_t::const_iterator, bool> has_cube( const exorcismq_cube& cube ) const
   {
     assert( !cube.invalid );
-    auto d = 2u;
+    const auto lits = cube.num_literals();
 
-    auto it = std::find_if( cubes.begin(), cubes.end(), [&cube, &d]( const exorcismq_cube& other ) {
-        if ( !other.invalid )
+    for ( auto l = lits == 0u ? 0u : lits - 1u; l <= std::min( n, lits + 1u ); ++l )
+    {
+      for ( auto id : buckets[l] )
+      {
+        const auto d = __builtin_popcount( cube.positions( cubes[id] ) );
+        if ( d < 2 )
         {
-          d = __builtin_popcount( cube.positions( other ) );
-          return d < 2;
+          return std::make_pair( cubes.begin() + id, d == 0 );
         }
-        return false;
-      } );
+      }
+    }
 
-    assert( it == cubes.end() || d < 2 );
-    return std::make_pair( it, d == 0 );
+    return std::make_pair( cubes.end(), false );
   }
 
   void invalidate_cube( size_type index )
@@ -392,6 +397,12 @@ public:
 
     cube.invalid = 1;
     free_ids.push( index );
+
+    auto& bucket = buckets[cube.num_literals()];
+    const auto it = std::find( bucket.begin(), bucket.end(), index );
+    assert( it != bucket.end() );
+    *it = bucket.back();
+    bucket.pop_back();
   }
 
   inline const exorcismq_cube& operator[]( size_type index ) const
@@ -427,46 +438,26 @@ public:
 private:
   void add_pairs( unsigned index )
   {
-    auto& cube = cubes[index];
+    const auto& cube = cubes[index];
     assert( !cube.invalid );
 
-    /* compute distances and positions to previous cubes */
-    std::vector<unsigned> distances;
-    std::vector<uint64_t> positions;
-    distances.reserve( index );
-    positions.reserve( index );
-
-    /* we use all_of to stop when we hit a distance of 1 or below */
-    auto other_id = -1;
-    std::all_of( cubes.begin(), cubes.begin() + index, [this, &cube, &distances, &positions, &other_id, index]( exorcismq_cube& other ) {
-        ++other_id;
-
-        /* don't combine with invalid cube */
-        if ( other.invalid )
-        {
-          distances.push_back( 65 );
-          positions.push_back( 0 );
-          return true;
-        } /* continue */
+    /* pairs of distance 2 to 4 with previous cubes, which only can be found in neighboring buckets */
+    const auto lits = cube.num_literals();
+    for ( auto l = lits < 4u ? 0u : lits - 4u; l <= std::min( n, lits + 4u ); ++l )
+    {
+      for ( auto id : buckets[l] )
+      {
+        if ( id >= index ) continue;
 
-        const auto p = cube.positions( other );
+        const auto p = cube.positions( cubes[id] );
         const auto d = __builtin_popcount( p );
 
         assert( d > 1 );
 
-        distances.push_back( d );
-        positions.push_back( p );
-
-        return true;
-      } );
-
-    /* and add all pairs according to their distance */
-    for ( auto i = 0u; i < distances.size(); ++i )
-    {
-      const auto d = distances[i] - 2;
-      if ( d <= 2 )
-      {
-        cube_pairs[d].emplace_back( i, index, cube.cost + cubes[i].cost, positions[i] );
+        if ( d <= 4 )
+        {
+          cube_pairs[d - 2].emplace_back( id, index, cube.cost + cubes[id].cost, p );
+        }
       }
     }
   }
@@ -475,6 +466,7 @@ private:
   unsigned                               n;
   cube_vec_t                             cubes;
   std::queue<size_type>                  free_ids;
+  std::vector<std::vector<size_type>>    buckets;
   std::vector<exorcismq_cube_pair_queue> cube_pairs;
 
   unsigned sorting_strategy = 0;
@@ -49,7 +49,8 @@ namespace cirkit
 
 cnf_manager::vertex_range_t cnf_manager::compute( const tt& func, unsigned* literal_count )
 {
-  const auto key = to_string( func );
+  tt_to_words( func, key );
+  key.insert( key.begin(), func.size() );
   const auto it = hash.find( key );
 
   unsigned begin = 0u, end = 0u, count = 0u;
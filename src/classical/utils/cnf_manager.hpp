@@ -36,10 +36,12 @@
 #ifndef CNF_MANAGER_HPP
 #define CNF_MANAGER_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <unordered_map>
 #include <vector>
 
+#include <boost/functional/hash.hpp>
 #include <boost/range/iterator_range.hpp>
 
 #include <classical/utils/truth_table_utils.hpp>
@@ -58,11 +60,20 @@ public:
   void print_statistics( std::ostream& os = std::cout ) const;
 
 private:
-  /* maps str repr of tt to tuple of start and (exclusive) end index in `covers', and the literal count */
-  using hash_t = std::unordered_map<std::string, std::tuple<unsigned, unsigned, unsigned>>;
+  /* tt packed into words, preceded by its number of bits */
+  using key_t = std::vector<std::uint64_t>;
+
+  struct key_hash
+  {
+    std::size_t operator()( const key_t& key ) const { return boost::hash_range( key.begin(), key.end() ); }
+  };
+
+  /* maps key of tt to tuple of start and (exclusive) end index in `covers', and the literal count */
+  using hash_t = std::unordered_map<key_t, std::tuple<unsigned, unsigned, unsigned>, key_hash>;
 
   std::vector<int> covers;
   hash_t           hash;
+  key_t            key; /* buffer */
 
   /* statistics */
   double        runtime    = 0.0;
@@ -50,6 +50,16 @@ int cube2::num_literals() const
   return __builtin_popcount( mask );
 }
 
+bool cube2::has_var( unsigned index ) const
+{
+  return ( mask >> index ) & 1;
+}
+
+bool cube2::polarity( unsigned index ) const
+{
+  return ( bits >> index ) & 1;
+}
+
 /******************************************************************************
  * Query operations (binary)                                                  *
  ******************************************************************************/
@@ -74,6 +84,11 @@ bool cube2::operator!=( const cube2& that ) const
   return value != that.value;
 }
 
+bool cube2::operator<( const cube2& that ) const
+{
+  return value < that.value;
+}
+
 /******************************************************************************
  * Operators (binary)                                                         *
  ******************************************************************************/
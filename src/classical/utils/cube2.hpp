@@ -46,18 +46,23 @@ namespace cirkit
 class cube2
 {
 public:
+  static constexpr unsigned max_vars = 32u;
+
   /* constructors */
   cube2();
   cube2( uint32_t bits, uint32_t mask );
 
   /* query operations (unary) */
   int num_literals() const;
+  bool has_var( unsigned index ) const;
+  bool polarity( unsigned index ) const;
 
   /* query operations (binary) */
   int distance( const cube2& that ) const;
   uint32_t differences( const cube2& that ) const;
   bool operator==( const cube2& that ) const;
   bool operator!=( const cube2& that ) const;
+  bool operator<( const cube2& that ) const;
 
   /* operators (binary) */
   cube2 operator&( const cube2& that ) const;
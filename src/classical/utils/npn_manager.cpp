@@ -26,9 +26,14 @@
 
 #include "npn_manager.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
 #include <boost/format.hpp>
 
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/functions/npn_canonization.hpp>
 
 namespace cirkit
@@ -38,62 +43,284 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+namespace detail
+{
+
+inline std::uint64_t npn_key_hash( const std::uint64_t* words, unsigned num_words, unsigned num_vars )
+{
+  auto h = 0x9e3779b97f4a7c15ull * ( num_vars + 1u );
+  for ( auto i = 0u; i < num_words; ++i )
+  {
+    h ^= words[i] + 0x9e3779b97f4a7c15ull + ( h << 6u ) + ( h >> 2u );
+  }
+
+  /* finalizer of MurmurHash3 */
+  h ^= h >> 33u;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33u;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33u;
+  return h;
+}
+
+/* key contains the number of variables as last element */
+struct npn_key_hasher
+{
+  std::size_t operator()( const std::vector<std::uint64_t>& key ) const
+  {
+    return npn_key_hash( key.data(), key.size() - 1u, key.back() );
+  }
+};
+
+}
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+npn_manager::table_t* npn_manager::table_for( unsigned num_words )
+{
+  auto index = 0u;
+  while ( ( 1u << index ) < num_words ) { ++index; }
+
+  auto& table = tables[index];
+  if ( !table.num_words ) /* first use */
+  {
+    table.num_words = num_words;
+
+    const auto entry_size = 2u * num_words * sizeof( std::uint64_t ) + sizeof( record_t );
+    auto num_entries = 1u;
+    while ( ( num_entries << 1u ) <= hash_table_size && ( num_entries << 1u ) * entry_size <= memory_limit - memory )
+    {
+      num_entries <<= 1u;
+    }
+
+    if ( num_entries >= 2u )
+    {
+      table.num_sets = num_entries >> 1u;
+      table.keys.resize( num_entries * num_words );
+      table.npns.resize( num_entries * num_words );
+      table.records.resize( num_entries, record_t{0u, {}, 0u, 0u, 0u} );
+      memory += num_entries * entry_size;
+    }
+  }
+
+  return table.num_sets ? &table : nullptr;
+}
+
+bool npn_manager::lookup( table_t& table, const std::vector<std::uint64_t>& key, unsigned num_vars,
+                          tt& npn, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+{
+  const auto w   = table.num_words;
+  const auto set = detail::npn_key_hash( key.data(), w, num_vars ) & ( table.num_sets - 1u );
+
+  for ( auto way = 0u; way < 2u; ++way )
+  {
+    const auto e = ( set << 1u ) + way;
+    auto& rec = table.records[e];
+    if ( !rec.valid || rec.num_vars != num_vars || !std::equal( key.begin(), key.end(), table.keys.begin() + e * w ) )
+    {
+      continue;
+    }
+
+    rec.recent = 1u;
+    table.records[e ^ 1u].recent = 0u;
+
+    npn = tt_from_words( &table.npns[e * w], 1u << num_vars );
+    phase.resize( num_vars + 1u );
+    for ( auto i = 0u; i <= num_vars; ++i )
+    {
+      phase[i] = ( rec.phase >> i ) & 1u;
+    }
+    perm.assign( rec.perm, rec.perm + num_vars );
+    return true;
+  }
+
+  return false;
+}
+
+void npn_manager::insert( table_t& table, const std::vector<std::uint64_t>& key, unsigned num_vars,
+                          const tt& npn, const boost::dynamic_bitset<>& phase, const std::vector<unsigned>& perm )
+{
+  assert( phase.size() <= 32u );
+  assert( perm.size() <= max_num_vars );
+
+  const auto w   = table.num_words;
+  const auto set = detail::npn_key_hash( key.data(), w, num_vars ) & ( table.num_sets - 1u );
+
+  /* replace invalid or less recently used entry */
+  auto e = set << 1u;
+  if ( table.records[e].valid && ( !table.records[e + 1u].valid || table.records[e].recent ) )
+  {
+    ++e;
+  }
+  if ( table.records[e].valid )
+  {
+    ++evictions;
+  }
+
+  std::copy( key.begin(), key.end(), table.keys.begin() + e * w );
+  boost::to_block_range( npn, table.npns.begin() + e * w );
+
+  auto& rec = table.records[e];
+  rec.phase = 0u;
+  for ( auto i = 0u; i < phase.size(); ++i )
+  {
+    rec.phase |= static_cast<std::uint32_t>( phase[i] ) << i;
+  }
+  for ( auto i = 0u; i < perm.size(); ++i )
+  {
+    rec.perm[i] = perm[i];
+  }
+  rec.num_vars = num_vars;
+  rec.valid    = 1u;
+  rec.recent   = 1u;
+  table.records[e ^ 1u].recent = 0u;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
-npn_manager::npn_manager( unsigned hash_table_size, const npn_classifier_t& npn_func )
-  : table( hash_table_size ),
+constexpr unsigned npn_manager::max_num_vars;
+
+npn_manager::npn_manager( unsigned hash_table_size, const npn_classifier_t& npn_func, std::size_t memory_limit )
+  : tables( max_num_vars - 5u ),
+    hash_table_size( hash_table_size ),
+    memory_limit( memory_limit ),
     npn_func( npn_func )
 {
 }
 
-tt npn_manager::compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+tt npn_manager::compute( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
 {
-  boost::dynamic_bitset<> npn;
+  tt npn;
+
+  const auto num_vars = tt_num_vars( t );
+  if ( !hash_table_size || num_vars > max_num_vars )
+  {
+    increment_timer timer( &runtime );
+    return npn_func( t, phase, perm );
+  }
 
   /* compute NPN and use hash table if possible */
-  if ( !table.empty() )
+  tt_to_words( t, key );
+  auto* table = table_for( key.size() );
+
+  if ( table && lookup( *table, key, num_vars, npn, phase, perm ) )
+  {
+    ++cache_hit;
+    return npn;
+  }
+
+  ++cache_miss;
+  {
+    increment_timer timer( &runtime );
+    npn = npn_func( t, phase, perm );
+  }
+
+  if ( table )
   {
-    const auto ttu      = tt.to_ulong();
-    const auto hash_key = ttu % table.size();
-    auto& entry         = table[hash_key];
+    insert( *table, key, num_vars, npn, phase, perm );
+  }
+
+  return npn;
+}
+
+std::vector<tt> npn_manager::compute( const std::vector<tt>& tts, std::vector<boost::dynamic_bitset<>>& phases,
+                                      std::vector<std::vector<unsigned>>& perms, unsigned num_threads )
+{
+  std::vector<tt> npns( tts.size() );
+  phases.resize( tts.size() );
+  perms.resize( tts.size() );
+
+  /* functions to classify, and for other misses the index of an equal function */
+  std::vector<unsigned> todo;
+  std::vector<std::pair<unsigned, unsigned>> copies;
+  std::unordered_map<std::vector<std::uint64_t>, unsigned, detail::npn_key_hasher> pending;
+
+  for ( auto i = 0u; i < tts.size(); ++i )
+  {
+    const auto num_vars = tt_num_vars( tts[i] );
+    if ( !hash_table_size || num_vars > max_num_vars )
+    {
+      todo.push_back( i );
+      continue;
+    }
 
-    if ( entry.tt == to_string( tt ) )
+    tt_to_words( tts[i], key );
+    auto* table = table_for( key.size() );
+    if ( table && lookup( *table, key, num_vars, npns[i], phases[i], perms[i] ) )
     {
       ++cache_hit;
-      npn = boost::dynamic_bitset<>( entry.npn );
-      perm = std::vector<unsigned>( entry.perm );
-      phase = boost::dynamic_bitset<>( entry.phase );
+      continue;
     }
-    else
+
+    key.push_back( num_vars );
+    const auto p = pending.insert( {key, i} );
+    if ( p.second )
     {
       ++cache_miss;
-      increment_timer t( &runtime );
-      npn = npn_func( tt, phase, perm );
+      todo.push_back( i );
+    }
+    else
+    {
+      ++cache_hit;
+      copies.push_back( {i, p.first->second} );
+    }
+  }
+
+  {
+    increment_timer timer( &runtime );
 
-      entry.tt    = to_string( tt );
-      entry.npn   = to_string( npn );
-      entry.perm  = perm;
-      entry.phase = phase;
+    if ( num_threads == 1u )
+    {
+      for ( auto i : todo )
+      {
+        npns[i] = npn_func( tts[i], phases[i], perms[i] );
+      }
+    }
+    else
+    {
+      work_stealing_pool pool( num_threads );
+      pool.parallel_for( 0u, todo.size(), [&]( std::size_t j, unsigned ) {
+          const auto i = todo[j];
+          npns[i] = npn_func( tts[i], phases[i], perms[i] );
+        } );
     }
   }
-  else
+
+  for ( auto i : todo )
   {
-    increment_timer t( &runtime );
-    npn = npn_func( tt, phase, perm );
+    const auto num_vars = tt_num_vars( tts[i] );
+    if ( !hash_table_size || num_vars > max_num_vars ) { continue; }
+
+    tt_to_words( tts[i], key );
+    if ( auto* table = table_for( key.size() ) )
+    {
+      insert( *table, key, num_vars, npns[i], phases[i], perms[i] );
+    }
   }
 
-  return npn;
+  for ( const auto& c : copies )
+  {
+    npns[c.first]   = npns[c.second];
+    phases[c.first] = phases[c.second];
+    perms[c.first]  = perms[c.second];
+  }
+
+  return npns;
 }
 
 void npn_manager::print_statistics( std::ostream& os ) const
 {
-  os << boost::format( "[i] NPN manager: size = %d   cache hits = %d   cache misses = %d   run-time = %.2f secs" ) % table.size() % cache_hit % cache_miss % runtime << std::endl;
+  auto size = 0u;
+  for ( const auto& table : tables )
+  {
+    size += table.records.size();
+  }
+
+  os << boost::format( "[i] NPN manager: size = %d   memory = %d bytes   cache hits = %d   cache misses = %d   evictions = %d   run-time = %.2f secs" ) % size % memory % cache_hit % cache_miss % evictions % runtime << std::endl;
 }
 
 }
@@ -36,6 +36,7 @@
 #ifndef NPN_MANAGER_HPP
 #define NPN_MANAGER_HPP
 
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <vector>
@@ -55,38 +56,78 @@ inline std::function<tt(const tt&, boost::dynamic_bitset<>&, std::vector<unsigne
     } );
 }
 
+/* Cache of NPN classifications
+ *
+ * Entries are keyed by the truth table packed into 64-bit words and store
+ * the NPN class together with fixed-size permutation and phase records;
+ * the cache therefore supports functions with up to 16 inputs.  There is
+ * one table for each number of words, which is allocated on first use
+ * with at most hash_table_size entries such that the memory of all tables
+ * does not exceed memory_limit bytes.  Tables are 2-way set-associative
+ * and evict the less recently used entry of a set.  A hash_table_size of 0
+ * disables caching, functions with more than 16 inputs are never cached.
+ */
 class npn_manager
 {
 public:
   using npn_classifier_t = std::function<tt(const tt&, boost::dynamic_bitset<>&, std::vector<unsigned>&)>;
 
-  npn_manager( unsigned hash_table_size = 4096, const npn_classifier_t& npn_func = make_exact_npn_canonization_wrapper() );
+  static constexpr unsigned max_num_vars = 16u;
+
+  npn_manager( unsigned hash_table_size = 4096, const npn_classifier_t& npn_func = make_exact_npn_canonization_wrapper(),
+               std::size_t memory_limit = 1u << 26u );
+
+  tt compute( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
+
+  /* classifies all functions, e.g., all cut functions of a network; each
+     function that is not in the cache is classified only once, and if
+     num_threads is not 1, using several threads (npn_func must be
+     thread-safe then, 0 uses as many threads as there are cores) */
+  std::vector<tt> compute( const std::vector<tt>& tts, std::vector<boost::dynamic_bitset<>>& phases,
+                           std::vector<std::vector<unsigned>>& perms, unsigned num_threads = 1u );
 
-  tt compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
   void print_statistics( std::ostream& os = std::cout ) const;
 
 private:
-  struct table_entry_t
+  struct record_t
   {
-    table_entry_t() {}
-    table_entry_t( const std::string& tt, const std::string& npn, const std::vector<unsigned>& perm, const boost::dynamic_bitset<>& phase )
-      : tt( tt ), npn( npn ), perm( perm ), phase( phase ) {}
-
-    std::string             tt;
-    std::string             npn;
-    std::vector<unsigned>   perm;
-    boost::dynamic_bitset<> phase;
+    std::uint32_t phase;
+    std::uint8_t  perm[max_num_vars];
+    std::uint8_t  num_vars;
+    std::uint8_t  valid;
+    std::uint8_t  recent;
   };
 
-  using table_t = std::vector<table_entry_t>;
+  struct table_t
+  {
+    unsigned                   num_words = 0u;
+    unsigned                   num_sets  = 0u;
+
+    /* keys and NPN classes, num_words for each entry */
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint64_t> npns;
+    std::vector<record_t>      records;
+  };
+
+  table_t* table_for( unsigned num_words );
+  bool lookup( table_t& table, const std::vector<std::uint64_t>& key, unsigned num_vars,
+               tt& npn, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
+  void insert( table_t& table, const std::vector<std::uint64_t>& key, unsigned num_vars,
+               const tt& npn, const boost::dynamic_bitset<>& phase, const std::vector<unsigned>& perm );
+
+  std::vector<table_t> tables; /* index is log2 of number of words */
+  unsigned             hash_table_size;
+  std::size_t          memory_limit;
+  std::size_t          memory = 0u;
 
-  table_t          table;
+  std::vector<std::uint64_t> key; /* buffer */
 
-  npn_classifier_t npn_func;
+  npn_classifier_t     npn_func;
 
-  double           runtime    = 0.0;
-  unsigned long    cache_hit  = 0;
-  unsigned long    cache_miss = 0;
+  double               runtime     = 0.0;
+  unsigned long        cache_hit   = 0;
+  unsigned long        cache_miss  = 0;
+  unsigned long        evictions   = 0;
 };
 
 }
@@ -451,6 +451,21 @@ tt tt_from_hex( const std::string& s, unsigned to )
   return t;
 }
 
+void tt_to_words( const tt& t, std::vector<std::uint64_t>& words )
+{
+  static_assert( sizeof( tt::block_type ) == sizeof( std::uint64_t ), "truth table blocks must have 64 bits" );
+
+  words.resize( t.num_blocks() );
+  boost::to_block_range( t, words.begin() );
+}
+
+tt tt_from_words( const std::uint64_t* words, unsigned num_bits )
+{
+  tt t( words, words + ( ( num_bits + 63u ) >> 6u ) );
+  t.resize( num_bits );
+  return t;
+}
+
 /******************************************************************************
  * truth table from expression                                                *
  ******************************************************************************/
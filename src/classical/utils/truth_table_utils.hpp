@@ -36,6 +36,9 @@
 #ifndef TRUTH_TABLE_UTILS_HPP
 #define TRUTH_TABLE_UTILS_HPP
 
+#include <cstdint>
+#include <vector>
+
 #include <boost/dynamic_bitset.hpp>
 
 #include <core/utils/bitset_utils.hpp>
@@ -277,6 +280,19 @@ tt tt_from_hex( const std::string& s );
  */
 tt tt_from_hex( const std::string& s, unsigned to );
 
+/**
+ * @brief Packs truth table into 64-bit words
+ *
+ * Bit i of the truth table is bit i % 64 of word i / 64.  Unused bits of
+ * the last word are zero.  Cheaper than string conversion as hash key.
+ */
+void tt_to_words( const tt& t, std::vector<std::uint64_t>& words );
+
+/**
+ * @brief Unpacks truth table with num_bits bits from 64-bit words
+ */
+tt tt_from_words( const std::uint64_t* words, unsigned num_bits );
+
 /**
  * @brief Iterate through each minterm
  */
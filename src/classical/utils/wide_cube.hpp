@@ -0,0 +1,343 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file wide_cube.hpp
+ *
+ * @brief Cube data structure with the interface of cube2 for up to 256 inputs
+ *
+ * The literals are stored in NumVars / 64 words for bits and mask each.
+ * All binary operations work on whole words, so that the compiler can
+ * vectorize them, and count with 64-bit popcounts.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef WIDE_CUBE_HPP
+#define WIDE_CUBE_HPP
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+#include <boost/format.hpp>
+
+#include <classical/utils/cube2.hpp>
+
+namespace cirkit
+{
+
+template<unsigned NumVars>
+class wide_cube
+{
+  static_assert( NumVars % 64u == 0u, "number of variables must be a multiple of 64" );
+
+public:
+  static constexpr unsigned num_words = NumVars / 64u;
+  static constexpr unsigned max_vars  = NumVars;
+
+  using words_t = std::array<uint64_t, num_words>;
+
+  /* constructors */
+  wide_cube()
+  {
+    bits.fill( 0u );
+    mask.fill( 0u );
+  }
+
+  wide_cube( const words_t& bits, const words_t& mask ) : bits( bits ), mask( mask ) {}
+
+  /* query operations (unary) */
+  int num_literals() const
+  {
+    auto n = 0;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      n += __builtin_popcountll( mask[w] );
+    }
+    return n;
+  }
+
+  bool has_var( unsigned index ) const
+  {
+    return ( mask[index >> 6u] >> ( index & 63u ) ) & 1u;
+  }
+
+  bool polarity( unsigned index ) const
+  {
+    return ( bits[index >> 6u] >> ( index & 63u ) ) & 1u;
+  }
+
+  /* query operations (binary) */
+  int distance( const wide_cube& that ) const
+  {
+    auto n = 0;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      n += __builtin_popcountll( ( bits[w] ^ that.bits[w] ) | ( mask[w] ^ that.mask[w] ) );
+    }
+    return n;
+  }
+
+  words_t differences( const wide_cube& that ) const
+  {
+    words_t d;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      d[w] = ( bits[w] ^ that.bits[w] ) | ( mask[w] ^ that.mask[w] );
+    }
+    return d;
+  }
+
+  bool operator==( const wide_cube& that ) const
+  {
+    return bits == that.bits && mask == that.mask;
+  }
+
+  bool operator!=( const wide_cube& that ) const
+  {
+    return !operator==( that );
+  }
+
+  bool operator<( const wide_cube& that ) const
+  {
+    return mask < that.mask || ( mask == that.mask && bits < that.bits );
+  }
+
+  /* operators (binary) */
+  wide_cube operator&( const wide_cube& that ) const
+  {
+    wide_cube res;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      /* literals must agree on intersection */
+      if ( ( bits[w] ^ that.bits[w] ) & mask[w] & that.mask[w] )
+      {
+        return zero_cube();
+      }
+      res.bits[w] = bits[w] | that.bits[w];
+      res.mask[w] = mask[w] | that.mask[w];
+    }
+    return res;
+  }
+
+  /* it is assumed that this and that have distance 1 */
+  wide_cube merge( const wide_cube& that ) const
+  {
+    wide_cube res;
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      const auto d = ( bits[w] ^ that.bits[w] ) | ( mask[w] ^ that.mask[w] );
+      res.bits[w] = bits[w] ^ ( ~that.bits[w] & d );
+      res.mask[w] = mask[w] ^ ( that.mask[w] & d );
+    }
+    return res;
+  }
+
+  std::array<wide_cube, 4> exorlink( const wide_cube& that, int distance, const words_t& differences, unsigned* group ) const
+  {
+    /* word index and bit of each differing position */
+    std::array<unsigned, 4> pw;
+    std::array<uint64_t, 4> pb;
+    auto k = 0;
+    for ( auto w = 0u; w < num_words && k < distance; ++w )
+    {
+      auto d = differences[w];
+      while ( d && k < distance )
+      {
+        pw[k] = w;
+        pb[k++] = d & -d;
+        d &= d - 1;
+      }
+    }
+
+    std::array<wide_cube, 4> res;
+
+    for ( int i = 0; i < distance; ++i )
+    {
+      res[i] = *this; /* start from this */
+
+      for ( int j = 0; j < distance; ++j )
+      {
+        const auto w = pw[j];
+        const auto p = pb[j];
+
+        switch ( *group++ )
+        {
+        case 0:
+          /* take from this */
+          break;
+        case 1:
+          /* take from that */
+          res[i].bits[w] ^= ( ( that.bits[w] & p ) ^ res[i].bits[w] ) & p;
+          res[i].mask[w] ^= ( ( that.mask[w] & p ) ^ res[i].mask[w] ) & p;
+          break;
+        case 2:
+          /* take other */
+          res[i].bits[w] ^= ( ( ~bits[w] & ~that.bits[w] & p ) ^ res[i].bits[w] ) & p;
+          res[i].mask[w] ^= ( ( ( mask[w] ^ that.mask[w] ) & p ) ^ res[i].mask[w] ) & p;
+          break;
+        }
+      }
+    }
+
+    return res;
+  }
+
+  /* modify operations */
+  void invert_all()
+  {
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      bits[w] ^= mask[w];
+    }
+  }
+
+  void rotate( unsigned bit ) /* x -> ~x -> * -> x -> ... */
+  {
+    auto& b = bits[bit >> 6u];
+    auto& m = mask[bit >> 6u];
+    const uint64_t p = uint64_t( 1 ) << ( bit & 63u );
+
+    const auto bits_tmp = b;
+    b ^= ( ~b ^ m ) & p;
+    m ^= ~bits_tmp & p;
+  }
+
+  /* construction */
+  static wide_cube one_cube()
+  {
+    return wide_cube();
+  }
+
+  static wide_cube zero_cube()
+  {
+    wide_cube res;
+    res.bits.fill( ~uint64_t( 0 ) );
+    return res;
+  }
+
+  static wide_cube elementary_cube( unsigned index )
+  {
+    wide_cube res;
+    res.bits[index >> 6u] = res.mask[index >> 6u] = uint64_t( 1 ) << ( index & 63u );
+    return res;
+  }
+
+  /* printing / debugging */
+  void print( unsigned length = NumVars, std::ostream& os = std::cout ) const
+  {
+    for ( auto i = 0u; i < length; ++i )
+    {
+      os << ( has_var( i ) ? ( polarity( i ) ? '1' : '0' ) : '-' );
+    }
+  }
+
+  /* cube data */
+  words_t bits;
+  words_t mask;
+};
+
+template<unsigned NumVars>
+std::ostream& operator<<( std::ostream& os, const wide_cube<NumVars>& cube )
+{
+  cube.print( NumVars, os );
+  return os;
+}
+
+using cube64  = wide_cube<64u>;
+using cube128 = wide_cube<128u>;
+using cube256 = wide_cube<256u>;
+
+/**
+ * @brief Calls fn with a default constructed cube of the smallest cube type
+ *        (cube2, cube64, cube128, or cube256) that has num_vars variables
+ *
+ * Algorithms that are templated over the cube type use it to select the
+ * width at runtime (throws a std::string for more than 256 variables), e.g.,
+ *
+ *   with_cube_type( n, [&]( auto tag ) {
+ *       using cube_t = decltype( tag );
+ *       ...
+ *     } );
+ */
+template<typename Fn>
+void with_cube_type( unsigned num_vars, Fn&& fn )
+{
+  if ( num_vars > 256u )
+  {
+    throw boost::str( boost::format( "cubes support at most 256 variables, but %d are required" ) % num_vars );
+  }
+
+  if ( num_vars <= 32u )
+  {
+    fn( cube2() );
+  }
+  else if ( num_vars <= 64u )
+  {
+    fn( cube64() );
+  }
+  else if ( num_vars <= 128u )
+  {
+    fn( cube128() );
+  }
+  else
+  {
+    fn( cube256() );
+  }
+}
+
+}
+
+namespace std
+{
+
+template<unsigned NumVars>
+struct hash<cirkit::wide_cube<NumVars>>
+{
+  std::size_t operator()( cirkit::wide_cube<NumVars> const& c ) const
+  {
+    std::size_t seed = 0u;
+    for ( auto w = 0u; w < cirkit::wide_cube<NumVars>::num_words; ++w )
+    {
+      seed ^= ( c.bits[w] + ( c.mask[w] << 32u ) + ( c.mask[w] >> 32u ) ) + 0x9e3779b97f4a7c15ull + ( seed << 6u ) + ( seed >> 2u );
+    }
+    return seed;
+  }
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
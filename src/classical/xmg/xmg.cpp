@@ -26,6 +26,8 @@
 
 #include "xmg.hpp"
 
+#include <algorithm>
+
 #include <range/v3/iterator_range.hpp>
 
 #include <classical/xmg/xmg_bitmarks.hpp>
@@ -44,6 +46,23 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+inline uint32_t xmg_strash_literal( const xmg_function& f )
+{
+  assert( f.node < ( 1u << 31u ) );
+  return ( static_cast<uint32_t>( f.node ) << 1u ) | static_cast<uint32_t>( f.complemented );
+}
+
+/* children as stored on the edges of a gate, i.e., normalized and sorted */
+inline strash_key3 xmg_maj_key( const std::vector<xmg_function>& children )
+{
+  return strash_key3( xmg_strash_literal( children[0] ), xmg_strash_literal( children[1] ), xmg_strash_literal( children[2] ) );
+}
+
+inline uint64_t xmg_xor_key( const std::vector<xmg_function>& children )
+{
+  return ( static_cast<uint64_t>( xmg_strash_literal( children[0] ) ) << 32u ) | xmg_strash_literal( children[1] );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -52,6 +71,8 @@ namespace cirkit
  * header                                                                     *
  ******************************************************************************/
 
+constexpr unsigned xmg_graph::mffc_unknown;
+
 xmg_graph::xmg_graph( const std::string& name )
   : constant( add_vertex( g ) ),
     _name( name ),
@@ -86,18 +107,29 @@ xmg_function xmg_graph::create_pi( const std::string& name )
   const auto node = add_vertex( g );
   _input_to_id.insert( {node, _inputs.size()} );
   _inputs.push_back( {node, name} );
+  update_for_new_node( node );
   return xmg_function( node );
 }
 
 void xmg_graph::create_po( const xmg_function& f, const std::string& name )
 {
   _outputs.push_back( {f, name} );
+  mffc_cache.make_dirty();
+  if ( !output_refs.is_dirty() )
+  {
+    ++(*output_refs)[f.node];
+  }
 }
 
 void xmg_graph::delete_po( unsigned index )
 {
   if ( index < _outputs.size() )
   {
+    mffc_cache.make_dirty();
+    if ( !output_refs.is_dirty() )
+    {
+      --(*output_refs)[_outputs[index].first.node];
+    }
     _outputs.erase( _outputs.begin() + index );
   }
 }
@@ -126,12 +158,15 @@ xmg_function xmg_graph::create_maj( const xmg_function& a, const xmg_function& b
     children[2].complemented = !children[2].complemented;
   }
 
-  auto key = std::make_tuple( children[0], children[1], children[2] );
+  const strash_key3 key( xmg_strash_literal( children[0] ), xmg_strash_literal( children[1] ), xmg_strash_literal( children[2] ) );
 
-  const auto it = maj_strash.find( key );
-  if ( _enable_structural_hashing && it != maj_strash.end() )
+  if ( _enable_structural_hashing )
   {
-    return xmg_function( it->second, node_complement );
+    const auto existing = maj_strash.find( key );
+    if ( existing != maj_strash.empty )
+    {
+      return xmg_function( existing, node_complement );
+    }
   }
 
   /* insert node */
@@ -146,9 +181,9 @@ xmg_function xmg_graph::create_maj( const xmg_function& a, const xmg_function& b
   _complement[eb] = children[1].complemented;
   _complement[ec] = children[2].complemented;
 
-  mark_as_modified();
+  update_for_new_node( node );
 
-  maj_strash[key] = node;
+  maj_strash.assign( key, node );
   return xmg_function( node, node_complement );
 }
 
@@ -174,10 +209,15 @@ xmg_function xmg_graph::create_xor( const xmg_function& a, const xmg_function& b
       key.first.complemented = key.second.complemented = false;
     }
 
-    const auto it = xor_strash.find( key );
-    if ( _enable_structural_hashing && it != xor_strash.end() )
+    const auto packed_key = ( static_cast<uint64_t>( xmg_strash_literal( key.first ) ) << 32u ) | xmg_strash_literal( key.second );
+
+    if ( _enable_structural_hashing )
     {
-      return xmg_function( it->second, node_complement );
+      const auto existing = xor_strash.find( packed_key );
+      if ( existing != xor_strash.empty )
+      {
+        return xmg_function( existing, node_complement );
+      }
     }
 
     /* insert node */
@@ -190,9 +230,9 @@ xmg_function xmg_graph::create_xor( const xmg_function& a, const xmg_function& b
     _complement[ea] = key.first.complemented;
     _complement[eb] = key.second.complemented;
 
-    mark_as_modified();
+    update_for_new_node( node );
 
-    xor_strash[key] = node;
+    xor_strash.assign( packed_key, node );
     return xmg_function( node, node_complement );
   }
   else
@@ -248,7 +288,7 @@ unsigned xmg_graph::level( node_t n ) const
 
 bool xmg_graph::is_input( node_t n ) const
 {
-  return fanin_count( n ) == 0u;
+  return fanin_count( n ) == 0u && !is_dead( n );
 }
 
 bool xmg_graph::is_maj( node_t n ) const
@@ -323,6 +363,9 @@ xmg_graph::input_vec_t& xmg_graph::inputs()
 
 xmg_graph::output_vec_t& xmg_graph::outputs()
 {
+  /* outputs may be changed by the caller */
+  output_refs.make_dirty();
+  mffc_cache.make_dirty();
   return _outputs;
 }
 
@@ -362,6 +405,12 @@ std::vector<xmg_graph::node_t> xmg_graph::topological_nodes() const
 {
   std::vector<node_t> top( num_vertices( g ) );
   boost::topological_sort( g, top.begin() );
+
+  /* nodes removed by substitute_node are not part of the network anymore */
+  if ( _num_dead )
+  {
+    top.erase( std::remove_if( top.begin(), top.end(), [this]( node_t n ) { return is_dead( n ); } ), top.end() );
+  }
   return top;
 }
 
@@ -414,6 +463,127 @@ void xmg_graph::inc_output_refs()
   }
 }
 
+unsigned xmg_graph::mffc_size( node_t n )
+{
+  compute_mffc_cache();
+
+  auto& size = (*mffc_cache)[n];
+  if ( size == mffc_unknown )
+  {
+    size = mffc_deref( n );
+    mffc_ref( n );
+  }
+  return size;
+}
+
+const std::vector<unsigned>& xmg_graph::mffc_sizes()
+{
+  compute_mffc_cache();
+  if ( _mffc_complete ) { return *mffc_cache; }
+
+  compute_parents();
+
+  /* immediate dominators in the graph from a virtual root to the outputs
+     and from each gate to its children, processed parents first */
+  const auto root = size();
+  std::vector<node_t> idom( size() + 1u, root );
+  std::vector<unsigned> depth( size() + 1u, 0u );
+
+  const auto lca = [&]( node_t a, node_t b ) {
+    while ( a != b )
+    {
+      if ( depth[a] >= depth[b] ) { a = idom[a]; }
+      else                        { b = idom[b]; }
+    }
+    return a;
+  };
+
+  const auto top = topological_nodes();
+  for ( auto it = top.rbegin(); it != top.rend(); ++it )
+  {
+    const auto m = *it;
+    if ( is_dead( m ) || fanin_count( m ) == 0u ) continue;
+
+    /* dangling gates are their own roots */
+    auto d = root;
+    if ( (*output_refs)[m] == 0u && !(*parentss)[m].empty() )
+    {
+      d = (*parentss)[m].front();
+      for ( const auto& p : (*parentss)[m] )
+      {
+        d = lca( d, p );
+      }
+    }
+
+    idom[m] = d;
+    depth[m] = depth[d] + 1u;
+  }
+
+  /* MFFC sizes are the subtree sizes, processed children first */
+  auto& sizes = *mffc_cache;
+  std::fill( sizes.begin(), sizes.end(), 0u );
+  for ( auto m : top )
+  {
+    if ( is_dead( m ) || fanin_count( m ) == 0u ) continue;
+
+    sizes[m] += 1u;
+    if ( idom[m] != root )
+    {
+      sizes[idom[m]] += sizes[m];
+    }
+  }
+
+  _mffc_complete = true;
+  return sizes;
+}
+
+unsigned xmg_graph::compute_mffc( node_t n, std::vector<node_t>& support )
+{
+  assert( !is_input( n ) );
+
+  compute_mffc_cache();
+
+  const auto size = mffc_deref( n );
+
+  /* leafs are the first nodes on each path that are still referenced */
+  mffc_visited.resize( this->size(), 0u );
+  ++_mffc_visit_id;
+
+  std::vector<node_t> stack;
+  const auto push_children = [this, &stack]( node_t m ) {
+    const auto cs = children( m );
+    for ( auto it = cs.rbegin(); it != cs.rend(); ++it )
+    {
+      stack.push_back( it->node );
+    }
+  };
+
+  /* same order as a recursive traversal */
+  push_children( n );
+
+  while ( !stack.empty() )
+  {
+    const auto m = stack.back();
+    stack.pop_back();
+
+    if ( mffc_visited[m] == _mffc_visit_id ) continue;
+    mffc_visited[m] = _mffc_visit_id;
+
+    if ( (*fanout)[m] > 0u || (*output_refs)[m] > 0u || is_input( m ) )
+    {
+      support.push_back( m );
+      continue;
+    }
+
+    push_children( m );
+  }
+
+  mffc_ref( n );
+  (*mffc_cache)[n] = size;
+
+  return size;
+}
+
 xmg_bitmarks& xmg_graph::bitmarks()
 {
   return *_bitmarks;
@@ -429,6 +599,407 @@ void xmg_graph::mark_as_modified()
   fanout.make_dirty();
   parentss.make_dirty();
   levels.make_dirty();
+  mffc_cache.make_dirty();
+}
+
+void xmg_graph::substitute_node( node_t n, const xmg_function& f )
+{
+  assert( !is_input( n ) && !is_dead( n ) && f.node != n );
+
+  compute_fanout();
+  compute_parents();
+  compute_output_refs();
+  mffc_cache.make_dirty();
+
+  /* replacing functions of pending substitutions are pinned by an output
+     reference, such that they are not taken out before they are used */
+  std::vector<std::pair<node_t, xmg_function>> pending{{n, f}};
+  std::unordered_map<node_t, xmg_function> replaced;
+  ++(*output_refs)[f.node];
+
+  while ( !pending.empty() )
+  {
+    const auto old_node = pending.back().first;
+    const auto pinned = pending.back().second.node;
+    auto by = pending.back().second;
+    pending.pop_back();
+
+    /* the replacing node may have been substituted in the meantime */
+    while ( is_dead( by.node ) )
+    {
+      by = replaced.at( by.node ) ^ by.complemented;
+    }
+
+    if ( !is_dead( old_node ) )
+    {
+      replaced[old_node] = by;
+      _journal.push_back( {xmg_change::substituted, old_node, by} );
+
+      /* outputs */
+      if ( (*output_refs)[old_node] > 0u )
+      {
+        for ( auto& o : _outputs )
+        {
+          if ( o.first.node != old_node ) continue;
+
+          o.first = by ^ o.first.complemented;
+          --(*output_refs)[old_node];
+          ++(*output_refs)[by.node];
+        }
+      }
+
+      /* parents */
+      const auto ps = (*parentss)[old_node];
+      for ( const auto& p : ps )
+      {
+        const auto cs = children( p );
+        auto new_cs = cs;
+        for ( auto& c : new_cs )
+        {
+          if ( c.node == old_node )
+          {
+            c = by ^ c.complemented;
+          }
+        }
+
+        /* unhash the old structure */
+        if ( cs.size() == 3u )
+        {
+          const auto key = xmg_maj_key( cs );
+          if ( maj_strash.find( key ) == p ) { maj_strash.erase( key ); }
+        }
+        else
+        {
+          const auto key = xmg_xor_key( cs );
+          if ( xor_strash.find( key ) == p ) { xor_strash.erase( key ); }
+        }
+
+        /* normalize as in create_maj and create_xor, fall back to these if
+           the new gate is trivial or its polarity changes */
+        auto in_place = true;
+        if ( new_cs.size() == 3u )
+        {
+          std::sort( new_cs.begin(), new_cs.end() );
+          in_place = new_cs[0].node != new_cs[1].node && new_cs[1].node != new_cs[2].node &&
+                     ( !_enable_inverter_propagation ||
+                       static_cast<unsigned>( new_cs[0].complemented ) + static_cast<unsigned>( new_cs[1].complemented ) + static_cast<unsigned>( new_cs[2].complemented ) < 2u );
+        }
+        else
+        {
+          if ( new_cs[1].node < new_cs[0].node ) { std::swap( new_cs[0], new_cs[1] ); }
+          in_place = new_cs[0].node != new_cs[1].node && new_cs[0].node != constant && new_cs[1].node != constant &&
+                     ( !_enable_inverter_propagation || ( !new_cs[0].complemented && !new_cs[1].complemented ) );
+        }
+
+        auto existing = maj_strash.empty;
+        if ( in_place && _enable_structural_hashing )
+        {
+          existing = new_cs.size() == 3u ? maj_strash.find( xmg_maj_key( new_cs ) ) : xor_strash.find( xmg_xor_key( new_cs ) );
+        }
+
+        if ( !in_place )
+        {
+          const auto r = new_cs.size() == 3u ? create_maj( new_cs[0], new_cs[1], new_cs[2] ) : create_xor( new_cs[0], new_cs[1] );
+          pending.push_back( {p, r} );
+          ++(*output_refs)[r.node];
+        }
+        else if ( existing != maj_strash.empty )
+        {
+          pending.push_back( {p, xmg_function( existing )} );
+          ++(*output_refs)[existing];
+        }
+        else
+        {
+          /* rewire */
+          for ( const auto& c : cs )
+          {
+            --(*fanout)[c.node];
+            remove_parent( c.node, p );
+          }
+          boost::clear_out_edges( p, g );
+
+          for ( const auto& c : new_cs )
+          {
+            const auto e = add_edge( p, c.node, g ).first;
+            _complement[e] = c.complemented;
+            ++(*fanout)[c.node];
+            (*parentss)[c.node].push_back( p );
+          }
+
+          if ( new_cs.size() == 3u )
+          {
+            maj_strash.assign( xmg_maj_key( new_cs ), p );
+          }
+          else
+          {
+            xor_strash.assign( xmg_xor_key( new_cs ), p );
+          }
+
+          _journal.push_back( {xmg_change::rewired, p, xmg_function()} );
+          update_level( p );
+        }
+      }
+
+      take_out_dangling( old_node );
+    }
+
+    --(*output_refs)[pinned];
+    take_out_dangling( pinned );
+  }
+}
+
+bool xmg_graph::is_dead( node_t n ) const
+{
+  return n < dead.size() && dead[n];
+}
+
+unsigned xmg_graph::num_dead() const
+{
+  return _num_dead;
+}
+
+const std::vector<xmg_change>& xmg_graph::journal() const
+{
+  return _journal;
+}
+
+void xmg_graph::clear_journal()
+{
+  _journal.clear();
+}
+
+void xmg_graph::reserve( std::size_t num_maj, std::size_t num_xor )
+{
+  maj_strash.reserve( num_maj );
+  xor_strash.reserve( num_xor );
+}
+
+xmg_graph::node_t xmg_graph::append_maj( const xmg_function& a, const xmg_function& b, const xmg_function& c )
+{
+  assert( a < b && b < c );
+
+  const auto node = add_vertex( g );
+  ++_num_maj;
+
+  _complement[add_edge( node, a.node, g ).first] = a.complemented;
+  _complement[add_edge( node, b.node, g ).first] = b.complemented;
+  _complement[add_edge( node, c.node, g ).first] = c.complemented;
+
+  update_for_new_node( node );
+
+  maj_strash.assign( strash_key3( xmg_strash_literal( a ), xmg_strash_literal( b ), xmg_strash_literal( c ) ), node );
+  return node;
+}
+
+xmg_graph::node_t xmg_graph::append_xor( const xmg_function& a, const xmg_function& b )
+{
+  assert( a.node < b.node );
+
+  const auto node = add_vertex( g );
+  ++_num_xor;
+
+  _complement[add_edge( node, a.node, g ).first] = a.complemented;
+  _complement[add_edge( node, b.node, g ).first] = b.complemented;
+
+  update_for_new_node( node );
+
+  xor_strash.assign( ( static_cast<uint64_t>( xmg_strash_literal( a ) ) << 32u ) | xmg_strash_literal( b ), node );
+  return node;
+}
+
+/* keeps computed network information up to date instead of invalidating it */
+void xmg_graph::update_for_new_node( node_t n )
+{
+  mffc_cache.make_dirty();
+
+  if ( !fanout.is_dirty() )
+  {
+    (*fanout).resize( n + 1u, 0u );
+    for ( const auto& c : children( n ) )
+    {
+      ++(*fanout)[c.node];
+    }
+  }
+
+  if ( !parentss.is_dirty() )
+  {
+    (*parentss).resize( n + 1u );
+    for ( const auto& c : children( n ) )
+    {
+      (*parentss)[c.node].push_back( n );
+    }
+  }
+
+  if ( !levels.is_dirty() )
+  {
+    (*levels).resize( n + 1u, 0u );
+    update_level( n );
+  }
+
+  if ( !output_refs.is_dirty() )
+  {
+    (*output_refs).resize( n + 1u, 0u );
+  }
+}
+
+void xmg_graph::compute_output_refs()
+{
+  output_refs.update( [this]() {
+      std::vector<unsigned> refs( size(), 0u );
+      for ( const auto& o : _outputs )
+      {
+        ++refs[o.first.node];
+      }
+      return refs;
+    } );
+}
+
+/* removes n and then recursively its children if they have no references */
+void xmg_graph::take_out_dangling( node_t n )
+{
+  std::vector<node_t> stack{n};
+
+  while ( !stack.empty() )
+  {
+    const auto m = stack.back();
+    stack.pop_back();
+
+    if ( is_dead( m ) || fanin_count( m ) == 0u || (*fanout)[m] > 0u || (*output_refs)[m] > 0u ) continue;
+
+    const auto cs = children( m );
+    if ( cs.size() == 3u )
+    {
+      const auto key = xmg_maj_key( cs );
+      if ( maj_strash.find( key ) == m ) { maj_strash.erase( key ); }
+      --_num_maj;
+    }
+    else
+    {
+      const auto key = xmg_xor_key( cs );
+      if ( xor_strash.find( key ) == m ) { xor_strash.erase( key ); }
+      --_num_xor;
+    }
+
+    boost::clear_out_edges( m, g );
+    for ( const auto& c : cs )
+    {
+      --(*fanout)[c.node];
+      remove_parent( c.node, m );
+      stack.push_back( c.node );
+    }
+
+    if ( dead.size() <= m )
+    {
+      dead.resize( size() );
+    }
+    dead.set( m );
+    ++_num_dead;
+    _journal.push_back( {xmg_change::removed, m, xmg_function()} );
+  }
+}
+
+void xmg_graph::remove_parent( node_t child, node_t parent )
+{
+  auto& ps = (*parentss)[child];
+  const auto it = std::find( ps.begin(), ps.end(), parent );
+  assert( it != ps.end() );
+  ps.erase( it );
+}
+
+void xmg_graph::compute_mffc_cache()
+{
+  compute_fanout();
+  compute_output_refs();
+
+  if ( mffc_cache.is_dirty() )
+  {
+    (*mffc_cache).assign( size(), mffc_unknown );
+    mffc_cache.make_clean();
+    _mffc_complete = false;
+  }
+}
+
+/* decrements reference counts in the cone of n and returns the number of gates that became unreferenced */
+unsigned xmg_graph::mffc_deref( node_t n )
+{
+  auto count = 0u;
+  std::vector<node_t> stack{n};
+
+  while ( !stack.empty() )
+  {
+    const auto m = stack.back();
+    stack.pop_back();
+
+    if ( is_input( m ) ) continue;
+    ++count;
+
+    for ( const auto& c : children( m ) )
+    {
+      assert( (*fanout)[c.node] > 0u );
+      if ( --(*fanout)[c.node] == 0u && (*output_refs)[c.node] == 0u )
+      {
+        stack.push_back( c.node );
+      }
+    }
+  }
+
+  return count;
+}
+
+/* reverts mffc_deref */
+unsigned xmg_graph::mffc_ref( node_t n )
+{
+  auto count = 0u;
+  std::vector<node_t> stack{n};
+
+  while ( !stack.empty() )
+  {
+    const auto m = stack.back();
+    stack.pop_back();
+
+    if ( is_input( m ) ) continue;
+    ++count;
+
+    for ( const auto& c : children( m ) )
+    {
+      if ( (*fanout)[c.node]++ == 0u && (*output_refs)[c.node] == 0u )
+      {
+        stack.push_back( c.node );
+      }
+    }
+  }
+
+  return count;
+}
+
+/* recomputes the level of n and propagates changes to its transitive fanout */
+void xmg_graph::update_level( node_t n )
+{
+  if ( levels.is_dirty() ) return;
+
+  std::vector<node_t> stack{n};
+  while ( !stack.empty() )
+  {
+    const auto m = stack.back();
+    stack.pop_back();
+
+    auto level = 0u;
+    for ( const auto& c : children( m ) )
+    {
+      level = std::max( level, (*levels)[c.node] + 1u );
+    }
+
+    if ( level == (*levels)[m] && m != n ) continue;
+    (*levels)[m] = level;
+
+    if ( !parentss.is_dirty() )
+    {
+      for ( const auto& p : (*parentss)[m] )
+      {
+        stack.push_back( p );
+      }
+    }
+  }
 }
 
 /******************************************************************************
@@ -37,6 +37,7 @@
 #define XMG_HPP
 
 #include <functional>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -48,6 +49,7 @@
 #include <core/utils/dirty.hpp>
 #include <core/utils/graph_utils.hpp>
 #include <core/utils/hash_utils.hpp>
+#include <core/utils/strash_table.hpp>
 
 namespace cirkit
 {
@@ -96,6 +98,16 @@ namespace cirkit
 class xmg_cover;
 class xmg_bitmarks;
 
+/* entry of the change journal of in-place substitutions */
+struct xmg_change
+{
+  enum kind_t { substituted, rewired, removed };
+
+  kind_t       kind;
+  xmg_node     node;
+  xmg_function by;   /* replacing function, only for substituted */
+};
+
 class xmg_graph
 {
 public:
@@ -171,12 +183,57 @@ public:
   unsigned dec_ref( xmg_node n );
   void inc_output_refs();
 
+  /* MFFCs
+   *
+   * The reference count of a node is its fanout plus the number of outputs
+   * that point to it; both are kept up to date with the network, such that
+   * no reference counts need to be initialized per query.  Sizes count the
+   * gates in the MFFC including the root, inputs have size 0.  Sizes are
+   * cached until the network changes.  mffc_size dereferences a single
+   * cone, mffc_sizes computes all sizes in one pass over the network as
+   * subtree sizes of the dominator tree of the fanout graph.
+   */
+  unsigned mffc_size( node_t n );
+  const std::vector<unsigned>& mffc_sizes();
+  unsigned compute_mffc( node_t n, std::vector<node_t>& support );
+
   /* marking */
   xmg_bitmarks& bitmarks();
   const xmg_bitmarks& bitmarks() const;
 
   void mark_as_modified();
 
+  /* in-place substitution
+   *
+   * Replaces all references to node n (by gates and outputs) with f, f must
+   * not be in the transitive fanout of n.  Parents whose fanins change are
+   * rewired in place and rehashed; if a parent becomes trivial, is
+   * structurally equal to an existing node, or its polarity has to be
+   * normalized, it is substituted as well.  Gates without references are
+   * removed recursively; their ids are not reused, but they have no fanins
+   * and no fanouts anymore and is_dead returns true for them (xmg_strash
+   * compacts the graph).  Node ids are no longer in topological order
+   * afterwards, use topological_nodes to traverse the graph, which skips
+   * dead nodes.  Fanout, parents, and levels are updated incrementally if
+   * they have been computed.  Each step is appended to the change journal.
+   */
+  void substitute_node( node_t n, const xmg_function& f );
+  bool is_dead( node_t n ) const;
+  unsigned num_dead() const;
+  const std::vector<xmg_change>& journal() const;
+  void clear_journal();
+
+  /* low-level construction for loaders of stored networks
+   *
+   * Children must be normalized and sorted as they are stored on the edges
+   * of a gate (see create_maj and create_xor), special cases are not checked
+   * and the strash tables are not searched.  The gate is added to the strash
+   * table, reserve avoids that the tables grow while loading.
+   */
+  void reserve( std::size_t num_maj, std::size_t num_xor );
+  node_t append_maj( const xmg_function& a, const xmg_function& b, const xmg_function& c );
+  node_t append_xor( const xmg_function& a, const xmg_function& b );
+
 public: /* properties */
   inline void set_native_xor( bool native_xor ) { _native_xor = native_xor; }
   inline bool has_native_xor() const            { return _native_xor; }
@@ -187,6 +244,21 @@ public: /* properties */
   inline void set_inverter_propagation( bool enabled ) { _enable_inverter_propagation = enabled; }
   inline bool has_inverter_propagation() const         { return _enable_inverter_propagation; }
 
+  inline const strash_table<strash_key3>& maj_strash_table() const { return maj_strash; }
+  inline const strash_table<uint64_t>& xor_strash_table() const    { return xor_strash; }
+
+private:
+  static constexpr unsigned mffc_unknown = std::numeric_limits<unsigned>::max();
+
+  void update_for_new_node( node_t n );
+  void compute_output_refs();
+  void take_out_dangling( node_t n );
+  void remove_parent( node_t child, node_t parent );
+  void update_level( node_t n );
+  void compute_mffc_cache();
+  unsigned mffc_deref( node_t n );
+  unsigned mffc_ref( node_t n );
+
 private:
   graph_t g;
   node_t  constant;
@@ -196,10 +268,9 @@ private:
   output_vec_t _outputs;
   std::unordered_map<xmg_node, unsigned> _input_to_id;
 
-  using maj_strash_key_t = std::tuple<xmg_function, xmg_function, xmg_function>;
-  using xor_strash_key_t = std::pair<xmg_function, xmg_function>;
-  std::unordered_map<maj_strash_key_t, node_t, hash<maj_strash_key_t>> maj_strash;
-  std::unordered_map<xor_strash_key_t, node_t, hash<xor_strash_key_t>> xor_strash;
+  /* keys are packed literals ( node << 1 | complemented ) of the normalized children */
+  strash_table<strash_key3>               maj_strash;
+  strash_table<uint64_t>                  xor_strash;
 
   complement_property_map_t               _complement;
 
@@ -223,6 +294,18 @@ private:
 
   /* utilities */
   std::vector<unsigned>                   ref_count;
+
+  /* in-place substitution */
+  dirty<std::vector<unsigned>>            output_refs;
+  boost::dynamic_bitset<>                 dead;
+  unsigned                                _num_dead = 0u;
+  std::vector<xmg_change>                 _journal;
+
+  /* MFFCs */
+  dirty<std::vector<unsigned>>            mffc_cache; /* mffc_unknown if not computed yet */
+  bool                                    _mffc_complete = false;
+  std::vector<unsigned>                   mffc_visited;
+  unsigned                                _mffc_visit_id = 0u;
 };
 
 }
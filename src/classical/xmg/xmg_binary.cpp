@@ -0,0 +1,334 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "xmg_binary.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include <core/utils/mapped_file.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/io/binary_network.hpp>
+#include <classical/xmg/xmg_cover.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* new index for each node, such that gates come after their children and
+   inputs keep their order; this is the identity for networks that are built
+   by appending nodes */
+std::vector<xmg_node> xmg_binary_order( const xmg_graph& xmg, std::vector<uint32_t>& index )
+{
+  const auto unassigned = std::numeric_limits<uint32_t>::max();
+
+  std::vector<xmg_node> order;
+  order.reserve( xmg.size() - xmg.num_dead() );
+  index.assign( xmg.size(), unassigned );
+
+  const auto assign = [&]( xmg_node n ) {
+    index[n] = order.size();
+    order.push_back( n );
+  };
+
+  auto next_input = 0u;
+  const auto assign_inputs_up_to = [&]( unsigned pos ) {
+    for ( ; next_input <= pos; ++next_input )
+    {
+      assign( xmg.inputs()[next_input].first );
+    }
+  };
+
+  assign( 0u );
+
+  std::vector<std::pair<xmg_node, bool>> stack;
+  for ( auto n = 1u; n < xmg.size(); ++n )
+  {
+    stack.push_back( {n, false} );
+
+    while ( !stack.empty() )
+    {
+      const auto p = stack.back();
+      stack.pop_back();
+
+      if ( index[p.first] != unassigned || xmg.is_dead( p.first ) ) continue;
+
+      if ( xmg.is_input( p.first ) )
+      {
+        assign_inputs_up_to( xmg.input_index( p.first ) );
+      }
+      else if ( p.second )
+      {
+        assign( p.first );
+      }
+      else
+      {
+        stack.push_back( {p.first, true} );
+        const auto cs = xmg.children( p.first );
+        for ( auto it = cs.rbegin(); it != cs.rend(); ++it )
+        {
+          if ( index[it->node] == unassigned )
+          {
+            stack.push_back( {it->node, false} );
+          }
+        }
+      }
+    }
+  }
+
+  if ( !xmg.inputs().empty() )
+  {
+    assign_inputs_up_to( xmg.inputs().size() - 1u );
+  }
+
+  return order;
+}
+
+inline uint32_t xmg_binary_literal( const xmg_function& f, const std::vector<uint32_t>& index )
+{
+  return ( index[f.node] << 1u ) | static_cast<uint32_t>( f.complemented );
+}
+
+inline xmg_function xmg_binary_function( uint32_t literal, uint32_t num_nodes )
+{
+  if ( ( literal >> 1u ) >= num_nodes ) { throw "Error: fanin refers to a node that is not defined yet"; }
+  return xmg_function( literal >> 1u, literal & 1u );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+void xmg_write_binary( const xmg_graph& xmg, const std::string& filename,
+                       const properties::ptr& settings,
+                       const properties::ptr& statistics )
+{
+  /* settings */
+  const auto write_cover = get( settings, "cover", true ) && xmg.has_cover();
+
+  /* timing */
+  properties_timer t( statistics );
+
+  std::vector<uint32_t> index;
+  const auto order = xmg_binary_order( xmg, index );
+
+  binary_network_header header;
+  header.kind        = binary_network_xmg;
+  header.flags       = ( xmg.has_native_xor() ? binary_network_native_xor : 0u ) |
+                       ( xmg.has_structural_hashing() ? binary_network_structural_hashing : 0u ) |
+                       ( xmg.has_inverter_propagation() ? binary_network_inverter_propagation : 0u ) |
+                       ( write_cover ? binary_network_has_cover : 0u );
+  header.num_nodes   = order.size();
+  header.num_inputs  = xmg.inputs().size();
+  header.num_outputs = xmg.outputs().size();
+  header.num_maj     = xmg.num_maj();
+  header.num_xor     = xmg.num_xor();
+
+  std::vector<uint8_t>  types( binary_network_types_size( header.num_nodes ), binary_network_constant );
+  std::vector<uint32_t> fanins( 3u * header.num_nodes, 0u );
+  std::vector<uint32_t> cover;
+  auto                  constant_used = false;
+
+  for ( auto i = 1u; i < order.size(); ++i )
+  {
+    const auto n = order[i];
+
+    if ( xmg.is_input( n ) )
+    {
+      types[i] = binary_network_input;
+    }
+    else
+    {
+      /* children are normalized, only their order may change with renumbering */
+      auto cs = xmg.children( n );
+      std::transform( cs.begin(), cs.end(), cs.begin(), [&index]( const xmg_function& f ) { return xmg_function( index[f.node], f.complemented ); } );
+      std::sort( cs.begin(), cs.end() );
+
+      types[i] = cs.size() == 3u ? binary_network_maj : binary_network_xor;
+      for ( auto j = 0u; j < cs.size(); ++j )
+      {
+        fanins[3u * i + j] = ( cs[j].node << 1u ) | static_cast<uint32_t>( cs[j].complemented );
+        constant_used = constant_used || cs[j].node == 0u;
+      }
+    }
+
+    if ( write_cover && xmg.cover().has_cut( n ) )
+    {
+      cover.push_back( i );
+      cover.push_back( xmg.cover().num_leafs( n ) );
+      for ( auto l : xmg.cover().cut( n ) )
+      {
+        cover.push_back( index[l] );
+      }
+      ++header.num_luts;
+    }
+  }
+
+  if ( write_cover )
+  {
+    header.cut_size = xmg.cover().cut_size();
+  }
+
+  std::vector<uint32_t> outputs;
+  outputs.reserve( header.num_outputs );
+  for ( const auto& o : xmg.outputs() )
+  {
+    outputs.push_back( xmg_binary_literal( o.first, index ) );
+    constant_used = constant_used || ( outputs.back() >> 1u ) == 0u;
+  }
+
+  if ( constant_used )
+  {
+    header.flags |= binary_network_constant_used;
+  }
+
+  std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+  os.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+  os.write( reinterpret_cast<const char*>( types.data() ), types.size() );
+  binary_network_write_words( os, fanins.data(), fanins.size() );
+  binary_network_write_words( os, outputs.data(), outputs.size() );
+  binary_network_write_words( os, cover.data(), cover.size() );
+
+  binary_network_write_string( os, xmg.name() );
+  for ( const auto& i : xmg.inputs() )
+  {
+    binary_network_write_string( os, i.second );
+  }
+  for ( const auto& o : xmg.outputs() )
+  {
+    binary_network_write_string( os, o.second );
+  }
+}
+
+xmg_graph xmg_read_binary( const std::string& filename,
+                           const properties::ptr& settings,
+                           const properties::ptr& statistics )
+{
+  /* timing */
+  properties_timer t( statistics );
+
+  mapped_file file( filename );
+  mapped_reader reader( file.begin(), file.end() );
+
+  const auto header = binary_network_read_header( reader, binary_network_xmg );
+
+  /* type and fanin arrays are used in place */
+  const auto types  = reinterpret_cast<const uint8_t*>( reader.skip( binary_network_types_size( header.num_nodes ) ) );
+  const auto fanins = reinterpret_cast<const uint32_t*>( reader.skip( 3u * static_cast<std::size_t>( header.num_nodes ) * sizeof( uint32_t ) ) );
+
+  xmg_graph xmg;
+  xmg.set_native_xor( header.flags & binary_network_native_xor );
+  xmg.set_structural_hashing( header.flags & binary_network_structural_hashing );
+  xmg.set_inverter_propagation( header.flags & binary_network_inverter_propagation );
+  xmg.reserve( header.num_maj, header.num_xor );
+
+  for ( auto i = 1u; i < header.num_nodes; ++i )
+  {
+    const auto* f = fanins + 3u * i;
+
+    xmg_node n;
+    switch ( types[i] )
+    {
+    case binary_network_input:
+      n = xmg.create_pi( std::string() ).node;
+      break;
+    case binary_network_maj:
+      if ( !( f[0] < f[1] && f[1] < f[2] ) ) { throw "Error: fanins of majority gate are not normalized"; }
+      n = xmg.append_maj( xmg_binary_function( f[0], i ), xmg_binary_function( f[1], i ), xmg_binary_function( f[2], i ) );
+      break;
+    case binary_network_xor:
+      if ( ( f[0] >> 1u ) >= ( f[1] >> 1u ) ) { throw "Error: fanins of XOR gate are not normalized"; }
+      n = xmg.append_xor( xmg_binary_function( f[0], i ), xmg_binary_function( f[1], i ) );
+      break;
+    default:
+      throw "Error: unknown node type in binary network";
+    }
+
+    assert( n == i );
+    (void)n;
+  }
+
+  if ( xmg.inputs().size() != header.num_inputs || xmg.num_maj() != header.num_maj || xmg.num_xor() != header.num_xor )
+  {
+    throw "Error: node counts do not match binary network header";
+  }
+
+  std::vector<uint32_t> outputs( header.num_outputs );
+  reader.read( outputs.data(), outputs.size() );
+
+  if ( header.flags & binary_network_has_cover )
+  {
+    xmg_cover cover( header.cut_size, xmg );
+    std::vector<unsigned> leafs;
+
+    for ( auto l = 0u; l < header.num_luts; ++l )
+    {
+      const auto node = reader.read<uint32_t>();
+      const auto num_leafs = reader.read<uint32_t>();
+      if ( num_leafs > header.cut_size ) { throw "Error: broken cover in binary network"; }
+      leafs.resize( num_leafs );
+      reader.read( leafs.data(), leafs.size() );
+
+      if ( node >= header.num_nodes || cover.has_cut( node ) ||
+           std::any_of( leafs.begin(), leafs.end(), [&header]( unsigned l ) { return l >= header.num_nodes; } ) )
+      {
+        throw "Error: broken cover in binary network";
+      }
+      cover.add_cut( node, leafs );
+    }
+
+    xmg.set_cover( cover );
+  }
+
+  xmg.set_name( reader.read_string() );
+  for ( auto& i : xmg.inputs() )
+  {
+    i.second = reader.read_string();
+  }
+  for ( auto o : outputs )
+  {
+    xmg.create_po( xmg_binary_function( o, header.num_nodes ), reader.read_string() );
+  }
+
+  return xmg;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -26,6 +26,9 @@
 
 #include "xmg_cuts_paged.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <mutex>
 #include <stack>
@@ -35,11 +38,13 @@
 #include <core/utils/range_utils.hpp>
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <classical/xmg/xmg_simulate.hpp>
 #include <classical/xmg/xmg_utils.hpp>
 
 #include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/range/adaptors.hpp>
@@ -62,10 +67,45 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+template<typename Cut>
+std::vector<Cut> fixed_cuts_from_paged( const boost::iterator_range<paged_memory::iterator>& sets )
+{
+  std::vector<Cut> cuts;
+  for ( const auto& s : sets )
+  {
+    cuts.push_back( Cut::from_sorted_range( s.begin(), s.end() ) );
+  }
+  return cuts;
+}
+
+std::vector<boost::iterator_range<const unsigned*>> ranges_from_paged( const boost::iterator_range<paged_memory::iterator>& sets )
+{
+  std::vector<boost::iterator_range<const unsigned*>> v;
+  for ( const auto& s : sets )
+  {
+    const unsigned* begin = s.size() ? &*s.begin() : nullptr;
+    v.push_back( boost::make_iterator_range( begin, begin + s.size() ) );
+  }
+  return v;
+}
+
+template<typename Cut>
+unsigned cut_min_level( const Cut& cut, const std::vector<std::pair<unsigned, unsigned>>& levels )
+{
+  auto min_level = std::numeric_limits<unsigned>::max();
+  for ( auto leaf : cut )
+  {
+    min_level = std::min( min_level, levels[leaf].second );
+  }
+  return min_level;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
+constexpr unsigned xmg_cuts_paged::max_cut_size;
+
 std::vector<std::pair<unsigned, unsigned>> compute_level_ranges( xmg_graph& xmg, unsigned& max_level )
 {
   xmg.compute_levels();
@@ -108,7 +148,7 @@ std::vector<std::pair<unsigned, unsigned>> compute_level_ranges( xmg_graph& xmg,
   return level_ranges;
 }
 
-xmg_cuts_paged::xmg_cuts_paged( xmg_graph& xmg, unsigned k, const properties::ptr& settings )
+xmg_cuts_paged::xmg_cuts_paged( xmg_graph& xmg, unsigned k, const properties::ptr& settings, const properties::ptr& statistics )
   : _xmg( xmg ),
     _k( k ),
     _priority( get( settings, "priority", 8u ) ),
@@ -117,14 +157,28 @@ xmg_cuts_paged::xmg_cuts_paged( xmg_graph& xmg, unsigned k, const properties::pt
     data( _xmg.size(), 2u + _extra ),
     cones( _xmg.size() )
 {
+  if ( k > max_cut_size )
+  {
+    throw boost::str( boost::format( "cut size %d exceeds the maximum cut size %d" ) % k % max_cut_size );
+  }
+
   unsigned max_level;
   _levels = compute_level_ranges( xmg, max_level );
 
-  enumerate();
+  if ( get( settings, "parallel", false ) )
+  {
+    enumerate_parallel( get( settings, "num_threads", 0u ) );
+  }
+  else
+  {
+    enumerate();
+  }
+  set_statistics( statistics );
 }
 
 xmg_cuts_paged::xmg_cuts_paged( xmg_graph& xmg, unsigned k, const std::vector<xmg_node>& start, const std::vector<xmg_node>& boundary,
-                                const std::vector<std::pair<unsigned, unsigned>>& levels, const properties::ptr& settings )
+                                const std::vector<std::pair<unsigned, unsigned>>& levels, const properties::ptr& settings,
+                                const properties::ptr& statistics )
   : _xmg( xmg ),
     _k( k ),
     _priority( get( settings, "priority", 8u ) ),
@@ -134,7 +188,13 @@ xmg_cuts_paged::xmg_cuts_paged( xmg_graph& xmg, unsigned k, const std::vector<xm
     cones( _xmg.size() ),
     _levels( levels )
 {
+  if ( k > max_cut_size )
+  {
+    throw boost::str( boost::format( "cut size %d exceeds the maximum cut size %d" ) % k % max_cut_size );
+  }
+
   enumerate_partial( start, boundary );
+  set_statistics( statistics );
 }
 
 const xmg_graph& xmg_cuts_paged::xmg() const
@@ -225,7 +285,6 @@ void xmg_cuts_paged::enumerate()
   boost::progress_display show_progress( top.size(), _progress ? std::cout : null_out );
 
   /* loop */
-  _top_index = 0u;
   for ( auto n : top )
   {
     ++show_progress;
@@ -256,13 +315,11 @@ void xmg_cuts_paged::enumerate()
         cns.push_back( c.node );
       }
 
-      enumerate_node_with_bitsets( n, cns );
+      enumerate_node( n, cns );
 
       data.append_singleton( n, n, get_extra( 0u, 1u ) );
       cones.append_singleton( n, n );
     }
-
-    _top_index++;
   }
 }
 
@@ -314,7 +371,6 @@ void xmg_cuts_paged::enumerate_with_xor_blocks( const std::unordered_map<xmg_nod
   /* loop */
   std::unordered_map<xmg_node, xmg_xor_block_t>::const_iterator it;
   //  std::remove_const<decltype( blocks )>::type::const_iterator it;
-  _top_index = 0u;
   for ( auto n : top )
   {
     if ( _xmg.is_input( n ) )
@@ -362,13 +418,11 @@ void xmg_cuts_paged::enumerate_with_xor_blocks( const std::unordered_map<xmg_nod
         cns.push_back( c.node );
       }
 
-      enumerate_node_with_bitsets( n, cns );
+      enumerate_node( n, cns );
 
       data.append_singleton( n, n, get_extra( 0u, 1u ) );
       cones.append_singleton( n, n );
     }
-
-    _top_index++;
   }
 }
 
@@ -439,46 +493,47 @@ void xmg_cuts_paged::enumerate_partial( const std::vector<xmg_node>& start, cons
       cns.push_back( c.node );
     }
 
-    _top_index = _xmg.size();
-    enumerate_node_with_bitsets( n, cns );
+    enumerate_node( n, cns );
 
     data.append_singleton( n, n, get_extra( 0u, 1u ) );
     cones.append_singleton( n, n );
   }
 }
 
-void xmg_cuts_paged::merge_cut( local_cut_vec_t& local_cuts, const boost::dynamic_bitset<>& new_cut, unsigned min_level, const boost::dynamic_bitset<>& new_cone ) const
+xmg_cuts_paged::local_cut_t* xmg_cuts_paged::merge_cut( local_cut_vec_t& local_cuts, const fixed_cut_t& new_cut ) const
 {
-  /* too large? */
-  if ( new_cut.count() > _k ) { return; }
-
   auto first_subsume = true;
   auto add = true;
+  auto slot = -1;
 
   auto l = 0u;
   while ( l < local_cuts.size() )
   {
-    auto cut = std::get<0>( local_cuts[l] );
+    const auto& cut = local_cuts[l].cut;
 
     /* same cut */
     if ( cut == new_cut ) { add = false; break; }
 
     /* cut subsumes new_cut */
-    if ( ( cut & new_cut ) == cut ) { add = false; break; }
+    if ( cut.dominates( new_cut ) ) { add = false; break; }
 
     /* new_cut subsumes cut */
-    if ( ( cut & new_cut ) == new_cut )
+    if ( new_cut.dominates( cut ) )
     {
       add = false;
       if ( first_subsume )
       {
-        local_cuts[l] = std::make_tuple( new_cut, min_level, new_cone );
+        local_cuts[l].cut = new_cut;
+        slot = l;
         first_subsume = false;
       }
       else
       {
-        local_cuts[l] = local_cuts.back();
+        /* the last cut moves to position l and still has to be checked */
+        if ( slot == static_cast<int>( local_cuts.size() ) - 1 ) { slot = l; }
+        local_cuts[l] = std::move( local_cuts.back() );
         local_cuts.pop_back();
+        continue;
       }
     }
 
@@ -487,70 +542,74 @@ void xmg_cuts_paged::merge_cut( local_cut_vec_t& local_cuts, const boost::dynami
 
   if ( add )
   {
-    local_cuts.push_back( std::make_tuple( new_cut, min_level, new_cone ) );
+    local_cuts.push_back( {new_cut, 0u, {}} );
+    return &local_cuts.back();
   }
+
+  return slot == -1 ? nullptr : &local_cuts[slot];
+}
+
+xmg_cuts_paged::child_cuts_t xmg_cuts_paged::child_cuts( xmg_node n )
+{
+  return {fixed_cuts_from_paged<fixed_cut_t>( cuts( n ) ), ranges_from_paged( cut_cones( n ) )};
 }
 
-xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( xmg_node n1, xmg_node n2, unsigned max_cut_size )
+xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( const child_cuts_t& c1, const child_cuts_t& c2 ) const
 {
   local_cut_vec_t local_cuts;
 
-  for ( const auto& c1 : boost::combine( cuts( n1 ), cut_cones( n1 ) ) )
+  fixed_cut_t new_cut;
+  for ( auto i = 0u; i < c1.cuts.size(); ++i )
   {
-    for ( const auto& c2 : boost::combine( cuts( n2 ), cut_cones( n2 ) ) )
+    for ( auto j = 0u; j < c2.cuts.size(); ++j )
     {
-      auto min_level = std::numeric_limits<unsigned>::max();
-      boost::dynamic_bitset<> new_cut( max_cut_size );
-      auto f = [&new_cut, &min_level, this]( unsigned pos ) {
-        new_cut.set( pos );
-        min_level = std::min( min_level, this->_levels[pos].second );
-      };
-      std::for_each( boost::get<0>( c1 ).begin(), boost::get<0>( c1 ).end(), f );
-      std::for_each( boost::get<0>( c2 ).begin(), boost::get<0>( c2 ).end(), f );
-
-      boost::dynamic_bitset<> new_cone( max_cut_size );
-      auto f2 = [&new_cone]( unsigned pos ) {
-        new_cone.set( pos );
-      };
-      std::for_each( boost::get<1>( c1 ).begin(), boost::get<1>( c1 ).end(), f2 );
-      std::for_each( boost::get<1>( c2 ).begin(), boost::get<1>( c2 ).end(), f2 );
-
-      merge_cut( local_cuts, new_cut, min_level, new_cone );
+      if ( !new_cut.merge( c1.cuts[i], c2.cuts[j], _k ) ) { continue; }
+
+      /* the cone is only computed when the cut is kept */
+      auto* entry = merge_cut( local_cuts, new_cut );
+      if ( !entry ) { continue; }
+
+      entry->min_level = cut_min_level( new_cut, _levels );
+      entry->cone.clear();
+      boost::set_union( c1.cones[i], c2.cones[j], std::back_inserter( entry->cone ) );
     }
   }
 
   return local_cuts;
 }
 
-xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( xmg_node n1, xmg_node n2, xmg_node n3, unsigned max_cut_size )
+xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( const child_cuts_t& c1, const child_cuts_t& c2, const child_cuts_t& c3 ) const
 {
   local_cut_vec_t local_cuts;
 
-  for ( const auto& c1 : boost::combine( cuts( n1 ), cut_cones( n1 ) ) )
+  fixed_cut_t cut12, new_cut;
+  std::vector<unsigned> cone12;
+  auto has_cone12 = false;
+  for ( auto i = 0u; i < c1.cuts.size(); ++i )
   {
-    for ( const auto& c2 : boost::combine( cuts( n2 ), cut_cones( n2 ) ) )
+    for ( auto j = 0u; j < c2.cuts.size(); ++j )
     {
-      for ( const auto& c3 : boost::combine( cuts( n3 ), cut_cones( n3 ) ) )
+      if ( !cut12.merge( c1.cuts[i], c2.cuts[j], _k ) ) { continue; }
+
+      has_cone12 = false;
+
+      for ( auto l = 0u; l < c3.cuts.size(); ++l )
       {
-        auto min_level = std::numeric_limits<unsigned>::max();
-        boost::dynamic_bitset<> new_cut( max_cut_size );
-        auto f = [&new_cut, &min_level, this]( unsigned pos ) {
-          new_cut.set( pos );
-          min_level = std::min( min_level, this->_levels[pos].second );
-        };
-        std::for_each( boost::get<0>( c1 ).begin(), boost::get<0>( c1 ).end(), f );
-        std::for_each( boost::get<0>( c2 ).begin(), boost::get<0>( c2 ).end(), f );
-        std::for_each( boost::get<0>( c3 ).begin(), boost::get<0>( c3 ).end(), f );
-
-        boost::dynamic_bitset<> new_cone( max_cut_size );
-        auto f2 = [&new_cone]( unsigned pos ) {
-          new_cone.set( pos );
-        };
-        std::for_each( boost::get<1>( c1 ).begin(), boost::get<1>( c1 ).end(), f2 );
-        std::for_each( boost::get<1>( c2 ).begin(), boost::get<1>( c2 ).end(), f2 );
-        std::for_each( boost::get<1>( c3 ).begin(), boost::get<1>( c3 ).end(), f2 );
-
-        merge_cut( local_cuts, new_cut, min_level, new_cone );
+        if ( !new_cut.merge( cut12, c3.cuts[l], _k ) ) { continue; }
+
+        auto* entry = merge_cut( local_cuts, new_cut );
+        if ( !entry ) { continue; }
+
+        if ( !has_cone12 )
+        {
+          cone12.clear();
+          boost::set_union( c1.cones[i], c2.cones[j], std::back_inserter( cone12 ) );
+          has_cone12 = true;
+        }
+
+        entry->min_level = cut_min_level( new_cut, _levels );
+        entry->cone.clear();
+        boost::set_union( cone12, c3.cones[l], std::back_inserter( entry->cone ) );
       }
     }
   }
@@ -558,26 +617,25 @@ xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( xmg_node n
   return local_cuts;
 }
 
-xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( const std::vector<xmg_node>& ns, unsigned max_cut_size )
+xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( const std::vector<child_cuts_t>& cs ) const
 {
   local_cut_vec_t local_cuts;
 
-  if ( ns.size() == 2u )
+  if ( cs.size() == 2u )
   {
-    local_cuts = enumerate_local_cuts( ns[0u], ns[1u], max_cut_size );
+    local_cuts = enumerate_local_cuts( cs[0u], cs[1u] );
   }
-  else if ( ns.size() == 3u )
+  else if ( cs.size() == 3u )
   {
-    local_cuts = enumerate_local_cuts( ns[0u], ns[1u], ns[2u], max_cut_size );
+    local_cuts = enumerate_local_cuts( cs[0u], cs[1u], cs[2u] );
   }
   else
   {
     assert( false );
   }
 
-  boost::sort( local_cuts, []( const std::tuple<boost::dynamic_bitset<>, unsigned, boost::dynamic_bitset<>>& e1,
-                               const std::tuple<boost::dynamic_bitset<>, unsigned, boost::dynamic_bitset<>>& e2 ) {
-                 return ( std::get<1>( e1 ) > std::get<1>( e2 ) ) || ( std::get<1>( e1 ) == std::get<1>( e2 ) && std::get<0>( e1 ).count() < std::get<0>( e2 ).count() ); } );
+  boost::sort( local_cuts, []( const local_cut_t& e1, const local_cut_t& e2 ) {
+                 return ( e1.min_level > e2.min_level ) || ( e1.min_level == e2.min_level && e1.cut.size() < e2.cut.size() ); } );
 
   if ( local_cuts.size() > _priority )
   {
@@ -587,16 +645,131 @@ xmg_cuts_paged::local_cut_vec_t xmg_cuts_paged::enumerate_local_cuts( const std:
   return local_cuts;
 }
 
-void xmg_cuts_paged::enumerate_node_with_bitsets( xmg_node n, const std::vector<xmg_node>& ns )
+void xmg_cuts_paged::enumerate_node( xmg_node n, const std::vector<xmg_node>& ns )
+{
+  std::vector<child_cuts_t> cs;
+  for ( auto c : ns )
+  {
+    cs.push_back( child_cuts( c ) );
+  }
+
+  for ( auto& cut : enumerate_local_cuts( cs ) )
+  {
+    auto& area = cut.cone;
+    area.insert( std::lower_bound( area.begin(), area.end(), static_cast<unsigned>( n ) ), n );
+    const auto extra = get_extra( _levels[n].first - cut.min_level, area.size() );
+    data.append_set( n, cut.cut.begin(), cut.cut.end(), extra );
+    cones.append_set( n, area.begin(), area.end() );
+  }
+}
+
+void xmg_cuts_paged::enumerate_parallel( unsigned num_threads )
+{
+  reference_timer t( &_enumeration_time );
+
+  work_stealing_pool pool( num_threads );
+
+  const auto additional = 2u + _extra;
+  std::vector<paged_memory_page> data_pages, cone_pages;
+  for ( auto i = 0u; i < pool.num_threads(); ++i )
+  {
+    data_pages.emplace_back( additional );
+    cone_pages.emplace_back( 0u );
+  }
+  std::vector<paged_memory_page::record> data_records( _xmg.size() ), cone_records( _xmg.size() );
+
+  const auto record_cuts = [&]( xmg_node n ) -> child_cuts_t {
+    child_cuts_t c;
+    paged_memory_page::foreach_set( data_records[n], additional, [&c]( const unsigned*, const unsigned* begin, const unsigned* end ) {
+        c.cuts.push_back( fixed_cut_t::from_sorted_range( begin, end ) );
+      } );
+    paged_memory_page::foreach_set( cone_records[n], 0u, [&c]( const unsigned*, const unsigned* begin, const unsigned* end ) {
+        c.cones.push_back( boost::make_iterator_range( begin, end ) );
+      } );
+    return c;
+  };
+
+  /* constant and inputs; gates sorted by level */
+  std::vector<std::vector<xmg_node>> gates_by_level;
+  for ( const auto& n : _xmg.nodes() )
+  {
+    if ( _xmg.is_dead( n ) ) { continue; }
+
+    if ( _xmg.is_input( n ) )
+    {
+      data_pages[0u].begin_record();
+      cone_pages[0u].begin_record();
+      if ( n == 0u )
+      {
+        data_pages[0u].append_empty( get_extra( 0u, 0u ) );
+        cone_pages[0u].append_empty();
+      }
+      else
+      {
+        data_pages[0u].append_singleton( n, get_extra( 0u, 1u ) );
+        cone_pages[0u].append_singleton( n );
+      }
+      data_records[n] = data_pages[0u].end_record();
+      cone_records[n] = cone_pages[0u].end_record();
+    }
+    else
+    {
+      const auto level = _xmg.level( n );
+      if ( level >= gates_by_level.size() )
+      {
+        gates_by_level.resize( level + 1u );
+      }
+      gates_by_level[level].push_back( n );
+    }
+  }
+
+  /* gates, the cuts of all children are final when a level is processed */
+  for ( const auto& gates : gates_by_level )
+  {
+    const auto grain_size = std::max<std::size_t>( 16u, gates.size() / ( 8u * pool.num_threads() ) );
+
+    pool.parallel_for( 0u, gates.size(), [&]( std::size_t i, unsigned worker ) {
+        const auto n = gates[i];
+        auto& data_page = data_pages[worker];
+        auto& cone_page = cone_pages[worker];
+
+        std::vector<child_cuts_t> cs;
+        for ( const auto& c : _xmg.children( n ) )
+        {
+          cs.push_back( record_cuts( c.node ) );
+        }
+
+        data_page.begin_record();
+        cone_page.begin_record();
+        for ( auto& cut : enumerate_local_cuts( cs ) )
+        {
+          auto& area = cut.cone;
+          area.insert( std::lower_bound( area.begin(), area.end(), static_cast<unsigned>( n ) ), n );
+          data_page.append_set( cut.cut.begin(), cut.cut.end(), get_extra( _levels[n].first - cut.min_level, area.size() ) );
+          cone_page.append_set( area.begin(), area.end() );
+        }
+        data_page.append_singleton( n, get_extra( 0u, 1u ) );
+        cone_page.append_singleton( n );
+        data_records[n] = data_page.end_record();
+        cone_records[n] = cone_page.end_record();
+      }, grain_size );
+  }
+
+  /* compaction */
+  for ( const auto& n : _xmg.nodes() )
+  {
+    data.assign_record( n, data_records[n] );
+    cones.assign_record( n, cone_records[n] );
+  }
+}
+
+void xmg_cuts_paged::set_statistics( const properties::ptr& statistics ) const
 {
-  for ( const auto& cut : enumerate_local_cuts( ns, _top_index ) )
+  if ( statistics )
   {
-    auto area = std::get<2>( cut );
-    area.resize( n + 1 );
-    area.set( n );
-    const auto extra = get_extra( _levels[n].first - std::get<1>( cut ), static_cast<unsigned int>( area.count() ) );
-    data.append_set( n, get_index_vector( std::get<0>( cut ) ), extra );
-    cones.append_set( n, get_index_vector( area ) );
+    statistics->set( "runtime", _enumeration_time );
+    statistics->set( "total_cuts", total_cut_count() );
+    statistics->set( "cuts_per_second", _enumeration_time > 0.0 ? total_cut_count() / _enumeration_time : 0.0 );
   }
 }
 
@@ -45,6 +45,7 @@
 
 #include <core/properties.hpp>
 #include <core/utils/paged_memory.hpp>
+#include <classical/functions/cuts/fixed_cut.hpp>
 #include <classical/xmg/xmg.hpp>
 #include <classical/xmg/xmg_xor_blocks.hpp>
 #include <classical/utils/truth_table_utils.hpp>
@@ -61,12 +62,20 @@ public:
   using cut = paged_memory::set;
   using cone = paged_memory::set;
 
-  xmg_cuts_paged( xmg_graph& xmg, unsigned k, const properties::ptr& settings = properties::ptr() );
+  /* largest supported k */
+  static constexpr unsigned max_cut_size = 16u;
+
+  /* settings:   priority, extra, progress,
+   *             parallel (default: false), num_threads (default: 0 = number of cores)
+   * statistics: runtime, total_cuts, cuts_per_second */
+  xmg_cuts_paged( xmg_graph& xmg, unsigned k, const properties::ptr& settings = properties::ptr(),
+                  const properties::ptr& statistics = properties::ptr() );
   xmg_cuts_paged( xmg_graph& xmg, unsigned k,
                   const std::vector<xmg_node>& start,
                   const std::vector<xmg_node>& boundary,
                   const std::vector<std::pair<unsigned, unsigned>>& levels,
-                  const properties::ptr& settings = properties::ptr() );
+                  const properties::ptr& settings = properties::ptr(),
+                  const properties::ptr& statistics = properties::ptr() );
 
   const xmg_graph& xmg() const;
 
@@ -92,13 +101,40 @@ private:
   void enumerate_with_xor_blocks( const std::unordered_map<xmg_node, xmg_xor_block_t>& blocks );
   void enumerate_partial( const std::vector<xmg_node>& start, const std::vector<xmg_node>& boundary );
 
-  void enumerate_node_with_bitsets( xmg_node n, const std::vector<xmg_node>& ns );
-
-  using local_cut_vec_t = std::vector<std::tuple<boost::dynamic_bitset<>, unsigned, boost::dynamic_bitset<>>>;
-  local_cut_vec_t enumerate_local_cuts( xmg_node n1, xmg_node n2, unsigned max_cut_size );
-  local_cut_vec_t enumerate_local_cuts( xmg_node n1, xmg_node n2, xmg_node n3, unsigned max_cut_size );
-  local_cut_vec_t enumerate_local_cuts( const std::vector<xmg_node>& ns, unsigned max_cut_size );
-  void merge_cut( local_cut_vec_t& local_cuts, const boost::dynamic_bitset<>& new_cut, unsigned min_level, const boost::dynamic_bitset<>& new_cone ) const;
+  void enumerate_node( xmg_node n, const std::vector<xmg_node>& ns );
+  void set_statistics( const properties::ptr& statistics ) const;
+
+  using fixed_cut_t = fixed_cut<max_cut_size>;
+
+  struct local_cut_t
+  {
+    fixed_cut_t           cut;
+    unsigned              min_level;
+    std::vector<unsigned> cone; /* sorted */
+  };
+  using local_cut_vec_t = std::vector<local_cut_t>;
+
+  /* cuts and cones of a child, either read from data and cones or from a page record */
+  struct child_cuts_t
+  {
+    std::vector<fixed_cut_t>                          cuts;
+    std::vector<boost::iterator_range<const unsigned*>> cones;
+  };
+
+  child_cuts_t child_cuts( xmg_node n );
+  local_cut_vec_t enumerate_local_cuts( const child_cuts_t& c1, const child_cuts_t& c2 ) const;
+  local_cut_vec_t enumerate_local_cuts( const child_cuts_t& c1, const child_cuts_t& c2, const child_cuts_t& c3 ) const;
+  local_cut_vec_t enumerate_local_cuts( const std::vector<child_cuts_t>& cs ) const;
+  local_cut_t* merge_cut( local_cut_vec_t& local_cuts, const fixed_cut_t& new_cut ) const;
+
+  /* Parallel enumeration
+   *
+   * Gates are processed level by level on a work_stealing_pool, hence the
+   * cuts of all children are final when a gate is processed.  Each worker
+   * writes cuts and cones into its own paged_memory_page, no locks are
+   * involved.  Finally, all records are compacted into data and cones.
+   */
+  void enumerate_parallel( unsigned num_threads );
 
   std::vector<unsigned> get_extra( unsigned depth, unsigned size ) const;
 
@@ -113,8 +149,6 @@ private:
 
   double           _enumeration_time = 0.0;
 
-  unsigned         _top_index = 0u; /* index when doing topo traversal */
-
   std::vector<std::pair<unsigned, unsigned>> _levels;
 };
 
@@ -26,12 +26,11 @@
 
 #include "xmg_dont_cares.hpp"
 
-#include <iostream>
-#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <functional>
 
-#include <classical/xmg/xmg_rewrite.hpp>
-#include <classical/xmg/xmg_simulate.hpp>
-#include <classical/xmg/xmg_utils.hpp>
+#include <core/utils/work_stealing_pool.hpp>
 
 namespace cirkit
 {
@@ -44,40 +43,334 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
-/* creates a miter in which node is inverted in one of the versions */
-xmg_graph xmg_dont_care_miter( const xmg_graph& xmg, xmg_node node )
+inline std::uint64_t literal_mask( std::uint32_t lit )
 {
-  /* create version with negative node */
-  const auto settings = std::make_shared<properties>();
-  xmg_substitutes_map_t::value_type map;
-  map[node] = xmg_function( node, true );
-  settings->set( "substitutes", xmg_substitutes_map_t( map ) );
-  const auto xmg_dub = xmg_rewrite_top_down( xmg, rewrite_default_maj, rewrite_default_xor, settings );
+  return -static_cast<std::uint64_t>( lit & 1u );
+}
+
+void xmg_observability_engine::compute( std::uint32_t root, window_t& window, std::uint64_t* obs ) const
+{
+  const auto num_words  = sim.num_words();
+  const auto first_gate = 1u + sim.num_inputs();
+  const auto& gates     = sim.gates();
+
+  std::fill( obs, obs + num_words, 0u );
+
+  /* collect transitive fanout within level bound */
+  auto& nodes = window.nodes;
+  nodes.assign( 1u, root );
+  window.slot[root] = 0;
+  for ( auto i = 0u; i < nodes.size(); ++i )
+  {
+    const auto n = nodes[i];
+    for ( auto j = fanout_offset[n]; j < fanout_offset[n + 1u]; ++j )
+    {
+      const auto p = fanouts[j];
+      if ( _max_levels && levels[p] > levels[root] + _max_levels )
+      {
+        window.leaks[n] = 1u;
+      }
+      else if ( window.slot[p] == -1 )
+      {
+        window.slot[p] = 0;
+        nodes.push_back( p );
+      }
+    }
+  }
+
+  /* simulator nodes are in topological order */
+  std::sort( nodes.begin() + 1u, nodes.end() );
+  for ( auto i = 0u; i < nodes.size(); ++i )
+  {
+    window.slot[nodes[i]] = i;
+  }
+  window.changed.assign( nodes.size(), 0u );
+  window.words.resize( nodes.size() * num_words );
+
+  /* invert root */
+  {
+    const auto* base = sim.node_words( root );
+    auto* out = window.words.data();
+    for ( auto w = 0u; w < num_words; ++w )
+    {
+      out[w] = ~base[w];
+    }
+    window.changed[0u] = 1u;
+  }
+
+  /* re-simulate gates with a changed fanin */
+  const auto fanin_words = [&]( std::uint32_t lit ) {
+    const auto s = window.slot[lit >> 1u];
+    return ( s != -1 && window.changed[s] ) ? window.words.data() + s * num_words : sim.node_words( lit >> 1u );
+  };
+
+  for ( auto i = 1u; i < nodes.size(); ++i )
+  {
+    const auto& g = gates[nodes[i] - first_gate];
+    const auto arity = g.type == bit_parallel_simulator::gate_type::maj_gate ? 3u : 2u;
+
+    auto affected = false;
+    for ( auto k = 0u; k < arity && !affected; ++k )
+    {
+      const auto s = window.slot[g.fanin[k] >> 1u];
+      affected = s != -1 && window.changed[s];
+    }
+    if ( !affected ) { continue; }
+
+    const auto* a = fanin_words( g.fanin[0] );
+    const auto* b = fanin_words( g.fanin[1] );
+    const auto ma = literal_mask( g.fanin[0] );
+    const auto mb = literal_mask( g.fanin[1] );
+    const auto* base = sim.node_words( nodes[i] );
+    auto* out = window.words.data() + i * num_words;
+
+    std::uint64_t diff = 0u;
+    switch ( g.type )
+    {
+    case bit_parallel_simulator::gate_type::and_gate:
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        out[w] = ( a[w] ^ ma ) & ( b[w] ^ mb );
+        diff |= out[w] ^ base[w];
+      }
+      break;
+
+    case bit_parallel_simulator::gate_type::xor_gate:
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        out[w] = a[w] ^ b[w] ^ ma ^ mb;
+        diff |= out[w] ^ base[w];
+      }
+      break;
+
+    case bit_parallel_simulator::gate_type::maj_gate:
+      {
+        const auto* c = fanin_words( g.fanin[2] );
+        const auto mc = literal_mask( g.fanin[2] );
+        for ( auto w = 0u; w < num_words; ++w )
+        {
+          const auto x = a[w] ^ ma, y = b[w] ^ mb, z = c[w] ^ mc;
+          out[w] = ( x & y ) | ( z & ( x | y ) );
+          diff |= out[w] ^ base[w];
+        }
+      }
+      break;
+    }
+
+    window.changed[i] = diff != 0u;
+  }
 
-  /* create miter and connect outputs */
-  auto miter = xmg_merge( xmg, xmg_dub );
-  const auto num_outputs = xmg.outputs().size();
-  std::vector<xmg_function> xors( num_outputs );
-  for ( auto i = 0u; i < num_outputs; ++i )
+  /* changes that reach an output or leave the window are observable */
+  for ( auto i = 0u; i < nodes.size(); ++i )
   {
-    xors[i] = miter.create_xor( miter.outputs()[i].first, miter.outputs()[num_outputs + i].first );
+    const auto n = nodes[i];
+    if ( window.changed[i] && ( is_output[n] || window.leaks[n] ) )
+    {
+      const auto* base = sim.node_words( n );
+      const auto* out = window.words.data() + i * num_words;
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        obs[w] |= out[w] ^ base[w];
+      }
+    }
+
+    window.slot[n]  = -1;
+    window.leaks[n] = 0u;
+  }
+}
+
+void xmg_observability_engine::compute_node( xmg_node node, window_t& window, std::uint64_t* obs ) const
+{
+  /* dead nodes have no simulator node and no fanout */
+  if ( is_dead[node] )
+  {
+    std::fill( obs, obs + sim.num_words(), 0u );
+    return;
   }
-  miter.outputs().clear();
-  miter.create_po( miter.create_nary_or( xors ), "miter" );
 
-  return miter;
+  compute( node_to_lit[node] >> 1u, window, obs );
+}
+
+boost::dynamic_bitset<> xmg_observability_engine::to_bitset( const std::uint64_t* words ) const
+{
+  static_assert( sizeof( boost::dynamic_bitset<>::block_type ) == sizeof( std::uint64_t ), "bitset blocks must have 64 bits" );
+
+  boost::dynamic_bitset<> bs( words, words + sim.num_words() );
+  bs.resize( _num_patterns );
+  return bs;
 }
 
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
-bool xmg_is_observable_at_node( const xmg_graph& xmg, xmg_node node, const boost::dynamic_bitset<>& pattern )
+xmg_observability_engine::xmg_observability_engine( const xmg_graph& xmg, unsigned max_levels )
+  : node_to_lit( xmg.size(), 0u ),
+    is_dead( xmg.size(), 0u ),
+    _max_levels( max_levels ),
+    _window( 0u )
+{
+  for ( const auto& input : xmg.inputs() )
+  {
+    node_to_lit[input.first] = sim.create_pi();
+  }
+
+  for ( const auto& node : xmg.nodes() )
+  {
+    is_dead[node] = xmg.is_dead( node );
+  }
+
+  const auto to_lit = [this]( const xmg_function& f ) { return node_to_lit[f.node] ^ static_cast<std::uint32_t>( f.complemented ); };
+
+  for ( const auto& node : xmg.topological_nodes() )
+  {
+    if ( xmg.is_input( node ) ) { continue; }
+
+    const auto children = xmg.children( node );
+    if ( xmg.is_xor( node ) )
+    {
+      node_to_lit[node] = sim.create_xor( to_lit( children[0u] ), to_lit( children[1u] ) );
+    }
+    else
+    {
+      node_to_lit[node] = sim.create_maj( to_lit( children[0u] ), to_lit( children[1u] ), to_lit( children[2u] ) );
+    }
+  }
+
+  for ( const auto& output : xmg.outputs() )
+  {
+    sim.create_po( to_lit( output.first ) );
+  }
+
+  /* levels, fanouts, and outputs */
+  const auto num_nodes  = sim.num_nodes();
+  const auto first_gate = 1u + sim.num_inputs();
+  const auto& gates     = sim.gates();
+
+  levels.assign( num_nodes, 0u );
+  fanout_offset.assign( num_nodes + 1u, 0u );
+  is_output.assign( num_nodes, 0u );
+
+  const auto for_each_fanin = [&gates]( unsigned index, const std::function<void( std::uint32_t )>& f ) {
+    const auto& g = gates[index];
+    const auto arity = g.type == bit_parallel_simulator::gate_type::maj_gate ? 3u : 2u;
+    for ( auto k = 0u; k < arity; ++k )
+    {
+      /* skip repeated fanins */
+      if ( k > 0u && ( g.fanin[k] >> 1u ) == ( g.fanin[k - 1u] >> 1u ) ) { continue; }
+      if ( k == 2u && ( g.fanin[2u] >> 1u ) == ( g.fanin[0u] >> 1u ) ) { continue; }
+      f( g.fanin[k] >> 1u );
+    }
+  };
+
+  for ( auto i = 0u; i < gates.size(); ++i )
+  {
+    for_each_fanin( i, [&]( std::uint32_t n ) {
+        levels[first_gate + i] = std::max( levels[first_gate + i], levels[n] + 1u );
+        ++fanout_offset[n + 1u];
+      } );
+  }
+  for ( auto n = 0u; n < num_nodes; ++n )
+  {
+    fanout_offset[n + 1u] += fanout_offset[n];
+  }
+
+  fanouts.resize( fanout_offset.back() );
+  std::vector<unsigned> pos( fanout_offset.begin(), fanout_offset.end() - 1u );
+  for ( auto i = 0u; i < gates.size(); ++i )
+  {
+    for_each_fanin( i, [&]( std::uint32_t n ) { fanouts[pos[n]++] = first_gate + i; } );
+  }
+
+  for ( auto lit : sim.outputs() )
+  {
+    is_output[lit >> 1u] = 1u;
+  }
+
+  _window = window_t( num_nodes );
+}
+
+void xmg_observability_engine::set_patterns( const std::vector<boost::dynamic_bitset<>>& patterns )
+{
+  _num_patterns = patterns.size();
+  sim.set_num_words( std::max( 1u, ( _num_patterns + 63u ) >> 6u ) );
+
+  for ( auto i = 0u; i < sim.num_inputs(); ++i )
+  {
+    auto* words = sim.input_words( i );
+    for ( auto p = 0u; p < _num_patterns; ++p )
+    {
+      assert( patterns[p].size() == sim.num_inputs() );
+      if ( patterns[p][i] )
+      {
+        words[p >> 6u] |= std::uint64_t( 1u ) << ( p & 63u );
+      }
+    }
+  }
+
+  sim.simulate();
+}
+
+void xmg_observability_engine::set_random_patterns( unsigned num_patterns, std::uint64_t seed )
+{
+  _num_patterns = num_patterns;
+  sim.set_num_words( std::max( 1u, ( _num_patterns + 63u ) >> 6u ) );
+  sim.set_random_inputs( seed );
+  sim.simulate();
+}
+
+boost::dynamic_bitset<> xmg_observability_engine::value( xmg_node node ) const
 {
-  const auto miter = xmg_dont_care_miter( xmg, node );
+  auto bs = to_bitset( sim.node_words( node_to_lit[node] >> 1u ) );
+  if ( node_to_lit[node] & 1u )
+  {
+    bs.flip();
+  }
+  return bs;
+}
+
+boost::dynamic_bitset<> xmg_observability_engine::observability( xmg_node node )
+{
+  std::vector<std::uint64_t> obs( sim.num_words() );
+  compute_node( node, _window, obs.data() );
+  return to_bitset( obs.data() );
+}
 
-  xmg_pattern_simulator sim( pattern );
-  return simulate_xmg_function( miter, miter.outputs().front().first, sim );
+std::vector<boost::dynamic_bitset<>> xmg_observability_engine::observability( const std::vector<xmg_node>& nodes, unsigned num_threads )
+{
+  const auto num_words = sim.num_words();
+  std::vector<boost::dynamic_bitset<>> result( nodes.size() );
+
+  if ( num_threads == 1u )
+  {
+    std::vector<std::uint64_t> obs( num_words );
+    for ( auto i = 0u; i < nodes.size(); ++i )
+    {
+      compute_node( nodes[i], _window, obs.data() );
+      result[i] = to_bitset( obs.data() );
+    }
+    return result;
+  }
+
+  work_stealing_pool pool( num_threads );
+  std::vector<window_t> windows( pool.num_threads() - 1u, window_t( sim.num_nodes() ) );
+  std::vector<std::uint64_t> obs( pool.num_threads() * num_words );
+
+  pool.parallel_for( 0u, nodes.size(), [&]( std::size_t i, unsigned worker ) {
+      auto& window = worker == 0u ? _window : windows[worker - 1u];
+      auto* words = obs.data() + worker * num_words;
+      compute_node( nodes[i], window, words );
+      result[i] = to_bitset( words );
+    } );
+
+  return result;
+}
+
+bool xmg_is_observable_at_node( const xmg_graph& xmg, xmg_node node, const boost::dynamic_bitset<>& pattern )
+{
+  xmg_observability_engine engine( xmg );
+  engine.set_patterns( {pattern} );
+  return engine.observability( node ).test( 0u );
 }
 
 }
@@ -36,13 +36,83 @@
 #ifndef XMG_DONT_CARES_HPP
 #define XMG_DONT_CARES_HPP
 
+#include <cstdint>
+#include <vector>
+
 #include <boost/dynamic_bitset.hpp>
 
+#include <classical/functions/bit_parallel_simulation.hpp>
 #include <classical/xmg/xmg.hpp>
 
 namespace cirkit
 {
 
+/* Observability don't cares for many nodes and patterns
+ *
+ * The XMG is simulated once bit-parallel for all patterns.  The
+ * observability of a node is computed by inverting its value and
+ * re-simulating its transitive fanout, without copying the graph.  Only
+ * gates with a changed fanin are evaluated.
+ *
+ * If max_levels is not 0, the window only contains fanout gates at most
+ * max_levels levels above the node.  A change that leaves the window
+ * counts as observable, so that the result over-approximates observability
+ * (and don't cares are never wrong) at a lower cost.
+ */
+class xmg_observability_engine
+{
+public:
+  explicit xmg_observability_engine( const xmg_graph& xmg, unsigned max_levels = 0u );
+
+  /* each pattern assigns a value to every input (in the order of inputs()) */
+  void set_patterns( const std::vector<boost::dynamic_bitset<>>& patterns );
+  void set_random_patterns( unsigned num_patterns, std::uint64_t seed = 0xcafe );
+
+  inline unsigned num_patterns() const { return _num_patterns; }
+  inline unsigned max_levels() const   { return _max_levels; }
+
+  /* simulated value of node for all patterns */
+  boost::dynamic_bitset<> value( xmg_node node ) const;
+
+  /* bit i is set, if inverting node changes an output for pattern i (never
+     for nodes that are dead after substitution) */
+  boost::dynamic_bitset<> observability( xmg_node node );
+  std::vector<boost::dynamic_bitset<>> observability( const std::vector<xmg_node>& nodes, unsigned num_threads = 1u );
+
+private:
+  /* scratch memory for one window */
+  struct window_t
+  {
+    explicit window_t( unsigned num_nodes ) : slot( num_nodes, -1 ), leaks( num_nodes, 0u ) {}
+
+    std::vector<int>           slot;    /* position of a node in the window, or -1 */
+    std::vector<unsigned char> leaks;   /* node has a fanout outside the window */
+    std::vector<std::uint32_t> nodes;
+    std::vector<unsigned char> changed;
+    std::vector<std::uint64_t> words;   /* values of window nodes after inversion */
+  };
+
+  void compute( std::uint32_t root, window_t& window, std::uint64_t* obs ) const;
+  void compute_node( xmg_node node, window_t& window, std::uint64_t* obs ) const;
+  boost::dynamic_bitset<> to_bitset( const std::uint64_t* words ) const;
+
+private:
+  bit_parallel_simulator     sim;
+  std::vector<std::uint32_t> node_to_lit;
+  std::vector<unsigned char> is_dead;
+
+  /* fanouts in CSR format, levels, and output flags of simulator nodes */
+  std::vector<unsigned>      fanout_offset;
+  std::vector<std::uint32_t> fanouts;
+  std::vector<unsigned>      levels;
+  std::vector<unsigned char> is_output;
+
+  unsigned                   _max_levels;
+  unsigned                   _num_patterns = 0u;
+
+  window_t                   _window;
+};
+
 /* checks whether `pattern` is a don't care at `node`, meaning that by inverting node, one does not see a difference at the output */
 bool xmg_is_observable_at_node( const xmg_graph& xmg, xmg_node node, const boost::dynamic_bitset<>& pattern );
 
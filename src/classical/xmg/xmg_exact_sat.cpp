@@ -0,0 +1,623 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "xmg_exact_sat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include <core/utils/timer.hpp>
+#include <core/utils/work_stealing_pool.hpp>
+#include <classical/abc/abc_api.hpp>
+#include <classical/functions/npn_canonization.hpp>
+#include <sat/glucose/AbcGlucose.h>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+struct xmg_exact_encoding
+{
+  std::string name;
+  bool        incremental; /* one solver for all gate counts */
+  bool        colex;       /* order gates by their largest fanin */
+};
+
+const std::vector<xmg_exact_encoding> xmg_exact_portfolio = {
+  {"incremental",        true,  true},
+  {"incremental-nocolex", true, false},
+  {"explicit",           false, true}
+};
+
+/* state shared by all encodings of a portfolio */
+struct xmg_exact_race
+{
+  std::mutex                 mutex;
+  std::atomic<unsigned>      lower{1u};      /* smaller gate counts are not searched */
+  unsigned                   proven = 1u;    /* smaller gate counts are proven infeasible (guarded by mutex) */
+  std::atomic<bool>          done{false};
+  int                        stop = 0;       /* polled by the SAT solvers */
+  boost::optional<xmg_graph> result;
+  unsigned                   size = 0u;
+  unsigned                   encoding = 0u;
+};
+
+/* Nodes are numbered such that 0 is the constant, 1 to n are the inputs, and
+ * gate i is node n + 1 + i.  Gate values for minterm 0 are not encoded, since
+ * they are always 0 due to the normalization of complemented edges; the
+ * output is complemented if the function is 1 for minterm 0. */
+class xmg_exact_instance
+{
+public:
+  xmg_exact_instance( const tt& spec, bool with_xor, bool colex, int* stop, const boost::optional<unsigned>& timeout )
+    : spec( spec ),
+      num_vars( tt_num_vars( spec ) ),
+      num_minterms( 1u << num_vars ),
+      with_xor( with_xor ),
+      colex( colex )
+  {
+    solver = abc::bmcg_sat_solver_start();
+    abc::bmcg_sat_solver_set_stop( solver, stop );
+    if ( (bool)timeout )
+    {
+      abc::bmcg_sat_solver_set_runtime_limit( solver, abc::Abc_Clock() + static_cast<abc::abctime>( *timeout ) * CLOCKS_PER_SEC );
+    }
+  }
+
+  ~xmg_exact_instance()
+  {
+    abc::bmcg_sat_solver_stop( solver );
+  }
+
+  xmg_exact_instance( const xmg_exact_instance& ) = delete;
+  xmg_exact_instance& operator=( const xmg_exact_instance& ) = delete;
+
+  /* returns GLUCOSE_SAT, GLUCOSE_UNSAT, or GLUCOSE_UNDEC (timeout or stopped) */
+  int solve( unsigned num_gates )
+  {
+    while ( gates.size() < num_gates )
+    {
+      add_gate();
+    }
+
+    int activation = activate( num_gates );
+    if ( !okay )
+    {
+      return GLUCOSE_UNSAT;
+    }
+
+    const auto result = abc::bmcg_sat_solver_solve( solver, &activation, 1 );
+
+    /* the gate count is never activated again */
+    if ( result == GLUCOSE_UNSAT )
+    {
+      add_clause( {abc::Abc_LitNot( activation )} );
+    }
+
+    return result;
+  }
+
+  xmg_graph extract( unsigned num_gates, const std::string& model_name, const std::string& output_name ) const
+  {
+    xmg_graph xmg( model_name );
+
+    std::vector<xmg_function> nodes;
+    nodes.push_back( xmg.get_constant( false ) );
+    for ( auto j = 0u; j < num_vars; ++j )
+    {
+      nodes.push_back( xmg.create_pi( boost::str( boost::format( "x%d" ) % j ) ) );
+    }
+
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+      const auto& g = gates[i];
+
+      std::array<xmg_function, 3u> fanins;
+      for ( auto k = 0u; k < 3u; ++k )
+      {
+        for ( auto j = 0u; j < g.select[k].size(); ++j )
+        {
+          if ( value( g.select[k][j] ) )
+          {
+            fanins[k] = nodes[j] ^ value( g.polarity[k] );
+            break;
+          }
+        }
+      }
+
+      if ( with_xor && value( g.type ) )
+      {
+        nodes.push_back( xmg.create_xor( fanins[0], fanins[1] ) );
+      }
+      else
+      {
+        nodes.push_back( xmg.create_maj( fanins[0], fanins[1], fanins[2] ) );
+      }
+    }
+
+    xmg.create_po( nodes.back() ^ spec[0u], output_name );
+
+    return xmg;
+  }
+
+private:
+  struct gate_vars
+  {
+    std::array<std::vector<int>, 3u> select;   /* one variable per node */
+    std::array<int, 3u>              polarity;
+    int                              type = 0; /* XOR if true */
+    std::array<std::vector<int>, 3u> operand;  /* operand values for minterms 1, 2, ... */
+    std::vector<int>                 output;   /* gate values for minterms 1, 2, ... */
+  };
+
+  inline int new_var()
+  {
+    return var_index++;
+  }
+
+  inline int lit( int var, bool complemented = false ) const
+  {
+    return abc::Abc_Var2Lit( var, complemented ? 1 : 0 );
+  }
+
+  inline bool value( int var ) const
+  {
+    return abc::bmcg_sat_solver_read_cex_varvalue( solver, var ) == 1;
+  }
+
+  void add_clause( std::vector<int> lits )
+  {
+    if ( okay && !abc::bmcg_sat_solver_addclause( solver, &lits[0], lits.size() ) )
+    {
+      okay = false;
+    }
+  }
+
+  /* the clause holds for MAJ gates only */
+  void add_maj_clause( const gate_vars& g, std::vector<int> lits )
+  {
+    if ( with_xor )
+    {
+      lits.push_back( lit( g.type ) );
+    }
+    add_clause( lits );
+  }
+
+  /* the clause holds for XOR gates only */
+  void add_xor_clause( const gate_vars& g, std::vector<int> lits )
+  {
+    if ( with_xor )
+    {
+      lits.push_back( lit( g.type, true ) );
+      add_clause( lits );
+    }
+  }
+
+  /* select variable for the largest fanin of g */
+  void add_key_clauses( const gate_vars& prev, const gate_vars& g )
+  {
+    const auto prev_nodes = prev.select[0u].size();
+
+    for ( auto j = 1u; j < prev_nodes; ++j )
+    {
+      for ( auto jj = 0u; jj < j; ++jj )
+      {
+        if ( !with_xor )
+        {
+          add_clause( {lit( prev.select[2u][j], true ), lit( g.select[2u][jj], true )} );
+          continue;
+        }
+
+        for ( auto t1 = 0u; t1 < 2u; ++t1 )
+        {
+          for ( auto t2 = 0u; t2 < 2u; ++t2 )
+          {
+            add_clause( {lit( prev.type, t1 == 1u ), lit( prev.select[t1 == 1u ? 1u : 2u][j], true ),
+                         lit( g.type, t2 == 1u ), lit( g.select[t2 == 1u ? 1u : 2u][jj], true )} );
+          }
+        }
+      }
+    }
+  }
+
+  void add_gate()
+  {
+    const auto i = gates.size();
+    const auto num_nodes = 1u + num_vars + i;
+
+    gate_vars g;
+    for ( auto k = 0u; k < 3u; ++k )
+    {
+      g.select[k].resize( num_nodes );
+      std::generate( g.select[k].begin(), g.select[k].end(), [this]() { return new_var(); } );
+      g.polarity[k] = new_var();
+      g.operand[k].resize( num_minterms - 1u );
+      std::generate( g.operand[k].begin(), g.operand[k].end(), [this]() { return new_var(); } );
+    }
+    if ( with_xor )
+    {
+      g.type = new_var();
+    }
+    g.output.resize( num_minterms - 1u );
+    std::generate( g.output.begin(), g.output.end(), [this]() { return new_var(); } );
+    abc::bmcg_sat_solver_set_nvars( solver, var_index );
+
+    /* exactly one fanin per operand */
+    for ( auto k = 0u; k < 3u; ++k )
+    {
+      std::vector<int> lits;
+      for ( auto j = 0u; j < num_nodes; ++j )
+      {
+        lits.push_back( lit( g.select[k][j] ) );
+        for ( auto jj = 0u; jj < j; ++jj )
+        {
+          add_clause( {lit( g.select[k][jj], true ), lit( g.select[k][j], true )} );
+        }
+      }
+      add_clause( lits );
+    }
+
+    /* fanins are strictly ordered (the third operand of an XOR is unused) */
+    for ( auto j = 0u; j < num_nodes; ++j )
+    {
+      for ( auto jj = 0u; jj <= j; ++jj )
+      {
+        add_clause( {lit( g.select[0u][j], true ), lit( g.select[1u][jj], true )} );
+        add_maj_clause( g, {lit( g.select[1u][j], true ), lit( g.select[2u][jj], true )} );
+      }
+    }
+
+    /* MAJ has at most one complemented operand */
+    add_maj_clause( g, {lit( g.polarity[0u], true ), lit( g.polarity[1u], true )} );
+    add_maj_clause( g, {lit( g.polarity[0u], true ), lit( g.polarity[2u], true )} );
+    add_maj_clause( g, {lit( g.polarity[1u], true ), lit( g.polarity[2u], true )} );
+
+    /* XOR has no constant and no complemented operands, the third operand is fixed */
+    add_xor_clause( g, {lit( g.select[0u][0u], true )} );
+    add_xor_clause( g, {lit( g.select[2u][0u] )} );
+    for ( auto k = 0u; k < 3u; ++k )
+    {
+      add_xor_clause( g, {lit( g.polarity[k], true )} );
+    }
+
+    /* gates are ordered by their largest fanin */
+    if ( colex && i > 0u )
+    {
+      add_key_clauses( gates.back(), g );
+    }
+
+    /* semantics */
+    for ( auto t = 1u; t < num_minterms; ++t )
+    {
+      for ( auto k = 0u; k < 3u; ++k )
+      {
+        const auto op = g.operand[k][t - 1u];
+        const auto s = [&]( unsigned j ) { return lit( g.select[k][j], true ); };
+        const auto p = lit( g.polarity[k] );
+        const auto np = lit( g.polarity[k], true );
+
+        for ( auto j = 0u; j < num_nodes; ++j )
+        {
+          if ( j <= num_vars )
+          {
+            const auto c = j > 0u && ( ( t >> ( j - 1u ) ) & 1u );
+            add_clause( {s( j ), p, lit( op, !c )} );
+            add_clause( {s( j ), np, lit( op, c )} );
+          }
+          else
+          {
+            const auto v = gates[j - num_vars - 1u].output[t - 1u];
+            add_clause( {s( j ), p, lit( v, true ), lit( op )} );
+            add_clause( {s( j ), p, lit( v ), lit( op, true )} );
+            add_clause( {s( j ), np, lit( v, true ), lit( op, true )} );
+            add_clause( {s( j ), np, lit( v ), lit( op )} );
+          }
+        }
+      }
+
+      const auto o0 = g.operand[0u][t - 1u];
+      const auto o1 = g.operand[1u][t - 1u];
+      const auto o2 = g.operand[2u][t - 1u];
+      const auto x  = g.output[t - 1u];
+
+      add_maj_clause( g, {lit( o0, true ), lit( o1, true ), lit( x )} );
+      add_maj_clause( g, {lit( o0, true ), lit( o2, true ), lit( x )} );
+      add_maj_clause( g, {lit( o1, true ), lit( o2, true ), lit( x )} );
+      add_maj_clause( g, {lit( o0 ), lit( o1 ), lit( x, true )} );
+      add_maj_clause( g, {lit( o0 ), lit( o2 ), lit( x, true )} );
+      add_maj_clause( g, {lit( o1 ), lit( o2 ), lit( x, true )} );
+
+      add_xor_clause( g, {lit( o0, true ), lit( o1, true ), lit( x, true )} );
+      add_xor_clause( g, {lit( o0 ), lit( o1 ), lit( x, true )} );
+      add_xor_clause( g, {lit( o0, true ), lit( o1 ), lit( x )} );
+      add_xor_clause( g, {lit( o0 ), lit( o1, true ), lit( x )} );
+    }
+
+    gates.push_back( g );
+  }
+
+  /* returns the literal that activates a realization with num_gates gates */
+  int activate( unsigned num_gates )
+  {
+    const auto a = new_var();
+    abc::bmcg_sat_solver_set_nvars( solver, var_index );
+
+    /* the last gate realizes the function */
+    const auto& last = gates[num_gates - 1u];
+    for ( auto t = 1u; t < num_minterms; ++t )
+    {
+      add_clause( {lit( a, true ), lit( last.output[t - 1u], spec[t] == spec[0u] )} );
+    }
+
+    /* every other gate is used by some later gate */
+    for ( auto i = 0u; i + 1u < num_gates; ++i )
+    {
+      std::vector<int> lits{lit( a, true )};
+      for ( auto ii = i + 1u; ii < num_gates; ++ii )
+      {
+        for ( auto k = 0u; k < 3u; ++k )
+        {
+          lits.push_back( lit( gates[ii].select[k][1u + num_vars + i] ) );
+        }
+      }
+      add_clause( lits );
+    }
+
+    return lit( a );
+  }
+
+private:
+  const tt&              spec;
+  unsigned               num_vars;
+  unsigned               num_minterms;
+  bool                   with_xor;
+  bool                   colex;
+
+  abc::bmcg_sat_solver*  solver;
+  int                    var_index = 1;
+  bool                   okay = true;
+  std::vector<gate_vars> gates;
+};
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* constants and literals need no gates */
+boost::optional<xmg_graph> xmg_exact_trivial( const tt& spec, unsigned num_vars, const std::string& model_name, const std::string& output_name )
+{
+  const auto num_minterms = 1u << num_vars;
+
+  for ( auto v = 0u; v <= num_vars; ++v )
+  {
+    auto matches = true;
+    for ( auto t = 1u; t < num_minterms && matches; ++t )
+    {
+      matches = ( spec[t] != spec[0u] ) == ( v > 0u && ( ( t >> ( v - 1u ) ) & 1u ) );
+    }
+
+    if ( matches )
+    {
+      xmg_graph xmg( model_name );
+      std::vector<xmg_function> inputs;
+      for ( auto j = 0u; j < num_vars; ++j )
+      {
+        inputs.push_back( xmg.create_pi( boost::str( boost::format( "x%d" ) % j ) ) );
+      }
+      xmg.create_po( ( v == 0u ? xmg.get_constant( false ) : inputs[v - 1u] ) ^ spec[0u], output_name );
+      return xmg;
+    }
+  }
+
+  return boost::none;
+}
+
+std::string xmg_exact_npn_class( const tt& spec )
+{
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned> perm;
+
+  if ( tt_num_vars( spec ) <= 5u )
+  {
+    return tt_to_hex( exact_npn_canonization( spec, phase, perm ) );
+  }
+  else
+  {
+    return tt_to_hex( npn_canonization_lucky( spec, phase, perm ) );
+  }
+}
+
+void xmg_exact_run_encoding( const tt& spec, unsigned index, bool with_xor, unsigned stop, const boost::optional<unsigned>& timeout,
+                             const std::string& model_name, const std::string& output_name, bool verbose, xmg_exact_race& race )
+{
+  const auto& encoding = xmg_exact_portfolio[index];
+
+  std::unique_ptr<xmg_exact_instance> inst;
+  auto r = race.lower.load();
+
+  while ( r <= stop && !race.done )
+  {
+    if ( !inst || !encoding.incremental )
+    {
+      inst.reset( new xmg_exact_instance( spec, with_xor, encoding.colex, &race.stop, timeout ) );
+    }
+
+    if ( verbose )
+    {
+      std::lock_guard<std::mutex> lock( race.mutex );
+      std::cout << boost::format( "[i] [%s] check for realization with %d gates" ) % encoding.name % r << std::endl;
+    }
+
+    const auto result = inst->solve( r );
+
+    if ( result == GLUCOSE_SAT )
+    {
+      std::lock_guard<std::mutex> lock( race.mutex );
+      if ( !race.done )
+      {
+        race.result = inst->extract( r, model_name, output_name );
+        race.size = r;
+        race.encoding = index;
+        race.done = true;
+        race.stop = 1;
+      }
+      return;
+    }
+    else if ( result == GLUCOSE_UNSAT )
+    {
+      /* other encodings skip this gate count as well; the bound is only
+         proven if all smaller gate counts are infeasible */
+      {
+        std::lock_guard<std::mutex> lock( race.mutex );
+        if ( r <= race.proven )
+        {
+          race.proven = std::max( race.proven, r + 1u );
+        }
+      }
+      auto lower = race.lower.load();
+      while ( lower < r + 1u && !race.lower.compare_exchange_weak( lower, r + 1u ) ) {}
+      r = std::max( r + 1u, race.lower.load() );
+    }
+    else
+    {
+      return;
+    }
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+unsigned xmg_exact_bounds::lower_bound( const std::string& npn_class, bool with_xor ) const
+{
+  std::lock_guard<std::mutex> lock( mutex );
+
+  const auto& m = bounds[with_xor ? 1u : 0u];
+  const auto it = m.find( npn_class );
+  return it == m.end() ? 1u : it->second;
+}
+
+void xmg_exact_bounds::update( const std::string& npn_class, bool with_xor, unsigned bound )
+{
+  std::lock_guard<std::mutex> lock( mutex );
+
+  auto& b = bounds[with_xor ? 1u : 0u][npn_class];
+  b = std::max( b, bound );
+}
+
+unsigned xmg_exact_bounds::size() const
+{
+  std::lock_guard<std::mutex> lock( mutex );
+  return bounds[0u].size() + bounds[1u].size();
+}
+
+boost::optional<xmg_graph> xmg_exact_sat( const tt& spec,
+                                          const properties::ptr& settings,
+                                          const properties::ptr& statistics )
+{
+  /* settings */
+  const auto with_xor    = get( settings, "with_xor",    true );
+  const auto start       = get( settings, "start",       1u );
+  const auto stop        = get( settings, "stop",        32u );
+  const auto timeout     = get( settings, "timeout",     boost::optional<unsigned>() );
+  const auto portfolio   = get( settings, "portfolio",   1u );
+  const auto bounds      = get( settings, "bounds",      xmg_exact_bounds::ptr() );
+  const auto model_name  = get( settings, "model_name",  std::string( "exact" ) );
+  const auto output_name = get( settings, "output_name", std::string( "f" ) );
+  const auto verbose     = get( settings, "verbose",     false );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  assert( !spec.empty() );
+
+  const auto num_vars = tt_num_vars( spec );
+
+  if ( const auto triv = xmg_exact_trivial( spec, num_vars, model_name, output_name ) )
+  {
+    set( statistics, "last_size", 0u );
+    return triv;
+  }
+
+  /* start from the best known lower bound; a larger start value is not
+     proven (e.g., after a timeout) and is therefore not cached */
+  xmg_exact_race race;
+  race.lower = std::max( start, 1u );
+
+  std::string npn_class;
+  if ( bounds )
+  {
+    npn_class = xmg_exact_npn_class( spec );
+    race.proven = bounds->lower_bound( npn_class, with_xor );
+    race.lower = std::max( race.lower.load(), race.proven );
+  }
+
+  const auto num_encodings = std::max<unsigned>( 1u, std::min<unsigned>( portfolio, xmg_exact_portfolio.size() ) );
+  if ( num_encodings == 1u )
+  {
+    xmg_exact_run_encoding( spec, 0u, with_xor, stop, timeout, model_name, output_name, verbose, race );
+  }
+  else
+  {
+    work_stealing_pool pool( num_encodings );
+    pool.parallel_for( 0u, num_encodings, [&]( std::size_t i, unsigned ) {
+        xmg_exact_run_encoding( spec, i, with_xor, stop, timeout, model_name, output_name, verbose, race );
+      } );
+  }
+
+  if ( bounds )
+  {
+    bounds->update( npn_class, with_xor, race.proven );
+  }
+
+  set( statistics, "last_size", race.result ? race.size : race.lower.load() );
+  set( statistics, "encoding", race.result ? xmg_exact_portfolio[race.encoding].name : std::string() );
+
+  if ( verbose && race.result )
+  {
+    std::cout << boost::format( "[i] found realization with %d gates using %s encoding" ) % race.size % xmg_exact_portfolio[race.encoding].name << std::endl;
+  }
+
+  return race.result;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
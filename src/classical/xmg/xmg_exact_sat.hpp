@@ -0,0 +1,130 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file xmg_exact_sat.hpp
+ *
+ * @brief Exact XMG synthesis with an incremental SAT encoding
+ *
+ * The encoding uses the bmcg SAT solver (glucose in ABC), as
+ * xmg_exact_decomposition does.  Gate counts are activated by assumptions,
+ * hence one solver instance (including its learned clauses) is used for all
+ * gate counts.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef XMG_EXACT_SAT_HPP
+#define XMG_EXACT_SAT_HPP
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
+
+#include <core/properties.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg.hpp>
+
+namespace cirkit
+{
+
+/* proven lower bounds on the number of gates per NPN class, which can be shared
+   by calls for related functions (e.g., when mining optimum XMGs); bounds for
+   XMGs and MIGs (with_xor) are kept apart; all methods are thread-safe */
+class xmg_exact_bounds
+{
+public:
+  using ptr = std::shared_ptr<xmg_exact_bounds>;
+
+  /* 1 if nothing is known about npn_class */
+  unsigned lower_bound( const std::string& npn_class, bool with_xor ) const;
+
+  /* bounds never decrease */
+  void update( const std::string& npn_class, bool with_xor, unsigned bound );
+
+  unsigned size() const;
+
+private:
+  mutable std::mutex                        mutex;
+  std::unordered_map<std::string, unsigned> bounds[2];
+};
+
+/**
+ * @brief Finds an XMG (or MIG) with the minimum number of gates
+ *
+ * The encoding breaks symmetries by ordering the fanins of each gate,
+ * normalizing the complemented edges (at most one for MAJ, none for XOR),
+ * requiring that every gate is used, and ordering gates by their largest
+ * fanin (co-lexicographic order).
+ *
+ * If portfolio is larger than 1, several encodings are raced on a thread
+ * pool.  They share the lower bound, i.e., if one of them proves that there
+ * is no solution with r gates, all of them continue with r + 1 gates, and
+ * the first solution is returned.
+ *
+ * @settings
+ *
+   |-------------+--------------------------------------------------+-----------------------------|
+   | Settings    | Description                                      | Default                     |
+   |-------------+--------------------------------------------------+-----------------------------|
+   | with_xor    | Allow XOR gates                                  | true                        |
+   | start       | Initial number of gates                          | 1u                          |
+   | stop        | Maximum number of gates                          | 32u                         |
+   | timeout     | Timeout in seconds for each solver instance      | boost::optional<unsigned>() |
+   | portfolio   | Number of encodings that are raced (at most 3)   | 1u                          |
+   | bounds      | Cache of proven lower bounds per NPN class       | xmg_exact_bounds::ptr()     |
+   | model_name  | Name of the XMG model                            | std::string( "exact" )      |
+   | output_name | Name of the output                               | std::string( "f" )          |
+   | verbose     | Be verbose                                       | false                       |
+   |-------------+--------------------------------------------------+-----------------------------|
+ *
+ * @statistics
+ *
+   |-------------+---------------------------------------------------------|
+   | Statistics  | Description                                             |
+   |-------------+---------------------------------------------------------|
+   | runtime     | Runtime in seconds                                      |
+   | last_size   | Smallest number of gates that has not been ruled out    |
+   | encoding    | Name of the encoding that found the solution            |
+   |-------------+---------------------------------------------------------|
+ */
+boost::optional<xmg_graph> xmg_exact_sat( const tt& spec,
+                                          const properties::ptr& settings = properties::ptr(),
+                                          const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -47,7 +47,8 @@ xmg_graph xmg_extract( const xmg_graph& xmg, xmg_node root, const std::vector<xm
 
   xmg_graph xcut;
 
-  prefill_func_t prefill = [leaves]( xmg_graph& xcut, std::map<xmg_node, xmg_function>& old_to_new ) {
+  xmg_rewrite_params params;
+  params.prefill = [&leaves]( xmg_graph& xcut, std::map<xmg_node, xmg_function>& old_to_new ) {
     auto i = 0u;
     for ( auto leaf : leaves ) {
       old_to_new[leaf] = xcut.create_pi( boost::str( boost::format( "x%d" ) % i ) );
@@ -55,10 +56,8 @@ xmg_graph xmg_extract( const xmg_graph& xmg, xmg_node root, const std::vector<xm
     }
   };
 
-  auto settings = std::make_shared<properties>();
-  settings->set( "prefill", prefill );
-
-  const auto o = xmg_rewrite_top_down_inplace( xcut, xmg_copy, rewrite_default_maj, rewrite_default_xor, {}, settings ).front();
+  xmg_rewrite_stats stats;
+  const auto o = xmg_rewrite_top_down_inplace( xcut, xmg_copy, rewrite_default_maj, rewrite_default_xor, {}, params, stats ).front();
   xcut.create_po( o, "o" );
 
   return xcut;
@@ -71,6 +71,8 @@ private:
 
   /* settings */
   unsigned cut_size;
+  bool     parallel_cuts;
+  unsigned num_threads;
   bool     progress;
   bool     verbose;
 };
@@ -80,9 +82,11 @@ xmg_flow_map_manager::xmg_flow_map_manager( xmg_graph& xmg, const properties::pt
     node_to_cut( xmg.size() ),
     node_to_level( xmg.size() )
 {
-  cut_size = get( settings, "cut_size", 4u );
-  progress = get( settings, "progress", false );
-  verbose  = get( settings, "verbose",  false );
+  cut_size      = get( settings, "cut_size",      4u );
+  parallel_cuts = get( settings, "parallel_cuts", false );
+  num_threads   = get( settings, "num_threads",   0u );
+  progress      = get( settings, "progress",      false );
+  verbose       = get( settings, "verbose",       false );
 }
 
 void xmg_flow_map_manager::run()
@@ -90,9 +94,13 @@ void xmg_flow_map_manager::run()
   /* compute cuts */
   auto cuts_settings = std::make_shared<properties>();
   cuts_settings->set( "progress", progress );
+  cuts_settings->set( "parallel", parallel_cuts );
+  cuts_settings->set( "num_threads", num_threads );
 
-  cuts = std::make_shared<xmg_cuts_paged>( xmg, cut_size, cuts_settings );
-  LN( boost::format( "[i] enumerated %d cuts in %.2f secs" ) % cuts->total_cut_count() % cuts->enumeration_time() );
+  auto cuts_statistics = std::make_shared<properties>();
+
+  cuts = std::make_shared<xmg_cuts_paged>( xmg, cut_size, cuts_settings, cuts_statistics );
+  LN( boost::format( "[i] enumerated %d cuts in %.2f secs (%.0f cuts/sec)" ) % cuts->total_cut_count() % cuts->enumeration_time() % cuts_statistics->get<double>( "cuts_per_second" ) );
 
   find_best_cuts();
   extract_cover();
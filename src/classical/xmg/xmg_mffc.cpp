@@ -123,66 +123,6 @@ private:
  * Private functions                                                          *
  ******************************************************************************/
 
-/* inspired by: https://bitbucket.org/alanmi/abc/src/9f0e7e81524337aeebec196723c23915c7354982/src/aig/gia/giaMffc.c?at=default&fileviewer=file-view-default */
-
-unsigned xmg_mffc_node_deref( xmg_graph& xmg, xmg_node n )
-{
-  auto counter = 0u;
-
-  if ( xmg.is_input( n ) )
-  {
-    return 0;
-  }
-
-  for ( auto child : xmg.children( n ) )
-  {
-    assert( xmg.get_ref( child.node ) > 0u );
-    if ( xmg.dec_ref( child.node ) == 0u )
-    {
-      counter += xmg_mffc_node_deref( xmg, child.node );
-    }
-  }
-
-  return counter + 1u;
-}
-
-unsigned xmg_mffc_node_ref( xmg_graph& xmg, xmg_node n )
-{
-  auto counter = 0u;
-
-  if ( xmg.is_input( n ) )
-  {
-    return 0;
-  }
-
-  for ( auto child : xmg.children( n ) )
-  {
-    if ( xmg.inc_ref( child.node ) == 0u )
-    {
-      counter += xmg_mffc_node_ref( xmg, child.node );
-    }
-  }
-
-  return counter + 1u;
-}
-
-void xmg_mffc_node_collect( xmg_graph& xmg, xmg_node n, std::vector<xmg_node>& support )
-{
-  if ( xmg.bitmarks().is_marked( n ) ) return;
-  xmg.bitmarks().mark( n );
-
-  if ( xmg.get_ref( n ) > 0u || xmg.is_input( n ) )
-  {
-    support.push_back( n );
-    return;
-  }
-
-  for ( const auto& child : xmg.children( n ) )
-  {
-    xmg_mffc_node_collect( xmg, child.node, support );
-  }
-}
-
 void xmg_mffc_mark_recurse( xmg_graph& xmg, xmg_node curr, const std::vector<xmg_node>& support )
 {
   if ( xmg.bitmarks().is_marked( curr ) ) return;
@@ -207,22 +147,7 @@ void xmg_mffc_mark_recurse( xmg_graph& xmg, xmg_node curr, const std::vector<xmg
 
 unsigned xmg_compute_mffc( xmg_graph& xmg, xmg_node n, std::vector<xmg_node>& support )
 {
-  assert( !xmg.is_input( n ) );
-
-  xmg.init_refs();
-  xmg.inc_output_refs();
-  xmg.bitmarks().init_marks( xmg.size() );
-
-  const auto size1 = xmg_mffc_node_deref( xmg, n );
-  for ( const auto& child : xmg.children( n ) )
-  {
-    xmg_mffc_node_collect( xmg, child.node, support );
-  }
-  const auto size2 = xmg_mffc_node_ref( xmg, n );
-
-  assert( size1 == size2 );
-
-  return size1;
+  return xmg.compute_mffc( n, support );
 }
 
 std::map<xmg_node, std::vector<xmg_node>> xmg_mffcs( xmg_graph& xmg )
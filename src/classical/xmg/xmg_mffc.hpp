@@ -44,6 +44,7 @@
 namespace cirkit
 {
 
+/* see xmg_graph::compute_mffc, support are the leafs of the MFFC */
 unsigned xmg_compute_mffc( xmg_graph& xmg, xmg_node n, std::vector<xmg_node>& support );
 std::map<xmg_node, std::vector<xmg_node>> xmg_mffcs( xmg_graph& xmg );
 
@@ -27,6 +27,7 @@
 #include "xmg_rewrite.hpp"
 
 #include <classical/xmg/xmg_bitmarks.hpp>
+#include <classical/xmg/xmg_utils.hpp>
 
 #include <core/utils/range_utils.hpp>
 #include <core/utils/timer.hpp>
@@ -151,64 +152,67 @@ xmg_function rewrite_default_xor( xmg_graph& xmg_new, const xmg_function& a, con
 xmg_graph xmg_rewrite_top_down( const xmg_graph& xmg,
                                 const maj_rewrite_func_t& on_maj,
                                 const xor_rewrite_func_t& on_xor,
-                                const properties::ptr& settings,
-                                const properties::ptr& statistics )
+                                const xmg_rewrite_params& params,
+                                xmg_rewrite_stats& stats )
 {
-  /* settings */
-  const auto prefill       = get( settings, "prefill",       prefill_func_t() );
-  const auto init          = get( settings, "init",          xmg_init_func_t() );
-  const auto substitutes   = get( settings, "substitutes",   xmg_substitutes_map_t() );
-  const auto keep_bitmarks = get( settings, "keep_bitmarks", true );
-
-  /* statistics */
-  properties_timer t( statistics );
+  reference_timer t( &stats.runtime );
 
   xmg_graph xmg_new( xmg.name() );
 
   /* init */
-  if ( init )
+  if ( params.init )
   {
-    init( xmg_new );
+    params.init( xmg_new );
   }
 
-  if ( keep_bitmarks && xmg.bitmarks().num_layers() > 0u )
+  if ( params.keep_bitmarks && xmg.bitmarks().num_layers() > 0u )
   {
     xmg_new.bitmarks().init_marks( 0u, xmg.bitmarks().num_layers() );
     xmg_new.bitmarks().set_used( xmg.bitmarks().get_used() );
   }
 
   /* create constant and PIs */
-  auto old_to_new = init_visited_table( xmg, xmg_new, keep_bitmarks );
+  auto old_to_new = init_visited_table( xmg, xmg_new, params.keep_bitmarks );
 
   /* prefill */
-  if ( prefill )
+  if ( params.prefill )
   {
-    prefill( xmg_new, old_to_new );
+    params.prefill( xmg_new, old_to_new );
   }
 
   /* map nodes */
   for ( const auto& po : xmg.outputs() )
   {
-    xmg_new.create_po( xmg_rewrite_top_down_rec( xmg, po.first.node, xmg_new, on_maj, on_xor, old_to_new, substitutes, keep_bitmarks ) ^ po.first.complemented, po.second );
+    xmg_new.create_po( xmg_rewrite_top_down_rec( xmg, po.first.node, xmg_new, on_maj, on_xor, old_to_new, params.substitutes, params.keep_bitmarks ) ^ po.first.complemented, po.second );
   }
 
   return xmg_new;
 }
 
+xmg_graph xmg_rewrite_top_down( const xmg_graph& xmg,
+                                const maj_rewrite_func_t& on_maj,
+                                const xor_rewrite_func_t& on_xor,
+                                const properties::ptr& settings,
+                                const properties::ptr& statistics )
+{
+  xmg_rewrite_stats stats;
+  const auto xmg_new = xmg_rewrite_top_down( xmg, on_maj, on_xor, from_properties<xmg_rewrite_params>( settings ), stats );
+
+  to_properties( stats, statistics );
+  xmg_strash_statistics( xmg_new, statistics );
+
+  return xmg_new;
+}
+
 std::vector<xmg_function> xmg_rewrite_top_down_inplace( xmg_graph& dest,
                                                         const xmg_graph& xmg,
                                                         const maj_rewrite_func_t& on_maj,
                                                         const xor_rewrite_func_t& on_xor,
                                                         const std::vector<xmg_function>& pi_mapping,
-                                                        const properties::ptr& settings,
-                                                        const properties::ptr& statistics )
+                                                        const xmg_rewrite_params& params,
+                                                        xmg_rewrite_stats& stats )
 {
-  /* settings */
-  const auto prefill =       get( settings, "prefill",       prefill_func_t() );
-  const auto keep_bitmarks = get( settings, "keep_bitmarks", true );
-
-  /* statistics */
-  properties_timer t( statistics );
+  reference_timer t( &stats.runtime );
 
   /* create constant and PIs */
   std::map<xmg_node, xmg_function> old_to_new;
@@ -223,21 +227,36 @@ std::vector<xmg_function> xmg_rewrite_top_down_inplace( xmg_graph& dest,
   }
 
   /* prefill */
-  if ( prefill )
+  if ( params.prefill )
   {
-    prefill( dest, old_to_new );
+    params.prefill( dest, old_to_new );
   }
 
   /* map nodes */
   std::vector<xmg_function> outputs;
   for ( const auto& po : xmg.outputs() )
   {
-    outputs.push_back( xmg_rewrite_top_down_rec( xmg, po.first.node, dest, on_maj, on_xor, old_to_new, boost::none, keep_bitmarks ) ^ po.first.complemented );
+    outputs.push_back( xmg_rewrite_top_down_rec( xmg, po.first.node, dest, on_maj, on_xor, old_to_new, boost::none, params.keep_bitmarks ) ^ po.first.complemented );
   }
 
   return outputs;
 }
 
+std::vector<xmg_function> xmg_rewrite_top_down_inplace( xmg_graph& dest,
+                                                        const xmg_graph& xmg,
+                                                        const maj_rewrite_func_t& on_maj,
+                                                        const xor_rewrite_func_t& on_xor,
+                                                        const std::vector<xmg_function>& pi_mapping,
+                                                        const properties::ptr& settings,
+                                                        const properties::ptr& statistics )
+{
+  xmg_rewrite_stats stats;
+  const auto outputs = xmg_rewrite_top_down_inplace( dest, xmg, on_maj, on_xor, pi_mapping, from_properties<xmg_rewrite_params>( settings ), stats );
+  to_properties( stats, statistics );
+
+  return outputs;
+}
+
 xmg_graph xmg_rewrite_bottom_up( const xmg_graph& xmg,
                                  const maj_rewrite_func_t& on_maj,
                                  const xor_rewrite_func_t& on_xor,
@@ -299,6 +318,8 @@ xmg_graph xmg_rewrite_bottom_up( const xmg_graph& xmg,
     xmg_new.create_po( old_to_new[po.first.node] ^ po.first.complemented, po.second );
   }
 
+  xmg_strash_statistics( xmg_new, statistics );
+
   return xmg_new;
 }
 
@@ -327,6 +348,24 @@ xmg_graph xmg_merge( const xmg_graph& xmg1, const xmg_graph& xmg2, const propert
   return xmg;
 }
 
+void xmg_substitute_inplace( xmg_graph& xmg, const std::unordered_map<xmg_node, xmg_function>& substitutes, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer t( statistics );
+
+  const auto offset = xmg.journal().size();
+  const auto num_dead = xmg.num_dead();
+
+  for ( const auto& p : substitutes )
+  {
+    /* node may have been removed by an earlier substitution */
+    if ( xmg.is_dead( p.first ) ) continue;
+    xmg.substitute_node( p.first, p.second );
+  }
+
+  set( statistics, "num_changes", static_cast<unsigned>( xmg.journal().size() - offset ) );
+  set( statistics, "num_removed", xmg.num_dead() - num_dead );
+}
+
 xmg_graph xmg_to_mig( const xmg_graph& xmg, const properties::ptr& settings, const properties::ptr& statistics )
 {
   settings->set( "init", xmg_init_func_t( []( xmg_graph& xmg_new ) { xmg_new.set_native_xor( false ); } ) );
@@ -43,6 +43,7 @@
 #include <boost/optional.hpp>
 
 #include <core/properties.hpp>
+#include <core/typed_properties.hpp>
 #include <classical/xmg/xmg.hpp>
 
 namespace cirkit
@@ -54,6 +55,33 @@ using prefill_func_t        = std::function<void(xmg_graph&, std::map<xmg_node,
 using xmg_init_func_t       = std::function<void(xmg_graph&)>;
 using xmg_substitutes_map_t = boost::optional<std::unordered_map<xmg_node, xmg_function>>;
 
+/* typed settings and statistics, the properties based functions convert at the boundary */
+struct xmg_rewrite_params
+{
+  prefill_func_t        prefill;
+  xmg_init_func_t       init;
+  xmg_substitutes_map_t substitutes;
+  bool                  keep_bitmarks = true;
+
+  static auto fields()
+  {
+    return std::make_tuple( make_property_field( "prefill",       &xmg_rewrite_params::prefill ),
+                            make_property_field( "init",          &xmg_rewrite_params::init ),
+                            make_property_field( "substitutes",   &xmg_rewrite_params::substitutes ),
+                            make_property_field( "keep_bitmarks", &xmg_rewrite_params::keep_bitmarks ) );
+  }
+};
+
+struct xmg_rewrite_stats
+{
+  double runtime = 0.0;
+
+  static auto fields()
+  {
+    return std::make_tuple( make_property_field( "runtime", &xmg_rewrite_stats::runtime ) );
+  }
+};
+
 xmg_function rewrite_default_maj( xmg_graph& xmg_new, const xmg_function& a, const xmg_function& b, const xmg_function& c );
 xmg_function rewrite_default_xor( xmg_graph& xmg_new, const xmg_function& a, const xmg_function& b );
 
@@ -71,12 +99,43 @@ std::vector<xmg_function> xmg_rewrite_top_down_inplace( xmg_graph& dest,
                                                         const properties::ptr& settings = properties::ptr(),
                                                         const properties::ptr& statistics = properties::ptr() );
 
+xmg_graph xmg_rewrite_top_down( const xmg_graph& xmg,
+                                const maj_rewrite_func_t& on_maj,
+                                const xor_rewrite_func_t& on_xor,
+                                const xmg_rewrite_params& params,
+                                xmg_rewrite_stats& stats );
+
+/* ignores params.init and params.substitutes as the properties based version */
+std::vector<xmg_function> xmg_rewrite_top_down_inplace( xmg_graph& dest,
+                                                        const xmg_graph& xmg,
+                                                        const maj_rewrite_func_t& on_maj,
+                                                        const xor_rewrite_func_t& on_xor,
+                                                        const std::vector<xmg_function>& pi_mapping,
+                                                        const xmg_rewrite_params& params,
+                                                        xmg_rewrite_stats& stats );
+
 xmg_graph xmg_rewrite_bottom_up( const xmg_graph& xmg,
                                  const maj_rewrite_func_t& on_maj,
                                  const xor_rewrite_func_t& on_xor,
                                  const properties::ptr& settings = properties::ptr(),
                                  const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * @brief Substitutes nodes in place
+ *
+ * Calls xmg_graph::substitute_node for each entry, such that the cost is
+ * proportional to the number of changes and not to the size of the graph
+ * as in xmg_rewrite_top_down with the substitutes setting.  Replacing
+ * functions must not be in the transitive fanout of the replaced nodes.
+ *
+ * Statistics: runtime (double), num_changes (unsigned, new journal
+ * entries), num_removed (unsigned, gates that became dead)
+ */
+void xmg_substitute_inplace( xmg_graph& xmg,
+                             const std::unordered_map<xmg_node, xmg_function>& substitutes,
+                             const properties::ptr& settings = properties::ptr(),
+                             const properties::ptr& statistics = properties::ptr() );
+
 xmg_graph xmg_strash( const xmg_graph& xmg, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 xmg_graph xmg_merge( const xmg_graph& xmg1, const xmg_graph& xmg2, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 xmg_graph xmg_to_mig( const xmg_graph& xmg, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
@@ -99,6 +99,12 @@ void xmg_print_stats( const xmg_graph& xmg, std::ostream& os )
   os << std::endl;
 }
 
+void xmg_strash_statistics( const xmg_graph& xmg, const properties::ptr& statistics )
+{
+  set_strash_statistics( statistics, "maj_strash", xmg.maj_strash_table() );
+  set_strash_statistics( statistics, "xor_strash", xmg.xor_strash_table() );
+}
+
 unsigned compute_pure_maj_count( const xmg_graph& xmg )
 {
   auto total = 0u;
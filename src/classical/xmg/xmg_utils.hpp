@@ -43,6 +43,7 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <core/properties.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <classical/xmg/xmg.hpp>
 
@@ -53,6 +54,9 @@ unsigned compute_depth( const xmg_graph& xmg );
 
 void xmg_print_stats( const xmg_graph& xmg, std::ostream& os );
 
+/* load factor and probe lengths of the MAJ and XOR strash tables (keys maj_strash_* and xor_strash_*) */
+void xmg_strash_statistics( const xmg_graph& xmg, const properties::ptr& statistics );
+
 unsigned compute_pure_maj_count( const xmg_graph& xmg );
 
 std::vector<unsigned> xmg_compute_levels( const xmg_graph& xmg );
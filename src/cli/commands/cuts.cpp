@@ -72,8 +72,8 @@ cuts_command::cuts_command( const environment::ptr& env ) : aig_mig_command( env
 
 bool cuts_command::execute_aig()
 {
-  paged_aig_cuts cuts( aig(), node_count, is_set( "parallel" ) );
-  std::cout << boost::format( "[i] found %d cuts in %.2f secs (%d KB)" ) % cuts.total_cut_count() % cuts.enumeration_time() % ( cuts.memory() >> 10u ) << std::endl;
+  paged_aig_cuts cuts( aig(), node_count, is_set( "parallel" ), 8u, statistics );
+  std::cout << boost::format( "[i] found %d cuts in %.2f secs (%d KB, %.0f cuts/sec)" ) % cuts.total_cut_count() % cuts.enumeration_time() % ( cuts.memory() >> 10u ) % statistics->get<double>( "cuts_per_second" ) << std::endl;
 
   if ( is_verbose() )
   {
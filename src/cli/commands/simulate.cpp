@@ -34,6 +34,7 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/format.hpp>
 
+#include <alice/rules.hpp>
 #include <cli/stores.hpp>
 #include <core/utils/program_options.hpp>
 #include <cli/stores.hpp>
@@ -60,11 +61,20 @@ namespace cirkit
 simulate_command::simulate_command( const environment::ptr& env )
   : aig_mig_command( env, "Simulates an AIG", "Simulate current %s" )
 {
+  if ( env->has_store<xmg_graph>() )
+  {
+    opts.add_options()
+      ( "xmg,x", "Simulate current XMG (only with --random)" )
+      ;
+  }
+
   opts.add_options()
     ( "pattern,p",       value( &pattern ),    "Simulates an input pattern" )
     ( "assignment,s",    value( &assignment ), "Simulates an input assignment, e.g. \"x1=0 x2=1 x3=1 y=1010 z=01\"" )
     ( "tt,t",                                  "Simulates a truth table" )
     ( "bdd,b",                                 "Simulates a BDD" )
+    ( "random,r",        value( &random_patterns ), "Simulates the given number of random patterns with the bit-parallel engine and prints the probability of each output to be 1" )
+    ( "seed",            value_with_default( &seed ), "Random seed for --random" )
     ( "little_endian,l",                       "Change bit endianness to little-endian in assignment method (default: big-endian)" )
     ( "quiet,q",                               "Don't print simulation results" )
     ;
@@ -84,7 +94,7 @@ command::rule_t simulate_command::one_simulation_method() const
   const auto assertion = [&]() {
     auto total = 0u;
 
-    for ( const auto& o : {"pattern","assignment","tt","bdd"} )
+    for ( const auto& o : {"pattern","assignment","tt","bdd","random"} )
     {
       if ( is_set( o ) ) { ++total; }
     }
@@ -115,16 +125,81 @@ command::rule_t simulate_command::check_pattern_size() const
   return {assertion, "pattern has incorrect size"};
 }
 
+command::rule_t simulate_command::xmg_random_only() const
+{
+  const auto assertion = [&]() {
+    return !xmg_selected() || is_set( "random" );
+  };
+  return {assertion, "XMGs can only be simulated with random patterns"};
+}
+
+bool simulate_command::xmg_selected() const
+{
+  return env->has_store<xmg_graph>() && is_set( "xmg" );
+}
+
+command::rule_t simulate_command::one_data_structure_or_xmg_selected() const
+{
+  const auto assertion = [&]() {
+    auto total = 0u;
+
+    if ( aig_selected() ) { ++total; }
+    if ( mig_selected() ) { ++total; }
+    if ( xmg_selected() ) { ++total; }
+
+    return total == 1u;
+  };
+
+  return {assertion, "exactly one circuit type needs to be selected"};
+}
+
 command::rules_t simulate_command::validity_rules() const
 {
-  auto rules = aig_mig_command::validity_rules();
+  rules_t rules = {one_data_structure_or_xmg_selected(), maybe_has_aig(), maybe_has_mig()};
+
+  if ( env->has_store<xmg_graph>() )
+  {
+    rules.push_back( has_store_element_if_set<xmg_graph>( *this, env, "xmg" ) );
+  }
 
   rules.push_back( one_simulation_method() );
   rules.push_back( check_pattern_size() );
+  rules.push_back( xmg_random_only() );
 
   return rules;
 }
 
+void simulate_command::random_simulation( bit_parallel_simulator& sim, const std::vector<std::string>& output_names )
+{
+  const auto settings = make_settings();
+  settings->set( "seed", seed );
+
+  const auto ones = bit_parallel_random_simulation( sim, random_patterns, settings, statistics );
+  const auto num_patterns = statistics->get<std::uint64_t>( "num_patterns" );
+
+  if ( !is_set( "quiet" ) )
+  {
+    for ( auto i = 0u; i < ones.size(); ++i )
+    {
+      std::cout << boost::format( "[i] %s : %.6f" ) % output_names[i] % ( static_cast<double>( ones[i] ) / num_patterns ) << std::endl;
+    }
+  }
+
+  std::cout << boost::format( "[i] simulated %d patterns on %d gates (%s kernel, %d words per node)" )
+               % num_patterns % sim.num_gates() % statistics->get<std::string>( "kernel" ) % sim.num_words() << std::endl
+            << boost::format( "[i] patterns per second: %.2f" ) % statistics->get<double>( "patterns_per_second" ) << std::endl;
+}
+
+bool simulate_command::execute()
+{
+  if ( xmg_selected() )
+  {
+    return before() && execute_xmg() && after();
+  }
+
+  return aig_mig_command::execute();
+}
+
 bool simulate_command::execute_aig()
 {
   tts.clear();
@@ -208,6 +283,19 @@ bool simulate_command::execute_aig()
       tts.push_back( to_string( tt ) );
     }
   }
+  else if ( is_set( "random" ) )
+  {
+    auto sim = bit_parallel_simulator_from_aig( aig() );
+    sim.set_num_words( bit_parallel_num_words( sim.num_nodes() ) );
+
+    std::vector<std::string> names;
+    for ( const auto& o : aig_info().outputs )
+    {
+      names.push_back( o.second );
+    }
+
+    random_simulation( sim, names );
+  }
   else if ( is_set( "bdd" ) )
   {
     properties_timer t( statistics );
@@ -285,6 +373,37 @@ bool simulate_command::execute_mig()
       tts.push_back( to_string( tt ) );
     }
   }
+  else if ( is_set( "random" ) )
+  {
+    auto sim = bit_parallel_simulator_from_mig( mig() );
+    sim.set_num_words( bit_parallel_num_words( sim.num_nodes() ) );
+
+    std::vector<std::string> names;
+    for ( const auto& o : mig_info().outputs )
+    {
+      names.push_back( o.second );
+    }
+
+    random_simulation( sim, names );
+  }
+
+  return true;
+}
+
+bool simulate_command::execute_xmg()
+{
+  const auto& xmg = env->store<xmg_graph>().current();
+
+  auto sim = bit_parallel_simulator_from_xmg( xmg );
+  sim.set_num_words( bit_parallel_num_words( sim.num_nodes() ) );
+
+  std::vector<std::string> names;
+  for ( const auto& o : xmg.outputs() )
+  {
+    names.push_back( o.second );
+  }
+
+  random_simulation( sim, names );
 
   return true;
 }
@@ -303,6 +422,12 @@ command::log_opt_t simulate_command::log() const
     m["runtime"] = statistics->get<double>( "runtime" );
   }
 
+  if ( is_set( "random" ) && statistics->has_key( "patterns_per_second" ) )
+  {
+    m["num_patterns"] = statistics->get<std::uint64_t>( "num_patterns" );
+    m["patterns_per_second"] = statistics->get<double>( "patterns_per_second" );
+  }
+
   if ( !m.empty() )
   {
     return m;
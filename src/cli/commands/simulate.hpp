@@ -27,7 +27,7 @@
 /**
  * @file simulate.hpp
  *
- * @brief Simulates an AIG
+ * @brief Simulates an AIG, MIG, or XMG
  *
  * @author Mathias Soeken
  * @since  2.3
@@ -36,11 +36,13 @@
 #ifndef CLI_SIMULATE_COMMAND_HPP
 #define CLI_SIMULATE_COMMAND_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include <cli/aig_mig_command.hpp>
 #include <core/utils/bdd_utils.hpp>
+#include <classical/functions/bit_parallel_simulation.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
 namespace cirkit
@@ -53,12 +55,19 @@ public:
 
 protected:
   rules_t validity_rules() const;
+  bool execute();
   bool execute_aig();
   bool execute_mig();
+  bool execute_xmg();
 
 private:
+  bool xmg_selected() const;
+  rule_t one_data_structure_or_xmg_selected() const;
   rule_t one_simulation_method() const;
   rule_t check_pattern_size() const;
+  rule_t xmg_random_only() const;
+
+  void random_simulation( bit_parallel_simulator& sim, const std::vector<std::string>& output_names );
 
   template<typename S>
   void store( const S& element )
@@ -78,6 +87,8 @@ public:
 private:
   std::string pattern;
   std::string assignment;
+  std::uint64_t random_patterns = 0u;
+  std::uint64_t seed = 0xcafe;
 
   std::vector<std::string> tts;
 };
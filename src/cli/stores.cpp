@@ -59,11 +59,13 @@
 #include <classical/io/write_aiger.hpp>
 #include <classical/io/write_bench.hpp>
 #include <classical/io/write_verilog.hpp>
+#include <classical/mig/mig_binary.hpp>
 #include <classical/mig/mig_to_aig.hpp>
 #include <classical/mig/mig_from_string.hpp>
 #include <classical/mig/mig_utils.hpp>
 #include <classical/mig/mig_verilog.hpp>
 #include <classical/xmg/xmg_aig.hpp>
+#include <classical/xmg/xmg_binary.hpp>
 #include <classical/xmg/xmg_cover.hpp>
 #include <classical/xmg/xmg_expr.hpp>
 #include <classical/xmg/xmg_io.hpp>
@@ -316,7 +318,9 @@ aig_graph store_read_io_type<aig_graph, io_aiger_tag_t>( const std::string& file
     }
     else
     {
-      read_aiger_binary( aig, filename, cmd.is_set( "nostrash" ) );
+      auto settings = std::make_shared<properties>();
+      settings->set( "strash", !cmd.is_set( "nostrash" ) );
+      read_aiger_mapped( aig, filename, settings );
     }
   }
   catch ( const char *e )
@@ -488,6 +492,18 @@ mig_graph store_read_io_type<mig_graph, io_verilog_tag_t>( const std::string& fi
   return read_mighty_verilog( filename );
 }
 
+template<>
+void store_write_io_type<mig_graph, io_binary_tag_t>( const mig_graph& mig, const std::string& filename, const command& cmd )
+{
+  mig_write_binary( mig, filename );
+}
+
+template<>
+mig_graph store_read_io_type<mig_graph, io_binary_tag_t>( const std::string& filename, const command& cmd )
+{
+  return mig_read_binary( filename );
+}
+
 /******************************************************************************
  * counterexample_t                                                           *
  ******************************************************************************/
@@ -808,6 +824,34 @@ xmg_graph store_read_io_type<xmg_graph, io_yig_tag_t>( const std::string& filena
   return xmg_read_yig( filename );
 }
 
+template<>
+bool store_can_write_io_type<xmg_graph, io_binary_tag_t>( command& cmd )
+{
+  boost::program_options::options_description xmg_options( "XMG options" );
+
+  xmg_options.add_options()
+    ( "no_cover", "do not write the LUT cover" )
+    ;
+
+  cmd.opts.add( xmg_options );
+
+  return true;
+}
+
+template<>
+void store_write_io_type<xmg_graph, io_binary_tag_t>( const xmg_graph& xmg, const std::string& filename, const command& cmd )
+{
+  auto settings = std::make_shared<properties>();
+  settings->set( "cover", !cmd.is_set( "no_cover" ) );
+  xmg_write_binary( xmg, filename, settings );
+}
+
+template<>
+xmg_graph store_read_io_type<xmg_graph, io_binary_tag_t>( const std::string& filename, const command& cmd )
+{
+  return xmg_read_binary( filename );
+}
+
 template<>
 bool store_can_write_io_type<xmg_graph, io_smt_tag_t>( command& cmd )
 {
@@ -59,6 +59,7 @@ using namespace cirkit;
 
 struct io_aiger_tag_t {};
 struct io_bench_tag_t {};
+struct io_binary_tag_t {};
 struct io_edgelist_tag_t {};
 struct io_pla_tag_t {};
 struct io_smt_tag_t {};
@@ -266,6 +267,18 @@ inline bool store_can_read_io_type<mig_graph, io_verilog_tag_t>( command& cmd )
 template<>
 mig_graph store_read_io_type<mig_graph, io_verilog_tag_t>( const std::string& filename, const command& cmd );
 
+template<>
+inline bool store_can_write_io_type<mig_graph, io_binary_tag_t>( command& cmd ) { return true; }
+
+template<>
+void store_write_io_type<mig_graph, io_binary_tag_t>( const mig_graph& mig, const std::string& filename, const command& cmd );
+
+template<>
+inline bool store_can_read_io_type<mig_graph, io_binary_tag_t>( command& cmd ) { return true; }
+
+template<>
+mig_graph store_read_io_type<mig_graph, io_binary_tag_t>( const std::string& filename, const command& cmd );
+
 /******************************************************************************
  * counterexample_t                                                           *
  ******************************************************************************/
@@ -477,6 +490,18 @@ inline bool store_can_read_io_type<xmg_graph, io_yig_tag_t>( command& cmd ) { re
 template<>
 xmg_graph store_read_io_type<xmg_graph, io_yig_tag_t>( const std::string& filename, const command& cmd );
 
+template<>
+bool store_can_write_io_type<xmg_graph, io_binary_tag_t>( command& cmd );
+
+template<>
+void store_write_io_type<xmg_graph, io_binary_tag_t>( const xmg_graph& xmg, const std::string& filename, const command& cmd );
+
+template<>
+inline bool store_can_read_io_type<xmg_graph, io_binary_tag_t>( command& cmd ) { return true; }
+
+template<>
+xmg_graph store_read_io_type<xmg_graph, io_binary_tag_t>( const std::string& filename, const command& cmd );
+
 template<>
 bool store_can_write_io_type<xmg_graph, io_smt_tag_t>( command& cmd );
 
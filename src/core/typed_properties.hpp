@@ -0,0 +1,157 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file typed_properties.hpp
+ *
+ * @brief Typed parameter and statistics structs convertible to properties
+ *
+ * Algorithms that are called often on small inputs take plain structs for
+ * settings and statistics.  Each struct lists its fields together with the
+ * property keys in a static fields() function, such that the public API
+ * taking properties::ptr can convert at the boundary:
+ *
+ * @code
+ * struct my_params
+ * {
+ *   unsigned limit = 10u;
+ *   bool     verbose = false;
+ *
+ *   static auto fields()
+ *   {
+ *     return std::make_tuple( make_property_field( "limit", &my_params::limit ),
+ *                             make_property_field( "verbose", &my_params::verbose ) );
+ *   }
+ * };
+ *
+ * const auto params = from_properties<my_params>( settings );
+ * @endcode
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef TYPED_PROPERTIES_HPP
+#define TYPED_PROPERTIES_HPP
+
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+#include <core/properties.hpp>
+
+namespace cirkit
+{
+
+template<typename S, typename T>
+struct property_field
+{
+  const char* key;
+  T S::*      member;
+};
+
+template<typename S, typename T>
+inline property_field<S, T> make_property_field( const char* key, T S::* member )
+{
+  return {key, member};
+}
+
+namespace detail
+{
+
+template<typename S, typename T>
+inline void read_property_field( const properties& settings, S& s, const property_field<S, T>& field )
+{
+  if ( settings.has_key( field.key ) )
+  {
+    s.*field.member = settings.get<T>( field.key );
+  }
+}
+
+template<typename S, typename T>
+inline void write_property_field( const S& s, properties& statistics, const property_field<S, T>& field )
+{
+  statistics.set( field.key, s.*field.member );
+}
+
+template<typename S, typename Fields, std::size_t... I>
+inline void read_property_fields( const properties& settings, S& s, const Fields& fields, std::index_sequence<I...> )
+{
+  (void)std::initializer_list<int>{ ( read_property_field( settings, s, std::get<I>( fields ) ), 0 )... };
+}
+
+template<typename S, typename Fields, std::size_t... I>
+inline void write_property_fields( const S& s, properties& statistics, const Fields& fields, std::index_sequence<I...> )
+{
+  (void)std::initializer_list<int>{ ( write_property_field( s, statistics, std::get<I>( fields ) ), 0 )... };
+}
+
+}
+
+/**
+ * @brief Overrides all fields of s for which settings has a key
+ */
+template<typename S>
+void from_properties( const properties::ptr& settings, S& s )
+{
+  if ( !settings ) { return; }
+
+  const auto fields = S::fields();
+  detail::read_property_fields( *settings, s, fields, std::make_index_sequence<std::tuple_size<decltype( fields )>::value>() );
+}
+
+/**
+ * @brief Default constructed struct, overridden by settings
+ */
+template<typename S>
+S from_properties( const properties::ptr& settings )
+{
+  S s;
+  from_properties( settings, s );
+  return s;
+}
+
+/**
+ * @brief Writes all fields of s into statistics
+ */
+template<typename S>
+void to_properties( const S& s, const properties::ptr& statistics )
+{
+  if ( !statistics ) { return; }
+
+  const auto fields = S::fields();
+  detail::write_property_fields( s, *statistics, fields, std::make_index_sequence<std::tuple_size<decltype( fields )>::value>() );
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
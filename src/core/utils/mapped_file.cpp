@@ -0,0 +1,81 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cirkit
+{
+
+mapped_file::mapped_file( const std::string& filename )
+{
+  const auto fd = open( filename.c_str(), O_RDONLY );
+  if ( fd == -1 ) { throw "Error: could not read input file (check path and permissions)"; }
+
+  struct stat st;
+  if ( fstat( fd, &st ) == -1 )
+  {
+    close( fd );
+    throw "Error: could not determine file size";
+  }
+  _size = st.st_size;
+
+  /* mmap of an empty file fails, there is nothing to map anyway */
+  if ( _size > 0u )
+  {
+    const auto p = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( p == MAP_FAILED )
+    {
+      close( fd );
+      throw "Error: could not map input file";
+    }
+    madvise( p, _size, MADV_SEQUENTIAL );
+    _data = static_cast<const char*>( p );
+  }
+
+  /* the mapping stays valid after closing the descriptor */
+  close( fd );
+}
+
+mapped_file::~mapped_file()
+{
+  if ( _data )
+  {
+    munmap( const_cast<char*>( _data ), _size );
+  }
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,127 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file mapped_file.hpp
+ *
+ * @brief Read-only memory mapped files
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace cirkit
+{
+
+/* maps a whole file read-only into memory and unmaps it on destruction;
+   throws a string if the file cannot be opened or mapped */
+class mapped_file
+{
+public:
+  explicit mapped_file( const std::string& filename );
+  ~mapped_file();
+
+  mapped_file( const mapped_file& ) = delete;
+  mapped_file& operator=( const mapped_file& ) = delete;
+
+  inline const char* data() const  { return _data; }
+  inline std::size_t size() const  { return _size; }
+  inline const char* begin() const { return _data; }
+  inline const char* end() const   { return _data + _size; }
+
+private:
+  const char* _data = nullptr;
+  std::size_t _size = 0u;
+};
+
+/* sequential reader over a memory range; reads are bounds checked and
+   copied via memcpy, such that unaligned data is fine */
+class mapped_reader
+{
+public:
+  mapped_reader( const char* begin, const char* end ) : pos( begin ), last( end ) {}
+
+  template<typename T>
+  T read()
+  {
+    T value;
+    read( &value, 1u );
+    return value;
+  }
+
+  template<typename T>
+  void read( T* values, std::size_t count )
+  {
+    const auto bytes = count * sizeof( T );
+    if ( remaining() < bytes ) { throw "Error: unexpected end of file"; }
+    std::memcpy( values, pos, bytes );
+    pos += bytes;
+  }
+
+  /* string as 32-bit length followed by the characters */
+  std::string read_string()
+  {
+    const auto length = read<uint32_t>();
+    if ( remaining() < length ) { throw "Error: unexpected end of file"; }
+    std::string s( pos, length );
+    pos += length;
+    return s;
+  }
+
+  /* returns a pointer to the next bytes and advances over them */
+  const char* skip( std::size_t bytes )
+  {
+    if ( remaining() < bytes ) { throw "Error: unexpected end of file"; }
+    const auto p = pos;
+    pos += bytes;
+    return p;
+  }
+
+  inline std::size_t remaining() const { return last - pos; }
+  inline const char* position() const  { return pos; }
+
+private:
+  const char* pos;
+  const char* last;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -26,6 +26,8 @@
 
 #include "paged_memory.hpp"
 
+#include <algorithm>
+
 #include <boost/range/algorithm.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/range/numeric.hpp>
@@ -33,6 +35,64 @@
 namespace cirkit
 {
 
+/******************************************************************************
+ * paged_memory_page                                                          *
+ ******************************************************************************/
+
+paged_memory_page::paged_memory_page( unsigned k, std::size_t block_size )
+  : _additional( k ),
+    _block_size( block_size )
+{
+}
+
+void paged_memory_page::begin_record()
+{
+  _scratch.clear();
+  _count = 0u;
+}
+
+void paged_memory_page::append_empty( const std::vector<unsigned>& extra )
+{
+  ++_count;
+  _scratch.push_back( 0u );
+  boost::push_back( _scratch, extra );
+}
+
+void paged_memory_page::append_singleton( unsigned value, const std::vector<unsigned>& extra )
+{
+  ++_count;
+  _scratch.push_back( 1u );
+  boost::push_back( _scratch, extra );
+  _scratch.push_back( value );
+}
+
+paged_memory_page::record paged_memory_page::end_record()
+{
+  /* records are never split, large records get a block of their own */
+  if ( _blocks.empty() || _block_used + _scratch.size() > _block_capacity )
+  {
+    _block_capacity = std::max( _block_size, _scratch.size() );
+    _blocks.emplace_back( new unsigned[_block_capacity] );
+    _block_used = 0u;
+    _memory += _block_capacity * sizeof( unsigned );
+  }
+
+  auto* dest = _blocks.back().get() + _block_used;
+  std::copy( _scratch.begin(), _scratch.end(), dest );
+  _block_used += _scratch.size();
+
+  record r;
+  r.data = dest;
+  r.size = _scratch.size();
+  r.count = _count;
+  return r;
+}
+
+std::size_t paged_memory_page::memory() const
+{
+  return _memory;
+}
+
 /******************************************************************************
  * paged_memory::set                                                          *
  ******************************************************************************/
@@ -197,6 +257,13 @@ void paged_memory::assign_singleton( unsigned index, unsigned value, const std::
   _data.push_back( value );
 }
 
+void paged_memory::assign_record( unsigned index, const paged_memory_page::record& r )
+{
+  _offset[index] = _data.size();
+  _count[index] = r.count;
+  _data.insert( _data.end(), r.data, r.data + r.size );
+}
+
 void paged_memory::append_begin( unsigned index )
 {
   _offset[index] = _data.size();
@@ -36,6 +36,8 @@
 #ifndef PAGED_MEMORY_HPP
 #define PAGED_MEMORY_HPP
 
+#include <iterator>
+#include <memory>
 #include <vector>
 
 #include <boost/range/iterator_range.hpp>
@@ -43,6 +45,69 @@
 namespace cirkit
 {
 
+/* paged_memory_page
+ *
+ * Append-only storage for the sets of several indexes, in the same format
+ * as the data container of paged_memory.  All sets of one index form a
+ * record, which is written into fixed-size blocks and never moves once
+ * end_record() returned.  Hence, a record can be read from other threads
+ * (after synchronization) while the owning thread keeps appending, e.g.,
+ * one page per thread.  Records are copied into a paged_memory with
+ * paged_memory::assign_record.
+ */
+class paged_memory_page
+{
+public:
+  struct record
+  {
+    const unsigned* data  = nullptr;
+    unsigned        size  = 0u; /* number of words */
+    unsigned        count = 0u; /* number of sets */
+  };
+
+  explicit paged_memory_page( unsigned k = 0u, std::size_t block_size = 1u << 16u );
+
+  void   begin_record();
+  void   append_empty( const std::vector<unsigned>& extra = std::vector<unsigned>() );
+  void   append_singleton( unsigned value, const std::vector<unsigned>& extra = std::vector<unsigned>() );
+  record end_record();
+
+  template<typename Iterator>
+  void append_set( Iterator begin, Iterator end, const std::vector<unsigned>& extra = std::vector<unsigned>() )
+  {
+    ++_count;
+    _scratch.push_back( std::distance( begin, end ) );
+    _scratch.insert( _scratch.end(), extra.begin(), extra.end() );
+    _scratch.insert( _scratch.end(), begin, end );
+  }
+
+  /* calls f( extra, begin, end ) for each set in r, where extra points to the k additional values */
+  template<typename Fn>
+  static void foreach_set( const record& r, unsigned k, Fn&& f )
+  {
+    auto p = r.data;
+    for ( auto i = 0u; i < r.count; ++i )
+    {
+      const auto size = *p;
+      f( p + 1, p + 1 + k, p + 1 + k + size );
+      p += 1u + k + size;
+    }
+  }
+
+  std::size_t memory() const;
+
+private:
+  unsigned                                 _additional;
+  std::size_t                              _block_size;
+  std::vector<std::unique_ptr<unsigned[]>> _blocks;
+  std::size_t                              _block_used = 0u;
+  std::size_t                              _block_capacity = 0u;
+  std::size_t                              _memory = 0u;
+
+  std::vector<unsigned>                    _scratch;
+  unsigned                                 _count = 0u;
+};
+
 /* paged_memory
  *
  * This data structure represents a vector where each
@@ -179,6 +244,18 @@ public:
   void                            append_singleton( unsigned index, unsigned value, const std::vector<unsigned>& extra = std::vector<unsigned>() );
   void                            append_set( unsigned index, const std::vector<unsigned>& values, const std::vector<unsigned>& extra = std::vector<unsigned>() );
 
+  /* copies a record of a paged_memory_page with the same k, updates the offset */
+  void                            assign_record( unsigned index, const paged_memory_page::record& r );
+
+  template<typename Iterator>
+  void append_set( unsigned index, Iterator begin, Iterator end, const std::vector<unsigned>& extra = std::vector<unsigned>() )
+  {
+    _count[index]++;
+    _data.push_back( std::distance( begin, end ) );
+    _data.insert( _data.end(), extra.begin(), extra.end() );
+    _data.insert( _data.end(), begin, end );
+  }
+
   unsigned                        memory() const;
 
 private:
@@ -0,0 +1,329 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file strash_table.hpp
+ *
+ * @brief Open-addressing hash table for structural hashing
+ *
+ * Maps keys, which are usually fanin literals packed into machine words,
+ * to 32-bit node indexes.  Two-input gates are keyed by one 64-bit word,
+ * three-input gates by a strash_key3.  All entries are stored in a single array that
+ * is searched by linear probing; the array is allocated on the first insert
+ * (graphs often keep empty tables) and grows by doubling when the load
+ * factor exceeds 1/2.  Erasing uses backward shifting, such that no
+ * tombstones are needed.  Inserting and looking up does not allocate
+ * memory except for growing the array.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef STRASH_TABLE_HPP
+#define STRASH_TABLE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <core/properties.hpp>
+
+namespace cirkit
+{
+
+/* 64-bit finalizer from MurmurHash3 */
+inline uint64_t strash_mix( uint64_t k )
+{
+  k ^= k >> 33u;
+  k *= 0xff51afd7ed558ccdull;
+  k ^= k >> 33u;
+  k *= 0xc4ceb9fe1a85ec53ull;
+  k ^= k >> 33u;
+  return k;
+}
+
+/* three 32-bit literals, the first two are packed into one 64-bit word */
+struct strash_key3
+{
+  strash_key3() = default;
+  strash_key3( uint32_t a, uint32_t b, uint32_t c ) : ab( ( static_cast<uint64_t>( a ) << 32u ) | b ), c( c ) {}
+
+  inline bool operator==( const strash_key3& other ) const { return ab == other.ab && c == other.c; }
+
+  uint64_t ab = 0ull;
+  uint32_t c  = 0u;
+};
+
+template<typename Key>
+struct strash_hash;
+
+template<>
+struct strash_hash<uint64_t>
+{
+  inline uint64_t operator()( uint64_t key ) const
+  {
+    return strash_mix( key );
+  }
+};
+
+template<>
+struct strash_hash<strash_key3>
+{
+  inline uint64_t operator()( const strash_key3& key ) const
+  {
+    return strash_mix( key.ab ^ ( static_cast<uint64_t>( key.c ) * 0x9e3779b97f4a7c15ull ) );
+  }
+};
+
+template<typename Key, typename Hash = strash_hash<Key>>
+class strash_table
+{
+public:
+  using key_type   = Key;
+  using value_type = uint32_t;
+
+  static constexpr value_type empty = std::numeric_limits<value_type>::max();
+
+  /* no memory is allocated if initial_capacity is 0 */
+  explicit strash_table( std::size_t initial_capacity = 0u )
+  {
+    if ( initial_capacity != 0u )
+    {
+      std::size_t capacity = min_capacity;
+      while ( capacity < initial_capacity ) { capacity <<= 1u; }
+      entries.resize( capacity );
+      mask = capacity - 1u;
+    }
+  }
+
+  /* returns the value for key or empty; this overload does not update the
+     probe statistics and can therefore be called concurrently */
+  value_type find( const key_type& key ) const
+  {
+    if ( entries.empty() ) { return empty; }
+
+    unsigned long probes;
+    return entries[locate( key, probes )].value;
+  }
+
+  /* returns the value for key or empty and updates the probe statistics */
+  value_type find( const key_type& key )
+  {
+    if ( entries.empty() ) { return empty; }
+
+    unsigned long probes;
+    const auto pos = locate( key, probes );
+    ++_lookups;
+    record_probes( probes );
+    return entries[pos].value;
+  }
+
+  /* inserts key if not contained; returns the value in the table and whether key was inserted */
+  std::pair<value_type, bool> insert( const key_type& key, value_type value )
+  {
+    if ( 2u * ( _size + 1u ) > entries.size() )
+    {
+      rehash( entries.empty() ? min_capacity : entries.size() << 1u );
+    }
+
+    ++_lookups;
+    for ( auto pos = hash( key ) & mask, probes = 1ul; ; pos = ( pos + 1u ) & mask, ++probes )
+    {
+      auto& e = entries[pos];
+      if ( e.value == empty )
+      {
+        record_probes( probes );
+        e.key = key;
+        e.value = value;
+        ++_size;
+        return {value, true};
+      }
+      if ( e.key == key )
+      {
+        record_probes( probes );
+        return {e.value, false};
+      }
+    }
+  }
+
+  /* inserts key or overrides its value */
+  void assign( const key_type& key, value_type value )
+  {
+    const auto r = insert( key, value );
+    if ( !r.second )
+    {
+      auto pos = hash( key ) & mask;
+      while ( !( entries[pos].key == key ) ) { pos = ( pos + 1u ) & mask; }
+      entries[pos].value = value;
+    }
+  }
+
+  /* returns true if key was contained */
+  bool erase( const key_type& key )
+  {
+    if ( entries.empty() ) { return false; }
+
+    auto pos = hash( key ) & mask;
+    while ( entries[pos].value != empty && !( entries[pos].key == key ) )
+    {
+      pos = ( pos + 1u ) & mask;
+    }
+    if ( entries[pos].value == empty ) { return false; }
+
+    /* backward shift deletion */
+    auto next = ( pos + 1u ) & mask;
+    while ( entries[next].value != empty )
+    {
+      const auto home = hash( entries[next].key ) & mask;
+      /* entry at next can be moved to pos if its home is not in (pos, next] */
+      if ( ( ( next - home ) & mask ) >= ( ( next - pos ) & mask ) )
+      {
+        entries[pos] = entries[next];
+        pos = next;
+      }
+      next = ( next + 1u ) & mask;
+    }
+    entries[pos].value = empty;
+    --_size;
+    return true;
+  }
+
+  void clear()
+  {
+    for ( auto& e : entries ) { e.value = empty; }
+    _size = 0u;
+  }
+
+  void reserve( std::size_t n )
+  {
+    if ( n == 0u ) { return; }
+
+    std::size_t capacity = entries.empty() ? min_capacity : entries.size();
+    while ( capacity < 2u * n ) { capacity <<= 1u; }
+    if ( capacity != entries.size() )
+    {
+      rehash( capacity );
+    }
+  }
+
+  std::size_t size() const     { return _size; }
+  std::size_t capacity() const { return entries.size(); }
+  double load_factor() const   { return entries.empty() ? 0.0 : static_cast<double>( _size ) / entries.size(); }
+  std::size_t memory() const   { return entries.size() * sizeof( entry ); }
+
+  /* probe statistics over all calls to insert and the non-const find */
+  unsigned long num_lookups() const      { return _lookups; }
+  unsigned long num_probes() const       { return _probes; }
+  unsigned long max_probe_length() const { return _max_probe_length; }
+  double average_probe_length() const    { return _lookups == 0ul ? 0.0 : static_cast<double>( _probes ) / _lookups; }
+  unsigned num_rehashes() const          { return _rehashes; }
+
+private:
+  static constexpr std::size_t min_capacity = 16u;
+
+  struct entry
+  {
+    key_type   key{};
+    value_type value = empty;
+  };
+
+  /* position of key or of the empty entry that ends its probe sequence */
+  inline std::size_t locate( const key_type& key, unsigned long& probes ) const
+  {
+    auto pos = hash( key ) & mask;
+    for ( probes = 1ul; entries[pos].value != empty && !( entries[pos].key == key ); ++probes )
+    {
+      pos = ( pos + 1u ) & mask;
+    }
+    return pos;
+  }
+
+  inline void record_probes( unsigned long probes )
+  {
+    _probes += probes;
+    _max_probe_length = std::max( _max_probe_length, probes );
+  }
+
+  void rehash( std::size_t capacity )
+  {
+    std::vector<entry> old( capacity );
+    std::swap( old, entries );
+    mask = capacity - 1u;
+    if ( !old.empty() ) { ++_rehashes; }
+
+    for ( const auto& e : old )
+    {
+      if ( e.value == empty ) { continue; }
+
+      auto pos = hash( e.key ) & mask;
+      while ( entries[pos].value != empty ) { pos = ( pos + 1u ) & mask; }
+      entries[pos] = e;
+    }
+  }
+
+private:
+  std::vector<entry>    entries;
+  std::size_t           mask = 0u;
+  std::size_t           _size = 0u;
+  Hash                  hash;
+
+  unsigned long         _lookups = 0ul;
+  unsigned long         _probes = 0ul;
+  unsigned long         _max_probe_length = 0ul;
+  unsigned              _rehashes = 0u;
+};
+
+template<typename Key, typename Hash>
+constexpr typename strash_table<Key, Hash>::value_type strash_table<Key, Hash>::empty;
+
+template<typename Key, typename Hash>
+constexpr std::size_t strash_table<Key, Hash>::min_capacity;
+
+/* writes size, load factor and probe lengths of table into statistics, all keys start with prefix */
+template<typename Key, typename Hash>
+void set_strash_statistics( const properties::ptr& statistics, const std::string& prefix, const strash_table<Key, Hash>& table )
+{
+  if ( !statistics ) { return; }
+
+  statistics->set( prefix + "_size",                 static_cast<unsigned>( table.size() ) );
+  statistics->set( prefix + "_load_factor",          table.load_factor() );
+  statistics->set( prefix + "_average_probe_length", table.average_probe_length() );
+  statistics->set( prefix + "_max_probe_length",     static_cast<unsigned>( table.max_probe_length() ) );
+  statistics->set( prefix + "_rehashes",             table.num_rehashes() );
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,216 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+void work_stealing_pool::worker_loop( unsigned worker )
+{
+  auto seen = 0ul;
+
+  while ( true )
+  {
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      start_condition.wait( lock, [this, seen]() { return stop || generation != seen; } );
+      if ( stop ) { return; }
+      seen = generation;
+    }
+
+    execute( worker );
+
+    {
+      std::unique_lock<std::mutex> lock( mutex );
+      if ( --pending == 0u )
+      {
+        done_condition.notify_one();
+      }
+    }
+  }
+}
+
+void work_stealing_pool::execute( unsigned worker )
+{
+  std::size_t first, last;
+
+  for ( auto i = 0u; i < _num_threads; ++i )
+  {
+    const auto owner = ( worker + i ) % _num_threads;
+
+    while ( claim( owner, first, last ) )
+    {
+      if ( owner != worker )
+      {
+        steals.fetch_add( 1ul, std::memory_order_relaxed );
+      }
+
+      try
+      {
+        for ( auto j = first; j < last; ++j )
+        {
+          ( *body )( j, worker );
+        }
+      }
+      catch ( ... )
+      {
+        std::unique_lock<std::mutex> lock( mutex );
+        if ( !error )
+        {
+          error = std::current_exception();
+        }
+      }
+    }
+  }
+}
+
+bool work_stealing_pool::claim( unsigned owner, std::size_t& first, std::size_t& last )
+{
+  auto& range = ranges[owner];
+
+  /* cheap check to avoid pushing the counter far beyond the end */
+  if ( range.next.load( std::memory_order_relaxed ) >= range.end ) { return false; }
+
+  first = range.next.fetch_add( grain_size, std::memory_order_relaxed );
+  if ( first >= range.end ) { return false; }
+
+  last = std::min( first + grain_size, range.end );
+  return true;
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+work_stealing_pool::work_stealing_pool( unsigned num_threads )
+  : _num_threads( num_threads == 0u ? std::max( 1u, std::thread::hardware_concurrency() ) : num_threads ),
+    ranges( new worker_range[_num_threads] )
+{
+  for ( auto i = 0u; i < _num_threads; ++i )
+  {
+    ranges[i].next = 0u;
+    ranges[i].end = 0u;
+  }
+
+  /* worker 0 is the thread that calls parallel_for */
+  for ( auto i = 1u; i < _num_threads; ++i )
+  {
+    workers.emplace_back( [this, i]() { worker_loop( i ); } );
+  }
+}
+
+work_stealing_pool::~work_stealing_pool()
+{
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    stop = true;
+  }
+
+  start_condition.notify_all();
+  for ( auto& worker : workers )
+  {
+    worker.join();
+  }
+}
+
+unsigned work_stealing_pool::num_threads() const
+{
+  return _num_threads;
+}
+
+void work_stealing_pool::parallel_for( std::size_t begin, std::size_t end, const loop_body_t& body, std::size_t grain_size )
+{
+  if ( begin >= end ) { return; }
+
+  grain_size = std::max<std::size_t>( grain_size, 1u );
+
+  /* small ranges are not worth waking up the workers */
+  if ( _num_threads == 1u || end - begin <= grain_size )
+  {
+    for ( auto i = begin; i < end; ++i )
+    {
+      body( i, 0u );
+    }
+    return;
+  }
+
+  /* split range evenly among workers */
+  const auto size = end - begin;
+  for ( auto i = 0u; i < _num_threads; ++i )
+  {
+    ranges[i].next.store( begin + ( size * i ) / _num_threads, std::memory_order_relaxed );
+    ranges[i].end = begin + ( size * ( i + 1u ) ) / _num_threads;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    this->body = &body;
+    this->grain_size = grain_size;
+    error = nullptr;
+    pending = _num_threads - 1u;
+    ++generation;
+  }
+  start_condition.notify_all();
+
+  execute( 0u );
+
+  std::exception_ptr e;
+  {
+    std::unique_lock<std::mutex> lock( mutex );
+    done_condition.wait( lock, [this]() { return pending == 0u; } );
+    this->body = nullptr;
+    std::swap( e, error );
+  }
+
+  if ( e )
+  {
+    std::rethrow_exception( e );
+  }
+}
+
+unsigned long work_stealing_pool::num_steals() const
+{
+  return steals.load();
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,122 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file work_stealing_pool.hpp
+ *
+ * @brief Fixed-size thread pool with work stealing for data-parallel loops
+ *
+ * In contrast to thread_pool, which executes independent tasks from a
+ * shared queue, this pool executes parallel loops.  The index range of
+ * a loop is split evenly among the workers and each worker claims
+ * chunks from its own range with an atomic counter.  Once a worker's
+ * range is exhausted, it steals chunks from the ranges of the other
+ * workers.  The calling thread participates as worker 0, such that a
+ * pool with one thread executes loops sequentially without
+ * synchronization.
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cirkit
+{
+
+class work_stealing_pool
+{
+public:
+  /* called with the loop index and the id of the executing worker */
+  using loop_body_t = std::function<void( std::size_t, unsigned )>;
+
+  /* number of threads is the same as number of cores if num_threads is 0 */
+  explicit work_stealing_pool( unsigned num_threads = 0u );
+  ~work_stealing_pool();
+
+  work_stealing_pool( const work_stealing_pool& ) = delete;
+  work_stealing_pool& operator=( const work_stealing_pool& ) = delete;
+
+  unsigned num_threads() const;
+
+  /* calls body( i, worker ) for all i in [begin, end) and blocks until all
+     calls returned; ranges not larger than grain_size are executed by the
+     calling thread; exceptions thrown in body are rethrown in the caller */
+  void parallel_for( std::size_t begin, std::size_t end, const loop_body_t& body, std::size_t grain_size = 1u );
+
+  /* number of chunks taken from the range of another worker so far */
+  unsigned long num_steals() const;
+
+private:
+  struct worker_range
+  {
+    std::atomic<std::size_t> next;
+    std::size_t              end;
+    char                     padding[64u - sizeof( std::atomic<std::size_t> ) - sizeof( std::size_t )]; /* avoid false sharing */
+  };
+
+  void worker_loop( unsigned worker );
+  void execute( unsigned worker );
+  bool claim( unsigned owner, std::size_t& first, std::size_t& last );
+
+private:
+  unsigned                        _num_threads;
+  std::vector<std::thread>        workers;
+  std::unique_ptr<worker_range[]> ranges;
+
+  std::mutex                      mutex;
+  std::condition_variable         start_condition;
+  std::condition_variable         done_condition;
+  unsigned long                   generation = 0ul;
+  unsigned                        pending = 0u;
+  bool                            stop = false;
+
+  const loop_body_t*              body = nullptr;
+  std::size_t                     grain_size = 1u;
+  std::exception_ptr              error;
+  std::atomic<unsigned long>      steals{0ul};
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,160 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE bdd_garbage_collection
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/dd/bdd.hpp>
+#include <classical/dd/count_solutions.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* parity of the first n variables */
+bdd parity( bdd_manager& mgr, unsigned n )
+{
+  auto f = mgr.bdd_bot();
+  for ( auto i = 0u; i < n; ++i )
+  {
+    f = f ^ mgr.bdd_var( i );
+  }
+  return f;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(collect_unreferenced_nodes)
+{
+  bdd_manager mgr( 12u, 10u );
+  mgr.set_auto_gc( false );
+
+  const auto base = mgr.size();
+
+  auto f = parity( mgr, 12u );
+  {
+    auto g = parity( mgr, 8u ) && mgr.bdd_var( 11u );
+    BOOST_CHECK( mgr.size() > base );
+  }
+
+  BOOST_CHECK( mgr.collect_garbage() > 0u );
+  BOOST_CHECK_EQUAL( mgr.size(), base + 22u ); /* parity of 12 variables has 2 * 11 inner nodes */
+  BOOST_CHECK_EQUAL( count_solutions( f ), 2048u );
+
+  /* freed slots are reused and the result is canonical */
+  auto h = parity( mgr, 12u );
+  BOOST_CHECK_EQUAL( h.index, f.index );
+
+  f = mgr.bdd_bot();
+  h = mgr.bdd_bot();
+  mgr.collect_garbage();
+  BOOST_CHECK_EQUAL( mgr.size(), base );
+}
+
+BOOST_AUTO_TEST_CASE(grow_node_table)
+{
+  bdd_manager mgr( 16u, 4u );
+
+  std::vector<bdd> fs;
+  for ( auto i = 1u; i <= 16u; ++i )
+  {
+    fs.push_back( parity( mgr, i ) );
+  }
+
+  BOOST_CHECK( mgr.capacity() > 16u );
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    BOOST_CHECK_EQUAL( count_solutions( fs[i] ), 1u << 15u );
+    BOOST_CHECK_EQUAL( parity( mgr, i + 1u ).index, fs[i].index );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_capacity_exceeded)
+{
+  bdd_manager mgr( 8u, 4u );
+
+  /* the node table cannot grow in concurrent mode */
+  {
+    concurrent_scope scope( mgr );
+    BOOST_CHECK( mgr.is_concurrent() );
+    BOOST_CHECK_THROW( parity( mgr, 8u ), dd_capacity_exceeded );
+  }
+  BOOST_CHECK( !mgr.is_concurrent() );
+
+  /* the manager is still usable and grows in sequential mode */
+  auto f = parity( mgr, 8u );
+  BOOST_CHECK( mgr.capacity() > 16u );
+  BOOST_CHECK_EQUAL( count_solutions( f ), 128u );
+}
+
+BOOST_AUTO_TEST_CASE(run_concurrent_grows_and_retries)
+{
+  bdd_manager mgr( 8u, 4u );
+
+  auto calls = 0u;
+  bdd f;
+  run_concurrent( mgr, [&]() {
+      ++calls;
+      BOOST_CHECK( mgr.is_concurrent() );
+      f = parity( mgr, 8u );
+    } );
+
+  BOOST_CHECK( !mgr.is_concurrent() );
+  BOOST_CHECK( calls > 1u );
+  BOOST_CHECK( mgr.capacity() > 16u );
+  BOOST_CHECK_EQUAL( count_solutions( f ), 128u );
+}
+
+BOOST_AUTO_TEST_CASE(forked_operations_grow)
+{
+  bdd_manager mgr( 16u, 4u );
+  mgr.set_num_threads( 4u, 4u );
+
+  auto f = mgr.bdd_bot();
+  auto g = mgr.bdd_top();
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    f = f ^ mgr.bdd_var( i );
+    g = g && ( mgr.bdd_var( i ) || mgr.bdd_var( ( i + 1u ) % 16u ) );
+  }
+
+  BOOST_CHECK( !mgr.is_concurrent() );
+  BOOST_CHECK( mgr.capacity() > 16u );
+  BOOST_CHECK_EQUAL( count_solutions( f ), 1u << 15u );
+  BOOST_CHECK_EQUAL( parity( mgr, 16u ).index, f.index );
+  BOOST_CHECK( count_solutions( g ) > 0u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,79 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE bit_parallel_simulation
+
+#include <cstdint>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/functions/bit_parallel_simulation.hpp>
+#include <classical/xmg/xmg.hpp>
+
+using namespace cirkit;
+
+BOOST_AUTO_TEST_CASE( random_rounds )
+{
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" );
+  const auto b = xmg.create_pi( "b" );
+  xmg.create_po( a, "a" );
+  xmg.create_po( xmg.create_and( a, b ), "f" );
+
+  auto sim = bit_parallel_simulator_from_xmg( xmg, 1u );
+  BOOST_CHECK_EQUAL( std::string( sim.kernel_name() ), "scalar" );
+
+  /* the second round must not repeat patterns of the first one, e.g., the
+     patterns of the second input shifted to the first input */
+  auto settings = std::make_shared<properties>();
+  auto statistics = std::make_shared<properties>();
+  bit_parallel_random_simulation( sim, 64u, settings, statistics );
+  const auto a0 = sim.node_words( 1u )[0u], b0 = sim.node_words( 2u )[0u];
+  BOOST_CHECK_EQUAL( sim.output_popcount( 1u ), static_cast<std::uint64_t>( __builtin_popcountll( a0 & b0 ) ) );
+  bit_parallel_random_simulation( sim, 128u, settings, statistics );
+  const auto a1 = sim.node_words( 1u )[0u], b1 = sim.node_words( 2u )[0u];
+  BOOST_CHECK( a1 != a0 && a1 != b0 && b1 != a0 && b1 != b0 );
+
+  const auto ones = bit_parallel_random_simulation( sim, 64u * 1024u, settings, statistics );
+  BOOST_CHECK_EQUAL( statistics->get<std::uint64_t>( "num_patterns" ), 64u * 1024u );
+  BOOST_CHECK_EQUAL( statistics->get<std::string>( "kernel" ), std::string( sim.kernel_name() ) );
+  BOOST_CHECK( ones[0u] > 31000u && ones[0u] < 34500u );
+  BOOST_CHECK( ones[1u] > 15000u && ones[1u] < 17800u );
+
+  auto wide = bit_parallel_simulator_from_xmg( xmg, 64u );
+  const auto wide_ones = bit_parallel_random_simulation( wide, 64u * 1024u, settings, statistics );
+  BOOST_CHECK_EQUAL( statistics->get<std::string>( "kernel" ), std::string( wide.kernel_name() ) );
+  BOOST_CHECK( wide_ones[1u] > 15000u && wide_ones[1u] < 17800u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,238 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE compact_aig
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/compact_aig/compact_aig.hpp>
+#include <classical/compact_aig/compact_aig_cuts.hpp>
+#include <classical/compact_aig/compact_aig_io.hpp>
+#include <classical/compact_aig/compact_aig_simulate.hpp>
+#include <classical/compact_aig/compact_aig_strash.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* random AIG, duplicate gates are only created if structural hashing is disabled */
+compact_aig random_compact_aig( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed, bool strash = true )
+{
+  std::mt19937 gen( seed );
+
+  compact_aig caig;
+  caig.set_structural_hashing( strash );
+
+  std::vector<compact_aig::literal> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( caig.create_pi() );
+  }
+
+  const auto pick = [&]() { return fs[gen() % fs.size()] ^ ( gen() % 2u ); };
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    const auto a = pick();
+    auto b = pick();
+    if ( compact_aig::get_node( a ) == compact_aig::get_node( b ) ) { b = fs[gen() % num_inputs]; }
+    fs.push_back( caig.create_and( a, b ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    caig.create_po( fs[fs.size() - 1u - i] ^ ( i % 2u ) );
+  }
+  return caig;
+}
+
+std::vector<uint64_t> random_words( unsigned count, unsigned seed )
+{
+  std::mt19937_64 gen( seed );
+  std::vector<uint64_t> words( count );
+  std::generate( words.begin(), words.end(), gen );
+  return words;
+}
+
+/* true, if every path from n to an input passes through a leaf */
+bool is_cut( const compact_aig& caig, compact_aig::node n, const std::vector<unsigned>& leaves )
+{
+  if ( std::find( leaves.begin(), leaves.end(), n ) != leaves.end() ) { return true; }
+  if ( caig.is_constant( n ) ) { return true; }
+  if ( caig.is_input( n ) ) { return false; }
+  return is_cut( caig, compact_aig::get_node( caig.fanin0( n ) ), leaves ) && is_cut( caig, compact_aig::get_node( caig.fanin1( n ) ), leaves );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(structural_hashing)
+{
+  compact_aig caig;
+  const auto a = caig.create_pi( "a" );
+  const auto b = caig.create_pi( "b" );
+
+  const auto f = caig.create_and( a, b ^ 1u );
+  BOOST_CHECK_EQUAL( caig.create_and( b ^ 1u, a ), f );
+  BOOST_CHECK_EQUAL( caig.num_gates(), 1u );
+
+  BOOST_CHECK_EQUAL( caig.create_and( a, caig.get_constant( false ) ), caig.get_constant( false ) );
+  BOOST_CHECK_EQUAL( caig.create_and( a, caig.get_constant( true ) ), a );
+  BOOST_CHECK_EQUAL( caig.create_and( a, a ), a );
+  BOOST_CHECK_EQUAL( caig.create_and( a, a ^ 1u ), caig.get_constant( false ) );
+  BOOST_CHECK_EQUAL( caig.num_gates(), 1u );
+  BOOST_CHECK_EQUAL( caig.strash().size(), 1u );
+
+  /* without structural hashing, every call creates a gate */
+  caig.set_structural_hashing( false );
+  BOOST_CHECK_NE( caig.create_and( a, b ^ 1u ), f );
+  BOOST_CHECK_EQUAL( caig.num_gates(), 2u );
+}
+
+BOOST_AUTO_TEST_CASE(simulate_operators)
+{
+  compact_aig caig;
+  const auto a = caig.create_pi();
+  const auto b = caig.create_pi();
+  const auto c = caig.create_pi();
+  caig.create_po( caig.create_and( a, b ) );
+  caig.create_po( caig.create_or( a, b ) );
+  caig.create_po( caig.create_xor( a, b ) );
+  caig.create_po( caig.create_ite( a, b, c ) );
+  caig.create_po( caig.create_nand( a, c ) );
+
+  const std::vector<uint64_t> inputs = {0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull};
+  const auto outputs = compact_aig_simulate( caig, inputs );
+
+  BOOST_CHECK_EQUAL( outputs[0u], inputs[0u] & inputs[1u] );
+  BOOST_CHECK_EQUAL( outputs[1u], inputs[0u] | inputs[1u] );
+  BOOST_CHECK_EQUAL( outputs[2u], inputs[0u] ^ inputs[1u] );
+  BOOST_CHECK_EQUAL( outputs[3u], ( inputs[0u] & inputs[1u] ) | ( ~inputs[0u] & inputs[2u] ) );
+  BOOST_CHECK_EQUAL( outputs[4u], ~( inputs[0u] & inputs[2u] ) );
+}
+
+BOOST_AUTO_TEST_CASE(aiger_round_trip)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    const auto caig = random_compact_aig( 10u, 200u, 5u, seed );
+
+    std::stringstream ss;
+    write_aiger( caig, ss );
+
+    compact_aig read;
+    read_aiger( read, ss );
+
+    BOOST_CHECK_EQUAL( read.num_inputs(), caig.num_inputs() );
+    BOOST_CHECK_EQUAL( read.num_outputs(), caig.num_outputs() );
+    BOOST_CHECK_EQUAL( read.num_gates(), caig.num_gates() );
+
+    const auto inputs = random_words( 10u * 4u, seed );
+    BOOST_CHECK( compact_aig_simulate( read, inputs, 4u ) == compact_aig_simulate( caig, inputs, 4u ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_ascii_aiger)
+{
+  /* x = a & !b, y = !x & c */
+  std::istringstream in( "aag 5 3 0 2 2\n2\n4\n6\n8\n11\n8 2 5\n10 9 6\n" );
+
+  compact_aig caig;
+  read_aiger( caig, in, true );
+  BOOST_CHECK_EQUAL( caig.num_inputs(), 3u );
+  BOOST_CHECK_EQUAL( caig.num_gates(), 2u );
+
+  const std::vector<uint64_t> inputs = {0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull};
+  const auto x = inputs[0u] & ~inputs[1u];
+  const auto outputs = compact_aig_simulate( caig, inputs );
+  BOOST_CHECK_EQUAL( outputs[0u], x );
+  BOOST_CHECK_EQUAL( outputs[1u], ~( ~x & inputs[2u] ) );
+}
+
+BOOST_AUTO_TEST_CASE(strash_removes_duplicates)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    const auto caig = random_compact_aig( 4u, 300u, 3u, seed, false );
+    const auto strashed = compact_aig_strash( caig );
+
+    BOOST_CHECK_LT( strashed.num_gates(), caig.num_gates() );
+    BOOST_CHECK_EQUAL( strashed.strash().size(), strashed.num_gates() );
+
+    /* no two gates have the same fanins */
+    std::vector<std::pair<compact_aig::literal, compact_aig::literal>> fanins;
+    for ( auto n = 1u; n < strashed.size(); ++n )
+    {
+      if ( strashed.is_and( n ) ) { fanins.emplace_back( strashed.fanin0( n ), strashed.fanin1( n ) ); }
+    }
+    std::sort( fanins.begin(), fanins.end() );
+    BOOST_CHECK( std::adjacent_find( fanins.begin(), fanins.end() ) == fanins.end() );
+
+    const auto inputs = random_words( 4u, seed );
+    BOOST_CHECK( compact_aig_simulate( strashed, inputs ) == compact_aig_simulate( caig, inputs ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cuts_are_valid)
+{
+  const auto caig = random_compact_aig( 8u, 150u, 4u, 3u );
+
+  for ( auto k : {3u, 4u, 6u} )
+  {
+    compact_aig_cuts cuts( caig, k );
+
+    for ( auto n = 1u; n < caig.size(); ++n )
+    {
+      auto trivial = false;
+      for ( const auto& cut : cuts.cuts( n ) )
+      {
+        const std::vector<unsigned> leaves( cut.begin(), cut.end() );
+        BOOST_CHECK_LE( leaves.size(), std::max( k, 1u ) );
+        BOOST_CHECK( std::is_sorted( leaves.begin(), leaves.end() ) );
+        BOOST_CHECK( is_cut( caig, n, leaves ) );
+
+        if ( leaves.size() == 1u && leaves.front() == n ) { trivial = true; }
+      }
+      BOOST_CHECK( trivial );
+
+      /* an AND gate always has the cut of its fanins */
+      if ( caig.is_and( n ) )
+      {
+        BOOST_CHECK_GE( cuts.count( n ), 2u );
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
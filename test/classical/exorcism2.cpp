@@ -0,0 +1,126 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE exorcism2
+
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/optimization/exorcism2.hpp>
+#include <classical/utils/cube2.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* truth table of an ESOP cover as vector of bits */
+std::vector<bool> evaluate( const std::vector<cube2>& cover, unsigned num_vars )
+{
+  std::vector<bool> tt( 1u << num_vars );
+  for ( auto x = 0u; x < tt.size(); ++x )
+  {
+    for ( const auto& c : cover )
+    {
+      if ( ( ( x ^ c.bits ) & c.mask ) == 0u )
+      {
+        tt[x] = !tt[x];
+      }
+    }
+  }
+  return tt;
+}
+
+/* random cubes over the variables in support */
+std::vector<cube2> random_cover( std::default_random_engine& gen, uint32_t support, unsigned num_cubes )
+{
+  std::uniform_int_distribution<uint32_t> dist;
+  std::vector<cube2> cover;
+  for ( auto i = 0u; i < num_cubes; ++i )
+  {
+    const auto mask = dist( gen ) & support;
+    cover.emplace_back( dist( gen ) & mask, mask );
+  }
+  return cover;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(partitioned_single_output)
+{
+  std::default_random_engine gen( 42u );
+
+  /* two groups with disjoint supports */
+  auto cover = random_cover( gen, 0x0fu, 20u );
+  const auto other = random_cover( gen, 0xf0u, 20u );
+  cover.insert( cover.end(), other.begin(), other.end() );
+
+  for ( auto num_threads : {1u, 2u} )
+  {
+    auto settings = std::make_shared<properties>();
+    settings->set( "num_threads", num_threads );
+    auto statistics = std::make_shared<properties>();
+
+    const auto opt = exorcism2( cover, 8, settings, statistics );
+
+    BOOST_CHECK( evaluate( opt, 8u ) == evaluate( cover, 8u ) );
+    BOOST_CHECK( opt.size() <= cover.size() );
+    BOOST_CHECK( statistics->get<unsigned>( "num_partitions" ) >= 2u );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(multi_output_with_merges)
+{
+  std::default_random_engine gen( 17u );
+
+  std::vector<std::vector<cube2>> covers;
+  for ( auto o = 0u; o < 4u; ++o )
+  {
+    covers.push_back( random_cover( gen, 0xffu, 30u ) );
+  }
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "num_threads", 0u );
+  settings->set( "merge_interval", 2u );
+
+  const auto opt = exorcism2( covers, 8, settings );
+
+  BOOST_REQUIRE_EQUAL( opt.size(), covers.size() );
+  for ( auto o = 0u; o < covers.size(); ++o )
+  {
+    BOOST_CHECK( evaluate( opt[o], 8u ) == evaluate( covers[o], 8u ) );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,232 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE npn_manager
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <classical/functions/npn_canonization.hpp>
+#include <classical/utils/npn_manager.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+tt random_tt( unsigned num_vars, std::mt19937& gen )
+{
+  tt t( 1u << num_vars );
+  for ( auto i = 0u; i < t.size(); ++i )
+  {
+    t[i] = gen() & 1u;
+  }
+  return t;
+}
+
+/* exact NPN canonization that counts its calls */
+npn_manager::npn_classifier_t counting_classifier( std::atomic<unsigned>& calls )
+{
+  return [&calls]( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) {
+    ++calls;
+    return exact_npn_canonization( t, phase, perm );
+  };
+}
+
+struct classification
+{
+  tt                      npn;
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned>   perm;
+
+  bool operator==( const classification& other ) const
+  {
+    return npn == other.npn && phase == other.phase && perm == other.perm;
+  }
+};
+
+classification classify( npn_manager& mgr, const tt& t )
+{
+  classification c;
+  c.npn = mgr.compute( t, c.phase, c.perm );
+  return c;
+}
+
+/* functions over 2 to 5 variables, with repetitions */
+std::vector<tt> random_functions( unsigned num_distinct, unsigned num_total, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  std::vector<tt> distinct;
+  for ( auto i = 0u; i < num_distinct; ++i )
+  {
+    distinct.push_back( random_tt( 2u + i % 4u, gen ) );
+  }
+
+  std::vector<tt> tts;
+  for ( auto i = 0u; i < num_total; ++i )
+  {
+    tts.push_back( distinct[gen() % distinct.size()] );
+  }
+  return tts;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(tt_words_round_trip)
+{
+  std::mt19937 gen( 1u );
+
+  std::vector<std::uint64_t> words;
+  for ( auto num_vars = 0u; num_vars <= 9u; ++num_vars )
+  {
+    const auto t = random_tt( num_vars, gen );
+    tt_to_words( t, words );
+
+    BOOST_CHECK_EQUAL( words.size(), ( t.size() + 63u ) / 64u );
+    for ( auto i = 0u; i < t.size(); ++i )
+    {
+      BOOST_CHECK_EQUAL( ( words[i / 64u] >> ( i % 64u ) ) & 1u, t[i] ? 1u : 0u );
+    }
+    if ( t.size() < 64u )
+    {
+      BOOST_CHECK_EQUAL( words[0u] >> t.size(), 0u );
+    }
+
+    BOOST_CHECK( tt_from_words( words.data(), t.size() ) == t );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cached_matches_uncached)
+{
+  const auto tts = random_functions( 60u, 600u, 2u );
+
+  std::atomic<unsigned> calls( 0u );
+  npn_manager uncached( 0u );
+  npn_manager cached( 4096u, counting_classifier( calls ) );
+
+  /* small tables and a small memory limit evict entries */
+  npn_manager small( 4u );
+  npn_manager limited( 4096u, make_exact_npn_canonization_wrapper(), 512u );
+
+  for ( const auto& t : tts )
+  {
+    const auto expected = classify( uncached, t );
+    BOOST_CHECK_EQUAL( expected.phase.size(), tt_num_vars( t ) + 1u );
+    BOOST_CHECK( classify( cached, t ) == expected );
+    BOOST_CHECK( classify( small, t ) == expected );
+    BOOST_CHECK( classify( limited, t ) == expected );
+  }
+
+  /* every distinct function is classified once */
+  BOOST_CHECK_LE( calls.load(), 60u );
+  for ( const auto& t : tts )
+  {
+    classify( cached, t );
+  }
+  BOOST_CHECK_LE( calls.load(), 60u );
+}
+
+BOOST_AUTO_TEST_CASE(batch_matches_individual)
+{
+  const auto tts = random_functions( 80u, 500u, 3u );
+
+  npn_manager reference( 0u );
+  std::vector<classification> expected;
+  for ( const auto& t : tts )
+  {
+    expected.push_back( classify( reference, t ) );
+  }
+
+  for ( auto num_threads : {1u, 4u} )
+  {
+    std::atomic<unsigned> calls( 0u );
+    npn_manager mgr( 4096u, counting_classifier( calls ) );
+
+    /* some functions are already in the cache */
+    for ( auto i = 0u; i < 10u; ++i )
+    {
+      classify( mgr, tts[i] );
+    }
+
+    std::vector<boost::dynamic_bitset<>> phases;
+    std::vector<std::vector<unsigned>> perms;
+    const auto npns = mgr.compute( tts, phases, perms, num_threads );
+
+    BOOST_REQUIRE_EQUAL( npns.size(), tts.size() );
+    for ( auto i = 0u; i < tts.size(); ++i )
+    {
+      BOOST_CHECK( ( classification{npns[i], phases[i], perms[i]} ) == expected[i] );
+    }
+    BOOST_CHECK_LE( calls.load(), 80u );
+
+    /* the batch filled the cache */
+    const auto batch_calls = calls.load();
+    for ( const auto& t : tts )
+    {
+      classify( mgr, t );
+    }
+    BOOST_CHECK_EQUAL( calls.load(), batch_calls );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(large_functions_are_not_cached)
+{
+  std::atomic<unsigned> calls( 0u );
+  npn_manager mgr( 4096u, [&calls]( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) {
+      ++calls;
+      phase.resize( tt_num_vars( t ) + 1u );
+      perm.resize( tt_num_vars( t ) );
+      return t;
+    } );
+
+  const tt t( 1u << ( npn_manager::max_num_vars + 1u ) );
+  for ( auto i = 0u; i < 2u; ++i )
+  {
+    classification c;
+    c.npn = mgr.compute( t, c.phase, c.perm );
+    BOOST_CHECK( c.npn == t );
+  }
+  BOOST_CHECK_EQUAL( calls.load(), 2u );
+
+  std::vector<boost::dynamic_bitset<>> phases;
+  std::vector<std::vector<unsigned>> perms;
+  mgr.compute( {t, t}, phases, perms );
+  BOOST_CHECK_EQUAL( calls.load(), 4u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,373 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE paged_cuts
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/graph/topological_sort.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/cuts/fixed_cut.hpp>
+#include <classical/functions/cuts/paged.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_cuts_paged.hpp>
+
+#include "random_xmg.hpp"
+
+using namespace cirkit;
+
+namespace
+{
+
+using leaves_t = std::vector<unsigned>;
+using children_func_t = std::function<std::vector<unsigned>(unsigned)>;
+
+aig_graph random_aig( unsigned num_inputs, unsigned num_gates, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  aig_graph aig;
+  aig_initialize( aig );
+
+  std::vector<aig_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( aig_create_pi( aig, "x" + std::to_string( i ) ) );
+  }
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    /* prefer recent nodes for deep networks */
+    std::uniform_int_distribution<unsigned> dist( fs.size() > 12u ? fs.size() - 12u : 0u, fs.size() - 1u );
+    const auto pick = [&]() { return fs[dist( gen )] ^ static_cast<bool>( gen() & 1u ); };
+
+    fs.push_back( aig_create_and( aig, pick(), pick() ) );
+  }
+  aig_create_po( aig, fs.back(), "y" );
+
+  return aig;
+}
+
+/* all k-feasible cuts that do not contain another cut, computed with sets */
+std::vector<std::set<leaves_t>> reference_cuts( const std::vector<unsigned>& topsort, unsigned size, const children_func_t& children, unsigned k )
+{
+  std::vector<std::set<leaves_t>> cuts( size );
+
+  for ( auto n : topsort )
+  {
+    const auto cs = children( n );
+    if ( cs.empty() )
+    {
+      cuts[n].insert( n == 0u ? leaves_t() : leaves_t{n} );
+      continue;
+    }
+
+    std::set<leaves_t> merged{leaves_t()};
+    for ( auto c : cs )
+    {
+      std::set<leaves_t> next;
+      for ( const auto& m : merged )
+      {
+        for ( const auto& cc : cuts[c] )
+        {
+          std::set<unsigned> u( m.begin(), m.end() );
+          u.insert( cc.begin(), cc.end() );
+          if ( u.size() <= k )
+          {
+            next.insert( leaves_t( u.begin(), u.end() ) );
+          }
+        }
+      }
+      merged.swap( next );
+    }
+
+    for ( const auto& cut : merged )
+    {
+      const auto dominated = std::any_of( merged.begin(), merged.end(), [&cut]( const leaves_t& other ) {
+          return other != cut && std::includes( cut.begin(), cut.end(), other.begin(), other.end() );
+        } );
+      if ( !dominated )
+      {
+        cuts[n].insert( cut );
+      }
+    }
+    cuts[n].insert( leaves_t{n} );
+  }
+
+  return cuts;
+}
+
+/* every path from n to an input passes through a leaf */
+bool is_cut( unsigned n, const leaves_t& leaves, const children_func_t& children )
+{
+  if ( std::find( leaves.begin(), leaves.end(), n ) != leaves.end() ) { return true; }
+
+  const auto cs = children( n );
+  if ( cs.empty() ) { return n == 0u; }
+
+  return std::all_of( cs.begin(), cs.end(), [&]( unsigned c ) { return is_cut( c, leaves, children ); } );
+}
+
+template<typename Range>
+std::set<leaves_t> to_set( const Range& sets )
+{
+  std::set<leaves_t> result;
+  for ( const auto& s : sets )
+  {
+    result.insert( leaves_t( s.begin(), s.end() ) );
+  }
+  return result;
+}
+
+/* sets in order, each preceded by its k extra values */
+template<typename Range>
+std::vector<leaves_t> paged_sets( const Range& sets, unsigned k )
+{
+  std::vector<leaves_t> result;
+  for ( const auto& s : sets )
+  {
+    leaves_t v;
+    for ( auto i = 0u; i < k; ++i )
+    {
+      v.push_back( s.extra( i ) );
+    }
+    v.insert( v.end(), s.begin(), s.end() );
+    result.push_back( v );
+  }
+  return result;
+}
+
+std::vector<unsigned> aig_children( const aig_graph& aig, unsigned n )
+{
+  std::vector<unsigned> cs;
+  for ( auto c : boost::make_iterator_range( adjacent_vertices( n, aig ) ) )
+  {
+    cs.push_back( c );
+  }
+  return cs;
+}
+
+std::vector<unsigned> xmg_children( const xmg_graph& xmg, unsigned n )
+{
+  std::vector<unsigned> cs;
+  if ( !xmg.is_input( n ) )
+  {
+    for ( const auto& c : xmg.children( n ) )
+    {
+      cs.push_back( c.node );
+    }
+  }
+  return cs;
+}
+
+std::vector<unsigned> aig_topsort( const aig_graph& aig )
+{
+  std::vector<unsigned> topsort( num_vertices( aig ) );
+  boost::topological_sort( aig, topsort.begin() );
+  return topsort;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(fixed_cut_operations)
+{
+  using cut_t = fixed_cut<8u>;
+
+  const unsigned l1[] = {1u, 3u, 5u};
+  const unsigned l2[] = {2u, 3u, 70u};
+  const auto a = cut_t::from_sorted_range( l1, l1 + 3 );
+  const auto b = cut_t::from_sorted_range( l2, l2 + 3 );
+
+  cut_t c;
+  BOOST_REQUIRE( c.merge( a, b, 5u ) );
+  BOOST_CHECK( c.to_vector() == std::vector<unsigned>( {1u, 2u, 3u, 5u, 70u} ) );
+  BOOST_CHECK_EQUAL( c.signature(), a.signature() | b.signature() );
+  BOOST_CHECK( !c.merge( a, b, 4u ) );
+
+  /* leaves 5 and 69 share a signature bit */
+  const unsigned l3[] = {5u, 69u};
+  const auto d = cut_t::from_sorted_range( l3, l3 + 2 );
+  BOOST_REQUIRE( c.merge( a, d, 4u ) );
+  BOOST_CHECK( c.to_vector() == std::vector<unsigned>( {1u, 3u, 5u, 69u} ) );
+
+  BOOST_CHECK( a.dominates( a ) );
+  BOOST_CHECK( a.dominates( c ) );
+  BOOST_CHECK( !c.dominates( a ) );
+  BOOST_CHECK( !d.dominates( a ) );
+  BOOST_CHECK( cut_t::singleton( 3u ).dominates( b ) );
+  BOOST_CHECK( !cut_t::singleton( 67u ).dominates( b ) );
+
+  std::vector<cut_t> cuts{a, d};
+  BOOST_CHECK( !add_cut_with_dominance_filter( cuts, c ) );
+  BOOST_CHECK( add_cut_with_dominance_filter( cuts, cut_t::singleton( 5u ) ) );
+  BOOST_CHECK_EQUAL( cuts.size(), 1u );
+}
+
+BOOST_AUTO_TEST_CASE(aig_cuts_match_reference)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    const auto aig = random_aig( 8u, 150u, seed );
+    const auto children = [&aig]( unsigned n ) { return aig_children( aig, n ); };
+
+    for ( auto k : {3u, 5u} )
+    {
+      const auto reference = reference_cuts( aig_topsort( aig ), num_vertices( aig ), children, k );
+
+      paged_aig_cuts cuts( aig, k, false, 100000u );
+      for ( auto n = 0u; n < num_vertices( aig ); ++n )
+      {
+        BOOST_CHECK( to_set( cuts.cuts( n ) ) == reference[n] );
+      }
+
+      /* with the default priority, cuts are still valid */
+      paged_aig_cuts pcuts( aig, k, false );
+      for ( auto n = 1u; n < num_vertices( aig ); ++n )
+      {
+        BOOST_CHECK_LE( pcuts.count( n ), 9u );
+        for ( const auto& cut : to_set( pcuts.cuts( n ) ) )
+        {
+          BOOST_CHECK_LE( cut.size(), k );
+          BOOST_CHECK( is_cut( n, cut, children ) );
+        }
+      }
+    }
+  }
+
+  const auto aig = random_aig( 4u, 10u, 0u );
+  BOOST_CHECK_THROW( paged_aig_cuts( aig, paged_aig_cuts::max_cut_size + 1u, false ), std::string );
+}
+
+BOOST_AUTO_TEST_CASE(xmg_cuts_match_reference)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    auto xmg = random_xmg( 8u, 120u, 3u, seed );
+    const auto children = [&xmg]( unsigned n ) { return xmg_children( xmg, n ); };
+    const auto nodes = xmg.topological_nodes();
+    const std::vector<unsigned> topsort( nodes.begin(), nodes.end() );
+
+    for ( auto k : {3u, 5u} )
+    {
+      const auto reference = reference_cuts( topsort, xmg.size(), children, k );
+
+      xmg_cuts_paged cuts( xmg, k, make_settings_from( std::make_pair( "priority", 100000u ) ) );
+      for ( auto n : topsort )
+      {
+        BOOST_CHECK( to_set( cuts.cuts( n ) ) == reference[n] );
+
+        /* cones contain leaves and root, the size extra counts them */
+        std::vector<leaves_t> cones;
+        for ( const auto& cone : cuts.cut_cones( n ) )
+        {
+          cones.emplace_back( cone.begin(), cone.end() );
+        }
+        auto i = 0u;
+        for ( const auto& cut : cuts.cuts( n ) )
+        {
+          const auto& cone = cones.at( i++ );
+          BOOST_CHECK( std::includes( cone.begin(), cone.end(), cut.begin(), cut.end() ) );
+          BOOST_CHECK( n == 0u || std::binary_search( cone.begin(), cone.end(), static_cast<unsigned>( n ) ) );
+          BOOST_CHECK_EQUAL( cuts.size( n, cut ), cone.size() );
+        }
+      }
+
+      xmg_cuts_paged pcuts( xmg, k );
+      for ( auto n : topsort )
+      {
+        BOOST_CHECK_LE( pcuts.count( n ), 9u );
+        for ( const auto& cut : to_set( pcuts.cuts( n ) ) )
+        {
+          BOOST_CHECK_LE( cut.size(), k );
+          BOOST_CHECK( is_cut( n, cut, children ) );
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_aig_cuts)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    const auto aig = random_aig( 16u, 2000u, seed );
+
+    for ( auto k : {4u, 6u} )
+    {
+      paged_aig_cuts sequential( aig, k, false );
+      paged_aig_cuts parallel( aig, k, true );
+
+      BOOST_CHECK_EQUAL( parallel.total_cut_count(), sequential.total_cut_count() );
+      for ( auto n = 0u; n < num_vertices( aig ); ++n )
+      {
+        BOOST_CHECK( paged_sets( parallel.cuts( n ), 0u ) == paged_sets( sequential.cuts( n ), 0u ) );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_xmg_cuts)
+{
+  for ( auto seed = 0u; seed < 5u; ++seed )
+  {
+    auto xmg = random_xmg( 16u, 2000u, 3u, seed );
+
+    for ( auto k : {4u, 6u} )
+    {
+      xmg_cuts_paged sequential( xmg, k );
+
+      for ( auto num_threads : {1u, 4u} )
+      {
+        const auto settings = make_settings_from( std::make_pair( "parallel", true ), std::make_pair( "num_threads", num_threads ) );
+        xmg_cuts_paged parallel( xmg, k, settings );
+
+        BOOST_CHECK_EQUAL( parallel.total_cut_count(), sequential.total_cut_count() );
+        for ( auto n : xmg.nodes() )
+        {
+          /* cuts in the same order with depth and size, and the same cones */
+          BOOST_CHECK( paged_sets( parallel.cuts( n ), 2u ) == paged_sets( sequential.cuts( n ), 2u ) );
+          BOOST_CHECK( paged_sets( parallel.cut_cones( n ), 0u ) == paged_sets( sequential.cut_cones( n ), 0u ) );
+        }
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
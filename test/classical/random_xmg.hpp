@@ -0,0 +1,91 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file random_xmg.hpp
+ *
+ * @brief Random XMGs for tests
+ *
+ * @author Mathias Soeken
+ * @since  2.4
+ */
+
+#ifndef TEST_RANDOM_XMG_HPP
+#define TEST_RANDOM_XMG_HPP
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <classical/xmg/xmg.hpp>
+
+namespace cirkit
+{
+
+/* MAJ, XOR, and AND gates with random complemented fanins, which are picked
+   among the last window nodes (among all nodes if window is 0) such that
+   larger networks get deep; the outputs are the last num_outputs nodes */
+inline xmg_graph random_xmg( unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed, unsigned window = 12u )
+{
+  std::mt19937 gen( seed );
+  xmg_graph xmg;
+
+  std::vector<xmg_function> fs;
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( xmg.create_pi( "x" + std::to_string( i ) ) );
+  }
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    std::uniform_int_distribution<unsigned> dist( window != 0u && fs.size() > window ? fs.size() - window : 0u, fs.size() - 1u );
+    const auto pick = [&]() { return fs[dist( gen )] ^ static_cast<bool>( gen() & 1u ); };
+
+    switch ( gen() % 4u )
+    {
+    case 0u: fs.push_back( xmg.create_xor( pick(), pick() ) ); break;
+    case 1u: fs.push_back( xmg.create_and( pick(), pick() ) ); break;
+    default: fs.push_back( xmg.create_maj( pick(), pick(), pick() ) ); break;
+    }
+  }
+
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    xmg.create_po( fs[fs.size() - 1u - i], "y" + std::to_string( i ) );
+  }
+
+  return xmg;
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
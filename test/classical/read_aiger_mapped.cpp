@@ -0,0 +1,187 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE read_aiger_mapped
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/any.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <core/utils/timer.hpp>
+#include <classical/aig.hpp>
+#include <classical/io/read_aiger.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+void encode( std::ostream& os, unsigned x )
+{
+  while ( x & ~0x7f )
+  {
+    os.put( static_cast<char>( ( x & 0x7f ) | 0x80 ) );
+    x >>= 7u;
+  }
+  os.put( static_cast<char>( x ) );
+}
+
+/* random binary AIGER file with symbol table and comment */
+void write_random_aiger( const std::string& filename, unsigned num_inputs, unsigned num_ands, unsigned num_outputs, unsigned seed )
+{
+  std::mt19937 gen( seed );
+
+  std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+  os << "aig " << num_inputs + num_ands << " " << num_inputs << " 0 " << num_outputs << " " << num_ands << "\n";
+
+  const auto max_lit = 2u * ( num_inputs + num_ands ) + 1u;
+  for ( auto i = 0u; i < num_outputs; ++i )
+  {
+    os << std::uniform_int_distribution<unsigned>( 0u, max_lit )( gen ) << "\n";
+  }
+
+  for ( auto i = 0u; i < num_ands; ++i )
+  {
+    const auto g = 2u * ( num_inputs + i + 1u );
+    auto a = std::uniform_int_distribution<unsigned>( 2u, g - 1u )( gen );
+    auto b = std::uniform_int_distribution<unsigned>( 2u, g - 1u )( gen );
+    if ( a < b ) { std::swap( a, b ); }
+    encode( os, g - a );
+    encode( os, a - b );
+  }
+
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    os << "i" << i << " in" << i << "\n";
+  }
+  os << "o0 first\n";
+  os << "c\nrandom AIG\n";
+}
+
+void check_same( const aig_graph& aig1, const aig_graph& aig2 )
+{
+  const auto& info1 = aig_info( aig1 );
+  const auto& info2 = aig_info( aig2 );
+
+  BOOST_REQUIRE_EQUAL( num_vertices( aig1 ), num_vertices( aig2 ) );
+  BOOST_CHECK_EQUAL( num_edges( aig1 ), num_edges( aig2 ) );
+  BOOST_CHECK( info1.inputs == info2.inputs );
+  BOOST_CHECK( info1.outputs == info2.outputs );
+  BOOST_CHECK( info1.node_names == info2.node_names );
+  BOOST_CHECK_EQUAL( info1.model_name, info2.model_name );
+
+  const auto& complement1 = boost::get( boost::edge_complement, aig1 );
+  const auto& complement2 = boost::get( boost::edge_complement, aig2 );
+  for ( auto n = 0u; n < num_vertices( aig1 ); ++n )
+  {
+    std::vector<std::pair<aig_node, bool>> cs1, cs2;
+    for ( const auto& e : boost::make_iterator_range( out_edges( n, aig1 ) ) ) { cs1.push_back( {target( e, aig1 ), complement1[e]} ); }
+    for ( const auto& e : boost::make_iterator_range( out_edges( n, aig2 ) ) ) { cs2.push_back( {target( e, aig2 ), complement2[e]} ); }
+    BOOST_CHECK( cs1 == cs2 );
+  }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( small_aig )
+{
+  const std::string filename = "/tmp/test_read_aiger_mapped_small.aig";
+  write_random_aiger( filename, 8u, 100u, 5u, 42u );
+
+  for ( auto noopt : {false, true} )
+  {
+    aig_graph aig1, aig2;
+    read_aiger_binary( aig1, filename, noopt );
+
+    auto settings = std::make_shared<properties>();
+    settings->set( "strash", !noopt );
+    read_aiger_mapped( aig2, filename, settings );
+
+    check_same( aig1, aig2 );
+  }
+
+  /* lazy symbol table */
+  aig_graph aig;
+  auto settings = std::make_shared<properties>();
+  auto statistics = std::make_shared<properties>();
+  settings->set( "symbols", false );
+  read_aiger_mapped( aig, filename, settings, statistics );
+  BOOST_CHECK_EQUAL( aig_info( aig ).outputs[0].second, "" );
+
+  read_aiger_symbols( aig, filename, statistics->get<std::size_t>( "symbol_offset" ) );
+  BOOST_CHECK_EQUAL( aig_info( aig ).outputs[0].second, "first" );
+  BOOST_CHECK_EQUAL( aig_info( aig ).node_names.at( aig_info( aig ).inputs[7] ), "in7" );
+
+  std::remove( filename.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE( parallel_decoding )
+{
+  const std::string filename = "/tmp/test_read_aiger_mapped_large.aig";
+  write_random_aiger( filename, 64u, 300000u, 32u, 7u );
+
+  aig_graph aig1, aig2, aig3;
+  read_aiger_binary( aig1, filename, true );
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "strash", false );
+  settings->set( "num_threads", 1u );
+  read_aiger_mapped( aig2, filename, settings );
+  check_same( aig1, aig2 );
+
+  settings->set( "num_threads", 4u );
+  read_aiger_mapped( aig3, filename, settings );
+  check_same( aig1, aig3 );
+
+  std::remove( filename.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE( truncated_file )
+{
+  const std::string filename = "/tmp/test_read_aiger_mapped_truncated.aig";
+  {
+    std::ofstream os( filename.c_str(), std::ofstream::out | std::ofstream::binary );
+    os << "aig 3 2 0 1 1\n6\n" << static_cast<char>( 0x82 );
+  }
+
+  aig_graph aig;
+  BOOST_CHECK_THROW( read_aiger_mapped( aig, filename ), const char* );
+
+  std::remove( filename.c_str() );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,210 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE structural_hashing
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/mig/mig_utils.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_utils.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+void check_statistics( const properties::ptr& statistics, const std::string& prefix, unsigned size )
+{
+  BOOST_CHECK_EQUAL( statistics->get<unsigned>( prefix + "_size" ), size );
+  BOOST_CHECK( statistics->has_key( prefix + "_load_factor" ) );
+  BOOST_CHECK( statistics->has_key( prefix + "_average_probe_length" ) );
+  BOOST_CHECK( statistics->has_key( prefix + "_max_probe_length" ) );
+  BOOST_CHECK( statistics->has_key( prefix + "_rehashes" ) );
+  BOOST_CHECK_LE( statistics->get<double>( prefix + "_load_factor" ), 0.5 );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(xmg_permuted_and_complemented_children)
+{
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" ), b = xmg.create_pi( "b" ), c = xmg.create_pi( "c" );
+
+  const auto f = xmg.create_maj( a, b, c );
+  BOOST_CHECK( xmg.create_maj( c, a, b ) == f );
+  BOOST_CHECK( xmg.create_maj( b, c, a ) == f );
+  BOOST_CHECK( xmg.create_maj( !a, !b, !c ) == !f );
+  BOOST_CHECK( xmg.create_maj( !c, !b, !a ) == !f );
+
+  const auto g = xmg.create_maj( !a, b, c );
+  BOOST_CHECK( g.node != f.node );
+  BOOST_CHECK( xmg.create_maj( a, !b, !c ) == !g );
+
+  const auto h = xmg.create_xor( a, b );
+  BOOST_CHECK( xmg.create_xor( b, a ) == h );
+  BOOST_CHECK( xmg.create_xor( !a, b ) == !h );
+  BOOST_CHECK( xmg.create_xor( !b, !a ) == h );
+
+  BOOST_CHECK_EQUAL( xmg.num_maj(), 2u );
+  BOOST_CHECK_EQUAL( xmg.num_xor(), 1u );
+  BOOST_CHECK_EQUAL( xmg.maj_strash_table().size(), 2u );
+  BOOST_CHECK_EQUAL( xmg.xor_strash_table().size(), 1u );
+
+  /* without structural hashing, every call creates a gate */
+  xmg.set_structural_hashing( false );
+  BOOST_CHECK( xmg.create_maj( a, b, c ).node != f.node );
+  BOOST_CHECK_EQUAL( xmg.num_maj(), 3u );
+}
+
+BOOST_AUTO_TEST_CASE(xmg_many_gates)
+{
+  std::default_random_engine gen( 7u );
+
+  xmg_graph xmg;
+  std::vector<xmg_function> fs;
+  for ( auto i = 0u; i < 16u; ++i )
+  {
+    fs.push_back( xmg.create_pi( "x" + std::to_string( i ) ) );
+  }
+
+  /* enough gates to rehash the tables several times */
+  const auto pick = [&]() {
+    return fs[std::uniform_int_distribution<unsigned>( 0u, fs.size() - 1u )( gen )] ^ ( gen() & 1u );
+  };
+
+  std::vector<std::vector<xmg_function>> fanins;
+  std::vector<xmg_function> gates;
+  for ( auto i = 0u; i < 5000u; ++i )
+  {
+    std::vector<xmg_function> children = i % 4u == 0u ? std::vector<xmg_function>{pick(), pick()} : std::vector<xmg_function>{pick(), pick(), pick()};
+    const auto f = children.size() == 2u ? xmg.create_xor( children[0], children[1] ) : xmg.create_maj( children[0], children[1], children[2] );
+    fanins.push_back( children );
+    gates.push_back( f );
+    fs.push_back( f );
+  }
+
+  const auto size = xmg.size();
+  BOOST_CHECK_GT( xmg.maj_strash_table().num_rehashes(), 0u );
+
+  /* recreating all gates with reversed children returns the same functions */
+  for ( auto i = 0u; i < gates.size(); ++i )
+  {
+    const auto& c = fanins[i];
+    const auto f = c.size() == 2u ? xmg.create_xor( c[1], c[0] ) : xmg.create_maj( c[2], c[1], c[0] );
+    BOOST_CHECK( f == gates[i] );
+  }
+  BOOST_CHECK_EQUAL( xmg.size(), size );
+  BOOST_CHECK_EQUAL( xmg.maj_strash_table().size(), xmg.num_maj() );
+  BOOST_CHECK_EQUAL( xmg.xor_strash_table().size(), xmg.num_xor() );
+
+  auto statistics = std::make_shared<properties>();
+  xmg_strash_statistics( xmg, statistics );
+  check_statistics( statistics, "maj_strash", xmg.num_maj() );
+  check_statistics( statistics, "xor_strash", xmg.num_xor() );
+}
+
+BOOST_AUTO_TEST_CASE(xmg_strash_after_substitution)
+{
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" ), b = xmg.create_pi( "b" ), c = xmg.create_pi( "c" ), d = xmg.create_pi( "d" );
+  const auto f = xmg.create_maj( a, b, c );
+  const auto g = xmg.create_maj( f, c, d );
+  const auto h = xmg.create_xor( f, d );
+  xmg.create_po( g, "g" );
+  xmg.create_po( h, "h" );
+
+  xmg.compute_fanout();
+  xmg.compute_parents();
+
+  /* parents are rewired in place and rehashed with their new fanins */
+  xmg.substitute_node( f.node, b );
+  BOOST_CHECK( xmg.is_dead( f.node ) );
+  BOOST_CHECK( xmg.create_maj( d, c, b ) == g );
+  BOOST_CHECK( xmg.create_xor( d, b ) == h );
+
+  /* the removed gate is not in the table anymore */
+  const auto f2 = xmg.create_maj( a, b, c );
+  BOOST_CHECK( f2.node != f.node );
+  BOOST_CHECK( !xmg.is_dead( f2.node ) );
+
+  /* a parent that becomes equal to an existing gate is merged into it */
+  const auto u = xmg.create_xor( a, c );
+  const auto v = xmg.create_maj( u, b, d );
+  const auto e = xmg.create_maj( a, b, d );
+  xmg.create_po( v, "v" );
+
+  xmg.substitute_node( u.node, a );
+  BOOST_CHECK( xmg.is_dead( u.node ) );
+  BOOST_CHECK( xmg.is_dead( v.node ) );
+  BOOST_CHECK( xmg.outputs().back().first == e );
+  BOOST_CHECK( xmg.create_maj( d, b, a ) == e );
+  BOOST_CHECK_EQUAL( xmg.maj_strash_table().size(), xmg.num_maj() );
+  BOOST_CHECK_EQUAL( xmg.xor_strash_table().size(), xmg.num_xor() );
+}
+
+BOOST_AUTO_TEST_CASE(mig_permuted_children)
+{
+  mig_graph mig;
+  mig_initialize( mig );
+
+  const auto a = mig_create_pi( mig, "a" ), b = mig_create_pi( mig, "b" ), c = mig_create_pi( mig, "c" );
+  const auto f = mig_create_maj( mig, a, b, c );
+  BOOST_CHECK( mig_create_maj( mig, c, b, a ) == f );
+  BOOST_CHECK( mig_create_maj( mig, b, a, c ) == f );
+
+  const auto g = mig_create_maj( mig, !a, b, c );
+  BOOST_CHECK( g.node != f.node );
+  BOOST_CHECK( mig_create_maj( mig, c, !a, b ) == g );
+
+  const auto h = mig_create_and( mig, a, b );
+  BOOST_CHECK( mig_create_and( mig, b, a ) == h );
+  BOOST_CHECK( mig_create_or( mig, a, b ).node != h.node );
+
+  const auto num_nodes = num_vertices( mig );
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    mig_create_xor( mig, a, c );
+  }
+  BOOST_CHECK_EQUAL( num_vertices( mig ), num_nodes + 3u );
+
+  auto statistics = std::make_shared<properties>();
+  mig_strash_statistics( mig, statistics );
+  check_statistics( statistics, "strash", num_vertices( mig ) - 4u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
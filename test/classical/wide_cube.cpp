@@ -0,0 +1,164 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE wide_cube
+
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/optimization/exorcism2.hpp>
+#include <classical/utils/cube2.hpp>
+#include <classical/utils/wide_cube.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* embeds a 32-bit cube at variable offset */
+template<typename Cube>
+Cube widen( const cube2& c, unsigned offset )
+{
+  Cube res;
+  for ( auto i = 0u; i < 32u; ++i )
+  {
+    if ( c.has_var( i ) )
+    {
+      res.rotate( offset + i );
+      if ( !c.polarity( i ) )
+      {
+        res.rotate( offset + i );
+      }
+    }
+  }
+  return res;
+}
+
+/* value of an ESOP cover over variables offset, ..., offset + n - 1 */
+template<typename Cube>
+std::vector<bool> evaluate( const std::vector<Cube>& cover, unsigned offset, unsigned n )
+{
+  std::vector<bool> tt( 1u << n );
+  for ( auto x = 0u; x < tt.size(); ++x )
+  {
+    for ( const auto& c : cover )
+    {
+      auto sat = true;
+      for ( auto i = 0u; i < n && sat; ++i )
+      {
+        sat = !c.has_var( offset + i ) || c.polarity( offset + i ) == ( ( x >> i ) & 1 );
+      }
+      if ( sat )
+      {
+        tt[x] = !tt[x];
+      }
+    }
+  }
+  return tt;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(same_as_cube2)
+{
+  std::default_random_engine gen( 1u );
+  std::uniform_int_distribution<uint32_t> dist;
+
+  for ( auto k = 0u; k < 1000u; ++k )
+  {
+    const auto m1 = dist( gen ) & dist( gen ), m2 = m1 ^ ( 1u << ( k % 32u ) ) ^ ( 1u << ( ( 7u * k ) % 32u ) );
+    const cube2 c1( dist( gen ) & m1, m1 ), c2( dist( gen ) & m2, m2 );
+
+    for ( auto offset : {0u, 20u, 40u, 96u} )
+    {
+      const auto w1 = widen<cube128>( c1, offset ), w2 = widen<cube128>( c2, offset );
+
+      BOOST_CHECK_EQUAL( w1.num_literals(), c1.num_literals() );
+      BOOST_CHECK_EQUAL( w1.distance( w2 ), c1.distance( c2 ) );
+      BOOST_CHECK( ( w1 & w2 ) == ( ( c1 & c2 ) == cube2::zero_cube() ? cube128::zero_cube() : widen<cube128>( c1 & c2, offset ) ) );
+
+      if ( c1.distance( c2 ) == 1 )
+      {
+        BOOST_CHECK( w1.merge( w2 ) == widen<cube128>( c1.merge( c2 ), offset ) );
+      }
+
+      const auto d = c1.distance( c2 );
+      if ( d >= 2 && d <= 4 )
+      {
+        unsigned group[16] = {2, 0, 1, 2, 0, 1, 1, 2, 0, 2, 1, 0, 1, 1, 2, 0};
+        const auto r = c1.exorlink( c2, d, c1.differences( c2 ), group );
+        const auto wr = w1.exorlink( w2, d, w1.differences( w2 ), group );
+        for ( auto i = 0; i < d; ++i )
+        {
+          BOOST_CHECK( wr[i] == widen<cube128>( r[i], offset ) );
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(exorcism_beyond_32_inputs)
+{
+  std::default_random_engine gen( 5u );
+  std::uniform_int_distribution<uint32_t> dist;
+
+  /* 12 variables starting at variable 30 */
+  std::vector<cube64> cover;
+  for ( auto i = 0u; i < 60u; ++i )
+  {
+    const auto mask = dist( gen ) & 0xfffu;
+    cover.push_back( widen<cube64>( cube2( dist( gen ) & mask, mask ), 30u ) );
+  }
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "num_threads", 2u );
+  const auto opt = exorcism2( cover, 64, settings );
+
+  BOOST_CHECK( opt.size() <= cover.size() );
+  BOOST_CHECK( evaluate( opt, 30u, 12u ) == evaluate( cover, 30u, 12u ) );
+
+  auto selected = 0u;
+  with_cube_type( 42u, [&selected]( auto tag ) { selected = decltype( tag )::max_vars; } );
+  BOOST_CHECK_EQUAL( selected, 64u );
+}
+
+BOOST_AUTO_TEST_CASE(cube_type_limit)
+{
+  auto selected = 0u;
+  with_cube_type( 256u, [&selected]( auto tag ) { selected = decltype( tag )::max_vars; } );
+  BOOST_CHECK_EQUAL( selected, 256u );
+
+  BOOST_CHECK_THROW( with_cube_type( 257u, []( auto ) {} ), std::string );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
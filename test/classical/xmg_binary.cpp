@@ -0,0 +1,294 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_binary
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/utils/mapped_file.hpp>
+#include <classical/io/binary_network.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/mig/mig_binary.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_binary.hpp>
+#include <classical/xmg/xmg_cover.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+std::vector<uint64_t> simulate_outputs( const xmg_graph& xmg )
+{
+  static const uint64_t projections[] = {0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+                                         0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull};
+
+  std::vector<uint64_t> tts( xmg.size(), 0u );
+  for ( auto i = 0u; i < xmg.inputs().size(); ++i )
+  {
+    tts[xmg.inputs()[i].first] = projections[i];
+  }
+
+  const auto value = [&tts]( const xmg_function& f ) { return f.complemented ? ~tts[f.node] : tts[f.node]; };
+
+  for ( auto n : xmg.topological_nodes() )
+  {
+    const auto cs = xmg.children( n );
+    if ( cs.size() == 3u )
+    {
+      tts[n] = ( value( cs[0] ) & value( cs[1] ) ) | ( value( cs[0] ) & value( cs[2] ) ) | ( value( cs[1] ) & value( cs[2] ) );
+    }
+    else if ( cs.size() == 2u )
+    {
+      tts[n] = value( cs[0] ) ^ value( cs[1] );
+    }
+  }
+
+  std::vector<uint64_t> outputs;
+  for ( const auto& o : xmg.outputs() )
+  {
+    outputs.push_back( value( o.first ) );
+  }
+  return outputs;
+}
+
+xmg_graph example_xmg()
+{
+  xmg_graph xmg( "example" );
+
+  const auto a = xmg.create_pi( "a" );
+  const auto b = xmg.create_pi( "b" );
+  const auto c = xmg.create_pi( "c" );
+  const auto f1 = xmg.create_and( a, !b );
+  const auto d = xmg.create_pi( "d" );
+  const auto f2 = xmg.create_xor( f1, !c );
+  const auto f3 = xmg.create_maj( f2, !d, a );
+  const auto f4 = xmg.create_or( f3, f1 );
+
+  xmg.create_po( f3, "x" );
+  xmg.create_po( !f4, "y" );
+  xmg.create_po( xmg.get_constant( true ), "z" );
+
+  return xmg;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( xmg_round_trip )
+{
+  const std::string filename = "/tmp/test_xmg_binary.bin";
+
+  auto xmg = example_xmg();
+  xmg_write_binary( xmg, filename );
+  const auto xmg2 = xmg_read_binary( filename );
+  std::remove( filename.c_str() );
+
+  BOOST_CHECK_EQUAL( xmg2.name(), "example" );
+  BOOST_CHECK_EQUAL( xmg2.size(), xmg.size() );
+  BOOST_CHECK_EQUAL( xmg2.num_maj(), xmg.num_maj() );
+  BOOST_CHECK_EQUAL( xmg2.num_xor(), xmg.num_xor() );
+  BOOST_CHECK_EQUAL( xmg2.inputs().size(), 4u );
+  BOOST_CHECK_EQUAL( xmg2.outputs().size(), 3u );
+
+  /* node indexes are kept */
+  for ( auto n : xmg.nodes() )
+  {
+    BOOST_CHECK( xmg2.children( n ) == xmg.children( n ) );
+  }
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    BOOST_CHECK_EQUAL( xmg2.inputs()[i].first, xmg.inputs()[i].first );
+    BOOST_CHECK_EQUAL( xmg2.inputs()[i].second, xmg.inputs()[i].second );
+  }
+  for ( auto i = 0u; i < 3u; ++i )
+  {
+    BOOST_CHECK( xmg2.outputs()[i].first == xmg.outputs()[i].first );
+    BOOST_CHECK_EQUAL( xmg2.outputs()[i].second, xmg.outputs()[i].second );
+  }
+
+  /* strash tables are restored */
+  auto copy = xmg2;
+  const auto size = copy.size();
+  const auto& in = copy.inputs();
+  copy.create_xor( xmg_function( in[2].first, true ), copy.create_and( xmg_function( in[0].first ), xmg_function( in[1].first, true ) ) );
+  BOOST_CHECK_EQUAL( copy.size(), size );
+}
+
+BOOST_AUTO_TEST_CASE( xmg_round_trip_after_substitution )
+{
+  const std::string filename = "/tmp/test_xmg_binary_subst.bin";
+
+  auto xmg = example_xmg();
+  const auto expected = simulate_outputs( xmg );
+
+  /* replace a gate by an input, this leaves dead nodes */
+  xmg_node f1 = 0u;
+  for ( auto n : xmg.nodes() )
+  {
+    if ( xmg.is_maj( n ) ) { f1 = n; break; }
+  }
+  const auto f3 = xmg.outputs()[0].first.node;
+  const auto g = xmg.create_maj( xmg.get_constant( false ), xmg_function( xmg.inputs()[0].first ), xmg_function( xmg.inputs()[1].first, true ) );
+  BOOST_CHECK_EQUAL( g.node, f1 );
+  xmg.substitute_node( f3, xmg_function( xmg.inputs()[3].first ) );
+  BOOST_CHECK( xmg.num_dead() > 0u );
+
+  xmg_write_binary( xmg, filename );
+  const auto xmg2 = xmg_read_binary( filename );
+  std::remove( filename.c_str() );
+
+  BOOST_CHECK_EQUAL( xmg2.size(), xmg.size() - xmg.num_dead() );
+  BOOST_CHECK_EQUAL( xmg2.num_gates(), xmg.num_gates() );
+  BOOST_CHECK_EQUAL( xmg2.num_dead(), 0u );
+  BOOST_CHECK( simulate_outputs( xmg2 ) == simulate_outputs( xmg ) );
+  BOOST_CHECK( simulate_outputs( xmg2 ) != expected );
+}
+
+BOOST_AUTO_TEST_CASE( xmg_round_trip_cover )
+{
+  const std::string filename = "/tmp/test_xmg_binary_cover.bin";
+
+  auto xmg = example_xmg();
+
+  xmg_cover cover( 4u, xmg );
+  const auto f3 = xmg.outputs()[0].first.node;
+  const auto f4 = xmg.outputs()[1].first.node;
+  cover.add_cut( f3, std::vector<unsigned>{1u, 2u, 3u, 5u} );
+  cover.add_cut( f4, std::vector<unsigned>{static_cast<unsigned>( f3 ), 1u, 2u} );
+  xmg.set_cover( cover );
+
+  xmg_write_binary( xmg, filename );
+  const auto xmg2 = xmg_read_binary( filename );
+
+  BOOST_CHECK( xmg2.has_cover() );
+  BOOST_CHECK_EQUAL( xmg2.cover().cut_size(), 4u );
+  BOOST_CHECK_EQUAL( xmg2.cover().lut_count(), 2u );
+  BOOST_CHECK( xmg2.cover().has_cut( f3 ) );
+  BOOST_CHECK_EQUAL( xmg2.cover().num_leafs( f4 ), 3u );
+  BOOST_CHECK_EQUAL( *xmg2.cover().cut( f4 ).begin(), f3 );
+
+  auto settings = std::make_shared<properties>();
+  settings->set( "cover", false );
+  xmg_write_binary( xmg, filename, settings );
+  BOOST_CHECK( !xmg_read_binary( filename ).has_cover() );
+  std::remove( filename.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE( mig_round_trip )
+{
+  const std::string filename = "/tmp/test_mig_binary.bin";
+
+  mig_graph mig;
+  mig_initialize( mig, "mig" );
+  const auto a = mig_create_pi( mig, "a" );
+  const auto b = mig_create_pi( mig, "b" );
+  const auto c = mig_create_pi( mig, "c" );
+  mig_create_po( mig, mig_create_xor( mig, a, mig_create_maj( mig, a, !b, c ) ), "f" );
+
+  mig_write_binary( mig, filename );
+  auto mig2 = mig_read_binary( filename );
+  std::remove( filename.c_str() );
+
+  const auto& info = boost::get_property( mig, boost::graph_name );
+  const auto& info2 = boost::get_property( mig2, boost::graph_name );
+
+  BOOST_CHECK_EQUAL( num_vertices( mig2 ), num_vertices( mig ) );
+  BOOST_CHECK_EQUAL( num_edges( mig2 ), num_edges( mig ) );
+  BOOST_CHECK_EQUAL( info2.model_name, "mig" );
+  BOOST_CHECK( info2.inputs == info.inputs );
+  BOOST_CHECK_EQUAL( info2.node_names.at( info2.inputs[1] ), "b" );
+  BOOST_CHECK( info2.outputs == info.outputs );
+  BOOST_CHECK_EQUAL( info2.constant_used, info.constant_used );
+  BOOST_CHECK_EQUAL( info2.strash.size(), info.strash.size() );
+
+  for ( auto n = 0u; n < num_vertices( mig ); ++n )
+  {
+    std::vector<std::pair<mig_node, bool>> cs, cs2;
+    for ( const auto& e : boost::make_iterator_range( out_edges( n, mig ) ) )
+    {
+      cs.push_back( {target( e, mig ), boost::get( boost::edge_complement, mig )[e]} );
+    }
+    for ( const auto& e : boost::make_iterator_range( out_edges( n, mig2 ) ) )
+    {
+      cs2.push_back( {target( e, mig2 ), boost::get( boost::edge_complement, mig2 )[e]} );
+    }
+    BOOST_CHECK( cs == cs2 );
+  }
+
+  /* existing gates are found by structural hashing */
+  BOOST_CHECK_EQUAL( mig_create_maj( mig2, mig_function{1u, false}, mig_function{2u, true}, mig_function{3u, false} ).node, 4u );
+}
+
+BOOST_AUTO_TEST_CASE( xmg_constant_used_flag )
+{
+  const std::string filename = "/tmp/test_xmg_binary_constant.bin";
+
+  const auto read_flags = [&filename]() {
+    mapped_file file( filename );
+    mapped_reader reader( file.begin(), file.end() );
+    return binary_network_read_header( reader, binary_network_xmg ).flags;
+  };
+
+  xmg_write_binary( example_xmg(), filename );
+  BOOST_CHECK( read_flags() & binary_network_constant_used );
+
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" );
+  const auto b = xmg.create_pi( "b" );
+  xmg.create_po( xmg.create_xor( a, b ), "f" );
+  xmg_write_binary( xmg, filename );
+  BOOST_CHECK( !( read_flags() & binary_network_constant_used ) );
+
+  std::remove( filename.c_str() );
+}
+
+BOOST_AUTO_TEST_CASE( broken_files )
+{
+  const std::string filename = "/tmp/test_xmg_binary_broken.bin";
+
+  {
+    std::ofstream os( filename.c_str() );
+    os << "aig 0 0 0 0 0" << std::endl;
+  }
+  BOOST_CHECK_THROW( xmg_read_binary( filename ), const char* );
+
+  xmg_write_binary( example_xmg(), filename );
+  BOOST_CHECK_THROW( mig_read_binary( filename ), const char* );
+
+  std::remove( filename.c_str() );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
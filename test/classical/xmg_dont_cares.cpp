@@ -0,0 +1,172 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_dont_cares
+
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_dont_cares.hpp>
+
+#include "random_xmg.hpp"
+
+using namespace cirkit;
+
+namespace
+{
+
+/* output values for one pattern, the value of node inverted (if any) is inverted */
+std::vector<bool> evaluate( const xmg_graph& xmg, const boost::dynamic_bitset<>& pattern, xmg_node inverted )
+{
+  std::vector<bool> values( xmg.size(), false );
+  for ( auto i = 0u; i < xmg.inputs().size(); ++i )
+  {
+    values[xmg.inputs()[i].first] = pattern[i];
+  }
+
+  const auto value = [&values]( const xmg_function& f ) { return values[f.node] != f.complemented; };
+
+  for ( auto n : xmg.topological_nodes() )
+  {
+    if ( !xmg.is_input( n ) )
+    {
+      const auto c = xmg.children( n );
+      values[n] = xmg.is_xor( n ) ? value( c[0u] ) != value( c[1u] )
+                                  : ( value( c[0u] ) + value( c[1u] ) + value( c[2u] ) ) >= 2;
+    }
+    if ( n == inverted )
+    {
+      values[n] = !values[n];
+    }
+  }
+
+  std::vector<bool> outputs;
+  for ( const auto& output : xmg.outputs() )
+  {
+    outputs.push_back( value( output.first ) );
+  }
+  return outputs;
+}
+
+bool is_observable( const xmg_graph& xmg, xmg_node node, const boost::dynamic_bitset<>& pattern )
+{
+  return evaluate( xmg, pattern, node ) != evaluate( xmg, pattern, xmg.size() );
+}
+
+/* compares the engine against inverting each node and evaluating the whole network */
+void check_against_brute_force( const xmg_graph& xmg )
+{
+  const auto num_inputs = xmg.inputs().size();
+
+  std::vector<boost::dynamic_bitset<>> patterns;
+  for ( auto m = 0u; m < ( 1u << num_inputs ); ++m )
+  {
+    patterns.emplace_back( num_inputs, m );
+  }
+
+  std::vector<xmg_node> nodes;
+  for ( auto n : xmg.nodes() )
+  {
+    if ( n != 0u )
+    {
+      nodes.push_back( n );
+    }
+  }
+
+  xmg_observability_engine engine( xmg ), windowed( xmg, 2u );
+  engine.set_patterns( patterns );
+  windowed.set_patterns( patterns );
+
+  const auto obs = engine.observability( nodes );
+  const auto obs_parallel = engine.observability( nodes, 3u );
+  const auto obs_windowed = windowed.observability( nodes );
+
+  for ( auto i = 0u; i < nodes.size(); ++i )
+  {
+    BOOST_CHECK( obs[i] == obs_parallel[i] );
+    BOOST_CHECK( obs[i].is_subset_of( obs_windowed[i] ) );
+
+    for ( auto m = 0u; m < patterns.size(); ++m )
+    {
+      const auto expected = !xmg.is_dead( nodes[i] ) && is_observable( xmg, nodes[i], patterns[m] );
+      BOOST_CHECK_EQUAL( obs[i][m], expected );
+      if ( m % 7u == 0u )
+      {
+        BOOST_CHECK_EQUAL( xmg_is_observable_at_node( xmg, nodes[i], patterns[m] ), expected );
+      }
+    }
+  }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( brute_force )
+{
+  for ( auto seed = 0u; seed < 20u; ++seed )
+  {
+    check_against_brute_force( random_xmg( 5u, 20u, 3u, seed, 0u ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( brute_force_after_substitution )
+{
+  for ( auto seed = 0u; seed < 20u; ++seed )
+  {
+    auto xmg = random_xmg( 5u, 20u, 3u, seed, 0u );
+
+    /* replace a gate by one of its children, which kills its fanin cone
+       if it has no other fanout */
+    std::mt19937 gen( seed );
+    for ( auto k = 0u; k < 3u; ++k )
+    {
+      std::vector<xmg_node> gates;
+      for ( auto n : xmg.nodes() )
+      {
+        if ( !xmg.is_input( n ) && !xmg.is_dead( n ) )
+        {
+          gates.push_back( n );
+        }
+      }
+      if ( gates.empty() ) { break; }
+
+      const auto n = gates[gen() % gates.size()];
+      xmg.substitute_node( n, xmg.children( n )[0u] );
+    }
+
+    BOOST_CHECK( xmg.num_dead() > 0u );
+    check_against_brute_force( xmg );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
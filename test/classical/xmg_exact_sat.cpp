@@ -0,0 +1,121 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_exact_sat
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg_exact_sat.hpp>
+#include <classical/xmg/xmg_simulate.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+tt simulate( const xmg_graph& xmg )
+{
+  auto f = simulate_xmg( xmg, xmg_tt_simulator() ).begin()->second;
+  tt_shrink( f, xmg.inputs().size() );
+  return f;
+}
+
+unsigned exact_size( const tt& spec, bool with_xor, unsigned portfolio = 1u, const xmg_exact_bounds::ptr& bounds = xmg_exact_bounds::ptr() )
+{
+  auto settings = std::make_shared<properties>();
+  settings->set( "with_xor", with_xor );
+  settings->set( "portfolio", portfolio );
+  settings->set( "bounds", bounds );
+
+  const auto xmg = xmg_exact_sat( spec, settings );
+  BOOST_REQUIRE( (bool)xmg );
+  BOOST_CHECK( simulate( *xmg ) == spec );
+
+  return xmg->num_gates();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( simple )
+{
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0xe8u ), true ), 1u );   /* maj */
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0x17u ), true ), 1u );   /* inverted maj */
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0x80u ), true ), 2u );   /* and3 */
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0x96u ), true ), 2u );   /* xor3 */
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0x96u ), false ), 3u );  /* xor3 without XOR gates */
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0xaau ), true ), 0u );   /* projection */
+  BOOST_CHECK_EQUAL( exact_size( tt( 8u, 0xffu ), true ), 0u );   /* constant */
+}
+
+BOOST_AUTO_TEST_CASE( portfolio_and_bounds )
+{
+  auto bounds = std::make_shared<xmg_exact_bounds>();
+
+  for ( auto f = 0u; f < 256u; f += 7u )
+  {
+    const tt spec( 8u, f );
+
+    const auto size = exact_size( spec, true );
+    BOOST_CHECK_EQUAL( exact_size( spec, true, 3u ), size );
+    BOOST_CHECK_EQUAL( exact_size( spec, true, 1u, bounds ), size );
+    BOOST_CHECK_EQUAL( exact_size( spec, true, 2u, bounds ), size );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( unproven_start_is_not_cached )
+{
+  auto bounds = std::make_shared<xmg_exact_bounds>();
+  const tt spec( 8u, 0x96u );                                     /* xor3 */
+
+  /* a start value above the optimum (as used in retries after timeouts) */
+  auto settings = std::make_shared<properties>();
+  settings->set( "start", 4u );
+  settings->set( "bounds", bounds );
+  const auto xmg = xmg_exact_sat( spec, settings );
+  BOOST_CHECK( !xmg || simulate( *xmg ) == spec );
+
+  BOOST_CHECK_EQUAL( exact_size( spec, true, 1u, bounds ), 2u );
+  BOOST_CHECK_EQUAL( exact_size( spec, true, 3u, bounds ), 2u );
+}
+
+BOOST_AUTO_TEST_CASE( bounds_depend_on_xor )
+{
+  auto bounds = std::make_shared<xmg_exact_bounds>();
+  const tt spec( 8u, 0x96u );                                     /* xor3 */
+
+  /* the MIG bound must not be used for XMGs */
+  BOOST_CHECK_EQUAL( exact_size( spec, false, 1u, bounds ), 3u );
+  BOOST_CHECK_EQUAL( exact_size( spec, true, 1u, bounds ), 2u );
+  BOOST_CHECK_EQUAL( exact_size( spec, false, 1u, bounds ), 3u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,156 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_mffc
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <classical/xmg/xmg.hpp>
+
+#include "random_xmg.hpp"
+
+using namespace cirkit;
+
+namespace
+{
+
+/* reference: deref on fresh reference counts */
+unsigned naive_mffc_size( const xmg_graph& xmg, xmg_node n )
+{
+  std::vector<unsigned> refs( xmg.size(), 0u );
+  for ( auto m : xmg.nodes() )
+  {
+    for ( const auto& c : xmg.children( m ) ) { ++refs[c.node]; }
+  }
+  for ( const auto& o : xmg.outputs() ) { ++refs[o.first.node]; }
+
+  auto count = 0u;
+  std::vector<xmg_node> stack{n};
+  while ( !stack.empty() )
+  {
+    const auto m = stack.back();
+    stack.pop_back();
+    if ( xmg.is_input( m ) ) continue;
+    ++count;
+    for ( const auto& c : xmg.children( m ) )
+    {
+      if ( --refs[c.node] == 0u ) { stack.push_back( c.node ); }
+    }
+  }
+  return count;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE( single_and_batch )
+{
+  for ( auto seed = 0u; seed < 10u; ++seed )
+  {
+    auto xmg = random_xmg( 8u, 300u, 6u, seed );
+
+    const auto sizes = xmg.mffc_sizes();
+    for ( auto n : xmg.nodes() )
+    {
+      const auto expected = naive_mffc_size( xmg, n );
+      BOOST_CHECK_EQUAL( sizes[n], expected );
+    }
+
+    auto xmg2 = random_xmg( 8u, 300u, 6u, seed );
+    for ( auto n : xmg2.nodes() )
+    {
+      BOOST_CHECK_EQUAL( xmg2.mffc_size( n ), sizes[n] );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( support )
+{
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" );
+  const auto b = xmg.create_pi( "b" );
+  const auto c = xmg.create_pi( "c" );
+  const auto d = xmg.create_pi( "d" );
+
+  const auto f1 = xmg.create_and( a, b );
+  const auto f2 = xmg.create_xor( f1, c );
+  const auto f3 = xmg.create_maj( f2, !d, f1 );
+  const auto f4 = xmg.create_or( f2, d );
+  xmg.create_po( f3, "x" );
+  xmg.create_po( f4, "y" );
+
+  /* f2 is shared, so MFFC of f3 is only f3 */
+  std::vector<xmg_node> leafs;
+  BOOST_CHECK_EQUAL( xmg.compute_mffc( f3.node, leafs ), 1u );
+  BOOST_CHECK( leafs == std::vector<xmg_node>( {d.node, f1.node, f2.node} ) );
+
+  leafs.clear();
+  BOOST_CHECK_EQUAL( xmg.compute_mffc( f4.node, leafs ), 1u );
+
+  /* reference counts are restored */
+  BOOST_CHECK_EQUAL( xmg.fanout_count( f2.node ), 2u );
+  BOOST_CHECK_EQUAL( xmg.mffc_size( f2.node ), 1u );
+}
+
+BOOST_AUTO_TEST_CASE( invalidation )
+{
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" );
+  const auto b = xmg.create_pi( "b" );
+  const auto c = xmg.create_pi( "c" );
+
+  const auto f1 = xmg.create_and( a, b );
+  const auto f2 = xmg.create_xor( f1, c );
+  xmg.create_po( f2, "x" );
+
+  BOOST_CHECK_EQUAL( xmg.mffc_size( f2.node ), 2u );
+  BOOST_CHECK_EQUAL( xmg.mffc_sizes()[f2.node], 2u );
+
+  /* new fanout of f1 */
+  const auto f3 = xmg.create_or( f1, c );
+  BOOST_CHECK_EQUAL( xmg.mffc_size( f2.node ), 1u );
+  BOOST_CHECK_EQUAL( xmg.mffc_sizes()[f3.node], 1u );
+
+  /* f1 becomes an output */
+  xmg.create_po( f3, "y" );
+  xmg.create_po( f1, "z" );
+  BOOST_CHECK_EQUAL( xmg.mffc_sizes()[f1.node], 1u );
+  xmg.delete_po( 2u );
+  BOOST_CHECK_EQUAL( xmg.mffc_size( f1.node ), 1u );
+
+  /* substitution */
+  xmg.substitute_node( f3.node, c );
+  BOOST_CHECK_EQUAL( xmg.mffc_size( f2.node ), 2u );
+  BOOST_CHECK_EQUAL( xmg.mffc_sizes()[f2.node], 2u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,274 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE xmg_substitute
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <classical/functions/bit_parallel_simulation.hpp>
+#include <classical/xmg/xmg.hpp>
+#include <classical/xmg/xmg_cuts_paged.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+/* truth tables of all nodes over up to 6 inputs, node override is replaced by by */
+std::vector<uint64_t> simulate( const xmg_graph& xmg, xmg_node override = 0u, const xmg_function& by = xmg_function() )
+{
+  static const uint64_t projections[] = {0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull,
+                                         0xff00ff00ff00ff00ull, 0xffff0000ffff0000ull, 0xffffffff00000000ull};
+
+  /* by is not in the transitive fanout of override */
+  const auto by_value = override != 0u ? simulate( xmg )[by.node] ^ ( by.complemented ? ~0ull : 0ull ) : 0ull;
+
+  std::vector<uint64_t> tts( xmg.size(), 0u );
+  for ( auto i = 0u; i < xmg.inputs().size(); ++i )
+  {
+    tts[xmg.inputs()[i].first] = projections[i];
+  }
+
+  const auto value = [&tts]( const xmg_function& f ) { return f.complemented ? ~tts[f.node] : tts[f.node]; };
+
+  for ( auto n : xmg.topological_nodes() )
+  {
+    if ( xmg.is_maj( n ) )
+    {
+      const auto c = xmg.children( n );
+      const auto a = value( c[0] ), b = value( c[1] ), d = value( c[2] );
+      tts[n] = ( a & b ) | ( a & d ) | ( b & d );
+    }
+    else if ( xmg.is_xor( n ) )
+    {
+      const auto c = xmg.children( n );
+      tts[n] = value( c[0] ) ^ value( c[1] );
+    }
+
+    if ( override != 0u && n == override )
+    {
+      tts[n] = by_value;
+    }
+  }
+
+  return tts;
+}
+
+std::vector<uint64_t> output_values( const xmg_graph& xmg, const std::vector<uint64_t>& tts )
+{
+  std::vector<uint64_t> values;
+  for ( const auto& o : xmg.outputs() )
+  {
+    values.push_back( o.first.complemented ? ~tts[o.first.node] : tts[o.first.node] );
+  }
+  return values;
+}
+
+/* incrementally maintained information must match a recomputation */
+void check_consistency( const xmg_graph& xmg )
+{
+  auto copy = xmg;
+  copy.mark_as_modified();
+  copy.compute_fanout();
+  copy.compute_parents();
+  copy.compute_levels();
+
+  auto num_maj = 0u, num_xor = 0u;
+  for ( auto n : xmg.nodes() )
+  {
+    BOOST_CHECK_EQUAL( xmg.fanout_count( n ), copy.fanout_count( n ) );
+    BOOST_CHECK_EQUAL( xmg.parents( n ).size(), copy.parents( n ).size() );
+    if ( !xmg.is_dead( n ) )
+    {
+      BOOST_CHECK_EQUAL( xmg.level( n ), copy.level( n ) );
+    }
+    num_maj += xmg.is_maj( n ) ? 1u : 0u;
+    num_xor += xmg.is_xor( n ) ? 1u : 0u;
+  }
+  BOOST_CHECK_EQUAL( xmg.num_maj(), num_maj );
+  BOOST_CHECK_EQUAL( xmg.num_xor(), num_xor );
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(substitute_and_remove_dangling)
+{
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" ), b = xmg.create_pi( "b" ), c = xmg.create_pi( "c" ), d = xmg.create_pi( "d" );
+  const auto f = xmg.create_maj( a, b, c );
+  const auto g = xmg.create_xor( f, d );
+  const auto h = xmg.create_and( f, g );
+  xmg.create_po( g, "g" );
+  xmg.create_po( h, "h" );
+
+  xmg.compute_fanout();
+  xmg.compute_parents();
+  xmg.compute_levels();
+
+  const auto expected = output_values( xmg, simulate( xmg, f.node, a ) );
+  xmg.substitute_node( f.node, a );
+
+  BOOST_CHECK( output_values( xmg, simulate( xmg ) ) == expected );
+  BOOST_CHECK( xmg.is_dead( f.node ) );
+  BOOST_CHECK_EQUAL( xmg.num_gates(), 2u );
+  BOOST_CHECK( xmg.journal().front().kind == xmg_change::substituted );
+  check_consistency( xmg );
+
+  /* substituting by a constant makes h trivial */
+  xmg.clear_journal();
+  const auto expected2 = output_values( xmg, simulate( xmg, g.node, xmg.get_constant( false ) ) );
+  xmg.substitute_node( g.node, xmg.get_constant( false ) );
+
+  BOOST_CHECK( output_values( xmg, simulate( xmg ) ) == expected2 );
+  BOOST_CHECK_EQUAL( xmg.num_gates(), 0u );
+  check_consistency( xmg );
+}
+
+BOOST_AUTO_TEST_CASE(random_substitutions)
+{
+  std::default_random_engine gen( 3u );
+
+  for ( auto round = 0u; round < 50u; ++round )
+  {
+    xmg_graph xmg;
+    std::vector<xmg_function> fs;
+    for ( auto i = 0u; i < 6u; ++i )
+    {
+      fs.push_back( xmg.create_pi( "x" + std::to_string( i ) ) );
+    }
+
+    const auto pick = [&]() {
+      return fs[std::uniform_int_distribution<unsigned>( 0u, fs.size() - 1u )( gen )] ^ ( gen() & 1u );
+    };
+
+    for ( auto i = 0u; i < 40u; ++i )
+    {
+      fs.push_back( ( gen() % 3u ) ? xmg.create_maj( pick(), pick(), pick() ) : xmg.create_xor( pick(), pick() ) );
+    }
+    for ( auto i = 0u; i < 5u; ++i )
+    {
+      xmg.create_po( pick(), "y" + std::to_string( i ) );
+    }
+
+    xmg.compute_fanout();
+    xmg.compute_parents();
+    xmg.compute_levels();
+
+    /* replace some gates by a node with a smaller index (cannot be in their fanout) */
+    for ( auto k = 0u; k < 5u; ++k )
+    {
+      const auto n = std::uniform_int_distribution<unsigned>( 7u, xmg.size() - 1u )( gen );
+      if ( xmg.is_dead( n ) || xmg.fanin_count( n ) == 0u ) continue;
+
+      const auto m = std::uniform_int_distribution<unsigned>( 0u, n - 1u )( gen );
+      if ( xmg.is_dead( m ) ) continue;
+
+      /* nodes created by earlier substitutions break the index order */
+      const auto tts = simulate( xmg );
+      auto in_tfo = false;
+      for ( auto p : xmg.topological_nodes() )
+      {
+        if ( p == m ) { break; }
+        if ( p == n ) { in_tfo = true; }
+      }
+      if ( in_tfo ) continue;
+
+      const xmg_function by( m, gen() & 1u );
+      const auto expected = output_values( xmg, simulate( xmg, n, by ) );
+      xmg.substitute_node( n, by );
+
+      BOOST_CHECK( output_values( xmg, simulate( xmg ) ) == expected );
+      check_consistency( xmg );
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(traverse_after_substitution)
+{
+  static const uint64_t projections[] = {0xaaaaaaaaaaaaaaaaull, 0xccccccccccccccccull, 0xf0f0f0f0f0f0f0f0ull, 0xff00ff00ff00ff00ull};
+
+  xmg_graph xmg;
+  const auto a = xmg.create_pi( "a" ), b = xmg.create_pi( "b" ), c = xmg.create_pi( "c" ), d = xmg.create_pi( "d" );
+  const auto f = xmg.create_maj( a, b, c );
+  const auto g = xmg.create_xor( f, d );
+  const auto h = xmg.create_and( !f, g );
+  xmg.create_po( g, "g" );
+  xmg.create_po( h, "h" );
+
+  xmg.substitute_node( f.node, xmg.create_or( a, b ) );
+  BOOST_CHECK( xmg.num_dead() > 0u );
+
+  for ( auto n : xmg.topological_nodes() )
+  {
+    BOOST_CHECK( !xmg.is_dead( n ) );
+  }
+
+  /* dead nodes have no children and must not be simulated */
+  auto sim = bit_parallel_simulator_from_xmg( xmg );
+  for ( auto i = 0u; i < 4u; ++i )
+  {
+    sim.input_words( i )[0u] = projections[i];
+  }
+  sim.simulate();
+
+  const auto expected = output_values( xmg, simulate( xmg ) );
+  for ( auto i = 0u; i < expected.size(); ++i )
+  {
+    BOOST_CHECK_EQUAL( sim.output_word( i, 0u ) & 0xffffull, expected[i] & 0xffffull );
+  }
+
+  /* sequential and parallel cut enumeration */
+  for ( auto parallel : {false, true} )
+  {
+    auto settings = std::make_shared<properties>();
+    settings->set( "parallel", parallel );
+    xmg_cuts_paged cuts( xmg, 4u, settings );
+
+    for ( auto n : xmg.nodes() )
+    {
+      if ( xmg.is_dead( n ) )
+      {
+        BOOST_CHECK_EQUAL( cuts.count( n ), 0u );
+      }
+      else
+      {
+        BOOST_CHECK( cuts.count( n ) > 0u );
+      }
+    }
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,228 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE paged_memory
+
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/utils/paged_memory.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+using sets_t = std::vector<std::vector<unsigned>>;
+
+/* sets and extra values of all indexes */
+std::vector<sets_t> contents( paged_memory& mem, unsigned n, unsigned k )
+{
+  std::vector<sets_t> result( n );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    for ( const auto& s : mem.sets( i ) )
+    {
+      std::vector<unsigned> v;
+      for ( auto j = 0u; j < k; ++j )
+      {
+        v.push_back( s.extra( j ) );
+      }
+      v.insert( v.end(), s.begin(), s.end() );
+      result[i].push_back( v );
+    }
+  }
+  return result;
+}
+
+sets_t record_contents( const paged_memory_page::record& r, unsigned k )
+{
+  sets_t result;
+  paged_memory_page::foreach_set( r, k, [&result]( const unsigned* extra, const unsigned* begin, const unsigned* end ) {
+      std::vector<unsigned> v( extra, begin );
+      v.insert( v.end(), begin, end );
+      result.push_back( v );
+    } );
+  return result;
+}
+
+/* index of the previous level that index i is derived from, it is written by another thread */
+unsigned source_index( unsigned i, unsigned width )
+{
+  return i - width + ( i + 1u ) % width - i % width;
+}
+
+/* the sets of index i are derived from the sets of its source index */
+sets_t derived_sets( const sets_t& previous, unsigned i )
+{
+  sets_t sets;
+  for ( const auto& s : previous )
+  {
+    if ( s.size() < 6u )
+    {
+      auto t = s;
+      t.push_back( i );
+      sets.push_back( t );
+    }
+  }
+  return sets;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(page_records)
+{
+  const auto k = 2u;
+  const auto n = 50u;
+
+  /* small blocks, such that records span several blocks and some records exceed the block size */
+  paged_memory_page page( k, 8u );
+  paged_memory expected( n, k );
+  std::vector<paged_memory_page::record> records( n );
+
+  for ( auto i = 0u; i < n; ++i )
+  {
+    page.begin_record();
+    if ( i == 0u )
+    {
+      page.append_empty( {7u, 8u} );
+      expected.assign_empty( i, {7u, 8u} );
+    }
+    else
+    {
+      expected.append_begin( i );
+      for ( auto j = 0u; j < i % 5u; ++j )
+      {
+        std::vector<unsigned> values;
+        for ( auto v = 0u; v <= j; ++v )
+        {
+          values.push_back( i + v );
+        }
+        page.append_set( values.begin(), values.end(), {i, j} );
+        expected.append_set( i, values, {i, j} );
+      }
+      page.append_singleton( i, {0u, 1u} );
+      expected.append_singleton( i, i, {0u, 1u} );
+    }
+    records[i] = page.end_record();
+  }
+
+  BOOST_CHECK_GT( page.memory(), 0u );
+
+  /* records did not move while appending */
+  const auto exp = contents( expected, n, k );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    BOOST_CHECK_EQUAL( records[i].count, expected.count( i ) );
+    BOOST_CHECK( record_contents( records[i], k ) == exp[i] );
+  }
+
+  /* compaction in a different order */
+  paged_memory mem( n, k );
+  for ( auto i = n; i-- > 0u; )
+  {
+    mem.assign_record( i, records[i] );
+  }
+  BOOST_CHECK( contents( mem, n, k ) == exp );
+  BOOST_CHECK_EQUAL( mem.sets_count(), expected.sets_count() );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_pages)
+{
+  const auto num_threads = 4u;
+  const auto width = 64u;
+  const auto num_levels = 8u;
+  const auto n = width * num_levels;
+
+  /* sequential reference */
+  paged_memory expected( n );
+  std::vector<sets_t> expected_sets( n );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    expected.append_begin( i );
+    if ( i >= width )
+    {
+      expected_sets[i] = derived_sets( expected_sets[source_index( i, width )], i );
+    }
+    expected_sets[i].push_back( {i} );
+    for ( const auto& s : expected_sets[i] )
+    {
+      expected.append_set( i, s );
+    }
+  }
+
+  /* level by level, each thread writes into its own page and reads records of other threads from earlier levels */
+  std::vector<paged_memory_page> pages;
+  for ( auto t = 0u; t < num_threads; ++t )
+  {
+    pages.emplace_back( 0u, 32u );
+  }
+  std::vector<paged_memory_page::record> records( n );
+
+  for ( auto l = 0u; l < num_levels; ++l )
+  {
+    std::vector<std::thread> threads;
+    for ( auto t = 0u; t < num_threads; ++t )
+    {
+      threads.emplace_back( [&, t]() {
+          auto& page = pages[t];
+          for ( auto i = l * width + t; i < ( l + 1u ) * width; i += num_threads )
+          {
+            page.begin_record();
+            if ( l > 0u )
+            {
+              for ( const auto& s : derived_sets( record_contents( records[source_index( i, width )], 0u ), i ) )
+              {
+                page.append_set( s.begin(), s.end() );
+              }
+            }
+            page.append_singleton( i );
+            records[i] = page.end_record();
+          }
+        } );
+    }
+    for ( auto& thread : threads )
+    {
+      thread.join();
+    }
+  }
+
+  paged_memory mem( n );
+  for ( auto i = 0u; i < n; ++i )
+  {
+    mem.assign_record( i, records[i] );
+  }
+  BOOST_CHECK( contents( mem, n, 0u ) == contents( expected, n, 0u ) );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,209 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE strash_table
+
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/utils/strash_table.hpp>
+
+using namespace cirkit;
+
+namespace
+{
+
+struct key3_hash
+{
+  std::size_t operator()( const strash_key3& key ) const { return strash_hash<strash_key3>()( key ); }
+};
+
+/* compares the table against std::unordered_map after each operation; small
+   key ranges lead to many collisions, long probe sequences, and erasures in
+   the middle of clusters */
+template<typename Key, typename Map, typename MakeKey>
+void check_against_map( MakeKey make_key, unsigned key_range, unsigned seed )
+{
+  std::mt19937 gen( seed );
+  strash_table<Key> table( 16u );
+  Map map;
+
+  for ( auto i = 0u; i < 20000u; ++i )
+  {
+    const auto key = make_key( gen() % key_range );
+    const auto value = static_cast<uint32_t>( gen() % 1000u );
+
+    switch ( gen() % 4u )
+    {
+    case 0u:
+      {
+        const auto r = table.insert( key, value );
+        const auto m = map.insert( {key, value} );
+        BOOST_REQUIRE_EQUAL( r.second, m.second );
+        BOOST_REQUIRE_EQUAL( r.first, m.first->second );
+      } break;
+    case 1u:
+      table.assign( key, value );
+      map[key] = value;
+      break;
+    case 2u:
+      BOOST_REQUIRE_EQUAL( table.erase( key ), map.erase( key ) == 1u );
+      break;
+    case 3u:
+      {
+        const auto it = map.find( key );
+        BOOST_REQUIRE_EQUAL( table.find( key ), it == map.end() ? table.empty : it->second );
+      } break;
+    }
+
+    BOOST_REQUIRE_EQUAL( table.size(), map.size() );
+    BOOST_REQUIRE_LE( table.load_factor(), 0.5 );
+  }
+
+  for ( auto k = 0u; k < key_range; ++k )
+  {
+    const auto key = make_key( k );
+    const auto it = map.find( key );
+    BOOST_CHECK_EQUAL( static_cast<const strash_table<Key>&>( table ).find( key ), it == map.end() ? table.empty : it->second );
+  }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(compare_with_unordered_map)
+{
+  for ( auto seed = 0u; seed < 4u; ++seed )
+  {
+    check_against_map<uint64_t, std::unordered_map<uint64_t, uint32_t>>( []( unsigned k ) { return static_cast<uint64_t>( k ) * 0x100000001ull; }, 3000u, seed );
+    check_against_map<strash_key3, std::unordered_map<strash_key3, uint32_t, key3_hash>>( []( unsigned k ) { return strash_key3( k % 7u, k / 7u, k % 13u ); }, 3000u, seed );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(reserve_and_clear)
+{
+  strash_table<uint64_t> table;
+  table.reserve( 5000u );
+  const auto capacity = table.capacity();
+  BOOST_CHECK_GE( capacity, 10000u );
+
+  for ( auto i = 0u; i < 5000u; ++i )
+  {
+    BOOST_CHECK( table.insert( i, i ).second );
+  }
+  BOOST_CHECK_EQUAL( table.capacity(), capacity );
+  BOOST_CHECK_EQUAL( table.num_rehashes(), 0u );
+
+  table.reserve( 10000u );
+  BOOST_CHECK_EQUAL( table.num_rehashes(), 1u );
+
+  table.clear();
+  BOOST_CHECK_EQUAL( table.size(), 0u );
+  for ( auto i = 0u; i < 5000u; ++i )
+  {
+    BOOST_CHECK_EQUAL( table.find( i ), table.empty );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(allocate_on_first_insert)
+{
+  strash_table<strash_key3> table;
+  BOOST_CHECK_EQUAL( table.capacity(), 0u );
+  BOOST_CHECK_EQUAL( table.memory(), 0u );
+  BOOST_CHECK_EQUAL( table.load_factor(), 0.0 );
+
+  const strash_key3 key( 1u, 2u, 3u );
+  BOOST_CHECK_EQUAL( table.find( key ), table.empty );
+  BOOST_CHECK_EQUAL( static_cast<const strash_table<strash_key3>&>( table ).find( key ), table.empty );
+  BOOST_CHECK( !table.erase( key ) );
+  table.clear();
+  BOOST_CHECK_EQUAL( table.capacity(), 0u );
+
+  BOOST_CHECK( table.insert( key, 7u ).second );
+  BOOST_CHECK_GT( table.capacity(), 0u );
+  BOOST_CHECK_EQUAL( table.find( key ), 7u );
+  BOOST_CHECK_EQUAL( table.num_rehashes(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE(probe_statistics)
+{
+  strash_table<uint64_t> table;
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    table.insert( i, i );
+  }
+  BOOST_CHECK_EQUAL( table.num_lookups(), 100u );
+  BOOST_CHECK_GE( table.num_probes(), 100u );
+
+  table.find( 5u );
+  BOOST_CHECK_EQUAL( table.num_lookups(), 101u );
+
+  /* lookups through a const reference do not modify the table */
+  const auto& ctable = table;
+  const auto probes = table.num_probes();
+  BOOST_CHECK_EQUAL( ctable.find( 5u ), 5u );
+  BOOST_CHECK_EQUAL( ctable.find( 500u ), ctable.empty );
+  BOOST_CHECK_EQUAL( table.num_lookups(), 101u );
+  BOOST_CHECK_EQUAL( table.num_probes(), probes );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_const_find)
+{
+  strash_table<strash_key3> table;
+  for ( auto i = 0u; i < 10000u; ++i )
+  {
+    table.insert( strash_key3( i, i + 1u, i + 2u ), i );
+  }
+
+  const auto& ctable = table;
+  std::vector<unsigned> errors( 4u, 0u );
+  std::vector<std::thread> threads;
+  for ( auto t = 0u; t < errors.size(); ++t )
+  {
+    threads.emplace_back( [&ctable, &errors, t]() {
+        for ( auto i = 0u; i < 20000u; ++i )
+        {
+          const auto expected = i < 10000u ? i : ctable.empty;
+          if ( ctable.find( strash_key3( i, i + 1u, i + 2u ) ) != expected ) { ++errors[t]; }
+        }
+      } );
+  }
+  for ( auto& thread : threads ) { thread.join(); }
+
+  for ( auto e : errors )
+  {
+    BOOST_CHECK_EQUAL( e, 0u );
+  }
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,91 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE typed_properties
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/properties.hpp>
+#include <core/typed_properties.hpp>
+
+using namespace cirkit;
+
+struct test_params
+{
+  unsigned    limit   = 10u;
+  bool        verbose = false;
+  std::string name    = "default";
+
+  static auto fields()
+  {
+    return std::make_tuple( make_property_field( "limit",   &test_params::limit ),
+                            make_property_field( "verbose", &test_params::verbose ),
+                            make_property_field( "name",    &test_params::name ) );
+  }
+};
+
+BOOST_AUTO_TEST_CASE(simple)
+{
+  /* defaults without settings */
+  const auto p1 = from_properties<test_params>( properties::ptr() );
+  BOOST_CHECK( p1.limit == 10u );
+  BOOST_CHECK( !p1.verbose );
+  BOOST_CHECK( p1.name == "default" );
+
+  /* only given keys are overridden */
+  const auto settings = std::make_shared<properties>();
+  settings->set( "limit", 5u );
+  settings->set( "other", 1 );
+  const auto p2 = from_properties<test_params>( settings );
+  BOOST_CHECK( p2.limit == 5u );
+  BOOST_CHECK( !p2.verbose );
+  BOOST_CHECK( p2.name == "default" );
+
+  /* round trip */
+  test_params p3;
+  p3.verbose = true;
+  p3.name = "typed";
+  const auto statistics = std::make_shared<properties>();
+  to_properties( p3, statistics );
+  BOOST_CHECK( statistics->get<unsigned>( "limit" ) == 10u );
+  BOOST_CHECK( statistics->get<bool>( "verbose" ) );
+  BOOST_CHECK( statistics->get<std::string>( "name" ) == "typed" );
+
+  const auto p4 = from_properties<test_params>( statistics );
+  BOOST_CHECK( p4.verbose && p4.name == "typed" );
+
+  /* null statistics are ignored */
+  to_properties( p3, properties::ptr() );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
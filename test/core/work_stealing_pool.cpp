@@ -0,0 +1,85 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE work_stealing_pool
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <core/utils/work_stealing_pool.hpp>
+
+using namespace cirkit;
+
+BOOST_AUTO_TEST_CASE(visit_each_index_once)
+{
+  for ( auto threads = 1u; threads <= 4u; ++threads )
+  {
+    work_stealing_pool pool( threads );
+    BOOST_CHECK_EQUAL( pool.num_threads(), threads );
+
+    for ( auto round = 0u; round < 10u; ++round )
+    {
+      std::vector<std::atomic<unsigned>> visited( 10000u );
+      for ( auto& v : visited ) { v = 0u; }
+      std::atomic<bool> valid_workers( true );
+
+      pool.parallel_for( 0u, visited.size(), [&visited, &valid_workers, threads]( std::size_t i, unsigned worker ) {
+          if ( worker >= threads ) { valid_workers = false; }
+          ++visited[i];
+        }, 7u );
+
+      BOOST_CHECK( valid_workers.load() );
+
+      for ( const auto& v : visited )
+      {
+        BOOST_CHECK_EQUAL( v.load(), 1u );
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(rethrow_exception)
+{
+  work_stealing_pool pool( 3u );
+  BOOST_CHECK_THROW( pool.parallel_for( 0u, 1000u, []( std::size_t i, unsigned ) {
+        if ( i == 500u ) { throw std::runtime_error( "error" ); }
+      } ), std::runtime_error );
+
+  /* pool can be used again */
+  std::atomic<unsigned> sum( 0u );
+  pool.parallel_for( 0u, 100u, [&sum]( std::size_t i, unsigned ) { sum += i; } );
+  BOOST_CHECK_EQUAL( sum.load(), 4950u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End: